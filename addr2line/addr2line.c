@@ -56,8 +56,8 @@ struct Func {
 
 struct CU {
 	Dwarf_Off off;
+	Dwarf_Half version;
 	Dwarf_Unsigned lopc;
-	Dwarf_Unsigned hipc;
 	char **srcfiles;
 	Dwarf_Signed nsrcfiles;
 	STAILQ_HEAD(, Func) funclist;
@@ -164,7 +164,8 @@ search_func(struct CU *cu, Dwarf_Unsigned addr)
 
 	STAILQ_FOREACH(f, &cu->funclist, next) {
 		if (f->ranges != NULL) {
-			addr_base = 0;
+			/* Range list entries are relative to the CU base. */
+			addr_base = cu->lopc;
 			for (i = 0; i < f->ranges_cnt; i++) {
 				if (f->ranges[i].dwr_type == DW_RANGES_END)
 					break;
@@ -232,8 +233,8 @@ collect_func(Dwarf_Debug dbg, Dwarf_Die die, struct Func *parent, struct CU *cu)
 		found_ranges = 0;
 		if (dwarf_attrval_unsigned(die, DW_AT_ranges, &ranges_off,
 		    &de) == DW_DLV_OK &&
-		    dwarf_get_ranges(dbg, (Dwarf_Off) ranges_off, &ranges,
-		    &ranges_cnt, NULL, &de) == DW_DLV_OK) {
+		    dwarf_get_ranges_a(dbg, (Dwarf_Off) ranges_off, die,
+		    &ranges, &ranges_cnt, NULL, &de) == DW_DLV_OK) {
 			if (ranges != NULL && ranges_cnt > 0) {
 				found_ranges = 1;
 				goto get_func_name;
@@ -346,7 +347,11 @@ print_inlines(struct CU *cu, struct Func *f, Dwarf_Unsigned call_file,
 	char demangled[1024];
 	char *file;
 
-	if (call_file > 0 && (Dwarf_Signed) call_file <= cu->nsrcfiles)
+	/* DWARF5 file numbers are 0-based. */
+	if (cu->version >= 5 && (Dwarf_Signed) call_file < cu->nsrcfiles)
+		file = cu->srcfiles[call_file];
+	else if (cu->version < 5 && call_file > 0 &&
+	    (Dwarf_Signed) call_file <= cu->nsrcfiles)
 		file = cu->srcfiles[call_file - 1];
 	else
 		file = unknown;
@@ -379,11 +384,11 @@ print_inlines(struct CU *cu, struct Func *f, Dwarf_Unsigned call_file,
 static void
 translate(Dwarf_Debug dbg, Elf *e, const char* addrstr)
 {
-	Dwarf_Die die, ret_die;
+	Dwarf_Die die;
 	Dwarf_Line *lbuf;
 	Dwarf_Error de;
-	Dwarf_Half tag;
-	Dwarf_Unsigned lopc, hipc, addr, lineno, plineno;
+	Dwarf_Half offset_size, version;
+	Dwarf_Unsigned lopc, addr, lineno, plineno;
 	Dwarf_Signed lcount;
 	Dwarf_Addr lineaddr, plineaddr;
 	Dwarf_Off off;
@@ -401,76 +406,36 @@ translate(Dwarf_Debug dbg, Elf *e, const char* addrstr)
 	cu = NULL;
 	die = NULL;
 
-	while ((ret = dwarf_next_cu_header(dbg, NULL, NULL, NULL, NULL, NULL,
-	    &de)) ==  DW_DLV_OK) {
-		die = NULL;
-		while (dwarf_siblingof(dbg, die, &ret_die, &de) == DW_DLV_OK) {
-			if (die != NULL)
-				dwarf_dealloc(dbg, die, DW_DLA_DIE);
-			die = ret_die;
-			if (dwarf_tag(die, &tag, &de) != DW_DLV_OK) {
-				warnx("dwarf_tag failed: %s",
-				    dwarf_errmsg(de));
-				goto next_cu;
-			}
-
-			/* XXX: What about DW_TAG_partial_unit? */
-			if (tag == DW_TAG_compile_unit)
-				break;
-		}
-		if (ret_die == NULL) {
-			warnx("could not find DW_TAG_compile_unit die");
-			goto next_cu;
-		}
-		if (dwarf_attrval_unsigned(die, DW_AT_low_pc, &lopc, &de) ==
-		    DW_DLV_OK) {
-			if (dwarf_attrval_unsigned(die, DW_AT_high_pc, &hipc,
-			   &de) == DW_DLV_OK) {
-				/*
-				 * Check if the address falls into the PC
-				 * range of this CU.
-				 */
-				if (handle_high_pc(die, lopc, &hipc) !=
-				    DW_DLV_OK)
-					goto out;
-			} else {
-				/* Assume ~0ULL if DW_AT_high_pc not present */
-				hipc = ~0ULL;
-			}
-
-			/*
-			 * Record the CU in the hash table for faster lookup
-			 * later.
-			 */
-			if (dwarf_dieoffset(die, &off, &de) != DW_DLV_OK) {
-				warnx("dwarf_dieoffset failed: %s",
-				    dwarf_errmsg(de));
-				goto out;
-			}
-			HASH_FIND(hh, culist, &off, sizeof(off), cu);
-			if (cu == NULL) {
-				if ((cu = calloc(1, sizeof(*cu))) == NULL)
-					err(EXIT_FAILURE, "calloc");
-				cu->off = off;
-				cu->lopc = lopc;
-				cu->hipc = hipc;
-				STAILQ_INIT(&cu->funclist);
-				HASH_ADD(hh, culist, off, sizeof(off), cu);
-			}
-
-			if (addr >= lopc && addr < hipc)
-				break;
-		}
+	/* Find the CU covering the address. */
+	ret = dwarf_get_cu_die_offset_given_pc(dbg, addr, &off, NULL, NULL,
+	    &de);
+	if (ret == DW_DLV_ERROR)
+		warnx("dwarf_get_cu_die_offset_given_pc: %s", dwarf_errmsg(de));
+	if (ret != DW_DLV_OK)
+		goto out;
 
-	next_cu:
-		if (die != NULL) {
-			dwarf_dealloc(dbg, die, DW_DLA_DIE);
-			die = NULL;
-		}
+	if ((ret = dwarf_offdie(dbg, off, &die, &de)) != DW_DLV_OK) {
+		warnx("dwarf_offdie failed: %s", dwarf_errmsg(de));
+		die = NULL;
+		goto out;
 	}
 
-	if (ret != DW_DLV_OK || die == NULL)
-		goto out;
+	/* Record the CU in the hash table for faster lookup later. */
+	HASH_FIND(hh, culist, &off, sizeof(off), cu);
+	if (cu == NULL) {
+		if (dwarf_get_version_of_die(die, &version, &offset_size) !=
+		    DW_DLV_OK)
+			version = 2;
+		lopc = 0;
+		(void) dwarf_attrval_unsigned(die, DW_AT_low_pc, &lopc, &de);
+		if ((cu = calloc(1, sizeof(*cu))) == NULL)
+			err(EXIT_FAILURE, "calloc");
+		cu->off = off;
+		cu->version = version;
+		cu->lopc = lopc;
+		STAILQ_INIT(&cu->funclist);
+		HASH_ADD(hh, culist, off, sizeof(off), cu);
+	}
 
 	switch (dwarf_srclines(die, &lbuf, &lcount, &de)) {
 	case DW_DLV_OK:
@@ -573,18 +538,6 @@ out:
 
 	if (die != NULL)
 		dwarf_dealloc(dbg, die, DW_DLA_DIE);
-
-	/*
-	 * Reset internal CU pointer, so we will start from the first CU
-	 * next round.
-	 */
-	while (ret != DW_DLV_NO_ENTRY) {
-		if (ret == DW_DLV_ERROR)
-			errx(EXIT_FAILURE, "dwarf_next_cu_header: %s",
-			    dwarf_errmsg(de));
-		ret = dwarf_next_cu_header(dbg, NULL, NULL, NULL, NULL, NULL,
-		    &de);
-	}
 }
 
 static void
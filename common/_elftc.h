@@ -381,6 +381,7 @@ extern const char *__progname;
 #define	ELFTC_BYTE_ORDER_BIG_ENDIAN		_BIG_ENDIAN
 
 #define	ELFTC_HAVE_MMAP				1
+#define	ELFTC_HAVE_PTHREADS			1
 #define	ELFTC_HAVE_STRMODE			1
 
 #define ELFTC_NEED_BYTEORDER_EXTENSIONS		1
@@ -397,6 +398,7 @@ extern const char *__progname;
 #define	ELFTC_BYTE_ORDER_BIG_ENDIAN		_BIG_ENDIAN
 
 #define	ELFTC_HAVE_MMAP				1
+#define	ELFTC_HAVE_PTHREADS			1
 
 #endif
 
@@ -409,6 +411,7 @@ extern const char *__progname;
 #define	ELFTC_BYTE_ORDER_BIG_ENDIAN		__BIG_ENDIAN
 
 #define	ELFTC_HAVE_MMAP				1
+#define	ELFTC_HAVE_PTHREADS			1
 
 /*
  * Debian GNU/Linux and Debian GNU/kFreeBSD do not have strmode(3).
@@ -433,6 +436,7 @@ extern const char *__progname;
 #define	ELFTC_BYTE_ORDER_BIG_ENDIAN		_BIG_ENDIAN
 
 #define	ELFTC_HAVE_MMAP				1
+#define	ELFTC_HAVE_PTHREADS			1
 #define	ELFTC_HAVE_STRMODE			1
 #if __FreeBSD_version <= 900000
 #define	ELFTC_BROKEN_YY_NO_INPUT		1
@@ -442,6 +446,7 @@ extern const char *__progname;
 
 #if defined(__minix)
 #define	ELFTC_HAVE_MMAP				0
+#define	ELFTC_HAVE_PTHREADS			0
 #endif	/* __minix */
 
 
@@ -455,6 +460,7 @@ extern const char *__progname;
 #define	ELFTC_BYTE_ORDER_BIG_ENDIAN		_BIG_ENDIAN
 
 #define	ELFTC_HAVE_MMAP				1
+#define	ELFTC_HAVE_PTHREADS			1
 #define	ELFTC_HAVE_STRMODE			1
 #if __NetBSD_Version__ <= 599002100
 /* from src/doc/CHANGES: flex(1): Import flex-2.5.35 [christos 20091025] */
@@ -474,6 +480,7 @@ extern const char *__progname;
 #define	ELFTC_BYTE_ORDER_BIG_ENDIAN		_BIG_ENDIAN
 
 #define	ELFTC_HAVE_MMAP				1
+#define	ELFTC_HAVE_PTHREADS			1
 #define	ELFTC_HAVE_STRMODE			1
 
 #define	ELFTC_NEED_BYTEORDER_EXTENSIONS		1
@@ -128,6 +128,7 @@ _find_and_create_got_section(struct ld *ld, int create)
 
 	if (create) {
 		is = ld_input_add_internal_section(ld, ".got");
+		ld->ld_got = is;
 		is->is_entsize = 4;
 		is->is_align = 4;
 		is->is_type = SHT_PROGBITS;
@@ -476,11 +477,7 @@ _got_offset(struct ld *ld, struct ld_symbol *lsb)
 	struct ld_output_section *os;
 
 	assert(lsb->lsb_got);
-
-	if (ld->ld_got == NULL) {
-		ld->ld_got = _find_and_create_got_section(ld, 0);
-		assert(ld->ld_got != NULL);
-	}
+	assert(ld->ld_got != NULL);
 
 	os = ld->ld_got->is_output;
 
@@ -491,13 +488,10 @@ static void
 _process_reloc(struct ld *ld, struct ld_input_section *is,
     struct ld_reloc_entry *lre, struct ld_symbol *lsb, uint8_t *buf)
 {
-	struct ld_state *ls;
 	struct ld_output *lo;
 	uint32_t p, s, l, g, got;
 	int32_t a, v;
 
-	ls = &ld->ld_state;
-
 	lo = ld->ld_output;
 	assert(lo != NULL);
 
@@ -525,11 +519,11 @@ _process_reloc(struct ld *ld, struct ld_input_section *is,
 		break;
 
 	case R_386_PLT32:
-		if (!ls->ls_ignore_next_plt) {
+		if (!is->is_ignore_next_plt) {
 			v = l + a - p;
 			WRITE_32(buf + lre->lre_offset, v);
 		} else
-			ls->ls_ignore_next_plt = 0;
+			is->is_ignore_next_plt = 0;
 		break;
 
 	case R_386_GOT32:
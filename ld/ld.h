@@ -41,6 +41,7 @@
 #include <inttypes.h>
 #include <libelftc.h>
 #include <libgen.h>
+#include <limits.h>
 #include <stdarg.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -67,9 +68,18 @@ struct ld_section_group;
 
 #define	LD_MAX_NESTED_GROUP	16
 
+#define	LD_HASH_STYLE_SYSV	0x1	/* .hash */
+#define	LD_HASH_STYLE_GNU	0x2	/* .gnu.hash */
+
+#define	LD_BUILD_ID_NONE	0	/* no build ID */
+#define	LD_BUILD_ID_FAST	1	/* 64-bit xxHash of the output */
+#define	LD_BUILD_ID_MD5		2	/* MD5 of the output */
+#define	LD_BUILD_ID_SHA1	3	/* SHA-1 of the output */
+#define	LD_BUILD_ID_UUID	4	/* random UUID */
+#define	LD_BUILD_ID_HEX		5	/* user-specified bytes */
+
 struct ld_state {
 	Elftc_Bfd_Target *ls_itgt;	/* input bfd target set by -b */
-	struct ld_file *ls_file;	/* current open file */
 	unsigned ls_static;		/* use static library */
 	unsigned ls_whole_archive;	/* include whole archive */
 	unsigned ls_as_needed;		/* DT_NEEDED */
@@ -87,7 +97,6 @@ struct ld_state {
 	unsigned ls_rerun;		/* ld(1) restarted */
 	unsigned ls_archive_mb_header;	/* extracted list header printed */
 	unsigned ls_first_output_sec;	/* flag indicates 1st output section */
-	unsigned ls_ignore_next_plt;	/* ignore next PLT relocation */
 	unsigned ls_version_local;	/* version entry is local */
 	uint64_t ls_relative_reloc;	/* number of *_RELATIVE relocations */
 	struct ld_input_section_head *ls_gc;
@@ -146,6 +155,10 @@ struct ld {
 	unsigned char ld_gc;		/* perform garbage collection */
 	unsigned char ld_gc_print;	/* print removed sections */
 	unsigned char ld_ehframe_hdr;	/* create .eh_frame_hdr section */
+	unsigned char ld_hash_style;	/* dynamic symbol hash sections */
+	unsigned char ld_build_id;	/* build ID style */
+	const char *ld_build_id_hex;	/* hex digits of --build-id=0x */
+	unsigned ld_threads;		/* worker threads (0: one per CPU) */
 	STAILQ_HEAD(ld_input_head, ld_input) ld_lilist; /* input object list */
 	TAILQ_HEAD(ld_file_head, ld_file) ld_lflist; /* input file list */
 };
@@ -0,0 +1,496 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "ld.h"
+#include "ld_build_id.h"
+#include "ld_layout.h"
+#include "ld_output.h"
+#include "ld_thread.h"
+#include "ld_utils.h"
+
+ELFTC_VCSID("$Id$");
+
+/*
+ * Support routines for the .note.gnu.build-id section.
+ *
+ * The build ID of a hashed style is computed over the output file as
+ * written, with the build ID itself still zero. The file is cut into
+ * chunks of _CHUNK_SIZE bytes that are hashed on a pool of threads,
+ * and the build ID is the hash of the concatenated chunk hashes. The
+ * result does not depend on the number of threads.
+ */
+
+#define	_CHUNK_SIZE	(1024 * 1024)
+#define	_MAX_DIGEST	20
+#define	_NOTE_HDR_SIZE	16
+
+#define	_ROTL32(x, n)	(((x) << (n)) | ((x) >> (32 - (n))))
+#define	_ROTL64(x, n)	(((x) << (n)) | ((x) >> (64 - (n))))
+
+struct _build_id_hash {
+	unsigned bh_style;		/* LD_BUILD_ID_* */
+	size_t bh_size;			/* digest size */
+	void (*bh_func)(const uint8_t *, size_t, uint8_t *);
+};
+
+struct _build_id_job {
+	const struct _build_id_hash *bj_hash; /* hash function */
+	const uint8_t *bj_buf;		/* output file image */
+	uint64_t bj_size;		/* output file size */
+	uint8_t *bj_digest;		/* chunk digests */
+};
+
+static void _fast(const uint8_t *buf, size_t len, uint8_t *digest);
+static void _md5(const uint8_t *buf, size_t len, uint8_t *digest);
+static void _sha1(const uint8_t *buf, size_t len, uint8_t *digest);
+static void _hash_chunk(struct ld *ld, void *arg, size_t i);
+
+static const struct _build_id_hash _hashes[] = {
+	{LD_BUILD_ID_FAST, 8, _fast},
+	{LD_BUILD_ID_MD5, 16, _md5},
+	{LD_BUILD_ID_SHA1, 20, _sha1},
+	{LD_BUILD_ID_NONE, 0, NULL}
+};
+
+void
+ld_build_id_create(struct ld *ld)
+{
+	struct ld_output *lo;
+	struct ld_output_section *os;
+	struct ld_output_data_buffer *odb;
+	const struct _build_id_hash *bh;
+	char build_id_name[] = ".note.gnu.build-id";
+	char hex[3];
+	uint8_t *desc;
+	size_t descsz, i;
+	int fd;
+
+	lo = ld->ld_output;
+	assert(lo != NULL);
+
+	/* The build ID identifies a final link. */
+	if (ld->ld_reloc)
+		return;
+
+	switch (ld->ld_build_id) {
+	case LD_BUILD_ID_UUID:
+		descsz = 16;
+		break;
+	case LD_BUILD_ID_HEX:
+		descsz = strlen(ld->ld_build_id_hex) / 2;
+		break;
+	default:
+		for (bh = _hashes; bh->bh_func != NULL; bh++)
+			if (bh->bh_style == ld->ld_build_id)
+				break;
+		assert(bh->bh_func != NULL);
+		descsz = bh->bh_size;
+		break;
+	}
+
+	HASH_FIND_STR(lo->lo_ostbl, build_id_name, os);
+	if (os == NULL)
+		os = ld_layout_insert_output_section(ld, build_id_name,
+		    SHF_ALLOC);
+	os->os_type = SHT_NOTE;
+	os->os_align = 4;
+	os->os_entsize = 0;
+	os->os_flags = SHF_ALLOC;
+
+	lo->lo_build_id = os;
+	lo->lo_phdr_note = 1;
+
+	if ((odb = calloc(1, sizeof(*odb))) == NULL)
+		ld_fatal_std(ld, "calloc");
+	odb->odb_size = _NOTE_HDR_SIZE + roundup(descsz, 4);
+	odb->odb_align = 4;
+	odb->odb_type = ELF_T_BYTE;
+
+	if ((odb->odb_buf = calloc(odb->odb_size, 1)) == NULL)
+		ld_fatal_std(ld, "calloc");
+
+	WRITE_32(odb->odb_buf, 4);
+	WRITE_32(odb->odb_buf + 4, descsz);
+	WRITE_32(odb->odb_buf + 8, NT_GNU_BUILD_ID);
+	memcpy(odb->odb_buf + 12, "GNU", 4);
+
+	/*
+	 * The build IDs that do not depend on the output contents are
+	 * stored right away; the others stay zero until the output file
+	 * is written.
+	 */
+	desc = odb->odb_buf + _NOTE_HDR_SIZE;
+	if (ld->ld_build_id == LD_BUILD_ID_UUID) {
+		if ((fd = open("/dev/urandom", O_RDONLY)) < 0)
+			ld_fatal_std(ld, "open /dev/urandom");
+		if (read(fd, desc, descsz) != (ssize_t) descsz)
+			ld_fatal_std(ld, "read /dev/urandom");
+		(void) close(fd);
+
+		/* Make it a version 4 (random) UUID. */
+		desc[6] = (desc[6] & 0x0f) | 0x40;
+		desc[8] = (desc[8] & 0x3f) | 0x80;
+	} else if (ld->ld_build_id == LD_BUILD_ID_HEX) {
+		for (i = 0; i < descsz; i++) {
+			memcpy(hex, ld->ld_build_id_hex + i * 2, 2);
+			hex[2] = '\0';
+			desc[i] = (uint8_t) strtoul(hex, NULL, 16);
+		}
+	}
+
+	lo->lo_build_id_odb = odb;
+
+	(void) ld_output_create_section_element(ld, os, OET_DATA_BUFFER, odb,
+	    NULL);
+}
+
+void
+ld_build_id_write(struct ld *ld)
+{
+	struct ld_output *lo;
+	struct ld_output_section *os;
+	struct ld_output_data_buffer *odb;
+	const struct _build_id_hash *bh;
+	struct _build_id_job bj;
+	uint8_t *buf, digest[_MAX_DIGEST];
+	size_t n;
+	off_t off;
+
+	lo = ld->ld_output;
+	assert(lo != NULL);
+
+	if ((os = lo->lo_build_id) == NULL)
+		return;
+
+	for (bh = _hashes; bh->bh_func != NULL; bh++)
+		if (bh->bh_style == ld->ld_build_id)
+			break;
+	if (bh->bh_func == NULL)
+		return;
+
+	odb = lo->lo_build_id_odb;
+	assert(odb != NULL);
+
+	buf = mmap(NULL, lo->lo_size, PROT_READ, MAP_SHARED, lo->lo_fd,
+	    (off_t) 0);
+	if (buf == MAP_FAILED)
+		ld_fatal_std(ld, "mmap output file");
+
+	n = (lo->lo_size + _CHUNK_SIZE - 1) / _CHUNK_SIZE;
+	bj.bj_hash = bh;
+	bj.bj_buf = buf;
+	bj.bj_size = lo->lo_size;
+	if ((bj.bj_digest = malloc(n * bh->bh_size)) == NULL)
+		ld_fatal_std(ld, "malloc");
+
+	ld_thread_run(ld, n, _hash_chunk, &bj);
+	bh->bh_func(bj.bj_digest, n * bh->bh_size, digest);
+
+	free(bj.bj_digest);
+	(void) munmap(buf, lo->lo_size);
+
+	off = os->os_off + odb->odb_off + _NOTE_HDR_SIZE;
+	if (pwrite(lo->lo_fd, digest, bh->bh_size, off) !=
+	    (ssize_t) bh->bh_size)
+		ld_fatal_std(ld, "write build ID");
+}
+
+static void
+_hash_chunk(struct ld *ld, void *arg, size_t i)
+{
+	struct _build_id_job *bj;
+	uint64_t off, len;
+
+	(void) ld;
+
+	bj = arg;
+	off = (uint64_t) i * _CHUNK_SIZE;
+	len = bj->bj_size - off;
+	if (len > _CHUNK_SIZE)
+		len = _CHUNK_SIZE;
+
+	bj->bj_hash->bh_func(bj->bj_buf + off, len,
+	    bj->bj_digest + i * bj->bj_hash->bh_size);
+}
+
+/*
+ * The "fast" style: 64-bit xxHash (XXH64) with a zero seed, stored in
+ * little-endian byte order.
+ */
+
+#define	_XXH_P1	0x9E3779B185EBCA87ULL
+#define	_XXH_P2	0xC2B2AE3D27D4EB4FULL
+#define	_XXH_P3	0x165667B19E3779F9ULL
+#define	_XXH_P4	0x85EBCA77C2B2AE63ULL
+#define	_XXH_P5	0x27D4EB2F165667C5ULL
+
+static uint64_t
+_xxh_round(uint64_t acc, uint64_t v)
+{
+
+	acc += v * _XXH_P2;
+	acc = _ROTL64(acc, 31);
+	return (acc * _XXH_P1);
+}
+
+static uint64_t
+_xxh_merge(uint64_t acc, uint64_t v)
+{
+
+	acc ^= _xxh_round(0, v);
+	return (acc * _XXH_P1 + _XXH_P4);
+}
+
+static void
+_fast(const uint8_t *buf, size_t len, uint8_t *digest)
+{
+	const uint8_t *p, *end;
+	uint64_t h, v, v1, v2, v3, v4;
+	uint32_t w;
+
+	p = buf;
+	end = buf + len;
+
+	if (len >= 32) {
+		v1 = _XXH_P1 + _XXH_P2;
+		v2 = _XXH_P2;
+		v3 = 0;
+		v4 = -_XXH_P1;
+		do {
+			READ_64LE(p, v);
+			v1 = _xxh_round(v1, v);
+			READ_64LE(p + 8, v);
+			v2 = _xxh_round(v2, v);
+			READ_64LE(p + 16, v);
+			v3 = _xxh_round(v3, v);
+			READ_64LE(p + 24, v);
+			v4 = _xxh_round(v4, v);
+			p += 32;
+		} while (end - p >= 32);
+		h = _ROTL64(v1, 1) + _ROTL64(v2, 7) + _ROTL64(v3, 12) +
+		    _ROTL64(v4, 18);
+		h = _xxh_merge(h, v1);
+		h = _xxh_merge(h, v2);
+		h = _xxh_merge(h, v3);
+		h = _xxh_merge(h, v4);
+	} else
+		h = _XXH_P5;
+
+	h += len;
+
+	for (; end - p >= 8; p += 8) {
+		READ_64LE(p, v);
+		h ^= _xxh_round(0, v);
+		h = _ROTL64(h, 27) * _XXH_P1 + _XXH_P4;
+	}
+	if (end - p >= 4) {
+		READ_32LE(p, w);
+		h ^= (uint64_t) w * _XXH_P1;
+		h = _ROTL64(h, 23) * _XXH_P2 + _XXH_P3;
+		p += 4;
+	}
+	for (; p < end; p++) {
+		h ^= (uint64_t) *p * _XXH_P5;
+		h = _ROTL64(h, 11) * _XXH_P1;
+	}
+
+	h ^= h >> 33;
+	h *= _XXH_P2;
+	h ^= h >> 29;
+	h *= _XXH_P3;
+	h ^= h >> 32;
+
+	WRITE_64LE(digest, h);
+}
+
+/*
+ * MD5 (RFC 1321) and SHA-1 (FIPS 180-4) share the message padding: a
+ * 0x80 byte, zeros, and the message length in bits as a 64-bit number,
+ * little-endian for MD5 and big-endian for SHA-1.
+ */
+
+static void
+_pad_and_hash(const uint8_t *buf, size_t len, uint32_t *st, int be,
+    void (*block)(uint32_t *, const uint8_t *))
+{
+	uint8_t tail[128];
+	uint64_t bits;
+	size_t n;
+
+	bits = (uint64_t) len * 8;
+	for (; len >= 64; buf += 64, len -= 64)
+		block(st, buf);
+
+	memset(tail, 0, sizeof(tail));
+	memcpy(tail, buf, len);
+	tail[len] = 0x80;
+	n = len < 56 ? 64 : 128;
+	if (be)
+		WRITE_64BE(tail + n - 8, bits);
+	else
+		WRITE_64LE(tail + n - 8, bits);
+
+	block(st, tail);
+	if (n == 128)
+		block(st, tail + 64);
+}
+
+static const uint32_t _md5_k[64] = {
+	0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee,
+	0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+	0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+	0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+	0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa,
+	0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+	0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed,
+	0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+	0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+	0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+	0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05,
+	0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+	0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039,
+	0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+	0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+	0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+
+static const unsigned _md5_s[16] = {
+	7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21
+};
+
+static void
+_md5_block(uint32_t *st, const uint8_t *p)
+{
+	uint32_t a, b, c, d, f, t, m[16];
+	int g, i;
+
+	for (i = 0; i < 16; i++)
+		READ_32LE(p + i * 4, m[i]);
+
+	a = st[0];
+	b = st[1];
+	c = st[2];
+	d = st[3];
+
+	for (i = 0; i < 64; i++) {
+		if (i < 16) {
+			f = (b & c) | (~b & d);
+			g = i;
+		} else if (i < 32) {
+			f = (d & b) | (~d & c);
+			g = (5 * i + 1) % 16;
+		} else if (i < 48) {
+			f = b ^ c ^ d;
+			g = (3 * i + 5) % 16;
+		} else {
+			f = c ^ (b | ~d);
+			g = (7 * i) % 16;
+		}
+		t = a + f + _md5_k[i] + m[g];
+		a = d;
+		d = c;
+		c = b;
+		b += _ROTL32(t, _md5_s[(i / 16) * 4 + i % 4]);
+	}
+
+	st[0] += a;
+	st[1] += b;
+	st[2] += c;
+	st[3] += d;
+}
+
+static void
+_md5(const uint8_t *buf, size_t len, uint8_t *digest)
+{
+	uint32_t st[4] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+	int i;
+
+	_pad_and_hash(buf, len, st, 0, _md5_block);
+
+	for (i = 0; i < 4; i++)
+		WRITE_32LE(digest + i * 4, st[i]);
+}
+
+static void
+_sha1_block(uint32_t *st, const uint8_t *p)
+{
+	uint32_t a, b, c, d, e, f, k, t, w[80];
+	int i;
+
+	for (i = 0; i < 16; i++)
+		READ_32BE(p + i * 4, w[i]);
+	for (; i < 80; i++) {
+		t = w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16];
+		w[i] = _ROTL32(t, 1);
+	}
+
+	a = st[0];
+	b = st[1];
+	c = st[2];
+	d = st[3];
+	e = st[4];
+
+	for (i = 0; i < 80; i++) {
+		if (i < 20) {
+			f = (b & c) | (~b & d);
+			k = 0x5a827999;
+		} else if (i < 40) {
+			f = b ^ c ^ d;
+			k = 0x6ed9eba1;
+		} else if (i < 60) {
+			f = (b & c) | (b & d) | (c & d);
+			k = 0x8f1bbcdc;
+		} else {
+			f = b ^ c ^ d;
+			k = 0xca62c1d6;
+		}
+		t = _ROTL32(a, 5) + f + e + k + w[i];
+		e = d;
+		d = c;
+		c = _ROTL32(b, 30);
+		b = a;
+		a = t;
+	}
+
+	st[0] += a;
+	st[1] += b;
+	st[2] += c;
+	st[3] += d;
+	st[4] += e;
+}
+
+static void
+_sha1(const uint8_t *buf, size_t len, uint8_t *digest)
+{
+	uint32_t st[5] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476,
+	    0xc3d2e1f0 };
+	int i;
+
+	_pad_and_hash(buf, len, st, 1, _sha1_block);
+
+	for (i = 0; i < 5; i++)
+		WRITE_32BE(digest + i * 4, st[i]);
+}
@@ -73,8 +73,17 @@ ld_dynamic_create(struct ld *ld)
 	/* Create .dynsym and .dynstr sections. */
 	_create_dynsym_and_dynstr_section(ld, lo);
 
+	/*
+	 * Create .gnu.hash section.  This reorders the dynamic symbol
+	 * table, so it is done before anything refers to the indices of
+	 * dynamic symbols.
+	 */
+	if (ld->ld_hash_style & LD_HASH_STYLE_GNU)
+		ld_hash_create_gnu_hash_section(ld);
+
 	/* Create .hash section. */
-	ld_hash_create_svr4_hash_section(ld);
+	if (ld->ld_hash_style & LD_HASH_STYLE_SYSV)
+		ld_hash_create_svr4_hash_section(ld);
 
 	/*
 	 * Create .gnu.version_d section if the linker creats a shared
@@ -315,9 +324,17 @@ _create_dynamic(struct ld *ld, struct ld_output *lo)
 		entries++;
 	}
 
-	/* DT_HASH, DT_STRTAB, DT_SYMTAB, DT_STRSZ and DT_SYMENT */
-	if (ld->ld_dynsym)
-		entries += 5;
+	/*
+	 * DT_HASH, DT_GNU_HASH, DT_STRTAB, DT_SYMTAB, DT_STRSZ and
+	 * DT_SYMENT
+	 */
+	if (ld->ld_dynsym) {
+		entries += 4;
+		if (ld->ld_hash_style & LD_HASH_STYLE_SYSV)
+			entries++;
+		if (ld->ld_hash_style & LD_HASH_STYLE_GNU)
+			entries++;
+	}
 
 	/* DT_RPATH. */
 	if (!STAILQ_EMPTY(&ld->ld_state.ls_rplist)) {
@@ -455,11 +472,15 @@ _finalize_dynamic(struct ld *ld, struct ld_output *lo)
 	if (lo->lo_hash != NULL)
 		DT_ENTRY_PTR(DT_HASH, lo->lo_hash->os_addr);
 
+	/* DT_GNU_HASH */
+	if (lo->lo_gnu_hash != NULL)
+		DT_ENTRY_PTR(DT_GNU_HASH, lo->lo_gnu_hash->os_addr);
+
 	/* DT_HASH, DT_STRTAB, DT_SYMTAB, DT_STRSZ and DT_SYMENT */
 	if (lo->lo_dynsym != NULL && lo->lo_dynstr != NULL) {
 		DT_ENTRY_PTR(DT_STRTAB, lo->lo_dynstr->os_addr);
 		DT_ENTRY_PTR(DT_SYMTAB, lo->lo_dynsym->os_addr);
-		DT_ENTRY_VAL(DT_STRSZ, ld_strtab_getsize(ld->ld_dynstr));
+		DT_ENTRY_VAL(DT_STRSZ, ld_strtab_getsize(ld, ld->ld_dynstr));
 		DT_ENTRY_VAL(DT_SYMENT,
 		    lo->lo_ec == ELFCLASS32 ? sizeof(Elf32_Sym) :
 		    sizeof(Elf64_Sym));
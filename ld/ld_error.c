@@ -29,7 +29,9 @@
 ELFTC_VCSID("$Id$");
 
 /*
- * Support routines for error and warning message generation.
+ * Support routines for error and warning message generation.  The
+ * stream is locked while a message is written, so that the messages
+ * of concurrent threads do not interleave.
  */
 
 void
@@ -37,11 +39,13 @@ ld_fatal(struct ld *ld, const char *fmt, ...)
 {
 	va_list ap;
 
+	flockfile(stderr);
 	fprintf(stderr, "%s: ", ld->ld_progname);
 	va_start(ap, fmt);
 	vfprintf(stderr, fmt, ap);
 	va_end(ap);
 	fputc('\n', stderr);
+	funlockfile(stderr);
 	exit(EXIT_FAILURE);
 }
 
@@ -50,11 +54,13 @@ ld_fatal_std(struct ld *ld, const char *fmt, ...)
 {
 	va_list ap;
 
+	flockfile(stderr);
 	fprintf(stderr, "%s: ", ld->ld_progname);
 	va_start(ap, fmt);
 	vfprintf(stderr, fmt, ap);
 	va_end(ap);
 	fprintf(stderr, ": %s\n", strerror(errno));
+	funlockfile(stderr);
 	exit(EXIT_FAILURE);
 }
 
@@ -63,11 +69,13 @@ ld_err(struct ld *ld, const char *fmt, ...)
 {
 	va_list ap;
 
+	flockfile(stderr);
 	fprintf(stderr, "%s: ", ld->ld_progname);
 	va_start(ap, fmt);
 	vfprintf(stderr, fmt, ap);
 	va_end(ap);
 	fputc('\n', stderr);
+	funlockfile(stderr);
 }
 
 void
@@ -75,11 +83,13 @@ ld_warn(struct ld *ld, const char *fmt, ...)
 {
 	va_list ap;
 
+	flockfile(stderr);
 	fprintf(stderr, "%s: warning: ", ld->ld_progname);
 	va_start(ap, fmt);
 	vfprintf(stderr, fmt, ap);
 	va_end(ap);
 	fputc('\n', stderr);
+	funlockfile(stderr);
 }
 
 void
@@ -87,9 +97,11 @@ ld_info(struct ld *ld, const char *fmt, ...)
 {
 	va_list ap;
 
+	flockfile(stdout);
 	fprintf(stdout, "%s: ", ld->ld_progname);
 	va_start(ap, fmt);
 	vfprintf(stdout, fmt, ap);
 	va_end(ap);
 	fputc('\n', stdout);
+	funlockfile(stdout);
 }
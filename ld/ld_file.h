@@ -34,6 +34,8 @@ enum ld_file_type {
 	LFT_BINARY
 };
 
+struct ld_symbol_preload;
+
 struct ld_archive_member {
 	char *lam_ar_name;		/* archive name */
 	char *lam_name;			/* archive member name */
@@ -54,6 +56,7 @@ struct ld_file {
 	Elf *lf_elf;			/* input file ELF descriptor */
 	struct ld_archive *lf_ar;	/* input archive */
 	struct ld_input *lf_input;	/* input object */
+	struct ld_symbol_preload *lf_preload; /* symbols read ahead */
 	unsigned lf_whole_archive;	/* include whole archive */
 	unsigned lf_as_needed;		/* DT_NEEDED */
 	unsigned lf_group_level;	/* archive group level */
@@ -29,6 +29,7 @@
 #include "ld_layout.h"
 #include "ld_output.h"
 #include "ld_symbols.h"
+#include "ld_utils.h"
 
 ELFTC_VCSID("$Id$");
 
@@ -45,6 +46,200 @@ static unsigned hash_buckets[] = {
 	16411, 32771, 65537, 131101, 262147
 };
 
+/*
+ * A dynamic symbol entered in the .gnu.hash section.
+ */
+struct ld_gnu_hash_sym {
+	struct ld_symbol *ghs_lsb;	/* dynamic symbol */
+	uint32_t ghs_hash;		/* GNU hash of the symbol name */
+	uint32_t ghs_bucket;		/* hash bucket */
+	uint32_t ghs_order;		/* position in the symbol list */
+};
+
+static uint32_t _bucket_count(uint32_t nsyms);
+static int _cmp_gnu_hash_sym(const void *a, const void *b);
+static uint32_t _gnu_hash(const char *name);
+
+/*
+ * Create the .gnu.hash section. The dynamic symbols which are defined
+ * in the output object are moved to the end of the dynamic symbol
+ * table and sorted by hash bucket, as the GNU hash table requires.
+ * Their dynamic symbol indices are reassigned accordingly.
+ */
+void
+ld_hash_create_gnu_hash_section(struct ld *ld)
+{
+	struct ld_output *lo;
+	struct ld_output_section *os;
+	struct ld_output_data_buffer *odb;
+	struct ld_symbol *lsb;
+	struct ld_symbol_head unhashed;
+	struct ld_gnu_hash_sym *ghs;
+	char hash_name[] = ".gnu.hash";
+	uint64_t *bloom;
+	uint8_t *buf, *chains, *p;
+	uint32_t h, nbuckets, nsyms, symoffset, maskwords, shift1, shift2;
+	uint32_t c, dyn_index, i, maskbitslog2, n;
+	size_t sz;
+
+	lo = ld->ld_output;
+	assert(lo != NULL);
+
+	HASH_FIND_STR(lo->lo_ostbl, hash_name, os);
+	if (os == NULL)
+		os = ld_layout_insert_output_section(ld, hash_name, SHF_ALLOC);
+	os->os_type = SHT_GNU_HASH;
+	os->os_flags = SHF_ALLOC;
+	os->os_entsize = 0;
+	if (lo->lo_ec == ELFCLASS32)
+		os->os_align = 4;
+	else
+		os->os_align = 8;
+
+	if ((os->os_link = strdup(".dynsym")) == NULL)
+		ld_fatal_std(ld, "strdup");
+
+	lo->lo_gnu_hash = os;
+
+	assert(ld->ld_dynsym != NULL && ld->ld_dynsym->sy_size > 0);
+
+	/*
+	 * Separate the symbols that are looked up through the hash
+	 * table from the undefined and imported ones.
+	 */
+	n = ld->ld_dynsym->sy_size;
+	if ((ghs = calloc(n, sizeof(*ghs))) == NULL)
+		ld_fatal_std(ld, "calloc");
+
+	STAILQ_INIT(&unhashed);
+	nsyms = 0;
+	i = 0;
+	if (ld->ld_dyn_symbols != NULL) {
+		while ((lsb = STAILQ_FIRST(ld->ld_dyn_symbols)) != NULL) {
+			STAILQ_REMOVE_HEAD(ld->ld_dyn_symbols, lsb_dyn);
+			if (lsb->lsb_name == NULL || lsb->lsb_import ||
+			    lsb->lsb_shndx == SHN_UNDEF)
+				STAILQ_INSERT_TAIL(&unhashed, lsb, lsb_dyn);
+			else {
+				ghs[nsyms].ghs_lsb = lsb;
+				ghs[nsyms].ghs_hash = _gnu_hash(lsb->lsb_name);
+				ghs[nsyms].ghs_order = i;
+				nsyms++;
+			}
+			i++;
+		}
+	}
+
+	nbuckets = _bucket_count(nsyms);
+	for (i = 0; i < nsyms; i++)
+		ghs[i].ghs_bucket = ghs[i].ghs_hash % nbuckets;
+	qsort(ghs, nsyms, sizeof(*ghs), _cmp_gnu_hash_sym);
+
+	/*
+	 * Rebuild the dynamic symbol list: unhashed symbols first, then
+	 * the hashed symbols in bucket order. Index 0 is the reserved
+	 * null symbol.
+	 */
+	dyn_index = 1;
+	STAILQ_FOREACH(lsb, &unhashed, lsb_dyn)
+		lsb->lsb_dyn_index = dyn_index++;
+	symoffset = dyn_index;
+	if (ld->ld_dyn_symbols != NULL) {
+		STAILQ_CONCAT(ld->ld_dyn_symbols, &unhashed);
+		for (i = 0; i < nsyms; i++) {
+			ghs[i].ghs_lsb->lsb_dyn_index = dyn_index++;
+			STAILQ_INSERT_TAIL(ld->ld_dyn_symbols, ghs[i].ghs_lsb,
+			    lsb_dyn);
+		}
+	}
+	assert(dyn_index == n);
+
+	/*
+	 * Size the Bloom filter from the symbol count the way GNU ld
+	 * does. The filter is made of words of the ELF class size.
+	 */
+	c = lo->lo_ec == ELFCLASS32 ? 32 : 64;
+	shift1 = lo->lo_ec == ELFCLASS32 ? 5 : 6;
+	for (maskbitslog2 = 0; (1U << maskbitslog2) < nsyms; maskbitslog2++)
+		;
+	maskbitslog2++;
+	if (maskbitslog2 < 3)
+		maskbitslog2 = 5;
+	else if ((1U << (maskbitslog2 - 2)) & nsyms)
+		maskbitslog2 += 3;
+	else
+		maskbitslog2 += 2;
+	if (maskbitslog2 < shift1)
+		maskbitslog2 = shift1;
+	shift2 = maskbitslog2;
+	maskwords = 1U << (maskbitslog2 - shift1);
+
+	/*
+	 * The section mixes 32-bit words with Bloom filter words of the
+	 * ELF class size, so it is written out in the target byte order
+	 * here instead of through libelf translation.
+	 */
+	if ((bloom = calloc(maskwords, sizeof(uint64_t))) == NULL)
+		ld_fatal_std(ld, "calloc");
+	for (i = 0; i < nsyms; i++) {
+		h = ghs[i].ghs_hash;
+		bloom[(h / c) & (maskwords - 1)] |=
+		    (1ULL << (h % c)) | (1ULL << ((h >> shift2) % c));
+	}
+
+	sz = 4 * 4 + maskwords * (c / 8) + (nbuckets + nsyms) * 4;
+	if ((buf = calloc(1, sz)) == NULL)
+		ld_fatal_std(ld, "calloc");
+
+	/* Header: nbuckets, symoffset, maskwords and shift2. */
+	p = buf;
+	WRITE_32(p, nbuckets);
+	WRITE_32(p + 4, symoffset);
+	WRITE_32(p + 8, maskwords);
+	WRITE_32(p + 12, shift2);
+	p += 16;
+
+	for (i = 0; i < maskwords; i++) {
+		if (c == 32) {
+			WRITE_32(p, bloom[i]);
+			p += 4;
+		} else {
+			WRITE_64(p, bloom[i]);
+			p += 8;
+		}
+	}
+
+	/*
+	 * Hash buckets and chains. A bucket holds the index of the first
+	 * symbol in it, a chain entry the symbol hash with the lowest bit
+	 * set on the last symbol of a bucket.
+	 */
+	chains = p + nbuckets * 4;
+	for (i = 0; i < nsyms; i++) {
+		if (i == 0 || ghs[i].ghs_bucket != ghs[i - 1].ghs_bucket)
+			WRITE_32(p + ghs[i].ghs_bucket * 4, symoffset + i);
+		h = ghs[i].ghs_hash & ~1U;
+		if (i == nsyms - 1 ||
+		    ghs[i].ghs_bucket != ghs[i + 1].ghs_bucket)
+			h |= 1;
+		WRITE_32(chains + i * 4, h);
+	}
+
+	if ((odb = calloc(1, sizeof(*odb))) == NULL)
+		ld_fatal_std(ld, "calloc");
+
+	odb->odb_buf = buf;
+	odb->odb_size = sz;
+	odb->odb_align = os->os_align;
+	odb->odb_type = ELF_T_BYTE;
+
+	(void) ld_output_create_section_element(ld, os, OET_DATA_BUFFER,
+	    odb, NULL);
+
+	free(bloom);
+	free(ghs);
+}
+
 void
 ld_hash_create_svr4_hash_section(struct ld *ld)
 {
@@ -78,17 +273,7 @@ ld_hash_create_svr4_hash_section(struct ld *ld)
 	assert(ld->ld_dynsym != NULL && ld->ld_dynsym->sy_size > 0);
 
 	nchains = ld->ld_dynsym->sy_size;
-	nbuckets = 0;
-	for (i = 1;
-	    (size_t) i < sizeof(hash_buckets) / sizeof(hash_buckets[0]);
-	    i++) {
-		if (nchains < hash_buckets[i]) {
-			nbuckets = hash_buckets[i - 1];
-			break;
-		}
-	}
-	if (nbuckets == 0)
-		nbuckets = hash_buckets[i - 1];
+	nbuckets = _bucket_count(nchains);
 
 	if ((buf = calloc(nbuckets + nchains + 2, sizeof(uint32_t))) == NULL)
 		ld_fatal_std(ld, "calloc");
@@ -124,3 +309,49 @@ ld_hash_create_svr4_hash_section(struct ld *ld)
 	(void) ld_output_create_section_element(ld, os, OET_DATA_BUFFER,
 	    odb, NULL);
 }
+
+static uint32_t
+_bucket_count(uint32_t nsyms)
+{
+	int i;
+
+	for (i = 1;
+	    (size_t) i < sizeof(hash_buckets) / sizeof(hash_buckets[0]);
+	    i++) {
+		if (nsyms < hash_buckets[i])
+			return (hash_buckets[i - 1]);
+	}
+
+	return (hash_buckets[i - 1]);
+}
+
+static int
+_cmp_gnu_hash_sym(const void *a, const void *b)
+{
+	const struct ld_gnu_hash_sym *ga, *gb;
+
+	ga = a;
+	gb = b;
+
+	if (ga->ghs_bucket != gb->ghs_bucket)
+		return (ga->ghs_bucket < gb->ghs_bucket ? -1 : 1);
+
+	/* Keep the order of the symbol list within a bucket. */
+	if (ga->ghs_order != gb->ghs_order)
+		return (ga->ghs_order < gb->ghs_order ? -1 : 1);
+
+	return (0);
+}
+
+static uint32_t
+_gnu_hash(const char *name)
+{
+	const unsigned char *s;
+	uint32_t h;
+
+	h = 5381;
+	for (s = (const unsigned char *) name; *s != '\0'; s++)
+		h = (h << 5) + h + *s;
+
+	return (h);
+}
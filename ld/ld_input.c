@@ -332,10 +332,14 @@ ld_input_get_section_rawdata(struct ld *ld, struct ld_input_section *is)
 	return (buf);
 }
 
+/*
+ * Open the ELF descriptor of an input object. The input file stays
+ * loaded, and is shared by the other objects it contains, until it is
+ * explicitly unloaded.
+ */
 void
 ld_input_load(struct ld *ld, struct ld_input *li)
 {
-	struct ld_state *ls;
 	struct ld_file *lf;
 	struct ld_archive_member *lam;
 
@@ -343,22 +347,15 @@ ld_input_load(struct ld *ld, struct ld_input *li)
 		return;
 
 	assert(li->li_elf == NULL);
-	ls = &ld->ld_state;
-	if (li->li_file != ls->ls_file) {
-		if (ls->ls_file != NULL)
-			ld_file_unload(ld, ls->ls_file);
-		ld_file_load(ld, li->li_file);
-	}
 	lf = li->li_file;
+	if (lf->lf_mmap == NULL)
+		ld_file_load(ld, lf);
 	if (lf->lf_ar != NULL) {
 		assert(li->li_lam != NULL);
 		lam = li->li_lam;
-		if (elf_rand(lf->lf_elf, lam->lam_off) != lam->lam_off)
-			ld_fatal(ld, "%s: elf_rand: %s", lf->lf_name,
-			    elf_errmsg(-1));
-		if ((li->li_elf = elf_begin(-1, ELF_C_READ, lf->lf_elf)) ==
-		    NULL)
-			ld_fatal(ld, "%s: elf_begin: %s", lf->lf_name,
+		if ((li->li_elf = elf_openarmember(lf->lf_elf,
+		    lam->lam_off)) == NULL)
+			ld_fatal(ld, "%s: elf_openarmember: %s", lf->lf_name,
 			    elf_errmsg(-1));
 	} else
 		li->li_elf = lf->lf_elf;
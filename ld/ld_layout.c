@@ -26,6 +26,7 @@
 
 #include "ld.h"
 #include "ld_arch.h"
+#include "ld_build_id.h"
 #include "ld_dynamic.h"
 #include "ld_ehframe.h"
 #include "ld_exp.h"
@@ -130,6 +131,10 @@ ld_layout_sections(struct ld *ld)
 	/* Initialise sections for dyanmically linked output object. */
 	ld_dynamic_create(ld);
 
+	/* Create .note.gnu.build-id section. */
+	if (ld->ld_build_id != LD_BUILD_ID_NONE)
+		ld_build_id_create(ld);
+
 	/* Create ELF sections. */
 	ld_output_create_elf_sections(ld);
 
@@ -1155,7 +1160,7 @@ _calc_output_section_offset(struct ld *ld, struct ld_output_section *os)
 		case OET_STRTAB:
 			assert(ls->ls_loc_counter == 0);
 			st = oe->oe_entry;
-			ls->ls_loc_counter = ld_strtab_getsize(st);
+			ls->ls_loc_counter = ld_strtab_getsize(ld, st);
 			break;
 		default:
 			break;
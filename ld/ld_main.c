@@ -26,6 +26,7 @@
 
 #include "ld.h"
 #include "ld_arch.h"
+#include "ld_build_id.h"
 #include "ld_ehframe.h"
 #include "ld_options.h"
 #include "ld_reloc.h"
@@ -91,6 +92,9 @@ restart:
 	/* The linker generate an executable by default */
 	ld->ld_exec = 1;
 
+	/* Only the SysV .hash section is generated by default. */
+	ld->ld_hash_style = LD_HASH_STYLE_SYSV;
+
 	ld_script_init(ld);
 
 	ld_options_parse(ld, argc, argv);
@@ -139,6 +143,9 @@ restart:
 
 	ld_output_create(ld);
 
+	/* Store the build ID computed over the output file. */
+	ld_build_id_write(ld);
+
 	_cleanup();
 
 	exit(EXIT_SUCCESS);
@@ -97,6 +97,7 @@ static struct ld_option ld_opts[] = {
 	{"no-keep-memory", KEY_NO_KEEP_MEMORY, ANY_DASH, NO_ARG},
 	{"no-omagic", KEY_NO_OMAGIC, ANY_DASH, NO_ARG},
 	{"no-print-gc-sections", KEY_NO_PRINT_GC_SECTIONS, ANY_DASH, NO_ARG},
+	{"no-threads", KEY_NO_THREADS, ANY_DASH, NO_ARG},
 	{"no-undefined", KEY_Z_DEFS, ANY_DASH, NO_ARG},
 	{"no-undefined-version", KEY_NO_UNDEF_VERSION, ANY_DASH, NO_ARG},
 	{"no-whole-archive", KEY_NO_WHOLE_ARCHIVE, ANY_DASH, NO_ARG},
@@ -128,6 +129,8 @@ static struct ld_option ld_opts[] = {
 	{"static", KEY_STATIC, ONE_DASH, NO_ARG},
 	{"strip-all", 's', ANY_DASH, NO_ARG},
 	{"strip-debug", 'S', ANY_DASH, NO_ARG},
+	{"thread-count", KEY_THREAD_COUNT, ANY_DASH, REQ_ARG},
+	{"threads", KEY_THREADS, ANY_DASH, NO_ARG},
 	{"trace", 't', ANY_DASH, NO_ARG},
 	{"trace_symbol", 'y', ANY_DASH, NO_ARG},
 	{"traditional-format", KEY_TRADITIONAL_FORMAT, ANY_DASH, NO_ARG},
@@ -193,6 +196,7 @@ static void _process_options(struct ld *ld, int key, char *arg);
 static int _parse_long_options(struct ld *, struct ld_option *, int,
     int, char **, char *, enum ld_dash);
 static void _print_version(struct ld *ld);
+static int _valid_build_id_hex(const char *s);
 
 void
 ld_options_parse(struct ld* ld, int argc, char **argv)
@@ -330,6 +334,8 @@ static void
 _process_options(struct ld *ld, int key, char *arg)
 {
 	struct ld_state *ls;
+	unsigned long n;
+	char *end;
 
 	assert(ld != NULL);
 	ls = &ld->ld_state;
@@ -400,6 +406,35 @@ _process_options(struct ld *ld, int key, char *arg)
 	case KEY_GC_SECTIONS:
 		ld->ld_gc = 1;
 		break;
+	case KEY_HASH_STYLE:
+		if (!strcmp(arg, "sysv"))
+			ld->ld_hash_style = LD_HASH_STYLE_SYSV;
+		else if (!strcmp(arg, "gnu"))
+			ld->ld_hash_style = LD_HASH_STYLE_GNU;
+		else if (!strcmp(arg, "both"))
+			ld->ld_hash_style = LD_HASH_STYLE_SYSV |
+			    LD_HASH_STYLE_GNU;
+		else
+			ld_fatal(ld, "invalid hash style `%s'", arg);
+		break;
+	case KEY_BUILD_ID:
+		if (arg == NULL || !strcmp(arg, "sha1"))
+			ld->ld_build_id = LD_BUILD_ID_SHA1;
+		else if (!strcmp(arg, "none"))
+			ld->ld_build_id = LD_BUILD_ID_NONE;
+		else if (!strcmp(arg, "fast"))
+			ld->ld_build_id = LD_BUILD_ID_FAST;
+		else if (!strcmp(arg, "md5"))
+			ld->ld_build_id = LD_BUILD_ID_MD5;
+		else if (!strcmp(arg, "uuid"))
+			ld->ld_build_id = LD_BUILD_ID_UUID;
+		else if (arg[0] == '0' && (arg[1] == 'x' || arg[1] == 'X') &&
+		    _valid_build_id_hex(arg + 2)) {
+			ld->ld_build_id = LD_BUILD_ID_HEX;
+			ld->ld_build_id_hex = arg + 2;
+		} else
+			ld_fatal(ld, "invalid build-id style `%s'", arg);
+		break;
 	case KEY_NO_AS_NEEDED:
 		ls->ls_as_needed = 0;
 		break;
@@ -412,6 +447,9 @@ _process_options(struct ld *ld, int key, char *arg)
 	case KEY_NO_PRINT_GC_SECTIONS:
 		ld->ld_gc_print = 0;
 		break;
+	case KEY_NO_THREADS:
+		ld->ld_threads = 1;
+		break;
 	case KEY_NO_WHOLE_ARCHIVE:
 		ls->ls_whole_archive = 0;
 		break;
@@ -440,6 +478,17 @@ _process_options(struct ld *ld, int key, char *arg)
 	case KEY_STATIC:
 		ls->ls_static = 1;
 		break;
+	case KEY_THREADS:
+		ld->ld_threads = 0;
+		break;
+	case KEY_THREAD_COUNT:
+		errno = 0;
+		n = strtoul(arg, &end, 10);
+		if (*arg == '\0' || *end != '\0' || errno != 0 || n == 0 ||
+		    n > UINT_MAX)
+			ld_fatal(ld, "invalid thread count `%s'", arg);
+		ld->ld_threads = (unsigned) n;
+		break;
 	case KEY_WHOLE_ARCHIVE:
 		ls->ls_whole_archive = 1;
 		break;
@@ -472,6 +521,18 @@ _print_version(struct ld *ld)
 	ld->ld_print_version = 1;
 }
 
+static int
+_valid_build_id_hex(const char *s)
+{
+	size_t len;
+
+	len = strlen(s);
+	if (len == 0 || len % 2 != 0)
+		return (0);
+
+	return (strspn(s, "0123456789abcdefABCDEF") == len);
+}
+
 static void
 _copy_optarg(struct ld *ld, char **dst, char *src)
 {
@@ -73,6 +73,7 @@ enum ld_key {
 	KEY_NO_PRINT_GC_SECTIONS,
 	KEY_NO_SHLIB_UNDEF,
 	KEY_NO_STDLIB,
+	KEY_NO_THREADS,
 	KEY_NO_UNDEF_VERSION,
 	KEY_NO_UNKNOWN,
 	KEY_NO_WHOLE_ARCHIVE,
@@ -98,6 +99,8 @@ enum ld_key {
 	KEY_SYMBOLIC_FUNC,
 	KEY_TBSS,
 	KEY_TDATA,
+	KEY_THREADS,
+	KEY_THREAD_COUNT,
 	KEY_TTEXT,
 	KEY_TRADITIONAL_FORMAT,
 	KEY_UNRESOLVED_SYMBOLS,
@@ -28,6 +28,7 @@
 #include "ld_arch.h"
 #include "ld_dynamic.h"
 #include "ld_ehframe.h"
+#include "ld_file.h"
 #include "ld_input.h"
 #include "ld_output.h"
 #include "ld_layout.h"
@@ -35,6 +36,7 @@
 #include "ld_script.h"
 #include "ld_strtab.h"
 #include "ld_symbols.h"
+#include "ld_thread.h"
 
 ELFTC_VCSID("$Id$");
 
@@ -48,6 +50,8 @@ static void _alloc_section_data_for_symtab(struct ld *ld,
 static void _alloc_section_data_for_strtab(struct ld *ld, Elf_Scn *scn,
     struct ld_strtab *strtab);
 static void _add_to_shstrtab(struct ld *ld, const char *name);
+static void _copy_and_reloc_input_section(struct ld *ld, void *arg,
+    size_t i);
 static void _copy_and_reloc_input_sections(struct ld *ld);
 static Elf_Scn *_create_elf_scn(struct ld *ld, struct ld_output *lo,
     struct ld_output_section *os);
@@ -96,7 +100,7 @@ ld_output_init(struct ld *ld)
 	else
 		fn = ld->ld_output_file;
 
-	lo->lo_fd = open(fn, O_WRONLY | O_CREAT, S_IRWXU | S_IRWXG | S_IRWXO);
+	lo->lo_fd = open(fn, O_RDWR | O_CREAT, S_IRWXU | S_IRWXG | S_IRWXO);
 	if (lo->lo_fd < 0)
 		ld_fatal_std(ld, "can not create output file: open %s", fn);
 
@@ -410,7 +414,7 @@ _alloc_section_data_for_strtab(struct ld *ld, Elf_Scn *scn,
 	size_t sz;
 
 	buf = ld_strtab_getbuf(ld, strtab);
-	sz = ld_strtab_getsize(strtab);
+	sz = ld_strtab_getsize(ld, strtab);
 	if (buf == NULL || sz == 0)
 		return;
 
@@ -426,54 +430,89 @@ _alloc_section_data_for_strtab(struct ld *ld, Elf_Scn *scn,
 }
 
 static void
-_copy_and_reloc_input_sections(struct ld *ld)
+_copy_and_reloc_input_section(struct ld *ld, void *arg, size_t i)
 {
-	struct ld_input *li;
 	struct ld_input_section *is;
 	Elf_Data *d;
+
+	is = ((struct ld_input_section **) arg)[i];
+	d = is->is_data;
+
+	d->d_align = is->is_align;
+	d->d_off = is->is_reloff;
+	d->d_type = ELF_T_BYTE;
+	d->d_size = is->is_size;
+	d->d_version = EV_CURRENT;
+
+	/*
+	 * Take different actions depending on different types of input
+	 * sections:
+	 *
+	 * For internal input sections, assign the internal buffer
+	 * directly to the data descriptor.
+	 * For relocation sections, they should be ignored since they are
+	 * handled elsewhere.
+	 * For other input sections, load the raw data from input object
+	 * and preform relocation.
+	 */
+	if (is->is_ibuf != NULL) {
+		d->d_buf = is->is_ibuf;
+		/* .eh_frame section needs relocation */
+		if (strcmp(is->is_name, ".eh_frame") == 0)
+			ld_reloc_process_input_section(ld, is, d->d_buf);
+	} else if (is->is_reloc == NULL) {
+		d->d_buf = ld_input_get_section_rawdata(ld, is);
+		ld_reloc_process_input_section(ld, is, d->d_buf);
+	}
+}
+
+static void
+_copy_and_reloc_input_sections(struct ld *ld)
+{
+	struct ld_input *li;
+	struct ld_input_section *is, **isv;
+	struct ld_file *lf;
+	size_t cnt, cap;
 	int i;
 
+	/*
+	 * Open the input objects and list their sections to copy. The
+	 * output offsets are fixed at this point, so the sections are
+	 * then copied and relocated independently of each other, on a
+	 * pool of threads.
+	 */
+	isv = NULL;
+	cnt = cap = 0;
 	STAILQ_FOREACH(li, &ld->ld_lilist, li_next) {
-		ld_input_load(ld, li);
 		for (i = 0; (uint64_t) i < li->li_shnum; i++) {
 			is = &li->li_is[i];
 
 			if (is->is_discard || !is->is_need_reloc)
 				continue;
 
-			d = is->is_data;
-
-			d->d_align = is->is_align;
-			d->d_off = is->is_reloff;
-			d->d_type = ELF_T_BYTE;
-			d->d_size = is->is_size;
-			d->d_version = EV_CURRENT;
+			if (li->li_elf == NULL)
+				ld_input_load(ld, li);
 
-			/*
-			 * Take different actions depending on different types
-			 * of input sections:
-			 *
-			 * For internal input sections, assign the internal
-			 * buffer directly to the data descriptor.
-			 * For relocation sections, they should be ignored
-			 * since they are handled elsewhere.
-			 * For other input sections, load the raw data from
-			 * input object and preform relocation.
-			 */
-			if (is->is_ibuf != NULL) {
-				d->d_buf = is->is_ibuf;
-				/* .eh_frame section needs relocation */
-				if (strcmp(is->is_name, ".eh_frame") == 0)
-					ld_reloc_process_input_section(ld, is,
-					    d->d_buf);
-			} else if (is->is_reloc == NULL) {
-				d->d_buf = ld_input_get_section_rawdata(ld,
-				    is);
-				ld_reloc_process_input_section(ld, is,
-				    d->d_buf);
+			if (cnt == cap) {
+				cap = cap == 0 ? 256 : cap * 2;
+				if ((isv = realloc(isv, cap * sizeof(*isv))) ==
+				    NULL)
+					ld_fatal_std(ld, "realloc");
 			}
+			isv[cnt++] = is;
 		}
-		ld_input_unload(ld, li);
+	}
+
+	ld_thread_run(ld, cnt, _copy_and_reloc_input_section, isv);
+	free(isv);
+
+	STAILQ_FOREACH(li, &ld->ld_lilist, li_next) {
+		if (li->li_elf != NULL)
+			ld_input_unload(ld, li);
+	}
+	TAILQ_FOREACH(lf, &ld->ld_lflist, lf_next) {
+		if (lf->lf_mmap != NULL)
+			ld_file_unload(ld, lf);
 	}
 }
 
@@ -891,6 +930,7 @@ ld_output_create(struct ld *ld)
 {
 	struct ld_output *lo;
 	GElf_Ehdr eh;
+	off_t size;
 
 	lo = ld->ld_output;
 
@@ -960,8 +1000,9 @@ ld_output_create(struct ld *ld)
 		_create_phdr(ld);
 
 	/* Finally write out the output ELF object. */
-	if (elf_update(lo->lo_elf, ELF_C_WRITE) < 0)
+	if ((size = elf_update(lo->lo_elf, ELF_C_WRITE)) < 0)
 		ld_fatal(ld, "elf_update failed: %s", elf_errmsg(-1));
+	lo->lo_size = (uint64_t) size;
 }
 
 static void
@@ -998,7 +1039,7 @@ _update_section_header(struct ld *ld)
 			ld_fatal(ld, "gelf_getshdr failed: %s",
 			    elf_errmsg(-1));
 
-		sh.sh_name = ld_strtab_lookup(st, os->os_name);
+		sh.sh_name = ld_strtab_lookup(ld, st, os->os_name);
 		sh.sh_flags = os->os_flags;
 		sh.sh_addr = os->os_addr;
 		sh.sh_addralign = os->os_align;
@@ -1067,7 +1108,7 @@ _create_symbol_table(struct ld *ld)
 	if (gelf_getshdr(scn_symtab, &sh) == NULL)
 		ld_fatal(ld, "gelf_getshdr failed: %s", elf_errmsg(-1));
 
-	sh.sh_name = ld_strtab_lookup(st, ".symtab");
+	sh.sh_name = ld_strtab_lookup(ld, st, ".symtab");
 	sh.sh_flags = 0;
 	sh.sh_addr = 0;
 	sh.sh_addralign = (lo->lo_ec == ELFCLASS32) ? 4 : 8;
@@ -1128,18 +1169,18 @@ ld_output_create_string_table_section(struct ld *ld, const char *name,
 	if (gelf_getshdr(scn, &sh) == NULL)
 		ld_fatal(ld, "gelf_getshdr failed: %s", elf_errmsg(-1));
 
-	sh.sh_name = ld_strtab_lookup(ld->ld_shstrtab, name);
+	sh.sh_name = ld_strtab_lookup(ld, ld->ld_shstrtab, name);
 	sh.sh_flags = 0;
 	sh.sh_addr = 0;
 	sh.sh_addralign = 1;
 	sh.sh_offset = ls->ls_offset;
-	sh.sh_size = ld_strtab_getsize(st);
+	sh.sh_size = ld_strtab_getsize(ld, st);
 	sh.sh_type = SHT_STRTAB;
 
 	if (!gelf_update_shdr(scn, &sh))
 		ld_fatal(ld, "gelf_update_shdr failed: %s", elf_errmsg(-1));
 
-	sz = ld_strtab_getsize(st);
+	sz = ld_strtab_getsize(ld, st);
 
 	if ((d = elf_newdata(scn)) == NULL)
 		ld_fatal(ld, "elf_newdata failed: %s", elf_errmsg(-1));
@@ -115,6 +115,7 @@ struct ld_output {
 	unsigned lo_rel_dyn_type;	 /* type of dynamic relocation */
 	unsigned lo_fde_num;		 /* num of FDE in .eh_frame */
 	uint64_t lo_shoff;		 /* section header table offset */
+	uint64_t lo_size;		 /* output file size */
 	uint64_t lo_tls_size;		 /* TLS segment size */
 	uint64_t lo_tls_align;		 /* TLS segment align */
 	uint64_t lo_tls_addr;		 /* TLS segment VMA */
@@ -131,6 +132,7 @@ struct ld_output {
 	struct ld_output_section *lo_dynsym; /* .dynsym section. */
 	struct ld_output_section *lo_dynstr; /* .dynstr section. */
 	struct ld_output_section *lo_hash; /* .hash section. */
+	struct ld_output_section *lo_gnu_hash; /* .gnu.hash section. */
 	struct ld_output_section *lo_verdef; /* .gnu.version.d section */
 	struct ld_output_section *lo_verneed; /* .gnu.version.r section */
 	struct ld_output_section *lo_versym; /* .gnu.version section */
@@ -139,11 +141,13 @@ struct ld_output {
 	struct ld_output_section *lo_rel_plt; /* PLT relocation section */
 	struct ld_output_section *lo_rel_dyn;  /* Dynamic relocation section */
 	struct ld_output_section *lo_ehframe_hdr; /* .eh_frame_hdr section */
+	struct ld_output_section *lo_build_id; /* .note.gnu.build-id section */
 	struct ld_output_data_buffer *lo_dynamic_odb; /* .dynamic buffer */
 	struct ld_output_data_buffer *lo_got_odb; /* GOT section data */
 	struct ld_output_data_buffer *lo_plt_odb; /* PLT section data */
 	struct ld_output_data_buffer *lo_rel_plt_odb; /* PLT reloc data */
 	struct ld_output_data_buffer *lo_rel_dyn_odb; /* dynamic reloc data */
+	struct ld_output_data_buffer *lo_build_id_odb; /* build ID note */
 };
 
 struct ld_output_section *ld_output_alloc_section(struct ld *, const char *,
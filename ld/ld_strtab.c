@@ -29,7 +29,15 @@
 
 ELFTC_VCSID("$Id$");
 
-#define	_DEFAULT_STRTAB_SIZE	512
+/*
+ * Strings are kept in a hash table keyed by their contents. Without
+ * suffix merging, a string is appended to the table when it is first
+ * inserted and its offset is known at once.  With suffix merging, the
+ * offsets are assigned when the table is first read: the strings are
+ * sorted by their reversed contents, so that a string immediately
+ * follows the strings it is a suffix of, and the table is laid out in
+ * one pass.
+ */
 
 struct ld_str {
 	char *s;
@@ -40,14 +48,14 @@ struct ld_str {
 struct ld_strtab {
 	struct ld_str *st_pool;
 	char *st_buf;
-	size_t st_cap;
 	size_t st_size;
 	unsigned char st_suffix;
 };
 
-
-static void _resize_strtab(struct ld *ld, struct ld_strtab *st,
-    size_t newsize);
+static void _layout_strtab(struct ld *ld, struct ld_strtab *st);
+static void _sort_strings(struct ld_str **v, size_t n, size_t pos);
+static struct ld_str *_add_string(struct ld *ld, struct ld_strtab *st,
+    const char *s);
 
 struct ld_strtab *
 ld_strtab_alloc(struct ld *ld, unsigned char suffix)
@@ -56,16 +64,9 @@ ld_strtab_alloc(struct ld *ld, unsigned char suffix)
 
 	if ((st = calloc(1, sizeof(*st))) == NULL)
 		ld_fatal_std(ld, "calloc");
-	
-	st->st_size = 0;
-	if (suffix) {
-		st->st_suffix = 1;
-		st->st_cap = _DEFAULT_STRTAB_SIZE;
-		if ((st->st_buf = calloc(1, st->st_cap)) == NULL)
-			ld_fatal_std(ld, "calloc");
-		ld_strtab_insert(ld, st, "");
-	} else
-		st->st_size = 1;
+
+	st->st_suffix = suffix ? 1 : 0;
+	st->st_size = 1;
 
 	return (st);
 }
@@ -98,8 +99,11 @@ ld_strtab_getbuf(struct ld *ld, struct ld_strtab *st)
 
 	assert(st != NULL);
 
-	if (st->st_suffix)
+	if (st->st_suffix) {
+		if (st->st_buf == NULL)
+			_layout_strtab(ld, st);
 		return (st->st_buf);
+	}
 
 	if (st->st_buf == NULL) {
 		if ((st->st_buf = malloc(st->st_size)) == NULL)
@@ -120,20 +124,13 @@ ld_strtab_getbuf(struct ld *ld, struct ld_strtab *st)
 }
 
 size_t
-ld_strtab_getsize(struct ld_strtab *st)
+ld_strtab_getsize(struct ld *ld, struct ld_strtab *st)
 {
 
-	return (st->st_size);
-}
-
-static void
-_resize_strtab(struct ld *ld, struct ld_strtab *st, size_t newsize)
-{
+	if (st->st_suffix && st->st_buf == NULL)
+		_layout_strtab(ld, st);
 
-	assert(st != NULL && st->st_suffix);
-	if ((st->st_buf = realloc(st->st_buf, newsize)) == NULL)
-		ld_fatal_std(ld, "realloc");
-	st->st_cap = newsize;
+	return (st->st_size);
 }
 
 size_t
@@ -149,19 +146,11 @@ ld_strtab_insert_no_suffix(struct ld *ld, struct ld_strtab *st, char *s)
 	if (*s == '\0')
 		return (0);
 
-	HASH_FIND_STR(st->st_pool, s, str);
+	HASH_FIND(hh, st->st_pool, s, strlen(s), str);
 	if (str != NULL)
 		return (str->off);
 
-	if ((str = calloc(1, sizeof(*str))) == NULL)
-		ld_fatal_std(ld, "calloc");
-
-	if ((str->s = strdup(s)) == NULL)
-		ld_fatal_std(ld, "strdup");
-
-	str->len = strlen(s);
-	HASH_ADD_KEYPTR(hh, st->st_pool, str->s, str->len, str);
-
+	str = _add_string(ld, st, s);
 	str->off = st->st_size;
 	st->st_size += str->len + 1;
 
@@ -171,68 +160,164 @@ ld_strtab_insert_no_suffix(struct ld *ld, struct ld_strtab *st, char *s)
 void
 ld_strtab_insert(struct ld *ld, struct ld_strtab *st, const char *s)
 {
-	const char *r;
-	char *b, *c;
-	size_t len, slen;
-	int append;
+	struct ld_str *str;
 
-	assert(st != NULL && st->st_buf != NULL && st->st_suffix);
+	assert(st != NULL && st->st_suffix);
 
-	if (s == NULL)
+	if (s == NULL || *s == '\0')
 		return;
 
-	slen = strlen(s);
-	append = 0;
-	b = st->st_buf;
-	for (c = b; c < b + st->st_size;) {
-		len = strlen(c);
-		if (!append && len >= slen) {
-			r = c + (len - slen);
-			if (strcmp(r, s) == 0)
-				return;
-		} else if (len < slen && len != 0) {
-			r = s + (slen - len);
-			if (strcmp(c, r) == 0) {
-				st->st_size -= len + 1;
-				memmove(c, c + len + 1, st->st_size - (c - b));
-				append = 1;
-				continue;
-			}
-		}
-		c += len + 1;
-	}
+	HASH_FIND(hh, st->st_pool, (void *) (uintptr_t) s, strlen(s), str);
+	if (str != NULL)
+		return;
 
-	while (st->st_size + slen + 1 >= st->st_cap)
-		_resize_strtab(ld, st, st->st_cap * 2);
+	(void) _add_string(ld, st, s);
 
-	b = st->st_buf;
-	memcpy(&b[st->st_size], s, slen);
-	b[st->st_size + slen] = '\0';
-	st->st_size += slen + 1;
+	/* The table has to be laid out again. */
+	free(st->st_buf);
+	st->st_buf = NULL;
 }
 
 size_t
-ld_strtab_lookup(struct ld_strtab *st, const char *s)
+ld_strtab_lookup(struct ld *ld, struct ld_strtab *st, const char *s)
 {
-	const char *b, *c, *r;
-	size_t len, slen;
+	struct ld_str *str;
 
-	assert(st != NULL && st->st_buf != NULL && st->st_suffix);
+	assert(st != NULL && st->st_suffix);
 
-	if (s == NULL)
+	if (s == NULL || *s == '\0')
 		return (0);
 
-	slen = strlen(s);
-	b = st->st_buf;
-	for (c = b; c < b + st->st_size;) {
-		len = strlen(c);
-		if (len >= slen) {
-			r = c + (len - slen);
-			if (strcmp(r, s) == 0)
-				return (r - b);
+	if (st->st_buf == NULL)
+		_layout_strtab(ld, st);
+
+	HASH_FIND(hh, st->st_pool, (void *) (uintptr_t) s, strlen(s), str);
+	if (str == NULL)
+		return (-1);
+
+	return (str->off);
+}
+
+static struct ld_str *
+_add_string(struct ld *ld, struct ld_strtab *st, const char *s)
+{
+	struct ld_str *str;
+
+	if ((str = calloc(1, sizeof(*str))) == NULL)
+		ld_fatal_std(ld, "calloc");
+
+	if ((str->s = strdup(s)) == NULL)
+		ld_fatal_std(ld, "strdup");
+
+	str->len = strlen(s);
+	HASH_ADD_KEYPTR(hh, st->st_pool, str->s, str->len, str);
+
+	return (str);
+}
+
+/*
+ * Lay out a suffix merged string table. The strings sorted by their
+ * reversed contents in descending order place each string right after
+ * the longest string it is a suffix of, if any.
+ */
+static void
+_layout_strtab(struct ld *ld, struct ld_strtab *st)
+{
+	struct ld_str **v, *str, *tmp, *prev;
+	size_t i, n;
+	char *p;
+
+	assert(st->st_suffix && st->st_buf == NULL);
+
+	n = HASH_COUNT(st->st_pool);
+	v = NULL;
+	if (n > 0 && (v = malloc(n * sizeof(*v))) == NULL)
+		ld_fatal_std(ld, "malloc");
+
+	i = 0;
+	HASH_ITER(hh, st->st_pool, str, tmp)
+		v[i++] = str;
+
+	_sort_strings(v, n, 0);
+
+	/* Offset 0 holds the empty string. */
+	st->st_size = 1;
+	prev = NULL;
+	for (i = 0; i < n; i++) {
+		str = v[i];
+		if (prev != NULL && prev->len >= str->len &&
+		    !memcmp(prev->s + prev->len - str->len, str->s, str->len))
+			str->off = prev->off + prev->len - str->len;
+		else {
+			str->off = st->st_size;
+			st->st_size += str->len + 1;
+			prev = str;
 		}
-		c += len + 1;
 	}
 
-	return (-1);
+	if ((st->st_buf = malloc(st->st_size)) == NULL)
+		ld_fatal_std(ld, "malloc");
+	st->st_buf[0] = '\0';
+	for (i = 0; i < n; i++) {
+		str = v[i];
+		p = &st->st_buf[str->off];
+		memcpy(p, str->s, str->len + 1);
+	}
+
+	free(v);
+}
+
+/*
+ * Byte of a string at position `pos' counting from its end, or -1 past
+ * its beginning.
+ */
+#define	_TAIL_AT(str, pos)						\
+	((pos) < (str)->len ?						\
+	    (int) (unsigned char) (str)->s[(str)->len - (pos) - 1] : -1)
+
+/*
+ * Sort strings by their reversed contents in descending order, using a
+ * three-way radix quicksort that does not compare again the bytes
+ * already known to be equal.
+ */
+static void
+_sort_strings(struct ld_str **v, size_t n, size_t pos)
+{
+	struct ld_str *t;
+	size_t i, j, k;
+	int c, pivot;
+
+	while (n > 1) {
+		/*
+		 * Partition so that [0, i) are greater than the pivot,
+		 * [i, j) are equal to it and [j, n) are less than it.
+		 */
+		pivot = _TAIL_AT(v[n / 2], pos);
+		i = 0;
+		j = n;
+		k = 0;
+		while (k < j) {
+			c = _TAIL_AT(v[k], pos);
+			if (c > pivot) {
+				t = v[i]; v[i] = v[k]; v[k] = t;
+				i++;
+				k++;
+			} else if (c < pivot) {
+				j--;
+				t = v[j]; v[j] = v[k]; v[k] = t;
+			} else
+				k++;
+		}
+
+		_sort_strings(v, i, pos);
+		_sort_strings(v + j, n - j, pos);
+
+		/* Strings equal up to their beginning are identical. */
+		if (pivot == -1)
+			break;
+
+		v += i;
+		n = j - i;
+		pos++;
+	}
 }
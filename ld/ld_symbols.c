@@ -33,17 +33,38 @@
 #include "ld_symver.h"
 #include "ld_script.h"
 #include "ld_strtab.h"
+#include "ld_thread.h"
 
 ELFTC_VCSID("$Id$");
 
 #define	_INIT_SYMTAB_SIZE	128
 
+/*
+ * Symbols of an input object, read ahead of symbol resolution.
+ */
+struct ld_symbol_preload {
+	struct ld_file *sp_file;	/* input file */
+	off_t sp_off;			/* archive member offset */
+	struct ld_symbol **sp_sym;	/* symbols read */
+	uint64_t sp_symnum;		/* number of symbols */
+	UT_hash_handle hh;		/* hash handle */
+};
+
 static void _load_symbols(struct ld *ld, struct ld_file *lf);
 static void _load_archive_symbols(struct ld *ld, struct ld_file *lf);
-static void _load_elf_symbols(struct ld *ld, struct ld_input *li, Elf *e);
+static void _load_elf_symbols(struct ld *ld, struct ld_input *li, Elf *e,
+    struct ld_symbol_preload *sp);
 static void _unload_symbols(struct ld_input *li);
-static void _add_elf_symbol(struct ld *ld, struct ld_input *li, Elf *e,
+static struct ld_symbol *_read_elf_symbol(struct ld *ld, Elf *e,
     GElf_Sym *sym, size_t strndx, int i);
+static void _read_elf_symbols(struct ld *ld, struct ld_symbol_preload *sp,
+    Elf *e);
+static void _preload_symbols(struct ld *ld, void *arg, size_t i);
+static void _preload_files(struct ld *ld, struct ld_file *lf);
+static void _free_preload_symbols(struct ld_symbol_preload *sp);
+static void _free_preload(struct ld_symbol_preload *sp);
+static void _add_elf_symbol(struct ld *ld, struct ld_input *li,
+    struct ld_symbol *lsb);
 static void _add_to_dynsym_table(struct ld *ld, struct ld_symbol *lsb);
 static void _write_to_dynsym_table(struct ld *ld, struct ld_symbol *lsb);
 static void _add_to_symbol_table(struct ld *ld, struct ld_symbol *lsb);
@@ -51,7 +72,8 @@ static void _free_symbol_table(struct ld_symbol_table *symtab);
 struct ld_symbol_table *_alloc_symbol_table(struct ld *ld);
 static int _archive_member_extracted(struct ld_archive *la, off_t off);
 static struct ld_archive_member * _extract_archive_member(struct ld *ld,
-    struct ld_file *lf, struct ld_archive *la, off_t off);
+    struct ld_file *lf, struct ld_archive *la, off_t off,
+    struct ld_symbol_preload *spt);
 static void _print_extracted_member(struct ld *ld,
     struct ld_archive_member *lam, struct ld_symbol *lsb);
 static void _resolve_and_add_symbol(struct ld *ld, struct ld_symbol *lsb);
@@ -60,9 +82,17 @@ static void _free_symbol(struct ld_symbol *lsb);
 static struct ld_symbol *_find_symbol(struct ld_symbol *tbl, char *name);
 static void _update_symbol(struct ld_symbol *lsb);
 
+/*
+ * The hash value of a symbol name is computed once, when the symbol is
+ * read, and then reused by the lookups and insertions below.
+ */
+#define	_set_key(s) do {					\
+	(s)->lsb_keylen = strlen((s)->lsb_longname);		\
+	HASH_VALUE((s)->lsb_longname, (s)->lsb_keylen, (s)->lsb_hashv); \
+	} while (0)
 #define	_add_symbol(tbl, s) do {				\
-	HASH_ADD_KEYPTR(hh, (tbl), (s)->lsb_longname,		\
-	    strlen((s)->lsb_longname), (s));			\
+	HASH_ADD_KEYPTR_BYHASHVALUE(hh, (tbl), (s)->lsb_longname,	\
+	    (s)->lsb_keylen, (s)->lsb_hashv, (s));		\
 	} while (0)
 #define _remove_symbol(tbl, s) do {				\
 	HASH_DEL((tbl), (s));					\
@@ -141,6 +171,7 @@ ld_symbols_add_extern(struct ld *ld, char *name)
 		ld_fatal_std(ld, "strdup");
 	if ((lsb->lsb_longname = strdup(name)) == NULL)
 		ld_fatal_std(ld, "strdup");
+	_set_key(lsb);
 
 	if (ld->ld_ext_symbols == NULL) {
 		ld->ld_ext_symbols = malloc(sizeof(*ld->ld_ext_symbols));
@@ -164,6 +195,7 @@ ld_symbols_add_variable(struct ld *ld, struct ld_script_variable *ldv,
 		ld_fatal_std(ld, "strdup");
 	if ((lsb->lsb_longname = strdup(ldv->ldv_name)) == NULL)
 		ld_fatal_std(ld, "strdup");
+	_set_key(lsb);
 	lsb->lsb_var = ldv;
 	lsb->lsb_bind = STB_GLOBAL;
 	lsb->lsb_shndx = SHN_ABS;
@@ -199,6 +231,7 @@ ld_symbols_add_internal(struct ld *ld, const char *name, uint64_t size,
 		ld_fatal_std(ld, "strdup");
 	if ((lsb->lsb_longname = strdup(name)) == NULL)
 		ld_fatal_std(ld, "strdup");
+	_set_key(lsb);
 	lsb->lsb_size = size;
 	lsb->lsb_value = value;
 	lsb->lsb_shndx = shndx;
@@ -256,17 +289,31 @@ ld_symbols_resolve(struct ld *ld)
 		}
 		ls->ls_group_level = lf->lf_group_level;
 
+		/* Read the symbols of this and the following files ahead. */
+		if (lf->lf_preload == NULL)
+			_preload_files(ld, lf);
+
 		/* Load symbols. */
 		ld_file_load(ld, lf);
 		if (ls->ls_arch_conflict) {
 			ld_file_unload(ld, lf);
-			return;
+			break;
 		}
 		_load_symbols(ld, lf);
 		ld_file_unload(ld, lf);
 		lf = TAILQ_NEXT(lf, lf_next);
 	}
 
+	TAILQ_FOREACH(lf, &ld->ld_lflist, lf_next) {
+		if (lf->lf_preload != NULL) {
+			_free_preload(lf->lf_preload);
+			lf->lf_preload = NULL;
+		}
+	}
+
+	if (ls->ls_arch_conflict)
+		return;
+
 	/* Print information regarding space allocated for common symbols. */
 	if (ld->ld_print_linkmap) {
 		printf("\nCommon symbols:\n");
@@ -652,7 +699,9 @@ _resolve_and_add_symbol(struct ld *ld, struct ld_symbol *lsb)
 	 * Search in the symbol table for the symbol with the same name and
 	 * same version.
 	 */
-	if ((_lsb = _find_symbol(ld->ld_sym, name)) != NULL)
+	HASH_FIND_BYHASHVALUE(hh, ld->ld_sym, name, lsb->lsb_keylen,
+	    lsb->lsb_hashv, _lsb);
+	if (_lsb != NULL)
 		goto found;
 
 	/*
@@ -664,7 +713,11 @@ _resolve_and_add_symbol(struct ld *ld, struct ld_symbol *lsb)
 	 * 2. If the symbol to resolve has the default version, search the
 	 *    symbol with the same name but without a version.
 	 */
-	HASH_FIND_STR(ld->ld_defver, sn, dv);
+	if (!strcmp(name, sn))
+		HASH_FIND_BYHASHVALUE(hh, ld->ld_defver, sn, lsb->lsb_keylen,
+		    lsb->lsb_hashv, dv);
+	else
+		HASH_FIND_STR(ld->ld_defver, sn, dv);
 	if (dv != NULL) {
 		if (!strcmp(name, sn)) {
 			if ((_lsb = _find_symbol(ld->ld_sym,
@@ -874,54 +927,62 @@ found:
 	}
 }
 
-static void
-_add_elf_symbol(struct ld *ld, struct ld_input *li, Elf *e, GElf_Sym *sym,
-    size_t strndx, int i)
+static struct ld_symbol *
+_read_elf_symbol(struct ld *ld, Elf *e, GElf_Sym *sym, size_t strndx, int i)
 {
 	struct ld_symbol *lsb;
-	struct ld_symbol_defver *dv;
 	char *name;
-	int j, len, ndx;
-	unsigned char st_bind;
 
 	if ((name = elf_strptr(e, strndx, sym->st_name)) == NULL)
-		return;
+		return (NULL);
+
+	lsb = _alloc_symbol(ld);
+
+	if ((lsb->lsb_name = strdup(name)) == NULL)
+		ld_fatal_std(ld, "strdup");
+	lsb->lsb_keylen = strlen(name);
+	HASH_VALUE(name, lsb->lsb_keylen, lsb->lsb_hashv);
+	lsb->lsb_value = sym->st_value;
+	lsb->lsb_size = sym->st_size;
+	lsb->lsb_bind = GELF_ST_BIND(sym->st_info);
+	lsb->lsb_type = GELF_ST_TYPE(sym->st_info);
+	lsb->lsb_other = sym->st_other;
+	lsb->lsb_shndx = sym->st_shndx;
+	lsb->lsb_index = i;
+
+	return (lsb);
+}
+
+static void
+_add_elf_symbol(struct ld *ld, struct ld_input *li, struct ld_symbol *lsb)
+{
+	struct ld_symbol_defver *dv;
+	int i, j, len, ndx;
 
 	/*
 	 * First check if the section this symbol refers to is belong
 	 * to a section group that has been removed.
 	 */
-	st_bind = GELF_ST_BIND(sym->st_info);
-	if (sym->st_shndx != SHN_UNDEF && sym->st_shndx != SHN_COMMON &&
-	    sym->st_shndx != SHN_ABS && sym->st_shndx < li->li_shnum - 1 &&
-	    li->li_is[sym->st_shndx].is_discard) {
-		st_bind = GELF_ST_BIND(sym->st_info);
-		if (st_bind == STB_GLOBAL || st_bind == STB_WEAK) {
+	if (lsb->lsb_shndx != SHN_UNDEF && lsb->lsb_shndx != SHN_COMMON &&
+	    lsb->lsb_shndx != SHN_ABS && lsb->lsb_shndx < li->li_shnum - 1 &&
+	    li->li_is[lsb->lsb_shndx].is_discard) {
+		if (lsb->lsb_bind == STB_GLOBAL || lsb->lsb_bind == STB_WEAK) {
 			/*
 			 * For symbol with STB_GLOBAL or STB_WEAK binding,
 			 * we convert it to an undefined symbol.
 			 */
-			sym->st_shndx = SHN_UNDEF;
+			lsb->lsb_shndx = SHN_UNDEF;
 		} else {
 			/*
 			 * Local symbols are discarded, if the section they
 			 * refer to are removed.
 			 */
+			_free_symbol(lsb);
 			return;
 		}
 	}
 
-	lsb = _alloc_symbol(ld);
-
-	if ((lsb->lsb_name = strdup(name)) == NULL)
-		ld_fatal_std(ld, "strdup");
-	lsb->lsb_value = sym->st_value;
-	lsb->lsb_size = sym->st_size;
-	lsb->lsb_bind = GELF_ST_BIND(sym->st_info);
-	lsb->lsb_type = GELF_ST_TYPE(sym->st_info);
-	lsb->lsb_other = sym->st_other;
-	lsb->lsb_shndx = sym->st_shndx;
-	lsb->lsb_index = i;
+	i = lsb->lsb_index;
 	lsb->lsb_input = li;
 	lsb->lsb_ver = NULL;
 
@@ -957,7 +1018,11 @@ _add_elf_symbol(struct ld *ld, struct ld_input *li, Elf *e, GElf_Sym *sym,
 		}
 	}
 
-	/* Build "long" symbol name which is used for hash key. */
+	/*
+	 * Build "long" symbol name which is used for hash key. The key
+	 * of an unversioned symbol is its name, which was hashed when
+	 * the symbol was read.
+	 */
 	if (lsb->lsb_ver == NULL || j < 2) {
 		lsb->lsb_longname = strdup(lsb->lsb_name);
 		if (lsb->lsb_longname == NULL)
@@ -968,6 +1033,7 @@ _add_elf_symbol(struct ld *ld, struct ld_input *li, Elf *e, GElf_Sym *sym,
 			ld_fatal_std(ld, "malloc");
 		snprintf(lsb->lsb_longname, len, "%s@%s", lsb->lsb_name,
 		    lsb->lsb_ver);
+		_set_key(lsb);
 	}
 
 	/* Keep track of default versions. */
@@ -1004,12 +1070,13 @@ _archive_member_extracted(struct ld_archive *la, off_t off)
 
 static struct ld_archive_member *
 _extract_archive_member(struct ld *ld, struct ld_file *lf,
-    struct ld_archive *la, off_t off)
+    struct ld_archive *la, off_t off, struct ld_symbol_preload *spt)
 {
 	Elf *e;
 	Elf_Arhdr *arhdr;
 	struct ld_archive_member *lam;
 	struct ld_input *li;
+	struct ld_symbol_preload *sp;
 
 	if (elf_rand(lf->lf_elf, off) == 0)
 		ld_fatal(ld, "%s: elf_rand failed: %s", lf->lf_name,
@@ -1045,7 +1112,8 @@ _extract_archive_member(struct ld *ld, struct ld_file *lf,
 	lam->lam_input = li;
 
 	/* Load the symbols of this member. */
-	_load_elf_symbols(ld, li, e);
+	HASH_FIND(hh, spt, &off, sizeof(off), sp);
+	_load_elf_symbols(ld, li, e, sp);
 
 	elf_end(e);
 
@@ -1083,9 +1151,11 @@ _load_archive_symbols(struct ld *ld, struct ld_file *lf)
 	struct ld_archive *la;
 	struct ld_archive_member *lam;
 	struct ld_symbol *lsb;
+	struct ld_symbol_preload *sp, *_sp, *spt, **spv = NULL;
 	Elf_Arsym *as;
-	size_t c;
-	int extracted, i;
+	size_t c, n;
+	unsigned *ashv = NULL, *aslen = NULL;
+	int extracted, i, preload;
 
 	assert(lf != NULL && lf->lf_type == LFT_ARCHIVE);
 	assert(lf->lf_ar != NULL);
@@ -1095,30 +1165,96 @@ _load_archive_symbols(struct ld *ld, struct ld_file *lf)
 	if ((as = elf_getarsym(lf->lf_elf, &c)) == NULL)
 		ld_fatal(ld, "%s: elf_getarsym failed: %s", lf->lf_name,
 		    elf_errmsg(-1));
+
+	/*
+	 * Hash the names in the archive symbol table once, rather than on
+	 * every pass over it.
+	 */
+	if ((ashv = calloc(c, sizeof(*ashv))) == NULL ||
+	    (aslen = calloc(c, sizeof(*aslen))) == NULL ||
+	    (spv = calloc(c, sizeof(*spv))) == NULL)
+		goto nomem;
+	for (i = 0; (size_t) i < c && as[i].as_name != NULL; i++) {
+		aslen[i] = strlen(as[i].as_name);
+		HASH_VALUE(as[i].as_name, aslen[i], ashv[i]);
+	}
+
+	preload = ld_thread_count(ld) > 1;
+
 	do {
+		/*
+		 * A member that defines a symbol already in the symbol table
+		 * is certain to be extracted by this pass. Read the symbols
+		 * of all such members in parallel before the pass starts;
+		 * members pulled in by symbols the pass itself adds are
+		 * read as they are extracted.
+		 */
+		spt = NULL;
+		n = 0;
+		for (i = 0; preload && (size_t) i < c; i++) {
+			if (as[i].as_name == NULL)
+				break;
+			if (_archive_member_extracted(la, as[i].as_off))
+				continue;
+			HASH_FIND_BYHASHVALUE(hh, ld->ld_sym, as[i].as_name,
+			    aslen[i], ashv[i], lsb);
+			if (lsb == NULL)
+				continue;
+			HASH_FIND(hh, spt, &as[i].as_off, sizeof(off_t), sp);
+			if (sp != NULL)
+				continue;
+			if ((sp = calloc(1, sizeof(*sp))) == NULL)
+				ld_fatal_std(ld, "calloc");
+			sp->sp_file = lf;
+			sp->sp_off = as[i].as_off;
+			HASH_ADD(hh, spt, sp_off, sizeof(sp->sp_off), sp);
+			spv[n++] = sp;
+		}
+		if (n > 0)
+			ld_thread_run(ld, n, _preload_symbols, spv);
+
 		extracted = 0;
 		for (i = 0; (size_t) i < c; i++) {
 			if (as[i].as_name == NULL)
 				break;
 			if (_archive_member_extracted(la, as[i].as_off))
 				continue;
-			if ((lsb = _find_symbol(ld->ld_sym, as[i].as_name)) !=
-			    NULL) {
+			HASH_FIND_BYHASHVALUE(hh, ld->ld_sym, as[i].as_name,
+			    aslen[i], ashv[i], lsb);
+			if (lsb != NULL) {
 				lam = _extract_archive_member(ld, lf, la,
-				    as[i].as_off);
+				    as[i].as_off, spt);
 				extracted = 1;
 				ls->ls_extracted[ls->ls_group_level] = 1;
 				if (ld->ld_print_linkmap)
 					_print_extracted_member(ld, lam, lsb);
 			}
 		}
+
+		HASH_ITER(hh, spt, sp, _sp) {
+			HASH_DEL(spt, sp);
+			_free_preload(sp);
+		}
 	} while (extracted);
+
+	free(ashv);
+	free(aslen);
+	free(spv);
+	return;
+
+nomem:
+	free(ashv);
+	free(aslen);
+	free(spv);
+	ld_fatal_std(ld, "calloc");
 }
 
 static void
-_load_elf_symbols(struct ld *ld, struct ld_input *li, Elf *e)
+_load_elf_symbols(struct ld *ld, struct ld_input *li, Elf *e,
+    struct ld_symbol_preload *sp)
 {
 	struct ld_input_section *is;
+	struct ld_symbol *lsb;
 	Elf_Scn *scn_sym, *scn_dynamic;
 	Elf_Scn *scn_versym, *scn_verneed, *scn_verdef;
 	Elf_Data *d;
@@ -1184,11 +1320,25 @@ _load_elf_symbols(struct ld *ld, struct ld_input *li, Elf *e)
 	}
 
 	li->li_symnum = d->d_size / shdr.sh_entsize;
+
+	/* Use the symbols read ahead, if any. */
+	if (sp != NULL && sp->sp_sym != NULL &&
+	    sp->sp_symnum == li->li_symnum) {
+		for (i = 0; (uint64_t) i < li->li_symnum; i++) {
+			if ((lsb = sp->sp_sym[i]) != NULL) {
+				sp->sp_sym[i] = NULL;
+				_add_elf_symbol(ld, li, lsb);
+			}
+		}
+		return;
+	}
+
 	for (i = 0; (uint64_t) i < li->li_symnum; i++) {
 		if (gelf_getsym(d, i, &sym) != &sym)
 			ld_warn(ld, "%s: gelf_getsym failed: %s", li->li_name,
 			    elf_errmsg(-1));
-		_add_elf_symbol(ld, li, e, &sym, strndx, i);
+		if ((lsb = _read_elf_symbol(ld, e, &sym, strndx, i)) != NULL)
+			_add_elf_symbol(ld, li, lsb);
 	}
 
 }
@@ -1201,8 +1351,175 @@ _load_symbols(struct ld *ld, struct ld_file *lf)
 		_load_archive_symbols(ld, lf);
 	else {
 		lf->lf_input = ld_input_alloc(ld, lf, lf->lf_name);
-		_load_elf_symbols(ld, lf->lf_input, lf->lf_elf);
+		_load_elf_symbols(ld, lf->lf_input, lf->lf_elf,
+		    lf->lf_preload);
+	}
+}
+
+/*
+ * Read the symbol table of an ELF object into 'sp'. This runs on a
+ * worker thread and does not touch the linker state: any failure just
+ * leaves 'sp' empty, and the object is then read and diagnosed again
+ * during symbol resolution.
+ */
+static void
+_read_elf_symbols(struct ld *ld, struct ld_symbol_preload *sp, Elf *e)
+{
+	Elf_Scn *scn, *scn_sym;
+	Elf_Data *d;
+	GElf_Ehdr ehdr;
+	GElf_Shdr shdr;
+	GElf_Sym sym;
+	struct ld_symbol **syms;
+	uint64_t i, n;
+	uint32_t type;
+
+	if (elf_kind(e) != ELF_K_ELF || gelf_getehdr(e, &ehdr) == NULL)
+		return;
+
+	/* Archive members are always treated as relocatable objects. */
+	if (sp->sp_file->lf_type == LFT_ARCHIVE || ehdr.e_type == ET_REL)
+		type = SHT_SYMTAB;
+	else if (ehdr.e_type == ET_DYN)
+		type = SHT_DYNSYM;
+	else
+		return;
+
+	scn = scn_sym = NULL;
+	while ((scn = elf_nextscn(e, scn)) != NULL) {
+		if (gelf_getshdr(scn, &shdr) != &shdr)
+			return;
+		if (shdr.sh_type == type)
+			scn_sym = scn;
 	}
+
+	if (scn_sym == NULL || gelf_getshdr(scn_sym, &shdr) != &shdr ||
+	    shdr.sh_link == SHN_UNDEF || shdr.sh_entsize == 0)
+		return;
+
+	if ((d = elf_getdata(scn_sym, NULL)) == NULL)
+		return;
+
+	if ((n = d->d_size / shdr.sh_entsize) == 0)
+		return;
+
+	if ((syms = calloc(n, sizeof(*syms))) == NULL)
+		ld_fatal_std(ld, "calloc");
+
+	for (i = 0; i < n; i++) {
+		if (gelf_getsym(d, i, &sym) != &sym)
+			break;
+		syms[i] = _read_elf_symbol(ld, e, &sym, shdr.sh_link, i);
+	}
+
+	sp->sp_sym = syms;
+	sp->sp_symnum = i;
+	if (i < n)
+		_free_preload_symbols(sp);
+}
+
+static void
+_preload_symbols(struct ld *ld, void *arg, size_t i)
+{
+	struct ld_symbol_preload *sp;
+	struct ld_file *lf;
+	struct stat sb;
+	void *m;
+	Elf *e;
+	int fd;
+
+	sp = ((struct ld_symbol_preload **) arg)[i];
+	lf = sp->sp_file;
+
+	/* An archive member, the archive itself is already open. */
+	if (lf->lf_type == LFT_ARCHIVE) {
+		if ((e = elf_openarmember(lf->lf_elf, sp->sp_off)) != NULL) {
+			_read_elf_symbols(ld, sp, e);
+			(void) elf_end(e);
+		}
+		return;
+	}
+
+	if ((fd = open(lf->lf_name, O_RDONLY)) < 0)
+		return;
+	if (fstat(fd, &sb) < 0 || sb.st_size == 0 ||
+	    (m = mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE, fd,
+	    (off_t) 0)) == MAP_FAILED) {
+		(void) close(fd);
+		return;
+	}
+	(void) close(fd);
+
+	if ((e = elf_memory(m, sb.st_size)) != NULL) {
+		_read_elf_symbols(ld, sp, e);
+		(void) elf_end(e);
+	}
+
+	(void) munmap(m, sb.st_size);
+}
+
+/*
+ * Read the symbol tables of the input files from 'lf' on, on a pool
+ * of threads. Symbol resolution depends on the order in which the
+ * symbols are seen, so it stays serial and only consumes the symbols
+ * read here.
+ */
+static void
+_preload_files(struct ld *ld, struct ld_file *lf)
+{
+	struct ld_symbol_preload **spv;
+	size_t cap, n;
+
+	if (ld_thread_count(ld) <= 1)
+		return;
+
+	spv = NULL;
+	cap = n = 0;
+	for (; lf != NULL; lf = TAILQ_NEXT(lf, lf_next)) {
+		if (lf->lf_preload != NULL)
+			continue;
+		if ((lf->lf_preload = calloc(1, sizeof(*lf->lf_preload))) ==
+		    NULL)
+			ld_fatal_std(ld, "calloc");
+		lf->lf_preload->sp_file = lf;
+
+		/* Archive members are read when they are extracted. */
+		if (lf->lf_type == LFT_ARCHIVE || lf->lf_type == LFT_BINARY)
+			continue;
+
+		if (n == cap) {
+			cap = cap == 0 ? 64 : cap * 2;
+			if ((spv = realloc(spv, cap * sizeof(*spv))) == NULL)
+				ld_fatal_std(ld, "realloc");
+		}
+		spv[n++] = lf->lf_preload;
+	}
+
+	ld_thread_run(ld, n, _preload_symbols, spv);
+	free(spv);
+}
+
+static void
+_free_preload_symbols(struct ld_symbol_preload *sp)
+{
+	uint64_t i;
+
+	if (sp->sp_sym == NULL)
+		return;
+
+	for (i = 0; i < sp->sp_symnum; i++)
+		_free_symbol(sp->sp_sym[i]);
+	free(sp->sp_sym);
+	sp->sp_sym = NULL;
+	sp->sp_symnum = 0;
+}
+
+static void
+_free_preload(struct ld_symbol_preload *sp)
+{
+
+	_free_preload_symbols(sp);
+	free(sp);
 }
 
 static void
@@ -33,6 +33,8 @@ struct ld_symbol {
 	uint64_t lsb_nameindex;		/* symbol name index */
 	char *lsb_ver;			/* symbol version */
 	char *lsb_longname;		/* symbol name+version (as hash key)*/
+	unsigned lsb_keylen;		/* length of the hash key */
+	unsigned lsb_hashv;		/* hash value of the hash key */
 	uint64_t lsb_size;		/* symbol size */
 	uint64_t lsb_value;		/* symbol value */
 	uint16_t lsb_shndx;		/* symbol section index */
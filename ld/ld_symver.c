@@ -554,7 +554,7 @@ _add_version_name(struct ld *ld, struct ld_input *li, int ndx,
 			ld_fatal_std(ld, "calloc");
 	}
 
-	if ((size_t) ndx >= li->li_vername_sz) {
+	while ((size_t) ndx >= li->li_vername_sz) {
 		li->li_vername = realloc(li->li_vername,
 		    sizeof(*li->li_vername) * li->li_vername_sz * 2);
 		if (li->li_vername == NULL)
@@ -0,0 +1,138 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "ld.h"
+#include "ld_thread.h"
+
+#if	ELFTC_HAVE_PTHREADS
+#include <pthread.h>
+#endif
+
+ELFTC_VCSID("$Id$");
+
+struct ld_thread_job {
+	struct ld *tj_ld;		/* linker context */
+	ld_thread_func tj_func;		/* work function */
+	void *tj_arg;			/* argument of 'tj_func' */
+	size_t tj_cnt;			/* number of work items */
+	size_t tj_next;			/* next work item */
+#if	ELFTC_HAVE_PTHREADS
+	pthread_mutex_t tj_lock;	/* protects 'tj_next' */
+#endif
+};
+
+static void *
+_worker(void *arg)
+{
+	struct ld_thread_job *tj;
+	size_t i;
+
+	tj = arg;
+
+	for (;;) {
+#if	ELFTC_HAVE_PTHREADS
+		(void) pthread_mutex_lock(&tj->tj_lock);
+#endif
+		i = tj->tj_next++;
+#if	ELFTC_HAVE_PTHREADS
+		(void) pthread_mutex_unlock(&tj->tj_lock);
+#endif
+		if (i >= tj->tj_cnt)
+			break;
+
+		tj->tj_func(tj->tj_ld, tj->tj_arg, i);
+	}
+
+	return (NULL);
+}
+
+/*
+ * Return the number of threads to run parallel work on.
+ */
+unsigned
+ld_thread_count(struct ld *ld)
+{
+	long n;
+
+	if (ld->ld_threads > 0)
+		return (ld->ld_threads);
+
+	if ((n = sysconf(_SC_NPROCESSORS_ONLN)) < 1)
+		n = 1;
+
+	return ((unsigned) n);
+}
+
+/*
+ * Call 'func' for each of the 'cnt' work items, in no particular order,
+ * on a pool of threads.  The calling thread takes part in the work and
+ * returns when all the items are done.
+ */
+void
+ld_thread_run(struct ld *ld, size_t cnt, ld_thread_func func, void *arg)
+{
+	struct ld_thread_job tj;
+#if	ELFTC_HAVE_PTHREADS
+	pthread_t *th;
+	size_t n, nthreads;
+#endif
+
+	tj.tj_ld = ld;
+	tj.tj_func = func;
+	tj.tj_arg = arg;
+	tj.tj_cnt = cnt;
+	tj.tj_next = 0;
+
+#if	ELFTC_HAVE_PTHREADS
+	if (pthread_mutex_init(&tj.tj_lock, NULL) != 0)
+		ld_fatal(ld, "pthread_mutex_init failed");
+
+	nthreads = ld_thread_count(ld);
+	if (nthreads > cnt)
+		nthreads = cnt;
+
+	th = NULL;
+	n = 0;
+	if (nthreads > 1) {
+		if ((th = calloc(nthreads - 1, sizeof(*th))) == NULL)
+			ld_fatal_std(ld, "calloc");
+		for (; n < nthreads - 1; n++)
+			if (pthread_create(&th[n], NULL, _worker, &tj) != 0)
+				break;
+	}
+
+	/* The calling thread helps, or does the work alone. */
+	(void) _worker(&tj);
+
+	while (n > 0)
+		(void) pthread_join(th[--n], NULL);
+	free(th);
+
+	(void) pthread_mutex_destroy(&tj.tj_lock);
+#else
+	(void) _worker(&tj);
+#endif
+}
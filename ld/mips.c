@@ -87,8 +87,8 @@ _process_reloc(struct ld *ld, struct ld_input_section *is,
 {
 	struct ld_output *lo = ld->ld_output;
 	uint32_t pc, s;
+	uint64_t gp;
 	int32_t a, v, la;
-	static uint64_t gp;
 	static char gp_name[] = "_gp";
 
 	assert(lo != NULL);
@@ -124,7 +124,7 @@ _process_reloc(struct ld *ld, struct ld_input_section *is,
 
 	case R_MIPS_GPREL16:
 		/* GP-relative byte address at lower 16 bits. */
-		if (! gp && ld_symbols_get_value(ld, gp_name, &gp) < 0)
+		if (ld_symbols_get_value(ld, gp_name, &gp) < 0)
 			ld_fatal(ld, "symbol _gp is undefined");
 
 		s += (int16_t)(a & 0xffff) - gp;
@@ -44,6 +44,10 @@
 
 #include "_elftc.h"
 
+#if	ELFTC_HAVE_PTHREADS
+#include <pthread.h>
+#endif
+
 #define DWARF_DIE_HASH_SIZE		8191
 
 struct _libdwarf_globals {
@@ -61,6 +65,26 @@ extern struct _libdwarf_globals _libdwarf;
 #define	DWARF_SET_ELF_ERROR(_d, _e)					\
 	_DWARF_SET_ERROR(_d, _e, DW_DLE_ELF, elf_errno())
 
+/*
+ * A consumer Dwarf_Debug may be shared between threads that walk
+ * different units.  State built lazily for the whole debug instance
+ * (the unit tables, range lists and the PC lookup table) is guarded by
+ * the instance lock, state hanging off a unit (abbreviations, DIEs,
+ * decoded attributes and line information) by the lock of the unit.
+ * The instance lock is taken before any unit lock.
+ */
+#if	ELFTC_HAVE_PTHREADS
+#define	DWARF_LOCK(D)		(void) pthread_mutex_lock(&(D)->dbg_lock)
+#define	DWARF_UNLOCK(D)		(void) pthread_mutex_unlock(&(D)->dbg_lock)
+#define	DWARF_CU_LOCK(C)	(void) pthread_mutex_lock(&(C)->cu_lock)
+#define	DWARF_CU_UNLOCK(C)	(void) pthread_mutex_unlock(&(C)->cu_lock)
+#else
+#define	DWARF_LOCK(D)		do { } while (0)
+#define	DWARF_UNLOCK(D)		do { } while (0)
+#define	DWARF_CU_LOCK(C)	do { } while (0)
+#define	DWARF_CU_UNLOCK(C)	do { } while (0)
+#endif
+
 /*
  * Convenient macros for producer bytes stream generation.
  */
@@ -91,10 +115,28 @@ extern struct _libdwarf_globals _libdwarf;
 
 typedef struct _Dwarf_CU *Dwarf_CU;
 
+/*
+ * Arena for DIEs, attributes and line rows; see libdwarf_arena.c.
+ * Objects up to _DWARF_ARENA_MAXSIZE bytes are served from chunks,
+ * with one free list per _DWARF_ARENA_ALIGN sized class.
+ */
+#define	_DWARF_ARENA_ALIGN	16
+#define	_DWARF_ARENA_MAXSIZE	256
+
+typedef struct _Dwarf_Arena {
+	struct _Dwarf_ArenaChunk *ar_chunk; /* Chunks, newest first. */
+	char		*ar_cur;	/* Next free byte in newest chunk. */
+	size_t		ar_avail;	/* Bytes left in newest chunk. */
+	void		*ar_free[_DWARF_ARENA_MAXSIZE / _DWARF_ARENA_ALIGN];
+					/* Free lists by size class. */
+} Dwarf_Arena;
+
 struct _Dwarf_AttrDef {
 	Dwarf_Half	ad_attrib;		/* DW_AT_XXX */
 	Dwarf_Half	ad_form;		/* DW_FORM_XXX */
 	uint64_t	ad_offset;		/* Offset in abbrev section. */
+	int64_t		ad_const;		/* DW_FORM_implicit_const. */
+	int64_t		ad_fixoff;		/* Value offset in DIE or -1. */
 	STAILQ_ENTRY(_Dwarf_AttrDef) ad_next;	/* Next attribute define. */
 };
 
@@ -126,6 +168,7 @@ struct _Dwarf_Abbrev {
 	uint64_t	ab_offset;	/* Offset in abbrev section. */
 	uint64_t	ab_length;	/* Length of this abbrev entry. */
 	uint64_t	ab_atnum;	/* Number of attribute defines. */
+	int64_t		ab_fixsize;	/* Size of attribute values or -1. */
 	UT_hash_handle	ab_hh;		/* Uthash handle. */
 	STAILQ_HEAD(, _Dwarf_AttrDef) ab_attrdef; /* List of attribute defs. */
 };
@@ -137,6 +180,7 @@ struct _Dwarf_Die {
 	Dwarf_Die	die_right;	/* Right sibling DIE. */
 	uint64_t	die_offset;	/* DIE offset in section. */
 	uint64_t	die_next_off;	/* Next DIE offset in section. */
+	uint64_t	die_attr_off;	/* Offset of attribute values. */
 	uint64_t	die_abnum;	/* Abbrev number. */
 	Dwarf_Abbrev	die_ab;		/* Abbrev pointer. */
 	Dwarf_Tag	die_tag;	/* DW_TAG_ */
@@ -144,6 +188,9 @@ struct _Dwarf_Die {
 	Dwarf_CU	die_cu;		/* Compilation unit pointer. */
 	char		*die_name;	/* Ptr to the name string. */
 	Dwarf_Attribute	*die_attrarray;	/* Array of attributes. */
+	int		die_cached;	/* Owned by the unit's DIE cache. */
+	int		die_lazy;	/* Attributes decoded on demand. */
+	LIST_ENTRY(_Dwarf_Die) die_cu_next; /* Next live DIE of the unit. */
 	STAILQ_HEAD(, _Dwarf_Attribute)	die_attr; /* List of attributes. */
 	STAILQ_ENTRY(_Dwarf_Die) die_pro_next; /* Next die in pro-die list. */
 };
@@ -204,6 +251,7 @@ struct _Dwarf_LineInfo {
 	Dwarf_Line	*li_lnarray;	/* Array of lines. */
 	Dwarf_Unsigned	li_lnlen;	/* Length of the line array. */
 	STAILQ_HEAD(, _Dwarf_Line) li_lnlist; /* List of lines. */
+	Dwarf_Arena	li_arena;	/* Storage of the lines. */
 };
 
 struct _Dwarf_NamePair {
@@ -230,6 +278,63 @@ struct _Dwarf_NameSec {
 	Dwarf_Unsigned	ns_len;		/* Length of the pair array. */
 };
 
+/* A name index of a .debug_names section. */
+typedef struct {
+	Dwarf_Unsigned	nu_cu_cnt;	/* Number of CUs. */
+	Dwarf_Unsigned	nu_ltu_cnt;	/* Number of local TUs. */
+	Dwarf_Unsigned	nu_bucket_cnt;	/* Number of hash buckets. */
+	Dwarf_Unsigned	nu_name_cnt;	/* Number of names. */
+	uint64_t	nu_cu_off;	/* Offset of the CU and TU lists. */
+	uint64_t	nu_bucket_off;	/* Offset of the hash buckets. */
+	uint64_t	nu_hash_off;	/* Offset of the hash values. */
+	uint64_t	nu_str_off;	/* Offset of the name string offsets. */
+	uint64_t	nu_entry_off;	/* Offset of the name entry offsets. */
+	uint64_t	nu_abbrev_off;	/* Offset of the abbreviation table. */
+	uint64_t	nu_pool_off;	/* Offset of the entry pool. */
+	uint64_t	nu_end;		/* End of the name index. */
+	int		nu_offset_size;	/* Size of section offsets. */
+} Dwarf_NameUnit;
+
+/* An entry of the name index built from the DIEs. */
+typedef struct _Dwarf_NameIdx {
+	uint32_t	ni_hash;	/* Hash of the name. */
+	const char	*ni_name;	/* Name of the DIEs. */
+	Dwarf_Off	*ni_off;	/* Offsets of the DIEs. */
+	Dwarf_Unsigned	ni_cnt;		/* Length of the offset array. */
+	Dwarf_Unsigned	ni_cap;		/* Capacity of the offset array. */
+	struct _Dwarf_NameIdx *ni_next; /* Next name with the same hash. */
+	UT_hash_handle	ni_hh;		/* Uthash handle. */
+} *Dwarf_NameIdx;
+
+/*
+ * The register rule table of an FDE, compiled into rows.  Each row
+ * holds the rules in effect below its end PC.  The rules of a row are
+ * those of the initial table, updated by the first 'fr_dend' column
+ * changes of the compiled table.
+ */
+typedef struct _Dwarf_FrameDelta {
+	Dwarf_Half	fd_col;		/* Column changed. */
+	Dwarf_Regtable_Entry3 fd_rule;	/* New rule of the column. */
+} Dwarf_FrameDelta;
+
+typedef struct _Dwarf_FrameRow {
+	Dwarf_Addr	fr_endpc;	/* End PC (exclusive). */
+	Dwarf_Addr	fr_rowpc;	/* PC of the last rule change. */
+	Dwarf_Unsigned	fr_dend;	/* Number of changes to apply. */
+} Dwarf_FrameRow;
+
+typedef struct _Dwarf_FrameTable {
+	Dwarf_FrameRow	*ft_row;	/* Array of rows. */
+	Dwarf_Unsigned	ft_rowcnt;	/* Length of row array. */
+	Dwarf_Unsigned	ft_rowcap;	/* Capacity of row array. */
+	Dwarf_FrameDelta *ft_delta;	/* Array of column changes. */
+	Dwarf_Unsigned	ft_deltacnt;	/* Length of change array. */
+	Dwarf_Unsigned	ft_deltacap;	/* Capacity of change array. */
+	Dwarf_Regtable3	*ft_last;	/* Rules of the last row built. */
+	Dwarf_Unsigned	ft_gen;		/* Frame parameters generation. */
+	int		ft_bad;		/* Instructions must be run. */
+} *Dwarf_FrameTable;
+
 struct _Dwarf_Fde {
 	Dwarf_Debug	fde_dbg;	/* Ptr to containing dbg. */
 	Dwarf_Cie	fde_cie;	/* Ptr to associated CIE. */
@@ -248,6 +353,7 @@ struct _Dwarf_Fde {
 	Dwarf_Unsigned	fde_symndx;	/* Symbol index for relocation. */
 	Dwarf_Unsigned	fde_esymndx;	/* End symbol index for relocation. */
 	Dwarf_Addr	fde_eoff;	/* Offset from the end symbol. */
+	Dwarf_FrameTable fde_table;	/* Compiled register rule table. */
 	STAILQ_ENTRY(_Dwarf_Fde) fde_next; /* Next FDE in list. */
 };
 
@@ -272,6 +378,24 @@ struct _Dwarf_Cie {
 	STAILQ_ENTRY(_Dwarf_Cie) cie_next;  /* Next CIE in list. */
 };
 
+/*
+ * A sorted table of non-overlapping PC intervals, used to map a PC to
+ * the CU, arange or FDE covering it by binary search.
+ */
+typedef struct _Dwarf_PcRange {
+	Dwarf_Unsigned	pr_lopc;	/* Start PC. */
+	Dwarf_Unsigned	pr_hipc;	/* End PC (exclusive). */
+	Dwarf_Unsigned	pr_seq;		/* Insertion order. */
+	void		*pr_obj;	/* Object covering the interval. */
+} Dwarf_PcRange;
+
+typedef struct _Dwarf_PcMap {
+	Dwarf_PcRange	*pm_range;	/* Array of intervals. */
+	Dwarf_Unsigned	pm_cnt;		/* Length of interval array. */
+	Dwarf_Unsigned	pm_cap;		/* Capacity of interval array. */
+	int		pm_sorted;	/* Array sorted and merged. */
+} Dwarf_PcMap;
+
 struct _Dwarf_FrameSec {
 	STAILQ_HEAD(, _Dwarf_Cie) fs_cielist; /* List of CIE. */
 	STAILQ_HEAD(, _Dwarf_Fde) fs_fdelist; /* List of FDE. */
@@ -279,6 +403,7 @@ struct _Dwarf_FrameSec {
 	Dwarf_Unsigned	fs_cielen;	/* Length of CIE array. */
 	Dwarf_Fde	*fs_fdearray;	/* Array of FDE.*/
 	Dwarf_Unsigned	fs_fdelen;	/* Length of FDE array. */
+	Dwarf_PcMap	fs_pcmap;	/* FDE lookup by PC. */
 };
 
 struct _Dwarf_Arange {
@@ -308,14 +433,32 @@ struct _Dwarf_MacroSet {
 	STAILQ_ENTRY(_Dwarf_MacroSet) ms_next; /* Next set in list. */
 };
 
+/*
+ * Hash key of a parsed range or location list.  'lk_cu' is the unit
+ * the list was parsed for, or NULL for a pre-DWARF5 range list, which
+ * reads the same from every unit.
+ */
+typedef struct {
+	Dwarf_Unsigned	lk_offset;	/* Offset of the list. */
+	Dwarf_CU	lk_cu;		/* Ptr to associated DWARF5 CU. */
+} Dwarf_ListKey;
+
 struct _Dwarf_Rangelist {
-	Dwarf_CU	rl_cu;		/* Ptr to associated CU. */
-	Dwarf_Unsigned	rl_offset;	/* Offset of the rangelist. */
+	Dwarf_ListKey	rl_key;		/* Hash key. */
 	Dwarf_Ranges	*rl_rgarray;	/* Array of ranges. */
 	Dwarf_Unsigned	rl_rglen;	/* Length of the ranges array. */
-	STAILQ_ENTRY(_Dwarf_Rangelist) rl_next; /* Next rangelist in list. */
+	UT_hash_handle	rl_hh;		/* Uthash handle. */
 };
 
+typedef struct _Dwarf_Loclist {
+	Dwarf_ListKey	ll_key;		/* Hash key. */
+	Dwarf_Locdesc	*ll_ldarray;	/* Array of location descriptions. */
+	Dwarf_Signed	ll_ldlen;	/* Length of the array. */
+	Dwarf_Signed	ll_ldcap;	/* Capacity of the array. */
+	Dwarf_Unsigned	ll_len;		/* Size of the list in its section. */
+	UT_hash_handle	ll_hh;		/* Uthash handle. */
+} *Dwarf_Loclist;
+
 struct _Dwarf_CU {
 	Dwarf_Debug	cu_dbg;		/* Ptr to containing dbg. */
 	Dwarf_Off	cu_offset;	/* Offset to the this CU. */
@@ -329,6 +472,8 @@ struct _Dwarf_CU {
 	uint64_t	cu_lineno_offset; /* Offset into .debug_lineno. */
 	uint8_t		cu_pointer_size;/* Number of bytes in pointer. */
 	uint8_t		cu_dwarf_size;	/* CU section dwarf size. */
+	uint8_t		cu_unit_type;	/* DWARF5 unit type: DW_UT_XXX */
+	uint64_t	cu_dwo_id;	/* Split unit id. */
 	Dwarf_Sig8	cu_type_sig;	/* Type unit's signature. */
 	uint64_t	cu_type_offset; /* Type unit's type offset. */
 	Dwarf_Off	cu_next_offset; /* Offset to the next CU. */
@@ -337,6 +482,21 @@ struct _Dwarf_CU {
 	Dwarf_LineInfo	cu_lineinfo;	/* Ptr to Dwarf_LineInfo. */
 	Dwarf_Abbrev	cu_abbrev_hash; /* Abbrev hash table. */
 	Dwarf_Bool	cu_is_info;	/* Compilation/type unit flag. */
+	int		cu_bases_loaded; /* DWARF5 section bases known. */
+	uint64_t	cu_str_offsets_base; /* DW_AT_str_offsets_base. */
+	uint64_t	cu_addr_base;	/* DW_AT_addr_base. */
+	uint64_t	cu_rnglists_base; /* DW_AT_rnglists_base. */
+	uint64_t	cu_loclists_base; /* DW_AT_loclists_base. */
+	Dwarf_Addr	cu_lowpc;	/* Base address of the unit. */
+	int		cu_has_arange;	/* Covered by .debug_aranges. */
+	uint64_t	*cu_die_off;	/* Sorted offsets of all DIEs. */
+	Dwarf_Die	*cu_die_cache;	/* DIEs materialized by offset. */
+	uint64_t	cu_die_cnt;	/* Number of DIEs in the unit. */
+	Dwarf_Arena	cu_arena;	/* Storage of DIEs and attributes. */
+	LIST_HEAD(, _Dwarf_Die) cu_die_live; /* DIEs not yet freed. */
+#if	ELFTC_HAVE_PTHREADS
+	pthread_mutex_t	cu_lock;	/* Protects lazily loaded state. */
+#endif
 	STAILQ_ENTRY(_Dwarf_CU) cu_next; /* Next compilation unit. */
 };
 
@@ -345,6 +505,7 @@ typedef struct _Dwarf_Section {
 	Dwarf_Small	*ds_data;	/* Section data. */
 	Dwarf_Unsigned	ds_addr;	/* Section virtual addr. */
 	Dwarf_Unsigned	ds_size;	/* Section size. */
+	int		ds_loaded;	/* Data fetched from the object. */
 } Dwarf_Section;
 
 typedef struct _Dwarf_P_Section {
@@ -381,15 +542,20 @@ typedef struct _Dwarf_Rel_Section {
 typedef struct {
 	Elf_Data *ed_data;
 	void *ed_alloc;
+	size_t ed_ndx;		/* ELF section index. */
+	size_t ed_relndx;	/* Index of the relocation section or 0. */
+	int ed_loaded;		/* Data read and relocated. */
 } Dwarf_Elf_Data;
 
 typedef struct {
+	Dwarf_Debug	eo_dbg;
 	Elf		*eo_elf;
 	GElf_Ehdr	eo_ehdr;
 	GElf_Shdr	*eo_shdr;
 	Dwarf_Elf_Data	*eo_data;
 	Dwarf_Unsigned	eo_seccnt;
 	size_t		eo_strndx;
+	size_t		eo_symtab;	/* Index of .symtab or 0. */
 	Dwarf_Obj_Access_Methods eo_methods;
 } Dwarf_Elf_Object;
 
@@ -400,6 +566,11 @@ struct _Dwarf_Debug {
 	Dwarf_Off	dbg_info_off;	/* Current info section offset. */
 	Dwarf_Section	*dbg_types_sec; /* Pointer to type section. */
 	Dwarf_Off	dbg_types_off;	/* Current types section offset. */
+	Dwarf_Section	*dbg_str_offsets_sec; /* DWARF5 string offsets. */
+	Dwarf_Section	*dbg_addr_sec;	/* DWARF5 address table. */
+	Dwarf_Section	*dbg_line_str_sec; /* DWARF5 line strings. */
+	Dwarf_Section	*dbg_rnglists_sec; /* DWARF5 range lists. */
+	Dwarf_Section	*dbg_loclists_sec; /* DWARF5 location lists. */
 	Dwarf_Unsigned	dbg_seccnt;	/* Total number of dwarf sections. */
 	int		dbg_mode;	/* Access mode. */
 	int		dbg_pointer_size; /* Object address size. */
@@ -413,22 +584,35 @@ struct _Dwarf_Debug {
 	STAILQ_HEAD(, _Dwarf_CU) dbg_tu;/* List of type units. */
 	Dwarf_CU	dbg_cu_current; /* Ptr to the current CU. */
 	Dwarf_CU	dbg_tu_current; /* Ptr to the current TU. */
+	Dwarf_CU	*dbg_cu_array;	/* CUs sorted by offset. */
+	Dwarf_Unsigned	dbg_cu_cnt;	/* Length of the CU array. */
+	Dwarf_CU	*dbg_tu_array;	/* TUs sorted by offset. */
+	Dwarf_Unsigned	dbg_tu_cnt;	/* Length of the TU array. */
+	Dwarf_Unit_Header *dbg_cu_hdr;	/* Headers of the CUs. */
+	Dwarf_Unit_Header *dbg_tu_hdr;	/* Headers of the TUs. */
 	Dwarf_NameSec	dbg_globals;	/* Ptr to pubnames lookup section. */
 	Dwarf_NameSec	dbg_pubtypes;	/* Ptr to pubtypes lookup section. */
 	Dwarf_NameSec	dbg_weaks;	/* Ptr to weaknames lookup section. */
 	Dwarf_NameSec	dbg_funcs;	/* Ptr to static funcs lookup sect. */
 	Dwarf_NameSec	dbg_vars;	/* Ptr to static vars lookup sect. */
 	Dwarf_NameSec	dbg_types;	/* Ptr to types lookup section. */
+	int		dbg_names_src;	/* Source of name lookups. */
+	Dwarf_NameUnit	*dbg_nu_array;	/* Name indexes of .debug_names. */
+	Dwarf_Unsigned	dbg_nu_cnt;	/* Length of the name index array. */
+	Dwarf_NameIdx	dbg_ni_hash;	/* Name index built from the DIEs. */
 	Dwarf_FrameSec	dbg_frame;	/* Ptr to .debug_frame section. */
 	Dwarf_FrameSec	dbg_eh_frame;	/* Ptr to .eh_frame section. */
 	STAILQ_HEAD(, _Dwarf_ArangeSet) dbg_aslist; /* List of arange set. */
 	Dwarf_Arange	*dbg_arange_array; /* Array of arange. */
 	Dwarf_Unsigned	dbg_arange_cnt;	/* Length of the arange array. */
+	Dwarf_PcMap	dbg_arange_pcmap; /* Arange lookup by PC. */
+	Dwarf_PcMap	dbg_cu_pcmap;	/* CU lookup by PC. */
 	char		*dbg_strtab;	/* Dwarf string table. */
 	Dwarf_Unsigned	dbg_strtab_cap; /* Dwarf string table capacity. */
 	Dwarf_Unsigned	dbg_strtab_size; /* Dwarf string table size. */
 	STAILQ_HEAD(, _Dwarf_MacroSet) dbg_mslist; /* List of macro set. */
-	STAILQ_HEAD(, _Dwarf_Rangelist) dbg_rllist; /* List of rangelist. */
+	Dwarf_Rangelist	dbg_rlhash;	/* Hash of parsed rangelists. */
+	Dwarf_Loclist	dbg_llhash;	/* Hash of parsed loclists. */
 	uint64_t	(*read)(uint8_t *, uint64_t *, int);
 	void		(*write)(uint8_t *, uint64_t *, uint64_t, int);
 	int		(*write_alloc)(uint8_t **, uint64_t *, uint64_t *,
@@ -440,9 +624,15 @@ struct _Dwarf_Debug {
 	Dwarf_Half	dbg_frame_cfa_value;
 	Dwarf_Half	dbg_frame_same_value;
 	Dwarf_Half	dbg_frame_undefined_value;
+	Dwarf_Unsigned	dbg_frame_gen;	/* Bumped when the above change. */
 
 	Dwarf_Regtable3	*dbg_internal_reg_table;
 
+#if	ELFTC_HAVE_PTHREADS
+	pthread_mutex_t	dbg_lock;	/* Protects lazily loaded state. */
+	pthread_mutex_t	dbg_sec_lock;	/* Protects section loading. */
+#endif
+
 	/*
 	 * Fields used by libdwarf producer.
 	 */
@@ -498,21 +688,35 @@ void		_dwarf_arange_cleanup(Dwarf_Debug);
 int		_dwarf_arange_gen(Dwarf_P_Debug, Dwarf_Error *);
 int		_dwarf_arange_init(Dwarf_Debug, Dwarf_Error *);
 void		_dwarf_arange_pro_cleanup(Dwarf_P_Debug);
+void		*_dwarf_arena_alloc(Dwarf_Arena *, size_t);
+void		_dwarf_arena_cleanup(Dwarf_Arena *);
+void		_dwarf_arena_free(Dwarf_Arena *, void *, size_t);
 int		_dwarf_attr_alloc(Dwarf_Die, Dwarf_Attribute *, Dwarf_Error *);
 Dwarf_Attribute	_dwarf_attr_find(Dwarf_Die, Dwarf_Half);
+int		_dwarf_attr_form_size(Dwarf_CU, uint64_t);
 int		_dwarf_attr_gen(Dwarf_P_Debug, Dwarf_P_Section, Dwarf_Rel_Section,
 		    Dwarf_CU, Dwarf_Die, int, Dwarf_Error *);
 int		_dwarf_attr_init(Dwarf_Debug, Dwarf_Section *, uint64_t *, int,
 		    Dwarf_CU, Dwarf_Die, Dwarf_AttrDef, uint64_t, int,
 		    Dwarf_Error *);
+int		_dwarf_attr_load(Dwarf_Die, Dwarf_Error *);
+int		_dwarf_attr_lookup(Dwarf_Die, Dwarf_Half, Dwarf_Attribute *,
+		    Dwarf_Error *);
+int		_dwarf_attr_resolve(Dwarf_Debug, Dwarf_CU, Dwarf_Attribute,
+		    Dwarf_Error *);
+int		_dwarf_attr_skip(Dwarf_Debug, Dwarf_Section *, uint64_t *,
+		    Dwarf_CU, uint64_t, Dwarf_Error *);
 int		_dwarf_attrdef_add(Dwarf_Debug, Dwarf_Abbrev, uint64_t,
-		    uint64_t, uint64_t, Dwarf_AttrDef *, Dwarf_Error *);
+		    uint64_t, uint64_t, int64_t, Dwarf_AttrDef *,
+		    Dwarf_Error *);
 uint64_t	_dwarf_decode_lsb(uint8_t **, int);
 uint64_t	_dwarf_decode_msb(uint8_t **, int);
 int64_t		_dwarf_decode_sleb128(uint8_t **);
 uint64_t	_dwarf_decode_uleb128(uint8_t **);
 void		_dwarf_deinit(Dwarf_Debug);
-int		_dwarf_die_alloc(Dwarf_Debug, Dwarf_Die *, Dwarf_Error *);
+int		_dwarf_die_alloc(Dwarf_Debug, Dwarf_CU, Dwarf_Die *,
+		    Dwarf_Error *);
+void		_dwarf_die_cache_cleanup(Dwarf_CU);
 int		_dwarf_die_count_links(Dwarf_P_Die, Dwarf_P_Die,
 		    Dwarf_P_Die, Dwarf_P_Die);
 Dwarf_Die	_dwarf_die_find(Dwarf_Die, Dwarf_Unsigned);
@@ -520,6 +724,9 @@ int		_dwarf_die_gen(Dwarf_P_Debug, Dwarf_CU, Dwarf_Rel_Section,
 		    Dwarf_Error *);
 void		_dwarf_die_link(Dwarf_P_Die, Dwarf_P_Die, Dwarf_P_Die,
 		    Dwarf_P_Die, Dwarf_P_Die);
+int		_dwarf_die_load_bases(Dwarf_Debug, Dwarf_CU, Dwarf_Error *);
+int		_dwarf_die_lookup(Dwarf_Debug, Dwarf_CU, uint64_t, Dwarf_Die *,
+		    Dwarf_Error *);
 int		_dwarf_die_parse(Dwarf_Debug, Dwarf_Section *, Dwarf_CU, int,
 		    uint64_t, uint64_t, Dwarf_Die *, int, Dwarf_Error *);
 void		_dwarf_die_pro_cleanup(Dwarf_P_Debug);
@@ -527,6 +734,7 @@ void		_dwarf_elf_deinit(Dwarf_Debug);
 int		_dwarf_elf_init(Dwarf_Debug, Elf *, Dwarf_Error *);
 int		_dwarf_elf_load_section(void *, Dwarf_Half, Dwarf_Small **,
 		    int *);
+int		_dwarf_elf_relocate(Dwarf_Elf_Object *, Dwarf_Elf_Data *);
 Dwarf_Endianness _dwarf_elf_get_byte_order(void *);
 Dwarf_Small	_dwarf_elf_get_length_size(void *);
 Dwarf_Small	_dwarf_elf_get_pointer_size(void *);
@@ -557,14 +765,19 @@ int		_dwarf_generate_sections(Dwarf_P_Debug, Dwarf_Error *);
 Dwarf_Unsigned	_dwarf_get_reloc_type(Dwarf_P_Debug, int);
 int		_dwarf_get_reloc_size(Dwarf_Debug, Dwarf_Unsigned);
 void		_dwarf_info_cleanup(Dwarf_Debug);
+int		_dwarf_info_find_cu(Dwarf_Debug, Dwarf_Bool, uint64_t,
+		    Dwarf_CU *, Dwarf_Error *);
 int		_dwarf_info_first_cu(Dwarf_Debug, Dwarf_Error *);
 int		_dwarf_info_first_tu(Dwarf_Debug, Dwarf_Error *);
 int		_dwarf_info_gen(Dwarf_P_Debug, Dwarf_Error *);
+int		_dwarf_info_headers(Dwarf_Debug, Dwarf_Bool,
+		    Dwarf_Unit_Header **, Dwarf_Unsigned *, Dwarf_Error *);
 int		_dwarf_info_load(Dwarf_Debug, Dwarf_Bool, Dwarf_Bool,
 		    Dwarf_Error *);
 int		_dwarf_info_next_cu(Dwarf_Debug, Dwarf_Error *);
 int		_dwarf_info_next_tu(Dwarf_Debug, Dwarf_Error *);
 void		_dwarf_info_pro_cleanup(Dwarf_P_Debug);
+void		_dwarf_info_release(Dwarf_CU);
 int		_dwarf_init(Dwarf_Debug, Dwarf_Unsigned, Dwarf_Handler,
 		    Dwarf_Ptr, Dwarf_Error *);
 int		_dwarf_lineno_gen(Dwarf_P_Debug, Dwarf_Error *);
@@ -581,16 +794,29 @@ int		_dwarf_loc_add(Dwarf_Die, Dwarf_Attribute, Dwarf_Error *);
 int		_dwarf_loc_expr_add_atom(Dwarf_Debug, uint8_t *, uint8_t *,
 		    Dwarf_Small, Dwarf_Unsigned, Dwarf_Unsigned, int *,
 		    Dwarf_Error *);
+void		_dwarf_loclist_cleanup(Dwarf_Debug);
 int		_dwarf_loclist_find(Dwarf_Debug, Dwarf_CU, uint64_t,
-		    Dwarf_Locdesc ***, Dwarf_Signed *, Dwarf_Unsigned *,
-		    Dwarf_Error *);
+		    Dwarf_Loclist *, Dwarf_Error *);
+#if	ELFTC_HAVE_PTHREADS
+int		_dwarf_lock_init(pthread_mutex_t *);
+#endif
 void		_dwarf_macinfo_cleanup(Dwarf_Debug);
+int		_dwarf_pcmap_add(Dwarf_Debug, Dwarf_PcMap *, Dwarf_Unsigned,
+		    Dwarf_Unsigned, void *, Dwarf_Error *);
+void		_dwarf_pcmap_cleanup(Dwarf_PcMap *);
+int		_dwarf_pcmap_cu_init(Dwarf_Debug, Dwarf_Error *);
+Dwarf_PcRange	*_dwarf_pcmap_find(Dwarf_PcMap *, Dwarf_Unsigned);
+void		_dwarf_pcmap_sort(Dwarf_PcMap *);
 int		_dwarf_macinfo_gen(Dwarf_P_Debug, Dwarf_Error *);
 int		_dwarf_macinfo_init(Dwarf_Debug, Dwarf_Error *);
 void		_dwarf_macinfo_pro_cleanup(Dwarf_P_Debug);
 int		_dwarf_nametbl_init(Dwarf_Debug, Dwarf_NameSec *,
 		    Dwarf_Section *, Dwarf_Error *);
 void		_dwarf_nametbl_cleanup(Dwarf_NameSec *);
+int		_dwarf_names_build(Dwarf_Debug, int, Dwarf_Error *);
+void		_dwarf_names_cleanup(Dwarf_Debug);
+int		_dwarf_names_lookup(Dwarf_Debug, const char *, Dwarf_Off **,
+		    Dwarf_Unsigned *, Dwarf_Error *);
 int		_dwarf_nametbl_gen(Dwarf_P_Debug, const char *, Dwarf_NameTbl,
 		    Dwarf_Error *);
 void		_dwarf_nametbl_pro_cleanup(Dwarf_NameTbl *);
@@ -601,7 +827,8 @@ Dwarf_P_Section	_dwarf_pro_find_section(Dwarf_P_Debug, const char *);
 int		_dwarf_ranges_add(Dwarf_Debug, Dwarf_CU, uint64_t,
 		    Dwarf_Rangelist *, Dwarf_Error *);
 void		_dwarf_ranges_cleanup(Dwarf_Debug);
-int		_dwarf_ranges_find(Dwarf_Debug, uint64_t, Dwarf_Rangelist *);
+int		_dwarf_ranges_find(Dwarf_Debug, Dwarf_CU, uint64_t,
+		    Dwarf_Rangelist *);
 uint64_t	_dwarf_read_lsb(uint8_t *, uint64_t *, int);
 uint64_t	_dwarf_read_msb(uint8_t *, uint64_t *, int);
 int64_t		_dwarf_read_sleb128(uint8_t *, uint64_t *);
@@ -632,6 +859,7 @@ int		_dwarf_section_callback(Dwarf_P_Debug, Dwarf_P_Section,
 void		_dwarf_section_free(Dwarf_P_Debug, Dwarf_P_Section *);
 int		_dwarf_section_init(Dwarf_P_Debug, Dwarf_P_Section *,
 		    const char *, int, Dwarf_Error *);
+int		_dwarf_section_load(Dwarf_Debug, Dwarf_Section *);
 void		_dwarf_set_error(Dwarf_Debug, Dwarf_Error *, int, int,
 		    const char *, int);
 int		_dwarf_strtab_add(Dwarf_Debug, char *, uint64_t *,
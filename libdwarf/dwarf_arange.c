@@ -61,6 +61,8 @@ dwarf_get_arange(Dwarf_Arange *arlist, Dwarf_Unsigned arange_cnt,
 {
 	Dwarf_Arange ar;
 	Dwarf_Debug dbg;
+	Dwarf_PcMap *pm;
+	Dwarf_PcRange *pr;
 	int i;
 
 	if (arlist == NULL) {
@@ -75,6 +77,33 @@ dwarf_get_arange(Dwarf_Arange *arlist, Dwarf_Unsigned arange_cnt,
 		return (DW_DLV_ERROR);
 	}
 
+	/*
+	 * The array returned by dwarf_get_aranges() is searched through
+	 * a PC-sorted index, built on first use.
+	 */
+	if (arlist == dbg->dbg_arange_array &&
+	    arange_cnt == dbg->dbg_arange_cnt) {
+		pm = &dbg->dbg_arange_pcmap;
+		if (!pm->pm_sorted) {
+			for (i = 0; (Dwarf_Unsigned)i < arange_cnt; i++) {
+				ar = arlist[i];
+				if (_dwarf_pcmap_add(dbg, pm, ar->ar_address,
+				    ar->ar_address + ar->ar_range, ar, error) !=
+				    DW_DLE_NONE) {
+					_dwarf_pcmap_cleanup(pm);
+					return (DW_DLV_ERROR);
+				}
+			}
+			_dwarf_pcmap_sort(pm);
+		}
+		if ((pr = _dwarf_pcmap_find(pm, addr)) != NULL) {
+			*ret_arange = pr->pr_obj;
+			return (DW_DLV_OK);
+		}
+		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
+		return (DW_DLV_NO_ENTRY);
+	}
+
 	for (i = 0; (Dwarf_Unsigned)i < arange_cnt; i++) {
 		ar = arlist[i];
 		if (addr >= ar->ar_address && addr < ar->ar_address +
@@ -116,6 +145,42 @@ dwarf_get_cu_die_offset(Dwarf_Arange ar, Dwarf_Off *ret_offset,
 	return (DW_DLV_OK);
 }
 
+int
+dwarf_get_cu_die_offset_given_pc(Dwarf_Debug dbg, Dwarf_Addr pc,
+    Dwarf_Off *ret_offset, Dwarf_Addr *lopc, Dwarf_Addr *hipc,
+    Dwarf_Error *error)
+{
+	Dwarf_CU cu;
+	Dwarf_PcRange *pr;
+	int ret;
+
+	if (dbg == NULL || ret_offset == NULL) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_ARGUMENT);
+		return (DW_DLV_ERROR);
+	}
+
+	ret = _dwarf_pcmap_cu_init(dbg, error);
+	if (ret == DW_DLE_NO_ENTRY) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
+		return (DW_DLV_NO_ENTRY);
+	} else if (ret != DW_DLE_NONE)
+		return (DW_DLV_ERROR);
+
+	if ((pr = _dwarf_pcmap_find(&dbg->dbg_cu_pcmap, pc)) == NULL) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
+		return (DW_DLV_NO_ENTRY);
+	}
+
+	cu = pr->pr_obj;
+	*ret_offset = cu->cu_1st_offset;
+	if (lopc != NULL)
+		*lopc = pr->pr_lopc;
+	if (hipc != NULL)
+		*hipc = pr->pr_hipc - 1;
+
+	return (DW_DLV_OK);
+}
+
 int
 dwarf_get_arange_cu_header_offset(Dwarf_Arange ar, Dwarf_Off *ret_offset,
     Dwarf_Error *error)
@@ -35,6 +35,7 @@ dwarf_attr(Dwarf_Die die, Dwarf_Half attr, Dwarf_Attribute *atp,
 {
 	Dwarf_Debug dbg;
 	Dwarf_Attribute at;
+	int ret;
 
 	dbg = die != NULL ? die->die_dbg : NULL;
 
@@ -43,10 +44,12 @@ dwarf_attr(Dwarf_Die die, Dwarf_Half attr, Dwarf_Attribute *atp,
 		return (DW_DLV_ERROR);
 	}
 
-	if ((at = _dwarf_attr_find(die, attr)) == NULL) {
+	ret = _dwarf_attr_lookup(die, attr, &at, error);
+	if (ret == DW_DLE_NO_ENTRY) {
 		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
 		return (DW_DLV_NO_ENTRY);
-	}
+	} else if (ret != DW_DLE_NONE)
+		return (DW_DLV_ERROR);
 
 	*atp = at;
 
@@ -73,15 +76,25 @@ dwarf_attrlist(Dwarf_Die die, Dwarf_Attribute **attrbuf,
 		return (DW_DLV_NO_ENTRY);
 	}
 
+	/* The attribute array of a DIE shared between threads is built once. */
+	DWARF_CU_LOCK(die->die_cu);
+
+	if (_dwarf_attr_load(die, error) != DW_DLE_NONE) {
+		DWARF_CU_UNLOCK(die->die_cu);
+		return (DW_DLV_ERROR);
+	}
+
 	*attrcount = die->die_ab->ab_atnum;
 
 	if (die->die_attrarray != NULL) {
 		*attrbuf = die->die_attrarray;
+		DWARF_CU_UNLOCK(die->die_cu);
 		return (DW_DLV_OK);
 	}
 
 	if ((die->die_attrarray = malloc(*attrcount * sizeof(Dwarf_Attribute)))
 	    == NULL) {
+		DWARF_CU_UNLOCK(die->die_cu);
 		DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
 		return (DW_DLV_ERROR);
 	}
@@ -92,6 +105,8 @@ dwarf_attrlist(Dwarf_Die die, Dwarf_Attribute **attrbuf,
 
 	*attrbuf = die->die_attrarray;
 
+	DWARF_CU_UNLOCK(die->die_cu);
+
 	return (DW_DLV_OK);
 }
 
@@ -99,6 +114,7 @@ int
 dwarf_hasattr(Dwarf_Die die, Dwarf_Half attr, Dwarf_Bool *ret_bool,
     Dwarf_Error *error)
 {
+	Dwarf_AttrDef ad;
 	Dwarf_Debug dbg;
 
 	dbg = die != NULL ? die->die_dbg : NULL;
@@ -108,7 +124,18 @@ dwarf_hasattr(Dwarf_Die die, Dwarf_Half attr, Dwarf_Bool *ret_bool,
 		return (DW_DLV_ERROR);
 	}
 
-	*ret_bool = (_dwarf_attr_find(die, attr) != NULL);
+	/*
+	 * The abbreviation tells if a DIE read from a unit has the
+	 * attribute, whether the attribute is decoded yet or not.
+	 */
+	if (die->die_cu != NULL) {
+		STAILQ_FOREACH(ad, &die->die_ab->ab_attrdef, ad_next) {
+			if (ad->ad_attrib == attr)
+				break;
+		}
+		*ret_bool = (ad != NULL);
+	} else
+		*ret_bool = (_dwarf_attr_find(die, attr) != NULL);
 
 	return (DW_DLV_OK);
 }
@@ -83,6 +83,12 @@ dwarf_attrval_string(Dwarf_Die die, Dwarf_Half attr, const char **strp, Dwarf_Er
 
 	switch (at->at_form) {
 	case DW_FORM_strp:
+	case DW_FORM_line_strp:
+	case DW_FORM_strx:
+	case DW_FORM_strx1:
+	case DW_FORM_strx2:
+	case DW_FORM_strx3:
+	case DW_FORM_strx4:
 		*strp = at->u[1].s;
 		break;
 	case DW_FORM_string:
@@ -128,6 +134,7 @@ dwarf_attrval_signed(Dwarf_Die die, Dwarf_Half attr, Dwarf_Signed *valp, Dwarf_E
 		break;
 	case DW_FORM_data8:
 	case DW_FORM_sdata:
+	case DW_FORM_implicit_const:
 		*valp = at->u[0].s64;
 		break;
 	default:
@@ -172,7 +179,7 @@ dwarf_attrval_unsigned(Dwarf_Die die, Dwarf_Half attr, Dwarf_Unsigned *valp, Dwa
 		case DW_FORM_ref4:
 		case DW_FORM_ref8:
 		case DW_FORM_ref_udata:
-			val = at->u[0].u64;
+			val = at->u[0].u64 + die->die_cu->cu_offset;
 			first = (die1 == NULL);
 			die1 = _dwarf_die_find(die, val);
 			if (!first)
@@ -206,8 +213,20 @@ dwarf_attrval_unsigned(Dwarf_Die die, Dwarf_Half attr, Dwarf_Unsigned *valp, Dwa
 	case DW_FORM_ref4:
 	case DW_FORM_ref8:
 	case DW_FORM_ref_udata:
+	case DW_FORM_sec_offset:
+	case DW_FORM_implicit_const:
 		*valp = at->u[0].u64;
 		break;
+	case DW_FORM_addrx:
+	case DW_FORM_addrx1:
+	case DW_FORM_addrx2:
+	case DW_FORM_addrx3:
+	case DW_FORM_addrx4:
+	case DW_FORM_loclistx:
+	case DW_FORM_rnglistx:
+		/* Indexed forms yield the address or offset they denote. */
+		*valp = at->u[1].u64;
+		break;
 	default:
 		if (die1 != NULL)
 			dwarf_dealloc(dbg, die1, DW_DLA_DIE);
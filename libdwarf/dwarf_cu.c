@@ -30,12 +30,13 @@
 ELFTC_VCSID("$Id$");
 
 int
-dwarf_next_cu_header_c(Dwarf_Debug dbg, Dwarf_Bool is_info,
+dwarf_next_cu_header_d(Dwarf_Debug dbg, Dwarf_Bool is_info,
     Dwarf_Unsigned *cu_length, Dwarf_Half *cu_version,
     Dwarf_Off *cu_abbrev_offset, Dwarf_Half *cu_pointer_size,
     Dwarf_Half *cu_offset_size, Dwarf_Half *cu_extension_size,
     Dwarf_Sig8 *type_signature, Dwarf_Unsigned *type_offset,
-    Dwarf_Unsigned *cu_next_offset, Dwarf_Error *error)
+    Dwarf_Unsigned *cu_next_offset, Dwarf_Half *cu_unit_type,
+    Dwarf_Error *error)
 {
 	Dwarf_CU cu;
 	int ret;
@@ -100,7 +101,11 @@ dwarf_next_cu_header_c(Dwarf_Debug dbg, Dwarf_Bool is_info,
 	if (cu_next_offset)
 		*cu_next_offset	= cu->cu_next_offset;
 
-	if (!is_info) {
+	if (cu_unit_type)
+		*cu_unit_type = cu->cu_unit_type;
+
+	if (cu->cu_unit_type == DW_UT_type ||
+	    cu->cu_unit_type == DW_UT_split_type) {
 		if (type_signature)
 			*type_signature = cu->cu_type_sig;
 		if (type_offset)
@@ -110,6 +115,21 @@ dwarf_next_cu_header_c(Dwarf_Debug dbg, Dwarf_Bool is_info,
 	return (DW_DLV_OK);
 }
 
+int
+dwarf_next_cu_header_c(Dwarf_Debug dbg, Dwarf_Bool is_info,
+    Dwarf_Unsigned *cu_length, Dwarf_Half *cu_version,
+    Dwarf_Off *cu_abbrev_offset, Dwarf_Half *cu_pointer_size,
+    Dwarf_Half *cu_offset_size, Dwarf_Half *cu_extension_size,
+    Dwarf_Sig8 *type_signature, Dwarf_Unsigned *type_offset,
+    Dwarf_Unsigned *cu_next_offset, Dwarf_Error *error)
+{
+
+	return (dwarf_next_cu_header_d(dbg, is_info, cu_length, cu_version,
+	    cu_abbrev_offset, cu_pointer_size, cu_offset_size,
+	    cu_extension_size, type_signature, type_offset, cu_next_offset,
+	    NULL, error));
+}
+
 
 int
 dwarf_next_cu_header_b(Dwarf_Debug dbg, Dwarf_Unsigned *cu_length,
@@ -136,6 +156,28 @@ dwarf_next_cu_header(Dwarf_Debug dbg, Dwarf_Unsigned *cu_length,
 	    error));
 }
 
+int
+dwarf_get_unit_headers(Dwarf_Debug dbg, Dwarf_Bool is_info,
+    Dwarf_Unit_Header **ret_headers, Dwarf_Unsigned *ret_count,
+    Dwarf_Error *error)
+{
+	int ret;
+
+	if (dbg == NULL || ret_headers == NULL || ret_count == NULL) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_ARGUMENT);
+		return (DW_DLV_ERROR);
+	}
+
+	ret = _dwarf_info_headers(dbg, is_info, ret_headers, ret_count, error);
+	if (ret == DW_DLE_NO_ENTRY) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
+		return (DW_DLV_NO_ENTRY);
+	} else if (ret != DW_DLE_NONE)
+		return (DW_DLV_ERROR);
+
+	return (DW_DLV_OK);
+}
+
 int
 dwarf_next_types_section(Dwarf_Debug dbg, Dwarf_Error *error)
 {
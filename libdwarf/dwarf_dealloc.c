@@ -28,12 +28,39 @@
 
 ELFTC_VCSID("$Id$");
 
+static void
+_dwarf_die_free(Dwarf_Die die)
+{
+	Dwarf_Attribute at, tat;
+
+	STAILQ_FOREACH_SAFE(at, &die->die_attr, at_next, tat) {
+		STAILQ_REMOVE(&die->die_attr, at, _Dwarf_Attribute, at_next);
+		if (at->at_ld != NULL) {
+			free(at->at_ld->ld_s);
+			free(at->at_ld);
+		}
+		if (die->die_cu != NULL)
+			_dwarf_arena_free(&die->die_cu->cu_arena, at,
+			    sizeof(struct _Dwarf_Attribute));
+		else
+			free(at);
+	}
+	if (die->die_attrarray)
+		free(die->die_attrarray);
+	if (die->die_cu != NULL) {
+		LIST_REMOVE(die, die_cu_next);
+		_dwarf_arena_free(&die->die_cu->cu_arena, die,
+		    sizeof(struct _Dwarf_Die));
+	} else
+		free(die);
+}
+
 void
 dwarf_dealloc(Dwarf_Debug dbg, Dwarf_Ptr p, Dwarf_Unsigned alloc_type)
 {
 	Dwarf_Abbrev ab;
 	Dwarf_AttrDef ad, tad;
-	Dwarf_Attribute at, tat;
+	Dwarf_CU cu;
 	Dwarf_Die die;
 
 	/*
@@ -59,19 +86,37 @@ dwarf_dealloc(Dwarf_Debug dbg, Dwarf_Ptr p, Dwarf_Unsigned alloc_type)
 		free(ab);
 	} else if (alloc_type == DW_DLA_DIE) {
 		die = p;
-		STAILQ_FOREACH_SAFE(at, &die->die_attr, at_next, tat) {
-			STAILQ_REMOVE(&die->die_attr, at,
-			    _Dwarf_Attribute, at_next);
-			if (at->at_ld != NULL)
-				free(at->at_ld);
-			free(at);
+		if ((cu = die->die_cu) == NULL) {
+			_dwarf_die_free(die);
+			return;
 		}
-		if (die->die_attrarray)
-			free(die->die_attrarray);
-		free(die);
+		/* DIEs in a unit's DIE cache are released with the unit. */
+		DWARF_CU_LOCK(cu);
+		if (!die->die_cached)
+			_dwarf_die_free(die);
+		DWARF_CU_UNLOCK(cu);
 	}
 }
 
+void
+dwarf_cu_dealloc(Dwarf_Debug dbg, Dwarf_Die die)
+{
+	Dwarf_CU cu;
+
+	(void) dbg;
+
+	/*
+	 * Release every DIE, attribute and line number row read from
+	 * the unit containing 'die', including 'die' itself.
+	 */
+	if (die == NULL || (cu = die->die_cu) == NULL)
+		return;
+
+	DWARF_CU_LOCK(cu);
+	_dwarf_info_release(cu);
+	DWARF_CU_UNLOCK(cu);
+}
+
 void
 dwarf_srclines_dealloc(Dwarf_Debug dbg, Dwarf_Line *linebuf,
 	Dwarf_Signed count)
@@ -78,17 +78,23 @@ dwarf_siblingof_b(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Die *ret_die,
 	}
 
 	ds = is_info ? dbg->dbg_info_sec : dbg->dbg_types_sec;
-	cu = is_info ? dbg->dbg_cu_current : dbg->dbg_tu_current;
-
-	if (cu == NULL) {
-		DWARF_SET_ERROR(dbg, error, DW_DLE_DIE_NO_CU_CONTEXT);
-		return (DW_DLV_ERROR);
-	}
 
-	/* Application requests the first DIE in this CU. */
-	if (die == NULL)
+	/* Application requests the first DIE in the current CU. */
+	if (die == NULL) {
+		cu = is_info ? dbg->dbg_cu_current : dbg->dbg_tu_current;
+		if (cu == NULL) {
+			DWARF_SET_ERROR(dbg, error, DW_DLE_DIE_NO_CU_CONTEXT);
+			return (DW_DLV_ERROR);
+		}
 		return (dwarf_offdie_b(dbg, cu->cu_1st_offset, is_info,
 		    ret_die, error));
+	}
+
+	/*
+	 * Otherwise the sibling is in the same CU as the DIE, which
+	 * need not be the current CU if the DIE was found by offset.
+	 */
+	cu = die->die_cu;
 
 	/*
 	 * Check if the `is_info' flag matches the debug section the
@@ -148,10 +154,23 @@ _dwarf_search_die_within_cu(Dwarf_Debug dbg, Dwarf_Section *s, Dwarf_CU cu,
     Dwarf_Off offset, Dwarf_Die *ret_die, Dwarf_Error *error)
 {
 
+	int ret;
+
 	assert(dbg != NULL && cu != NULL && ret_die != NULL);
 
-	return (_dwarf_die_parse(dbg, s, cu, cu->cu_dwarf_size,
-	    offset, cu->cu_next_offset, ret_die, 0, error));
+	/*
+	 * A lookup of just the unit DIE is answered without indexing
+	 * the whole unit.
+	 */
+	DWARF_CU_LOCK(cu);
+	if (offset == cu->cu_1st_offset && cu->cu_die_cache == NULL)
+		ret = _dwarf_die_parse(dbg, s, cu, cu->cu_dwarf_size, offset,
+		    cu->cu_next_offset, ret_die, 0, error);
+	else
+		ret = _dwarf_die_lookup(dbg, cu, offset, ret_die, error);
+	DWARF_CU_UNLOCK(cu);
+
+	return (ret);
 }
 
 int
@@ -170,57 +189,24 @@ dwarf_offdie_b(Dwarf_Debug dbg, Dwarf_Off offset, Dwarf_Bool is_info,
 	ds = is_info ? dbg->dbg_info_sec : dbg->dbg_types_sec;
 	cu = is_info ? dbg->dbg_cu_current : dbg->dbg_tu_current;
 
-	/* First search the current CU. */
-	if (cu != NULL) {
-		if (offset > cu->cu_offset && offset < cu->cu_next_offset) {
-			ret = _dwarf_search_die_within_cu(dbg, ds, cu, offset,
-			    ret_die, error);
-			if (ret == DW_DLE_NO_ENTRY) {
-				DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
-				return (DW_DLV_NO_ENTRY);
-			} else if (ret != DW_DLE_NONE)
-				return (DW_DLV_ERROR);
-			return (DW_DLV_OK);
-		}
+	/* First search the current CU, then the other CUs. */
+	if (cu == NULL || offset < cu->cu_1st_offset ||
+	    offset >= cu->cu_next_offset) {
+		ret = _dwarf_info_find_cu(dbg, is_info, offset, &cu, error);
+		if (ret == DW_DLE_NO_ENTRY)
+			return (DW_DLV_NO_ENTRY);
+		else if (ret != DW_DLE_NONE)
+			return (DW_DLV_ERROR);
 	}
 
-	/* Search other CUs. */
-	ret = _dwarf_info_load(dbg, 1, is_info, error);
-	if (ret != DW_DLE_NONE)
+	ret = _dwarf_search_die_within_cu(dbg, ds, cu, offset, ret_die, error);
+	if (ret == DW_DLE_NO_ENTRY) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
+		return (DW_DLV_NO_ENTRY);
+	} else if (ret != DW_DLE_NONE)
 		return (DW_DLV_ERROR);
 
-	if (is_info) {
-		STAILQ_FOREACH(cu, &dbg->dbg_cu, cu_next) {
-			if (offset < cu->cu_offset ||
-			    offset > cu->cu_next_offset)
-				continue;
-			ret = _dwarf_search_die_within_cu(dbg, ds, cu, offset,
-			    ret_die, error);
-			if (ret == DW_DLE_NO_ENTRY) {
-				DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
-				return (DW_DLV_NO_ENTRY);
-			} else if (ret != DW_DLE_NONE)
-				return (DW_DLV_ERROR);
-			return (DW_DLV_OK);
-		}
-	} else {
-		STAILQ_FOREACH(cu, &dbg->dbg_tu, cu_next) {
-			if (offset < cu->cu_offset ||
-			    offset > cu->cu_next_offset)
-				continue;
-			ret = _dwarf_search_die_within_cu(dbg, ds, cu, offset,
-			    ret_die, error);
-			if (ret == DW_DLE_NO_ENTRY) {
-				DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
-				return (DW_DLV_NO_ENTRY);
-			} else if (ret != DW_DLE_NONE)
-				return (DW_DLV_ERROR);
-			return (DW_DLV_OK);
-		}
-	}
-
-	DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
-	return (DW_DLV_NO_ENTRY);
+	return (DW_DLV_OK);
 }
 
 int
@@ -314,7 +300,9 @@ dwarf_die_CU_offset_range(Dwarf_Die die, Dwarf_Off *cu_offset,
 int
 dwarf_diename(Dwarf_Die die, char **ret_name, Dwarf_Error *error)
 {
+	Dwarf_Attribute at;
 	Dwarf_Debug dbg;
+	int ret;
 
 	dbg = die != NULL ? die->die_dbg : NULL;
 
@@ -323,6 +311,16 @@ dwarf_diename(Dwarf_Die die, char **ret_name, Dwarf_Error *error)
 		return (DW_DLV_ERROR);
 	}
 
+	/*
+	 * Decoding DW_AT_name of a lazy DIE sets its name.  The lookup
+	 * also orders this read after a decoding done by another thread.
+	 */
+	if (die->die_cu != NULL) {
+		ret = _dwarf_attr_lookup(die, DW_AT_name, &at, error);
+		if (ret != DW_DLE_NONE && ret != DW_DLE_NO_ENTRY)
+			return (DW_DLV_ERROR);
+	}
+
 	if (die->die_name == NULL) {
 		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
 		return (DW_DLV_NO_ENTRY);
@@ -411,3 +409,21 @@ dwarf_get_die_infotypes_flag(Dwarf_Die die)
 
 	return (die->die_cu->cu_is_info);
 }
+
+int
+dwarf_get_version_of_die(Dwarf_Die die, Dwarf_Half *version,
+    Dwarf_Half *offset_size)
+{
+	Dwarf_CU cu;
+
+	if (die == NULL || version == NULL || offset_size == NULL)
+		return (DW_DLV_ERROR);
+
+	cu = die->die_cu;
+	assert(cu != NULL);
+
+	*version = cu->cu_version;
+	*offset_size = cu->cu_dwarf_size;
+
+	return (DW_DLV_OK);
+}
@@ -60,8 +60,12 @@ dwarf_get_AT_name(unsigned attr, const char **s)
 		*s = "DW_AT_abstract_origin"; break;
 	case DW_AT_accessibility:
 		*s = "DW_AT_accessibility"; break;
+	case DW_AT_addr_base:
+		*s = "DW_AT_addr_base"; break;
 	case DW_AT_address_class:
 		*s = "DW_AT_address_class"; break;
+	case DW_AT_alignment:
+		*s = "DW_AT_alignment"; break;
 	case DW_AT_artificial:
 		*s = "DW_AT_artificial"; break;
 	case DW_AT_allocated:
@@ -82,6 +86,32 @@ dwarf_get_AT_name(unsigned attr, const char **s)
 		*s = "DW_AT_byte_size"; break;
 	case DW_AT_byte_stride:
 		*s = "DW_AT_byte_stride"; break;
+	case DW_AT_call_all_calls:
+		*s = "DW_AT_call_all_calls"; break;
+	case DW_AT_call_all_source_calls:
+		*s = "DW_AT_call_all_source_calls"; break;
+	case DW_AT_call_all_tail_calls:
+		*s = "DW_AT_call_all_tail_calls"; break;
+	case DW_AT_call_data_location:
+		*s = "DW_AT_call_data_location"; break;
+	case DW_AT_call_data_value:
+		*s = "DW_AT_call_data_value"; break;
+	case DW_AT_call_origin:
+		*s = "DW_AT_call_origin"; break;
+	case DW_AT_call_parameter:
+		*s = "DW_AT_call_parameter"; break;
+	case DW_AT_call_pc:
+		*s = "DW_AT_call_pc"; break;
+	case DW_AT_call_return_pc:
+		*s = "DW_AT_call_return_pc"; break;
+	case DW_AT_call_tail_call:
+		*s = "DW_AT_call_tail_call"; break;
+	case DW_AT_call_target:
+		*s = "DW_AT_call_target"; break;
+	case DW_AT_call_target_clobbered:
+		*s = "DW_AT_call_target_clobbered"; break;
+	case DW_AT_call_value:
+		*s = "DW_AT_call_value"; break;
 	case DW_AT_calling_convention:
 		*s = "DW_AT_calling_convention"; break;
 	case DW_AT_common_reference:
@@ -122,6 +152,10 @@ dwarf_get_AT_name(unsigned attr, const char **s)
 		*s = "DW_AT_decimal_scale"; break;
 	case DW_AT_decimal_sign:
 		*s = "DW_AT_decimal_sign"; break;
+	case DW_AT_defaulted:
+		*s = "DW_AT_defaulted"; break;
+	case DW_AT_deleted:
+		*s = "DW_AT_deleted"; break;
 	case DW_AT_description:
 		*s = "DW_AT_description"; break;
 	case DW_AT_digit_count:
@@ -132,12 +166,16 @@ dwarf_get_AT_name(unsigned attr, const char **s)
 		*s = "DW_AT_discr_list"; break;
 	case DW_AT_discr_value:
 		*s = "DW_AT_discr_value"; break;
+	case DW_AT_dwo_name:
+		*s = "DW_AT_dwo_name"; break;
 	case DW_AT_element_list:
 		*s = "DW_AT_element_list"; break;
 	case DW_AT_encoding:
 		*s = "DW_AT_encoding"; break;
 	case DW_AT_enum_class:
 		*s = "DW_AT_enum_class"; break;
+	case DW_AT_export_symbols:
+		*s = "DW_AT_export_symbols"; break;
 	case DW_AT_external:
 		*s = "DW_AT_external"; break;
 	case DW_AT_entry_pc:
@@ -174,12 +212,16 @@ dwarf_get_AT_name(unsigned attr, const char **s)
 		*s = "DW_AT_lo_user"; break;
 	case DW_AT_location:
 		*s = "DW_AT_location"; break;
+	case DW_AT_loclists_base:
+		*s = "DW_AT_loclists_base"; break;
 	case DW_AT_low_pc:
 		*s = "DW_AT_low_pc"; break;
 	case DW_AT_lower_bound:
 		*s = "DW_AT_lower_bound"; break;
 	case DW_AT_macro_info:
 		*s = "DW_AT_macro_info"; break;
+	case DW_AT_macros:
+		*s = "DW_AT_macros"; break;
 	case DW_AT_main_subprogram:
 		*s = "DW_AT_main_subprogram"; break;
 	case DW_AT_mutable:
@@ -190,6 +232,8 @@ dwarf_get_AT_name(unsigned attr, const char **s)
 		*s = "DW_AT_name"; break;
 	case DW_AT_namelist_item:
 		*s = "DW_AT_namelist_item"; break;
+	case DW_AT_noreturn:
+		*s = "DW_AT_noreturn"; break;
 	case DW_AT_ordering:
 		*s = "DW_AT_ordering"; break;
 	case DW_AT_object_pointer:
@@ -204,12 +248,20 @@ dwarf_get_AT_name(unsigned attr, const char **s)
 		*s = "DW_AT_picture_string"; break;
 	case DW_AT_pure:
 		*s = "DW_AT_pure"; break;
+	case DW_AT_rank:
+		*s = "DW_AT_rank"; break;
+	case DW_AT_reference:
+		*s = "DW_AT_reference"; break;
 	case DW_AT_return_addr:
 		*s = "DW_AT_return_addr"; break;
 	case DW_AT_ranges:
 		*s = "DW_AT_ranges"; break;
 	case DW_AT_recursive:
 		*s = "DW_AT_recursive"; break;
+	case DW_AT_rnglists_base:
+		*s = "DW_AT_rnglists_base"; break;
+	case DW_AT_rvalue_reference:
+		*s = "DW_AT_rvalue_reference"; break;
 	case DW_AT_segment:
 		*s = "DW_AT_segment"; break;
 	case DW_AT_sibling:
@@ -224,8 +276,14 @@ dwarf_get_AT_name(unsigned attr, const char **s)
 		*s = "DW_AT_static_link"; break;
 	case DW_AT_stmt_list:
 		*s = "DW_AT_stmt_list"; break;
+	case DW_AT_str_offsets_base:
+		*s = "DW_AT_str_offsets_base"; break;
 	case DW_AT_string_length:
 		*s = "DW_AT_string_length"; break;
+	case DW_AT_string_length_bit_size:
+		*s = "DW_AT_string_length_bit_size"; break;
+	case DW_AT_string_length_byte_size:
+		*s = "DW_AT_string_length_byte_size"; break;
 	case DW_AT_subscr_data:
 		*s = "DW_AT_subscr_data"; break;
 	case DW_AT_small:
@@ -534,6 +592,16 @@ dwarf_get_FORM_name(unsigned form, const char **s)
 	switch (form) {
 	case DW_FORM_addr:
 		*s = "DW_FORM_addr"; break;
+	case DW_FORM_addrx:
+		*s = "DW_FORM_addrx"; break;
+	case DW_FORM_addrx1:
+		*s = "DW_FORM_addrx1"; break;
+	case DW_FORM_addrx2:
+		*s = "DW_FORM_addrx2"; break;
+	case DW_FORM_addrx3:
+		*s = "DW_FORM_addrx3"; break;
+	case DW_FORM_addrx4:
+		*s = "DW_FORM_addrx4"; break;
 	case DW_FORM_block:
 		*s = "DW_FORM_block"; break;
 	case DW_FORM_block1:
@@ -544,6 +612,8 @@ dwarf_get_FORM_name(unsigned form, const char **s)
 		*s = "DW_FORM_block4"; break;
 	case DW_FORM_data1:
 		*s = "DW_FORM_data1"; break;
+	case DW_FORM_data16:
+		*s = "DW_FORM_data16"; break;
 	case DW_FORM_data2:
 		*s = "DW_FORM_data2"; break;
 	case DW_FORM_data4:
@@ -556,8 +626,18 @@ dwarf_get_FORM_name(unsigned form, const char **s)
 		*s = "DW_FORM_flag"; break;
 	case DW_FORM_flag_present:
 		*s = "DW_FORM_flag_present"; break;
+	case DW_FORM_GNU_ref_alt:
+		*s = "DW_FORM_GNU_ref_alt"; break;
+	case DW_FORM_GNU_strp_alt:
+		*s = "DW_FORM_GNU_strp_alt"; break;
+	case DW_FORM_implicit_const:
+		*s = "DW_FORM_implicit_const"; break;
 	case DW_FORM_indirect:
 		*s = "DW_FORM_indirect"; break;
+	case DW_FORM_line_strp:
+		*s = "DW_FORM_line_strp"; break;
+	case DW_FORM_loclistx:
+		*s = "DW_FORM_loclistx"; break;
 	case DW_FORM_ref1:
 		*s = "DW_FORM_ref1"; break;
 	case DW_FORM_ref2:
@@ -570,8 +650,14 @@ dwarf_get_FORM_name(unsigned form, const char **s)
 		*s = "DW_FORM_ref_addr"; break;
 	case DW_FORM_ref_sig8:
 		*s = "DW_FORM_ref_sig8"; break;
+	case DW_FORM_ref_sup4:
+		*s = "DW_FORM_ref_sup4"; break;
+	case DW_FORM_ref_sup8:
+		*s = "DW_FORM_ref_sup8"; break;
 	case DW_FORM_ref_udata:
 		*s = "DW_FORM_ref_udata"; break;
+	case DW_FORM_rnglistx:
+		*s = "DW_FORM_rnglistx"; break;
 	case DW_FORM_sdata:
 		*s = "DW_FORM_sdata"; break;
 	case DW_FORM_sec_offset:
@@ -580,6 +666,18 @@ dwarf_get_FORM_name(unsigned form, const char **s)
 		*s = "DW_FORM_string"; break;
 	case DW_FORM_strp:
 		*s = "DW_FORM_strp"; break;
+	case DW_FORM_strp_sup:
+		*s = "DW_FORM_strp_sup"; break;
+	case DW_FORM_strx:
+		*s = "DW_FORM_strx"; break;
+	case DW_FORM_strx1:
+		*s = "DW_FORM_strx1"; break;
+	case DW_FORM_strx2:
+		*s = "DW_FORM_strx2"; break;
+	case DW_FORM_strx3:
+		*s = "DW_FORM_strx3"; break;
+	case DW_FORM_strx4:
+		*s = "DW_FORM_strx4"; break;
 	case DW_FORM_udata:
 		*s = "DW_FORM_udata"; break;
 	default:
@@ -1238,6 +1336,26 @@ dwarf_get_OP_name(unsigned op, const char **s)
 		*s = "DW_OP_implicit_value"; break;
 	case DW_OP_stack_value:
 		*s = "DW_OP_stack_value"; break;
+	case DW_OP_implicit_pointer:
+		*s = "DW_OP_implicit_pointer"; break;
+	case DW_OP_addrx:
+		*s = "DW_OP_addrx"; break;
+	case DW_OP_constx:
+		*s = "DW_OP_constx"; break;
+	case DW_OP_entry_value:
+		*s = "DW_OP_entry_value"; break;
+	case DW_OP_const_type:
+		*s = "DW_OP_const_type"; break;
+	case DW_OP_regval_type:
+		*s = "DW_OP_regval_type"; break;
+	case DW_OP_deref_type:
+		*s = "DW_OP_deref_type"; break;
+	case DW_OP_xderef_type:
+		*s = "DW_OP_xderef_type"; break;
+	case DW_OP_convert:
+		*s = "DW_OP_convert"; break;
+	case DW_OP_reinterpret:
+		*s = "DW_OP_reinterpret"; break;
 	case DW_OP_GNU_push_tls_address:
 		*s = "DW_OP_GNU_push_tls_address"; break;
 	case DW_OP_GNU_uninit:
@@ -1300,12 +1418,20 @@ dwarf_get_TAG_name(unsigned tag, const char **s)
 		*s = "DW_TAG_access_declaration"; break;
 	case DW_TAG_array_type:
 		*s = "DW_TAG_array_type"; break;
+	case DW_TAG_atomic_type:
+		*s = "DW_TAG_atomic_type"; break;
 	case DW_TAG_base_type:
 		*s = "DW_TAG_base_type"; break;
+	case DW_TAG_call_site:
+		*s = "DW_TAG_call_site"; break;
+	case DW_TAG_call_site_parameter:
+		*s = "DW_TAG_call_site_parameter"; break;
 	case DW_TAG_catch_block:
 		*s = "DW_TAG_catch_block"; break;
 	case DW_TAG_class_type:
 		*s = "DW_TAG_class_type"; break;
+	case DW_TAG_coarray_type:
+		*s = "DW_TAG_coarray_type"; break;
 	case DW_TAG_common_block:
 		*s = "DW_TAG_common_block"; break;
 	case DW_TAG_common_inclusion:
@@ -1320,6 +1446,8 @@ dwarf_get_TAG_name(unsigned tag, const char **s)
 		*s = "DW_TAG_constant"; break;
 	case DW_TAG_dwarf_procedure:
 		*s = "DW_TAG_dwarf_procedure"; break;
+	case DW_TAG_dynamic_type:
+		*s = "DW_TAG_dynamic_type"; break;
 	case DW_TAG_entry_point:
 		*s = "DW_TAG_entry_point"; break;
 	case DW_TAG_enumeration_type:
@@ -1330,6 +1458,10 @@ dwarf_get_TAG_name(unsigned tag, const char **s)
 		*s = "DW_TAG_formal_parameter"; break;
 	case DW_TAG_friend:
 		*s = "DW_TAG_friend"; break;
+	case DW_TAG_generic_subrange:
+		*s = "DW_TAG_generic_subrange"; break;
+	case DW_TAG_immutable_type:
+		*s = "DW_TAG_immutable_type"; break;
 	case DW_TAG_imported_declaration:
 		*s = "DW_TAG_imported_declaration"; break;
 	case DW_TAG_imported_module:
@@ -1374,6 +1506,8 @@ dwarf_get_TAG_name(unsigned tag, const char **s)
 		*s = "DW_TAG_set_type"; break;
 	case DW_TAG_shared_type:
 		*s = "DW_TAG_shared_type"; break;
+	case DW_TAG_skeleton_unit:
+		*s = "DW_TAG_skeleton_unit"; break;
 	case DW_TAG_string_type:
 		*s = "DW_TAG_string_type"; break;
 	case DW_TAG_structure_type:
@@ -1441,6 +1575,32 @@ dwarf_get_TAG_name(unsigned tag, const char **s)
 	return (DW_DLV_OK);
 }
 
+int
+dwarf_get_UT_name(unsigned ut, const char **s)
+{
+
+	assert(s != NULL);
+
+	switch (ut) {
+	case DW_UT_compile:
+		*s = "DW_UT_compile"; break;
+	case DW_UT_type:
+		*s = "DW_UT_type"; break;
+	case DW_UT_partial:
+		*s = "DW_UT_partial"; break;
+	case DW_UT_skeleton:
+		*s = "DW_UT_skeleton"; break;
+	case DW_UT_split_compile:
+		*s = "DW_UT_split_compile"; break;
+	case DW_UT_split_type:
+		*s = "DW_UT_split_type"; break;
+	default:
+		return (DW_DLV_NO_ENTRY);
+	}
+
+	return (DW_DLV_OK);
+}
+
 int
 dwarf_get_VIRTUALITY_name(unsigned vir, const char **s)
 {
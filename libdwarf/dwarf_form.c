@@ -152,6 +152,11 @@ dwarf_global_formref(Dwarf_Attribute at, Dwarf_Off *return_offset,
 		*return_offset = (Dwarf_Off) at->u[0].u64;
 		ret = DW_DLV_OK;
 		break;
+	case DW_FORM_loclistx:
+	case DW_FORM_rnglistx:
+		*return_offset = (Dwarf_Off) at->u[1].u64;
+		ret = DW_DLV_OK;
+		break;
 	case DW_FORM_ref1:
 	case DW_FORM_ref2:
 	case DW_FORM_ref4:
@@ -182,10 +187,20 @@ dwarf_formaddr(Dwarf_Attribute at, Dwarf_Addr *return_addr, Dwarf_Error *error)
 		return (DW_DLV_ERROR);
 	}
 
-	if (at->at_form == DW_FORM_addr) {
+	switch (at->at_form) {
+	case DW_FORM_addr:
 		*return_addr = at->u[0].u64;
 		ret = DW_DLV_OK;
-	} else {
+		break;
+	case DW_FORM_addrx:
+	case DW_FORM_addrx1:
+	case DW_FORM_addrx2:
+	case DW_FORM_addrx3:
+	case DW_FORM_addrx4:
+		*return_addr = at->u[1].u64;
+		ret = DW_DLV_OK;
+		break;
+	default:
 		DWARF_SET_ERROR(dbg, error, DW_DLE_ATTR_FORM_BAD);
 		ret = DW_DLV_ERROR;
 	}
@@ -238,6 +253,9 @@ dwarf_formudata(Dwarf_Attribute at, Dwarf_Unsigned *return_uvalue,
 	case DW_FORM_data4:
 	case DW_FORM_data8:
 	case DW_FORM_udata:
+	case DW_FORM_implicit_const:
+	case DW_FORM_loclistx:
+	case DW_FORM_rnglistx:
 		*return_uvalue = at->u[0].u64;
 		ret = DW_DLV_OK;
 		break;
@@ -278,6 +296,7 @@ dwarf_formsdata(Dwarf_Attribute at, Dwarf_Signed *return_svalue,
 		break;
 	case DW_FORM_data8:
 	case DW_FORM_sdata:
+	case DW_FORM_implicit_const:
 		*return_svalue = at->u[0].s64;
 		ret = DW_DLV_OK;
 		break;
@@ -308,6 +327,7 @@ dwarf_formblock(Dwarf_Attribute at, Dwarf_Block **return_block,
 	case DW_FORM_block1:
 	case DW_FORM_block2:
 	case DW_FORM_block4:
+	case DW_FORM_data16:
 		*return_block = &at->at_block;
 		ret = DW_DLV_OK;
 		break;
@@ -387,6 +407,12 @@ dwarf_formstring(Dwarf_Attribute at, char **return_string,
 		ret = DW_DLV_OK;
 		break;
 	case DW_FORM_strp:
+	case DW_FORM_line_strp:
+	case DW_FORM_strx:
+	case DW_FORM_strx1:
+	case DW_FORM_strx2:
+	case DW_FORM_strx3:
+	case DW_FORM_strx4:
 		*return_string = (char *) at->u[1].s;
 		ret = DW_DLV_OK;
 		break;
@@ -405,6 +431,11 @@ dwarf_get_form_class(Dwarf_Half dwversion, Dwarf_Half attr,
 
 	switch (form) {
 	case DW_FORM_addr:
+	case DW_FORM_addrx:
+	case DW_FORM_addrx1:
+	case DW_FORM_addrx2:
+	case DW_FORM_addrx3:
+	case DW_FORM_addrx4:
 		return (DW_FORM_CLASS_ADDRESS);
 	case DW_FORM_block:
 	case DW_FORM_block1:
@@ -413,6 +444,13 @@ dwarf_get_form_class(Dwarf_Half dwversion, Dwarf_Half attr,
 		return (DW_FORM_CLASS_BLOCK);
 	case DW_FORM_string:
 	case DW_FORM_strp:
+	case DW_FORM_line_strp:
+	case DW_FORM_strp_sup:
+	case DW_FORM_strx:
+	case DW_FORM_strx1:
+	case DW_FORM_strx2:
+	case DW_FORM_strx3:
+	case DW_FORM_strx4:
 		return (DW_FORM_CLASS_STRING);
 	case DW_FORM_flag:
 	case DW_FORM_flag_present:
@@ -424,11 +462,19 @@ dwarf_get_form_class(Dwarf_Half dwversion, Dwarf_Half attr,
 	case DW_FORM_ref2:
 	case DW_FORM_ref4:
 	case DW_FORM_ref8:
+	case DW_FORM_ref_sup4:
+	case DW_FORM_ref_sup8:
 		return (DW_FORM_CLASS_REFERENCE);
 	case DW_FORM_exprloc:
 		return (DW_FORM_CLASS_EXPRLOC);
+	case DW_FORM_loclistx:
+		return (DW_FORM_CLASS_LOCLISTPTR);
+	case DW_FORM_rnglistx:
+		return (DW_FORM_CLASS_RANGELISTPTR);
 	case DW_FORM_data1:
 	case DW_FORM_data2:
+	case DW_FORM_data16:
+	case DW_FORM_implicit_const:
 	case DW_FORM_sdata:
 	case DW_FORM_udata:
 		return (DW_FORM_CLASS_CONSTANT);
@@ -467,6 +513,7 @@ dwarf_get_form_class(Dwarf_Half dwversion, Dwarf_Half attr,
 		case DW_AT_ranges:
 			return (DW_FORM_CLASS_RANGELISTPTR);
 		case DW_AT_macro_info:
+		case DW_AT_macros:
 			return (DW_FORM_CLASS_MACPTR);
 		default:
 			if (form == DW_FORM_data4 || form == DW_FORM_data8)
@@ -142,6 +142,8 @@ dwarf_get_fde_at_pc(Dwarf_Fde *fdelist, Dwarf_Addr pc, Dwarf_Fde *ret_fde,
 	Dwarf_FrameSec fs;
 	Dwarf_Debug dbg;
 	Dwarf_Fde fde;
+	Dwarf_PcMap *pm;
+	Dwarf_PcRange *pr;
 	int i;
 
 	dbg = fdelist != NULL ? (*fdelist)->fde_dbg : NULL;
@@ -155,15 +157,27 @@ dwarf_get_fde_at_pc(Dwarf_Fde *fdelist, Dwarf_Addr pc, Dwarf_Fde *ret_fde,
 	fs = fdelist[0]->fde_fs;
 	assert(fs != NULL);
 
-	for (i = 0; (Dwarf_Unsigned)i < fs->fs_fdelen; i++) {
-		fde = fdelist[i];
-		if (pc >= fde->fde_initloc && pc < fde->fde_initloc +
-		    fde->fde_adrange) {
-			*ret_fde = fde;
-			*lopc = fde->fde_initloc;
-			*hipc = fde->fde_initloc + fde->fde_adrange - 1;
-			return (DW_DLV_OK);
+	/* Build the PC-sorted FDE index on first use. */
+	pm = &fs->fs_pcmap;
+	if (!pm->pm_sorted) {
+		for (i = 0; (Dwarf_Unsigned)i < fs->fs_fdelen; i++) {
+			fde = fs->fs_fdearray[i];
+			if (_dwarf_pcmap_add(dbg, pm, fde->fde_initloc,
+			    fde->fde_initloc + fde->fde_adrange, fde, error) !=
+			    DW_DLE_NONE) {
+				_dwarf_pcmap_cleanup(pm);
+				return (DW_DLV_ERROR);
+			}
 		}
+		_dwarf_pcmap_sort(pm);
+	}
+
+	if ((pr = _dwarf_pcmap_find(pm, pc)) != NULL) {
+		fde = pr->pr_obj;
+		*ret_fde = fde;
+		*lopc = fde->fde_initloc;
+		*hipc = fde->fde_initloc + fde->fde_adrange - 1;
+		return (DW_DLV_OK);
 	}
 
 	DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
@@ -554,6 +568,7 @@ dwarf_set_frame_rule_table_size(Dwarf_Debug dbg, Dwarf_Half value)
 
 	old_value = dbg->dbg_frame_rule_table_size;
 	dbg->dbg_frame_rule_table_size = value;
+	dbg->dbg_frame_gen++;
 
 	return (old_value);
 }
@@ -565,6 +580,7 @@ dwarf_set_frame_rule_initial_value(Dwarf_Debug dbg, Dwarf_Half value)
 
 	old_value = dbg->dbg_frame_rule_initial_value;
 	dbg->dbg_frame_rule_initial_value = value;
+	dbg->dbg_frame_gen++;
 
 	return (old_value);
 }
@@ -576,6 +592,7 @@ dwarf_set_frame_cfa_value(Dwarf_Debug dbg, Dwarf_Half value)
 
 	old_value = dbg->dbg_frame_cfa_value;
 	dbg->dbg_frame_cfa_value = value;
+	dbg->dbg_frame_gen++;
 
 	return (old_value);
 }
@@ -587,6 +604,7 @@ dwarf_set_frame_same_value(Dwarf_Debug dbg, Dwarf_Half value)
 
 	old_value = dbg->dbg_frame_same_value;
 	dbg->dbg_frame_same_value = value;
+	dbg->dbg_frame_gen++;
 
 	return (old_value);
 }
@@ -598,6 +616,7 @@ dwarf_set_frame_undefined_value(Dwarf_Debug dbg, Dwarf_Half value)
 
 	old_value = dbg->dbg_frame_undefined_value;
 	dbg->dbg_frame_undefined_value = value;
+	dbg->dbg_frame_gen++;
 
 	return (old_value);
 }
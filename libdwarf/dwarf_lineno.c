@@ -28,6 +28,45 @@
 
 ELFTC_VCSID("$Id$");
 
+/*
+ * Return the line information of the unit of 'die', reading it from
+ * the line number program named by the DW_AT_stmt_list attribute of
+ * 'die' the first time it is asked for.
+ */
+static int
+_dwarf_srclines_load(Dwarf_Die die, Dwarf_LineInfo *ret_li,
+    Dwarf_Error *error)
+{
+	Dwarf_Attribute at;
+	Dwarf_LineInfo li;
+	Dwarf_CU cu;
+	int ret;
+
+	if ((at = _dwarf_attr_find(die, DW_AT_stmt_list)) == NULL) {
+		DWARF_SET_ERROR(die->die_dbg, error, DW_DLE_NO_ENTRY);
+		return (DW_DLV_NO_ENTRY);
+	}
+
+	cu = die->die_cu;
+	DWARF_CU_LOCK(cu);
+	ret = DW_DLE_NONE;
+	if (cu->cu_lineinfo == NULL)
+		ret = _dwarf_lineno_init(die, at->u[0].u64, error);
+	li = cu->cu_lineinfo;
+	DWARF_CU_UNLOCK(cu);
+
+	if (ret != DW_DLE_NONE)
+		return (DW_DLV_ERROR);
+	if (li == NULL) {
+		DWARF_SET_ERROR(die->die_dbg, error, DW_DLE_NO_ENTRY);
+		return (DW_DLV_NO_ENTRY);
+	}
+
+	*ret_li = li;
+
+	return (DW_DLV_OK);
+}
+
 int
 dwarf_srclines(Dwarf_Die die, Dwarf_Line **linebuf, Dwarf_Signed *linecount,
     Dwarf_Error *error)
@@ -36,8 +75,7 @@ dwarf_srclines(Dwarf_Die die, Dwarf_Line **linebuf, Dwarf_Signed *linecount,
 	Dwarf_Debug dbg;
 	Dwarf_Line ln;
 	Dwarf_CU cu;
-	Dwarf_Attribute at; 
-	int i;
+	int i, ret;
 
 	dbg = die != NULL ? die->die_dbg : NULL;
 
@@ -46,23 +84,10 @@ dwarf_srclines(Dwarf_Die die, Dwarf_Line **linebuf, Dwarf_Signed *linecount,
 		return (DW_DLV_ERROR);
 	}
 
-	if ((at = _dwarf_attr_find(die, DW_AT_stmt_list)) == NULL) {
-		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
-		return (DW_DLV_NO_ENTRY);
-	}
+	if ((ret = _dwarf_srclines_load(die, &li, error)) != DW_DLV_OK)
+		return (ret);
 
 	cu = die->die_cu;
-	if (cu->cu_lineinfo == NULL) {
-		if (_dwarf_lineno_init(die, at->u[0].u64, error) !=
-		    DW_DLE_NONE)
-			return (DW_DLV_ERROR);
-	}
-	if (cu->cu_lineinfo == NULL) {
-		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
-		return (DW_DLV_NO_ENTRY);
-	}
-
-	li = cu->cu_lineinfo;
 	*linecount = (Dwarf_Signed) li->li_lnlen;
 
 	if (*linecount == 0) {
@@ -70,13 +95,17 @@ dwarf_srclines(Dwarf_Die die, Dwarf_Line **linebuf, Dwarf_Signed *linecount,
 		return (DW_DLV_NO_ENTRY);
 	}
 
+	DWARF_CU_LOCK(cu);
+
 	if (li->li_lnarray != NULL) {
 		*linebuf = li->li_lnarray;
+		DWARF_CU_UNLOCK(cu);
 		return (DW_DLV_OK);
 	}
 
 	if ((li->li_lnarray = malloc(*linecount * sizeof(Dwarf_Line))) ==
 	    NULL) {
+		DWARF_CU_UNLOCK(cu);
 		DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
 		return (DW_DLV_ERROR);
 	}
@@ -87,6 +116,8 @@ dwarf_srclines(Dwarf_Die die, Dwarf_Line **linebuf, Dwarf_Signed *linecount,
 
 	*linebuf = li->li_lnarray;
 
+	DWARF_CU_UNLOCK(cu);
+
 	return (DW_DLV_OK);
 }
 
@@ -98,8 +129,7 @@ dwarf_srcfiles(Dwarf_Die die, char ***srcfiles, Dwarf_Signed *srccount,
 	Dwarf_LineFile lf;
 	Dwarf_Debug dbg;
 	Dwarf_CU cu;
-	Dwarf_Attribute at; 
-	int i;
+	int i, ret;
 
 	dbg = die != NULL ? die->die_dbg : NULL;
 
@@ -108,23 +138,10 @@ dwarf_srcfiles(Dwarf_Die die, char ***srcfiles, Dwarf_Signed *srccount,
 		return (DW_DLV_ERROR);
 	}
 
-	if ((at = _dwarf_attr_find(die, DW_AT_stmt_list)) == NULL) {
-		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
-		return (DW_DLV_NO_ENTRY);
-	}
+	if ((ret = _dwarf_srclines_load(die, &li, error)) != DW_DLV_OK)
+		return (ret);
 
 	cu = die->die_cu;
-	if (cu->cu_lineinfo == NULL) {
-		if (_dwarf_lineno_init(die, at->u[0].u64, error) !=
-		    DW_DLE_NONE)
-			return (DW_DLV_ERROR);
-	}
-	if (cu->cu_lineinfo == NULL) {
-		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
-		return (DW_DLV_NO_ENTRY);
-	}
-
-	li = cu->cu_lineinfo;
 	*srccount = (Dwarf_Signed) li->li_lflen;
 
 	if (*srccount == 0) {
@@ -132,12 +149,16 @@ dwarf_srcfiles(Dwarf_Die die, char ***srcfiles, Dwarf_Signed *srccount,
 		return (DW_DLV_NO_ENTRY);
 	}
 
+	DWARF_CU_LOCK(cu);
+
 	if (li->li_lfnarray != NULL) {
 		*srcfiles = li->li_lfnarray;
+		DWARF_CU_UNLOCK(cu);
 		return (DW_DLV_OK);
 	}
 
 	if ((li->li_lfnarray = malloc(*srccount * sizeof(char *))) == NULL) {
+		DWARF_CU_UNLOCK(cu);
 		DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
 		return (DW_DLV_ERROR);
 	}
@@ -152,6 +173,8 @@ dwarf_srcfiles(Dwarf_Die die, char ***srcfiles, Dwarf_Signed *srccount,
 
 	*srcfiles = li->li_lfnarray;
 
+	DWARF_CU_UNLOCK(cu);
+
 	return (DW_DLV_OK);
 }
 
@@ -259,7 +282,8 @@ dwarf_linesrc(Dwarf_Line ln, char **ret_linesrc, Dwarf_Error *error)
 	li = ln->ln_li;
 	assert(li != NULL);
 
-	for (i = 1, lf = STAILQ_FIRST(&li->li_lflist);
+	/* DWARF5 numbers the file entries from 0. */
+	for (i = li->li_version >= 5 ? 0 : 1, lf = STAILQ_FIRST(&li->li_lflist);
 	     (Dwarf_Unsigned) i < ln->ln_fileno && lf != NULL;
 	     i++, lf = STAILQ_NEXT(lf, lf_next))
 		;
@@ -53,6 +53,60 @@ copy_locdesc(Dwarf_Debug dbg, Dwarf_Locdesc *dst, Dwarf_Locdesc *src,
 	return (DW_DLE_NONE);
 }
 
+/*
+ * Hand out a copy of the cached location list at offset 'lloff'.  The
+ * application releases the copy with dwarf_dealloc(), as with SGI
+ * libdwarf, so it can not share memory with the cache.
+ */
+static int
+copy_loclist(Dwarf_Debug dbg, Dwarf_CU cu, Dwarf_Unsigned lloff,
+    Dwarf_Locdesc ***llbuf, Dwarf_Signed *listlen, Dwarf_Error *error)
+{
+	Dwarf_Locdesc **ldp;
+	Dwarf_Loclist ll;
+	Dwarf_Signed i;
+	int ret;
+
+	ret = _dwarf_loclist_find(dbg, cu, lloff, &ll, error);
+	if (ret == DW_DLE_NO_ENTRY) {
+		DWARF_SET_ERROR(dbg, error, ret);
+		return (DW_DLV_NO_ENTRY);
+	}
+	if (ret != DW_DLE_NONE)
+		return (DW_DLV_ERROR);
+
+	if ((ldp = calloc(ll->ll_ldlen, sizeof(Dwarf_Locdesc *))) == NULL) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+		return (DW_DLV_ERROR);
+	}
+	for (i = 0; i < ll->ll_ldlen; i++) {
+		if ((ldp[i] = calloc(1, sizeof(Dwarf_Locdesc))) == NULL) {
+			DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+			goto fail_cleanup;
+		}
+		if (copy_locdesc(dbg, ldp[i], &ll->ll_ldarray[i], error) !=
+		    DW_DLE_NONE) {
+			free(ldp[i]);
+			goto fail_cleanup;
+		}
+	}
+
+	*llbuf = ldp;
+	*listlen = ll->ll_ldlen;
+
+	return (DW_DLV_OK);
+
+fail_cleanup:
+
+	while (--i >= 0) {
+		free(ldp[i]->ld_s);
+		free(ldp[i]);
+	}
+	free(ldp);
+
+	return (DW_DLV_ERROR);
+}
+
 int
 dwarf_loclist_n(Dwarf_Attribute at, Dwarf_Locdesc ***llbuf,
     Dwarf_Signed *listlen, Dwarf_Error *error)
@@ -92,25 +146,25 @@ dwarf_loclist_n(Dwarf_Attribute at, Dwarf_Locdesc ***llbuf,
 			}
 			/* FALLTHROUGH */
 		case DW_FORM_sec_offset:
-			ret = _dwarf_loclist_find(dbg, at->at_die->die_cu,
-			    at->u[0].u64, llbuf, listlen, NULL, error);
-			if (ret == DW_DLE_NO_ENTRY) {
-				DWARF_SET_ERROR(dbg, error, ret);
-				return (DW_DLV_NO_ENTRY);
-			}
-			if (ret != DW_DLE_NONE)
-				return (DW_DLV_ERROR);
-			return (DW_DLV_OK);
+			return (copy_loclist(dbg, at->at_die->die_cu,
+			    at->u[0].u64, llbuf, listlen, error));
+		case DW_FORM_loclistx:
+			return (copy_loclist(dbg, at->at_die->die_cu,
+			    at->u[1].u64, llbuf, listlen, error));
 		case DW_FORM_block:
 		case DW_FORM_block1:
 		case DW_FORM_block2:
 		case DW_FORM_block4:
 		case DW_FORM_exprloc:
+			DWARF_CU_LOCK(at->at_die->die_cu);
 			if (at->at_ld == NULL) {
 				ret = _dwarf_loc_add(at->at_die, at, error);
-				if (ret != DW_DLE_NONE)
+				if (ret != DW_DLE_NONE) {
+					DWARF_CU_UNLOCK(at->at_die->die_cu);
 					return (DW_DLV_ERROR);
+				}
 			}
+			DWARF_CU_UNLOCK(at->at_die->die_cu);
 			*llbuf = calloc(1, sizeof(Dwarf_Locdesc *));
 			if (*llbuf == NULL) {
 				DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
@@ -175,10 +229,12 @@ dwarf_get_loclist_entry(Dwarf_Debug dbg, Dwarf_Unsigned offset,
     Dwarf_Unsigned *entry_len, Dwarf_Unsigned *next_entry,
     Dwarf_Error *error)
 {
-	Dwarf_Locdesc *ld, **llbuf;
+	Dwarf_Locdesc *ld;
+	Dwarf_Loclist ll;
 	Dwarf_Section *ds;
-	Dwarf_Signed listlen;
-	int i, ret;
+	Dwarf_CU cu;
+	Dwarf_Signed i;
+	int ret;
 
 	/*
 	 * Note that this API sometimes will not work correctly because
@@ -192,8 +248,8 @@ dwarf_get_loclist_entry(Dwarf_Debug dbg, Dwarf_Unsigned offset,
 		return (DW_DLV_ERROR);
 	}
 
-	ret = _dwarf_loclist_find(dbg, STAILQ_FIRST(&dbg->dbg_cu), offset,
-	    &llbuf, &listlen, entry_len, error);
+	cu = STAILQ_FIRST(&dbg->dbg_cu);
+	ret = _dwarf_loclist_find(dbg, cu, offset, &ll, error);
 	if (ret == DW_DLE_NO_ENTRY) {
 		DWARF_SET_ERROR(dbg, error, DW_DLV_NO_ENTRY);
 		return (DW_DLV_NO_ENTRY);
@@ -201,8 +257,8 @@ dwarf_get_loclist_entry(Dwarf_Debug dbg, Dwarf_Unsigned offset,
 		return (DW_DLV_ERROR);
 
 	*hipc = *lopc = 0;
-	for (i = 0; i < listlen; i++) {
-		ld = llbuf[i];
+	for (i = 0; i < ll->ll_ldlen; i++) {
+		ld = &ll->ll_ldarray[i];
 		if (i == 0) {
 			*hipc = ld->ld_hipc;
 			*lopc = ld->ld_lopc;
@@ -214,9 +270,13 @@ dwarf_get_loclist_entry(Dwarf_Debug dbg, Dwarf_Unsigned offset,
 		}
 	}
 
-	ds = _dwarf_find_section(dbg, ".debug_loc");
+	if (cu->cu_version >= 5)
+		ds = dbg->dbg_loclists_sec;
+	else
+		ds = _dwarf_find_section(dbg, ".debug_loc");
 	assert(ds != NULL);
 	*data = (uint8_t *) ds->ds_data + offset;
+	*entry_len = ll->ll_len;
 	*next_entry = offset + *entry_len;
 
 	return (DW_DLV_OK);
@@ -37,11 +37,15 @@ _dwarf_get_ranges(Dwarf_Debug dbg, Dwarf_CU cu, Dwarf_Off off,
 	int ret;
 
 	assert(cu != NULL);
-	if (_dwarf_ranges_find(dbg, off, &rl) == DW_DLE_NO_ENTRY) {
+	DWARF_LOCK(dbg);
+	if (_dwarf_ranges_find(dbg, cu, off, &rl) == DW_DLE_NO_ENTRY) {
 		ret = _dwarf_ranges_add(dbg, cu, off, &rl, error);
-		if (ret != DW_DLE_NONE)
+		if (ret != DW_DLE_NONE) {
+			DWARF_UNLOCK(dbg);
 			return (DW_DLV_ERROR);
+		}
 	}
+	DWARF_UNLOCK(dbg);
 
 	*ranges = rl->rl_rgarray;
 	*ret_cnt = rl->rl_rglen;
@@ -143,6 +143,14 @@ typedef struct {
 	enum Dwarf_Ranges_Entry_Type dwr_type;
 } Dwarf_Ranges;
 
+typedef struct {
+	Dwarf_Off	uh_offset;
+	Dwarf_Unsigned	uh_length;
+	Dwarf_Off	uh_die_offset;
+	Dwarf_Half	uh_version;
+	Dwarf_Small	uh_unit_type;
+} Dwarf_Unit_Header;
+
 enum Dwarf_Form_Class {
 	DW_FORM_CLASS_UNKNOWN,
 	DW_FORM_CLASS_ADDRESS,
@@ -534,6 +542,7 @@ int		dwarf_bitoffset(Dwarf_Die, Dwarf_Unsigned *, Dwarf_Error *);
 int		dwarf_bitsize(Dwarf_Die, Dwarf_Unsigned *, Dwarf_Error *);
 int		dwarf_bytesize(Dwarf_Die, Dwarf_Unsigned *, Dwarf_Error *);
 int		dwarf_child(Dwarf_Die, Dwarf_Die *, Dwarf_Error *);
+void		dwarf_cu_dealloc(Dwarf_Debug, Dwarf_Die);
 void		dwarf_dealloc(Dwarf_Debug, Dwarf_Ptr, Dwarf_Unsigned);
 int		dwarf_def_macro(Dwarf_P_Debug, Dwarf_Unsigned, char *, char *,
 		    Dwarf_Error *);
@@ -599,6 +608,7 @@ int		dwarf_get_MACINFO_name(unsigned, const char **);
 int		dwarf_get_OP_name(unsigned, const char **);
 int		dwarf_get_ORD_name(unsigned, const char **);
 int		dwarf_get_TAG_name(unsigned, const char **);
+int		dwarf_get_UT_name(unsigned, const char **);
 int		dwarf_get_VIRTUALITY_name(unsigned, const char **);
 int		dwarf_get_VIS_name(unsigned, const char **);
 int		dwarf_get_abbrev(Dwarf_Debug, Dwarf_Unsigned, Dwarf_Abbrev *,
@@ -631,6 +641,8 @@ int		dwarf_get_cu_die_offset_given_cu_header_offset(Dwarf_Debug,
 		    Dwarf_Off, Dwarf_Off *, Dwarf_Error *);
 int		dwarf_get_cu_die_offset_given_cu_header_offset_b(Dwarf_Debug,
 		    Dwarf_Off, Dwarf_Bool, Dwarf_Off *, Dwarf_Error *);
+int		dwarf_get_cu_die_offset_given_pc(Dwarf_Debug, Dwarf_Addr,
+		    Dwarf_Off *, Dwarf_Addr *, Dwarf_Addr *, Dwarf_Error *);
 Dwarf_Bool	dwarf_get_die_infotypes_flag(Dwarf_Die);
 int		dwarf_get_elf(Dwarf_Debug, Elf **, Dwarf_Error *);
 int		dwarf_get_fde_at_pc(Dwarf_Fde *, Dwarf_Addr, Dwarf_Fde *,
@@ -698,6 +710,9 @@ int		dwarf_get_str(Dwarf_Debug, Dwarf_Off, char **, Dwarf_Signed *,
 		    Dwarf_Error *);
 int		dwarf_get_types(Dwarf_Debug, Dwarf_Type **, Dwarf_Signed *,
 		    Dwarf_Error *);
+int		dwarf_get_unit_headers(Dwarf_Debug, Dwarf_Bool,
+		    Dwarf_Unit_Header **, Dwarf_Unsigned *, Dwarf_Error *);
+int		dwarf_get_version_of_die(Dwarf_Die, Dwarf_Half *, Dwarf_Half *);
 int		dwarf_get_vars(Dwarf_Debug, Dwarf_Var **, Dwarf_Signed *,
 		    Dwarf_Error *);
 int		dwarf_get_weaks(Dwarf_Debug, Dwarf_Weak **, Dwarf_Signed *,
@@ -747,6 +762,9 @@ int		dwarf_loclist_from_expr_b(Dwarf_Debug, Dwarf_Ptr,
 int		dwarf_loclist_n(Dwarf_Attribute, Dwarf_Locdesc ***,
 		    Dwarf_Signed *, Dwarf_Error *);
 int		dwarf_lowpc(Dwarf_Die, Dwarf_Addr *, Dwarf_Error *);
+int		dwarf_name_index_build(Dwarf_Debug, int, Dwarf_Error *);
+int		dwarf_name_lookup(Dwarf_Debug, const char *, Dwarf_Off **,
+		    Dwarf_Unsigned *, Dwarf_Error *);
 Dwarf_P_Die	dwarf_new_die(Dwarf_P_Debug, Dwarf_Tag, Dwarf_P_Die,
 		    Dwarf_P_Die, Dwarf_P_Die, Dwarf_P_Die, Dwarf_Error *);
 Dwarf_P_Expr	dwarf_new_expr(Dwarf_P_Debug, Dwarf_Error *);
@@ -761,6 +779,10 @@ int		dwarf_next_cu_header_c(Dwarf_Debug, Dwarf_Bool,
 		    Dwarf_Unsigned *, Dwarf_Half *, Dwarf_Off *, Dwarf_Half *,
 		    Dwarf_Half *, Dwarf_Half *, Dwarf_Sig8 *, Dwarf_Unsigned *,
 		    Dwarf_Unsigned *, Dwarf_Error *);
+int		dwarf_next_cu_header_d(Dwarf_Debug, Dwarf_Bool,
+		    Dwarf_Unsigned *, Dwarf_Half *, Dwarf_Off *, Dwarf_Half *,
+		    Dwarf_Half *, Dwarf_Half *, Dwarf_Sig8 *, Dwarf_Unsigned *,
+		    Dwarf_Unsigned *, Dwarf_Half *, Dwarf_Error *);
 int		dwarf_next_types_section(Dwarf_Debug, Dwarf_Error *);
 int		dwarf_object_finish(Dwarf_Debug, Dwarf_Error *);
 int		dwarf_object_init(Dwarf_Obj_Access_Interface *, Dwarf_Handler,
@@ -50,6 +50,7 @@ _dwarf_abbrev_add(Dwarf_CU cu, uint64_t entry, uint64_t tag, uint8_t children,
 	ab->ab_offset	= aboff;
 	ab->ab_length	= 0;	/* fill in later. */
 	ab->ab_atnum	= 0;	/* fill in later. */
+	ab->ab_fixsize	= -1;	/* fill in later. */
 
 	/* Initialise the list of attribute definitions. */
 	STAILQ_INIT(&ab->ab_attrdef);
@@ -65,7 +66,8 @@ _dwarf_abbrev_add(Dwarf_CU cu, uint64_t entry, uint64_t tag, uint8_t children,
 
 int
 _dwarf_attrdef_add(Dwarf_Debug dbg, Dwarf_Abbrev ab, uint64_t attr,
-    uint64_t form, uint64_t adoff, Dwarf_AttrDef *adp, Dwarf_Error *error)
+    uint64_t form, uint64_t adoff, int64_t adconst, Dwarf_AttrDef *adp,
+    Dwarf_Error *error)
 {
 	Dwarf_AttrDef ad;
 
@@ -83,6 +85,8 @@ _dwarf_attrdef_add(Dwarf_Debug dbg, Dwarf_Abbrev ab, uint64_t attr,
 	ad->ad_attrib	= attr;
 	ad->ad_form	= form;
 	ad->ad_offset	= adoff;
+	ad->ad_const	= adconst;
+	ad->ad_fixoff	= -1;
 
 	/* Add the attribute definition to the list in the abbrev. */
 	STAILQ_INSERT_TAIL(&ab->ab_attrdef, ad, ad_next);
@@ -96,6 +100,32 @@ _dwarf_attrdef_add(Dwarf_Debug dbg, Dwarf_Abbrev ab, uint64_t attr,
 	return (DW_DLE_NONE);
 }
 
+/*
+ * Record where the value of each attribute lies in a DIE using this
+ * abbreviation, as long as all the values before it have a fixed size
+ * in unit 'cu'.  This lets attributes be found without decoding the
+ * attributes in front of them.
+ */
+static void
+_dwarf_abbrev_layout(Dwarf_CU cu, Dwarf_Abbrev ab)
+{
+	Dwarf_AttrDef ad;
+	int64_t off;
+	int size;
+
+	off = 0;
+	STAILQ_FOREACH(ad, &ab->ab_attrdef, ad_next) {
+		ad->ad_fixoff = off;
+		if (off < 0)
+			continue;
+		if ((size = _dwarf_attr_form_size(cu, ad->ad_form)) < 0)
+			off = -1;
+		else
+			off += size;
+	}
+	ab->ab_fixsize = off;
+}
+
 int
 _dwarf_abbrev_parse(Dwarf_Debug dbg, Dwarf_CU cu, Dwarf_Unsigned *offset,
     Dwarf_Abbrev *abp, Dwarf_Error *error)
@@ -104,6 +134,7 @@ _dwarf_abbrev_parse(Dwarf_Debug dbg, Dwarf_CU cu, Dwarf_Unsigned *offset,
 	uint64_t attr;
 	uint64_t entry;
 	uint64_t form;
+	int64_t adconst;
 	uint64_t aboff;
 	uint64_t adoff;
 	uint64_t tag;
@@ -140,14 +171,22 @@ _dwarf_abbrev_parse(Dwarf_Debug dbg, Dwarf_CU cu, Dwarf_Unsigned *offset,
 		adoff = *offset;
 		attr = _dwarf_read_uleb128(ds->ds_data, offset);
 		form = _dwarf_read_uleb128(ds->ds_data, offset);
+		/* DWARF5 constants stored in the abbreviation itself. */
+		adconst = 0;
+		if (form == DW_FORM_implicit_const)
+			adconst = _dwarf_read_sleb128(ds->ds_data, offset);
 		if (attr != 0)
 			if ((ret = _dwarf_attrdef_add(dbg, *abp, attr,
-			    form, adoff, NULL, error)) != DW_DLE_NONE)
+			    form, adoff, adconst, NULL, error)) !=
+			    DW_DLE_NONE)
 				return (ret);
 	} while (attr != 0);
 
 	(*abp)->ab_length = *offset - aboff;
 
+	if (cu != NULL)
+		_dwarf_abbrev_layout(cu, *abp);
+
 	return (ret);
 }
 
@@ -49,6 +49,8 @@ _dwarf_arange_cleanup(Dwarf_Debug dbg)
 
 	dbg->dbg_arange_array = NULL;
 	dbg->dbg_arange_cnt = 0;
+
+	_dwarf_pcmap_cleanup(&dbg->dbg_arange_pcmap);
 }
 
 int
@@ -125,6 +127,7 @@ _dwarf_arange_init(Dwarf_Debug dbg, Dwarf_Error *error)
 			if ((ar = calloc(1, sizeof(struct _Dwarf_Arange))) ==
 			    NULL) {
 				DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+				ret = DW_DLE_MEMORY;
 				goto fail_cleanup;
 			}
 			ar->ar_as = as;
@@ -0,0 +1,122 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "_libdwarf.h"
+
+ELFTC_VCSID("$Id$");
+
+/*
+ * Arena allocator for the small, numerous objects built by the
+ * consumer: DIEs, attributes and line number rows.
+ *
+ * Objects are carved out of large chunks and are only returned to
+ * the system when the whole arena is released, either with the unit
+ * that owns it or by dwarf_finish(3).  An object freed individually
+ * is kept on a free list for its size class and reused by the next
+ * allocation of that size, so a walk that releases DIEs as it goes
+ * does not grow the arena.
+ */
+
+struct _Dwarf_ArenaChunk {
+	struct _Dwarf_ArenaChunk *ac_next;	/* Next chunk. */
+	size_t		ac_size;		/* Usable size of chunk. */
+};
+
+#define	_ARENA_ROUND(s)		roundup2((s), _DWARF_ARENA_ALIGN)
+#define	_ARENA_CHUNK_HDR	_ARENA_ROUND(sizeof(struct _Dwarf_ArenaChunk))
+#define	_ARENA_CHUNK_MIN	4096
+#define	_ARENA_CHUNK_MAX	(128 * 1024)
+
+void *
+_dwarf_arena_alloc(Dwarf_Arena *ar, size_t size)
+{
+	struct _Dwarf_ArenaChunk *ac;
+	size_t csize;
+	void **fl, *p;
+
+	assert(ar != NULL && size > 0 && size <= _DWARF_ARENA_MAXSIZE);
+
+	size = _ARENA_ROUND(size);
+	fl = &ar->ar_free[size / _DWARF_ARENA_ALIGN - 1];
+
+	if ((p = *fl) != NULL) {
+		*fl = *(void **) p;
+		memset(p, 0, size);
+		return (p);
+	}
+
+	if (ar->ar_avail < size) {
+		/* Chunks double in size as the arena grows. */
+		csize = ar->ar_chunk != NULL ? ar->ar_chunk->ac_size * 2 :
+		    _ARENA_CHUNK_MIN;
+		if (csize > _ARENA_CHUNK_MAX)
+			csize = _ARENA_CHUNK_MAX;
+		if ((ac = malloc(_ARENA_CHUNK_HDR + csize)) == NULL)
+			return (NULL);
+		ac->ac_size = csize;
+		ac->ac_next = ar->ar_chunk;
+		ar->ar_chunk = ac;
+		ar->ar_cur = (char *) ac + _ARENA_CHUNK_HDR;
+		ar->ar_avail = csize;
+	}
+
+	p = ar->ar_cur;
+	ar->ar_cur += size;
+	ar->ar_avail -= size;
+	memset(p, 0, size);
+
+	return (p);
+}
+
+void
+_dwarf_arena_free(Dwarf_Arena *ar, void *p, size_t size)
+{
+	void **fl;
+
+	assert(ar != NULL && size > 0 && size <= _DWARF_ARENA_MAXSIZE);
+
+	if (p == NULL)
+		return;
+
+	fl = &ar->ar_free[_ARENA_ROUND(size) / _DWARF_ARENA_ALIGN - 1];
+	*(void **) p = *fl;
+	*fl = p;
+}
+
+void
+_dwarf_arena_cleanup(Dwarf_Arena *ar)
+{
+	struct _Dwarf_ArenaChunk *ac, *tac;
+
+	assert(ar != NULL);
+
+	for (ac = ar->ar_chunk; ac != NULL; ac = tac) {
+		tac = ac->ac_next;
+		free(ac);
+	}
+
+	memset(ar, 0, sizeof(*ar));
+}
@@ -37,7 +37,13 @@ _dwarf_attr_alloc(Dwarf_Die die, Dwarf_Attribute *atp, Dwarf_Error *error)
 	assert(die != NULL);
 	assert(atp != NULL);
 
-	if ((at = calloc(1, sizeof(struct _Dwarf_Attribute))) == NULL) {
+	/* Attributes of a DIE read from a unit live in the unit's arena. */
+	if (die->die_cu != NULL)
+		at = _dwarf_arena_alloc(&die->die_cu->cu_arena,
+		    sizeof(struct _Dwarf_Attribute));
+	else
+		at = calloc(1, sizeof(struct _Dwarf_Attribute));
+	if (at == NULL) {
 		DWARF_SET_ERROR(die->die_dbg, error, DW_DLE_MEMORY);
 		return (DW_DLE_MEMORY);
 	}
@@ -65,6 +71,12 @@ _dwarf_attr_add(Dwarf_Die die, Dwarf_Attribute atref, Dwarf_Attribute *atp,
 	if (at->at_attrib == DW_AT_name) {
 		switch (at->at_form) {
 		case DW_FORM_strp:
+		case DW_FORM_line_strp:
+		case DW_FORM_strx:
+		case DW_FORM_strx1:
+		case DW_FORM_strx2:
+		case DW_FORM_strx3:
+		case DW_FORM_strx4:
 			die->die_name = at->u[1].s;
 			break;
 		case DW_FORM_string:
@@ -81,16 +93,256 @@ _dwarf_attr_add(Dwarf_Die die, Dwarf_Attribute atref, Dwarf_Attribute *atp,
 	return (DW_DLE_NONE);
 }
 
-Dwarf_Attribute
-_dwarf_attr_find(Dwarf_Die die, Dwarf_Half attr)
+/*
+ * Resolve a DWARF5 indexed form through the section bases of its unit.
+ * The index stays in u[0]; the string, address or section offset it
+ * denotes is stored in u[1].
+ */
+int
+_dwarf_attr_resolve(Dwarf_Debug dbg, Dwarf_CU cu, Dwarf_Attribute at,
+    Dwarf_Error *error)
 {
+	Dwarf_Section *ds;
+	uint64_t base, off, value;
+	int size;
+
+	switch (at->at_form) {
+	case DW_FORM_strx:
+	case DW_FORM_strx1:
+	case DW_FORM_strx2:
+	case DW_FORM_strx3:
+	case DW_FORM_strx4:
+		ds = dbg->dbg_str_offsets_sec;
+		base = cu->cu_str_offsets_base;
+		size = cu->cu_dwarf_size;
+		break;
+	case DW_FORM_addrx:
+	case DW_FORM_addrx1:
+	case DW_FORM_addrx2:
+	case DW_FORM_addrx3:
+	case DW_FORM_addrx4:
+		ds = dbg->dbg_addr_sec;
+		base = cu->cu_addr_base;
+		size = cu->cu_pointer_size;
+		break;
+	case DW_FORM_rnglistx:
+		ds = dbg->dbg_rnglists_sec;
+		base = cu->cu_rnglists_base;
+		size = cu->cu_dwarf_size;
+		break;
+	case DW_FORM_loclistx:
+		ds = dbg->dbg_loclists_sec;
+		base = cu->cu_loclists_base;
+		size = cu->cu_dwarf_size;
+		break;
+	default:
+		return (DW_DLE_NONE);
+	}
+
+	off = base + at->u[0].u64 * size;
+	if (ds == NULL || at->u[0].u64 > ds->ds_size / size ||
+	    off + size > ds->ds_size) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_ATTR_FORM_BAD);
+		return (DW_DLE_ATTR_FORM_BAD);
+	}
+	value = dbg->read(ds->ds_data, &off, size);
+
+	switch (at->at_form) {
+	case DW_FORM_addrx:
+	case DW_FORM_addrx1:
+	case DW_FORM_addrx2:
+	case DW_FORM_addrx3:
+	case DW_FORM_addrx4:
+		at->u[1].u64 = value;
+		break;
+	case DW_FORM_rnglistx:
+	case DW_FORM_loclistx:
+		/* Offsets are relative to the first entry of the table. */
+		at->u[1].u64 = base + value;
+		break;
+	default:
+		if (value >= dbg->dbg_strtab_size) {
+			DWARF_SET_ERROR(dbg, error, DW_DLE_ATTR_FORM_BAD);
+			return (DW_DLE_ATTR_FORM_BAD);
+		}
+		at->u[1].s = _dwarf_strtab_get_table(dbg) + value;
+		if (at->at_attrib == DW_AT_name)
+			at->at_die->die_name = at->u[1].s;
+		break;
+	}
+
+	return (DW_DLE_NONE);
+}
+
+/*
+ * DIEs other than the unit DIE are read without decoding their
+ * attributes; see _dwarf_die_parse().  An attribute of such a "lazy"
+ * DIE is decoded the first time it is asked for, and stays on the
+ * DIE's attribute list afterwards.  DIEs found by offset are shared
+ * between the threads using a unit, so the attribute list of a DIE
+ * read from a unit is only looked at with the unit locked.
+ */
+
+static int
+_dwarf_attr_lookup_locked(Dwarf_Die die, Dwarf_Half attr, Dwarf_Attribute *atp,
+    Dwarf_Error *error)
+{
+	Dwarf_Debug dbg;
+	Dwarf_CU cu;
+	Dwarf_Section *ds;
 	Dwarf_Attribute at;
+	Dwarf_AttrDef ad, nad;
+	uint64_t offset;
+	int ret;
 
 	STAILQ_FOREACH(at, &die->die_attr, at_next) {
-		if (at->at_attrib == attr)
+		if (at->at_attrib == attr) {
+			*atp = at;
+			return (DW_DLE_NONE);
+		}
+	}
+
+	if (!die->die_lazy)
+		return (DW_DLE_NO_ENTRY);
+
+	dbg = die->die_dbg;
+	cu = die->die_cu;
+	ds = cu->cu_is_info ? dbg->dbg_info_sec : dbg->dbg_types_sec;
+
+	/*
+	 * Values at a fixed offset are reached directly, the others by
+	 * skipping over the values in front of them.
+	 */
+	offset = die->die_attr_off;
+	STAILQ_FOREACH(ad, &die->die_ab->ab_attrdef, ad_next) {
+		if (ad->ad_fixoff >= 0)
+			offset = die->die_attr_off + ad->ad_fixoff;
+		if (ad->ad_attrib == attr)
+			break;
+		nad = STAILQ_NEXT(ad, ad_next);
+		if (nad != NULL && nad->ad_fixoff < 0 &&
+		    (ret = _dwarf_attr_skip(dbg, ds, &offset, cu, ad->ad_form,
+		    error)) != DW_DLE_NONE)
+			return (ret);
+	}
+	if (ad == NULL)
+		return (DW_DLE_NO_ENTRY);
+
+	if ((ret = _dwarf_attr_init(dbg, ds, &offset, cu->cu_dwarf_size, cu,
+	    die, ad, ad->ad_form, 0, error)) != DW_DLE_NONE)
+		return (ret);
+
+	*atp = STAILQ_LAST(&die->die_attr, _Dwarf_Attribute, at_next);
+
+	return (DW_DLE_NONE);
+}
+
+static int
+_dwarf_attr_load_locked(Dwarf_Die die, Dwarf_Error *error)
+{
+	STAILQ_HEAD(, _Dwarf_Attribute) atlist;
+	Dwarf_Debug dbg;
+	Dwarf_CU cu;
+	Dwarf_Section *ds;
+	Dwarf_Attribute at;
+	Dwarf_AttrDef ad;
+	uint64_t offset, voff;
+	int ret;
+
+	if (!die->die_lazy)
+		return (DW_DLE_NONE);
+
+	dbg = die->die_dbg;
+	cu = die->die_cu;
+	ds = cu->cu_is_info ? dbg->dbg_info_sec : dbg->dbg_types_sec;
+
+	ret = DW_DLE_NONE;
+	STAILQ_INIT(&atlist);
+	offset = die->die_attr_off;
+	STAILQ_FOREACH(ad, &die->die_ab->ab_attrdef, ad_next) {
+		/* Decoded attributes are recorded at their value offset. */
+		voff = offset;
+		if (ad->ad_form == DW_FORM_indirect)
+			(void) _dwarf_read_uleb128(ds->ds_data, &voff);
+		STAILQ_FOREACH(at, &die->die_attr, at_next) {
+			if (at->at_attrib == ad->ad_attrib &&
+			    at->at_offset == voff)
+				break;
+		}
+		if (at != NULL)
+			ret = _dwarf_attr_skip(dbg, ds, &offset, cu,
+			    ad->ad_form, error);
+		else {
+			ret = _dwarf_attr_init(dbg, ds, &offset,
+			    cu->cu_dwarf_size, cu, die, ad, ad->ad_form, 0,
+			    error);
+			at = STAILQ_LAST(&die->die_attr, _Dwarf_Attribute,
+			    at_next);
+		}
+		if (ret != DW_DLE_NONE)
 			break;
+		STAILQ_REMOVE(&die->die_attr, at, _Dwarf_Attribute, at_next);
+		STAILQ_INSERT_TAIL(&atlist, at, at_next);
 	}
 
+	/* Attributes still on the DIE's list, if any, go last. */
+	STAILQ_CONCAT(&atlist, &die->die_attr);
+	STAILQ_CONCAT(&die->die_attr, &atlist);
+
+	if (ret == DW_DLE_NONE)
+		die->die_lazy = 0;
+
+	return (ret);
+}
+
+/* Find the attribute 'attr' of a DIE, decoding it if needed. */
+int
+_dwarf_attr_lookup(Dwarf_Die die, Dwarf_Half attr, Dwarf_Attribute *atp,
+    Dwarf_Error *error)
+{
+	int ret;
+
+	if (die->die_cu == NULL)
+		return (_dwarf_attr_lookup_locked(die, attr, atp, error));
+
+	DWARF_CU_LOCK(die->die_cu);
+	ret = _dwarf_attr_lookup_locked(die, attr, atp, error);
+	DWARF_CU_UNLOCK(die->die_cu);
+
+	return (ret);
+}
+
+/*
+ * Decode all the attributes of a DIE that are not decoded yet, and
+ * leave the attribute list in abbreviation order.
+ */
+int
+_dwarf_attr_load(Dwarf_Die die, Dwarf_Error *error)
+{
+	int ret;
+
+	if (die->die_cu == NULL)
+		return (_dwarf_attr_load_locked(die, error));
+
+	DWARF_CU_LOCK(die->die_cu);
+	ret = _dwarf_attr_load_locked(die, error);
+	DWARF_CU_UNLOCK(die->die_cu);
+
+	return (ret);
+}
+
+/*
+ * Find the attribute 'attr' of a DIE.  Errors decoding the attribute
+ * are reported through the error handler.
+ */
+Dwarf_Attribute
+_dwarf_attr_find(Dwarf_Die die, Dwarf_Half attr)
+{
+	Dwarf_Attribute at;
+
+	if (_dwarf_attr_lookup(die, attr, &at, NULL) != DW_DLE_NONE)
+		return (NULL);
+
 	return (at);
 }
 
@@ -100,6 +352,7 @@ _dwarf_attr_init(Dwarf_Debug dbg, Dwarf_Section *ds, uint64_t *offsetp,
     uint64_t form, int indirect, Dwarf_Error *error)
 {
 	struct _Dwarf_Attribute atref;
+	Dwarf_Section *ls;
 	int ret;
 
 	ret = DW_DLE_NONE;
@@ -152,8 +405,43 @@ _dwarf_attr_init(Dwarf_Debug dbg, Dwarf_Section *ds, uint64_t *offsetp,
 		break;
 	case DW_FORM_data8:
 	case DW_FORM_ref8:
+	case DW_FORM_ref_sup8:
 		atref.u[0].u64 = dbg->read(ds->ds_data, offsetp, 8);
 		break;
+	case DW_FORM_data16:
+		atref.u[0].u64 = 16;
+		atref.u[1].u8p = _dwarf_read_block(ds->ds_data, offsetp,
+		    atref.u[0].u64);
+		break;
+	case DW_FORM_implicit_const:
+		/* The value lives in the abbreviation, not in the DIE. */
+		atref.u[0].s64 = ad->ad_const;
+		break;
+	case DW_FORM_ref_sup4:
+		atref.u[0].u64 = dbg->read(ds->ds_data, offsetp, 4);
+		break;
+	case DW_FORM_strx:
+	case DW_FORM_addrx:
+	case DW_FORM_rnglistx:
+	case DW_FORM_loclistx:
+		atref.u[0].u64 = _dwarf_read_uleb128(ds->ds_data, offsetp);
+		break;
+	case DW_FORM_strx1:
+	case DW_FORM_addrx1:
+		atref.u[0].u64 = dbg->read(ds->ds_data, offsetp, 1);
+		break;
+	case DW_FORM_strx2:
+	case DW_FORM_addrx2:
+		atref.u[0].u64 = dbg->read(ds->ds_data, offsetp, 2);
+		break;
+	case DW_FORM_strx3:
+	case DW_FORM_addrx3:
+		atref.u[0].u64 = dbg->read(ds->ds_data, offsetp, 3);
+		break;
+	case DW_FORM_strx4:
+	case DW_FORM_addrx4:
+		atref.u[0].u64 = dbg->read(ds->ds_data, offsetp, 4);
+		break;
 	case DW_FORM_indirect:
 		form = _dwarf_read_uleb128(ds->ds_data, offsetp);
 		return (_dwarf_attr_init(dbg, ds, offsetp, dwarf_size, cu, die,
@@ -184,6 +472,21 @@ _dwarf_attr_init(Dwarf_Debug dbg, Dwarf_Section *ds, uint64_t *offsetp,
 		atref.u[0].u64 = dbg->read(ds->ds_data, offsetp, dwarf_size);
 		atref.u[1].s = _dwarf_strtab_get_table(dbg) + atref.u[0].u64;
 		break;
+	case DW_FORM_line_strp:
+		atref.u[0].u64 = dbg->read(ds->ds_data, offsetp, dwarf_size);
+		ls = dbg->dbg_line_str_sec;
+		if (ls == NULL || atref.u[0].u64 >= ls->ds_size) {
+			DWARF_SET_ERROR(dbg, error, DW_DLE_ATTR_FORM_BAD);
+			return (DW_DLE_ATTR_FORM_BAD);
+		}
+		atref.u[1].s = (char *) ls->ds_data + atref.u[0].u64;
+		break;
+	case DW_FORM_strp_sup:
+	case DW_FORM_GNU_strp_alt:
+	case DW_FORM_GNU_ref_alt:
+		/* Offsets into a supplementary object file. */
+		atref.u[0].u64 = dbg->read(ds->ds_data, offsetp, dwarf_size);
+		break;
 	case DW_FORM_ref_sig8:
 		atref.u[0].u64 = 8;
 		atref.u[1].u8p = _dwarf_read_block(ds->ds_data, offsetp,
@@ -201,16 +504,137 @@ _dwarf_attr_init(Dwarf_Debug dbg, Dwarf_Section *ds, uint64_t *offsetp,
 
 	if (ret == DW_DLE_NONE) {
 		if (form == DW_FORM_block || form == DW_FORM_block1 ||
-		    form == DW_FORM_block2 || form == DW_FORM_block4) {
+		    form == DW_FORM_block2 || form == DW_FORM_block4 ||
+		    form == DW_FORM_data16) {
 			atref.at_block.bl_len = atref.u[0].u64;
 			atref.at_block.bl_data = atref.u[1].u8p;
 		}
-		ret = _dwarf_attr_add(die, &atref, NULL, error);
+		/*
+		 * Indexed forms of the unit DIE are resolved by the
+		 * caller once the unit's section bases are known.
+		 */
+		if (cu->cu_bases_loaded)
+			ret = _dwarf_attr_resolve(dbg, cu, &atref, error);
+		if (ret == DW_DLE_NONE)
+			ret = _dwarf_attr_add(die, &atref, NULL, error);
 	}
 
 	return (ret);
 }
 
+/*
+ * Return the size of an attribute value of the given form in a DIE of
+ * unit 'cu', or -1 if the size varies from value to value.
+ */
+int
+_dwarf_attr_form_size(Dwarf_CU cu, uint64_t form)
+{
+
+	switch (form) {
+	case DW_FORM_flag_present:
+	case DW_FORM_implicit_const:
+		return (0);
+	case DW_FORM_data1:
+	case DW_FORM_flag:
+	case DW_FORM_ref1:
+	case DW_FORM_strx1:
+	case DW_FORM_addrx1:
+		return (1);
+	case DW_FORM_data2:
+	case DW_FORM_ref2:
+	case DW_FORM_strx2:
+	case DW_FORM_addrx2:
+		return (2);
+	case DW_FORM_strx3:
+	case DW_FORM_addrx3:
+		return (3);
+	case DW_FORM_data4:
+	case DW_FORM_ref4:
+	case DW_FORM_ref_sup4:
+	case DW_FORM_strx4:
+	case DW_FORM_addrx4:
+		return (4);
+	case DW_FORM_data8:
+	case DW_FORM_ref8:
+	case DW_FORM_ref_sup8:
+	case DW_FORM_ref_sig8:
+		return (8);
+	case DW_FORM_data16:
+		return (16);
+	case DW_FORM_addr:
+		return (cu->cu_pointer_size);
+	case DW_FORM_ref_addr:
+		return (cu->cu_version == 2 ? cu->cu_pointer_size :
+		    cu->cu_dwarf_size);
+	case DW_FORM_sec_offset:
+	case DW_FORM_strp:
+	case DW_FORM_line_strp:
+	case DW_FORM_strp_sup:
+	case DW_FORM_GNU_strp_alt:
+	case DW_FORM_GNU_ref_alt:
+		return (cu->cu_dwarf_size);
+	default:
+		return (-1);
+	}
+}
+
+/*
+ * Advance '*offsetp' past an attribute value of the given form without
+ * materializing it.
+ */
+int
+_dwarf_attr_skip(Dwarf_Debug dbg, Dwarf_Section *ds, uint64_t *offsetp,
+    Dwarf_CU cu, uint64_t form, Dwarf_Error *error)
+{
+	uint64_t len;
+	int size;
+
+	if ((size = _dwarf_attr_form_size(cu, form)) >= 0) {
+		*offsetp += size;
+		return (DW_DLE_NONE);
+	}
+
+	switch (form) {
+	case DW_FORM_udata:
+	case DW_FORM_ref_udata:
+	case DW_FORM_sdata:
+	case DW_FORM_strx:
+	case DW_FORM_addrx:
+	case DW_FORM_rnglistx:
+	case DW_FORM_loclistx:
+		(void) _dwarf_read_uleb128(ds->ds_data, offsetp);
+		break;
+	case DW_FORM_string:
+		(void) _dwarf_read_string(ds->ds_data, ds->ds_size, offsetp);
+		break;
+	case DW_FORM_block:
+	case DW_FORM_exprloc:
+		len = _dwarf_read_uleb128(ds->ds_data, offsetp);
+		*offsetp += len;
+		break;
+	case DW_FORM_block1:
+		len = dbg->read(ds->ds_data, offsetp, 1);
+		*offsetp += len;
+		break;
+	case DW_FORM_block2:
+		len = dbg->read(ds->ds_data, offsetp, 2);
+		*offsetp += len;
+		break;
+	case DW_FORM_block4:
+		len = dbg->read(ds->ds_data, offsetp, 4);
+		*offsetp += len;
+		break;
+	case DW_FORM_indirect:
+		form = _dwarf_read_uleb128(ds->ds_data, offsetp);
+		return (_dwarf_attr_skip(dbg, ds, offsetp, cu, form, error));
+	default:
+		DWARF_SET_ERROR(dbg, error, DW_DLE_ATTR_FORM_BAD);
+		return (DW_DLE_ATTR_FORM_BAD);
+	}
+
+	return (DW_DLE_NONE);
+}
+
 static int
 _dwarf_attr_write(Dwarf_P_Debug dbg, Dwarf_P_Section ds, Dwarf_Rel_Section drs,
     Dwarf_CU cu, Dwarf_Attribute at, int pass2, Dwarf_Error *error)
@@ -29,19 +29,32 @@
 
 ELFTC_VCSID("$Id$");
 
+/*
+ * Allocate a DIE.  DIEs read from a unit are allocated from the arena
+ * of unit 'cu' and kept on its list of live DIEs, producer DIEs (cu is
+ * NULL) from the heap.
+ */
 int
-_dwarf_die_alloc(Dwarf_Debug dbg, Dwarf_Die *ret_die, Dwarf_Error *error)
+_dwarf_die_alloc(Dwarf_Debug dbg, Dwarf_CU cu, Dwarf_Die *ret_die,
+    Dwarf_Error *error)
 {
 	Dwarf_Die die;
 
 	assert(ret_die != NULL);
 
-	if ((die = calloc(1, sizeof(struct _Dwarf_Die))) == NULL) {
+	if (cu != NULL)
+		die = _dwarf_arena_alloc(&cu->cu_arena,
+		    sizeof(struct _Dwarf_Die));
+	else
+		die = calloc(1, sizeof(struct _Dwarf_Die));
+	if (die == NULL) {
 		DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
 		return (DW_DLE_MEMORY);
 	}
 
 	STAILQ_INIT(&die->die_attr);
+	if (cu != NULL)
+		LIST_INSERT_HEAD(&cu->cu_die_live, die, die_cu_next);
 
 	*ret_die = die;
 
@@ -61,7 +74,7 @@ _dwarf_die_add(Dwarf_CU cu, uint64_t offset, uint64_t abnum, Dwarf_Abbrev ab,
 
 	dbg = cu->cu_dbg;
 
-	if ((ret = _dwarf_die_alloc(dbg, &die, error)) != DW_DLE_NONE)
+	if ((ret = _dwarf_die_alloc(dbg, cu, &die, error)) != DW_DLE_NONE)
 		return (ret);
 
 	die->die_offset	= offset;
@@ -76,32 +89,274 @@ _dwarf_die_add(Dwarf_CU cu, uint64_t offset, uint64_t abnum, Dwarf_Abbrev ab,
 	return (DW_DLE_NONE);
 }
 
+/* Advance '*offsetp' past the attribute values of a DIE. */
+static int
+_dwarf_die_skip_attrs(Dwarf_Debug dbg, Dwarf_Section *ds, Dwarf_CU cu,
+    Dwarf_Abbrev ab, uint64_t *offsetp, Dwarf_Error *error)
+{
+	Dwarf_AttrDef ad;
+	int ret;
+
+	if (ab->ab_fixsize >= 0) {
+		*offsetp += ab->ab_fixsize;
+		return (DW_DLE_NONE);
+	}
+
+	STAILQ_FOREACH(ad, &ab->ab_attrdef, ad_next) {
+		if ((ret = _dwarf_attr_skip(dbg, ds, offsetp, cu, ad->ad_form,
+		    error)) != DW_DLE_NONE)
+			return (ret);
+	}
+
+	return (DW_DLE_NONE);
+}
+
 /* Find die at offset 'off' within the same CU. */
 Dwarf_Die
 _dwarf_die_find(Dwarf_Die die, Dwarf_Unsigned off)
 {
-	Dwarf_Debug dbg;
-	Dwarf_Section *ds;
-	Dwarf_CU cu;
 	Dwarf_Die die1;
 	Dwarf_Error de;
+
+	if (_dwarf_die_lookup(die->die_dbg, die->die_cu, off, &die1, &de) !=
+	    DW_DLE_NONE)
+		return (NULL);
+
+	return (die1);
+}
+
+/*
+ * Record the offset of every DIE in a unit.  The abbreviations tell
+ * us which attributes each DIE has, so the attribute values are only
+ * skipped over, not decoded.
+ */
+static int
+_dwarf_die_index_build(Dwarf_Debug dbg, Dwarf_CU cu, Dwarf_Error *error)
+{
+	Dwarf_Section *ds;
+	Dwarf_Abbrev ab;
+	uint64_t abnum, cap, die_offset, offset, *off;
 	int ret;
 
-	cu = die->die_cu;
-	dbg = die->die_dbg;
 	ds = cu->cu_is_info ? dbg->dbg_info_sec : dbg->dbg_types_sec;
 
-	ret = _dwarf_die_parse(dbg, ds, cu, cu->cu_dwarf_size, off,
-	    cu->cu_next_offset, &die1, 0, &de);
+	cap = 0;
+	offset = cu->cu_1st_offset;
+	while (offset < cu->cu_next_offset && offset < ds->ds_size) {
+		die_offset = offset;
+		abnum = _dwarf_read_uleb128(ds->ds_data, &offset);
+		if (abnum == 0)
+			continue;
+
+		if ((ret = _dwarf_abbrev_find(cu, abnum, &ab, error)) !=
+		    DW_DLE_NONE)
+			goto fail_cleanup;
+
+		if (cu->cu_die_cnt == cap) {
+			cap = cap > 0 ? cap * 2 : 256;
+			if ((off = realloc(cu->cu_die_off, cap *
+			    sizeof(*off))) == NULL) {
+				DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+				ret = DW_DLE_MEMORY;
+				goto fail_cleanup;
+			}
+			cu->cu_die_off = off;
+		}
+		cu->cu_die_off[cu->cu_die_cnt++] = die_offset;
 
-	if (ret == DW_DLE_NONE)
-		return (die1);
-	else
-		return (NULL);
+		if ((ret = _dwarf_die_skip_attrs(dbg, ds, cu, ab, &offset,
+		    error)) != DW_DLE_NONE)
+			goto fail_cleanup;
+	}
+
+	if ((cu->cu_die_cache = calloc(cu->cu_die_cnt > 0 ? cu->cu_die_cnt :
+	    1, sizeof(Dwarf_Die))) == NULL) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+		ret = DW_DLE_MEMORY;
+		goto fail_cleanup;
+	}
+
+	return (DW_DLE_NONE);
+
+fail_cleanup:
+
+	free(cu->cu_die_off);
+	cu->cu_die_off = NULL;
+	cu->cu_die_cnt = 0;
+
+	return (ret);
+}
+
+/*
+ * Return the DIE at section offset 'offset' of a unit.  The first
+ * lookup builds an index of the DIE offsets in the unit.  A DIE found
+ * through the index is kept in a per-unit cache and returned again by
+ * later lookups of the same offset.  Cached DIEs live until the unit
+ * is released, so dwarf_dealloc() ignores them.
+ */
+static int
+_dwarf_die_lookup_locked(Dwarf_Debug dbg, Dwarf_CU cu, uint64_t offset,
+    Dwarf_Die *ret_die, Dwarf_Error *error)
+{
+	Dwarf_Section *ds;
+	Dwarf_Die die;
+	uint64_t lo, hi, mid;
+	int ret;
+
+	if (cu->cu_die_cache == NULL &&
+	    (ret = _dwarf_die_index_build(dbg, cu, error)) != DW_DLE_NONE)
+		return (ret);
+
+	lo = 0;
+	hi = cu->cu_die_cnt;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (cu->cu_die_off[mid] < offset)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo == cu->cu_die_cnt || cu->cu_die_off[lo] != offset) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
+		return (DW_DLE_NO_ENTRY);
+	}
+
+	if ((die = cu->cu_die_cache[lo]) == NULL) {
+		ds = cu->cu_is_info ? dbg->dbg_info_sec : dbg->dbg_types_sec;
+		ret = _dwarf_die_parse(dbg, ds, cu, cu->cu_dwarf_size, offset,
+		    cu->cu_next_offset, &die, 0, error);
+		if (ret != DW_DLE_NONE)
+			return (ret);
+		die->die_cached = 1;
+		cu->cu_die_cache[lo] = die;
+	}
+
+	*ret_die = die;
+
+	return (DW_DLE_NONE);
 }
 
 int
-_dwarf_die_parse(Dwarf_Debug dbg, Dwarf_Section *ds, Dwarf_CU cu,
+_dwarf_die_lookup(Dwarf_Debug dbg, Dwarf_CU cu, uint64_t offset,
+    Dwarf_Die *ret_die, Dwarf_Error *error)
+{
+	int ret;
+
+	assert(dbg != NULL && cu != NULL && ret_die != NULL);
+
+	DWARF_CU_LOCK(cu);
+	ret = _dwarf_die_lookup_locked(dbg, cu, offset, ret_die, error);
+	DWARF_CU_UNLOCK(cu);
+
+	return (ret);
+}
+
+void
+_dwarf_die_cache_cleanup(Dwarf_CU cu)
+{
+	Dwarf_Die die;
+	uint64_t i;
+
+	if (cu->cu_die_cache != NULL) {
+		for (i = 0; i < cu->cu_die_cnt; i++) {
+			if ((die = cu->cu_die_cache[i]) == NULL)
+				continue;
+			die->die_cached = 0;
+			dwarf_dealloc(cu->cu_dbg, die, DW_DLA_DIE);
+		}
+		free(cu->cu_die_cache);
+		cu->cu_die_cache = NULL;
+	}
+
+	free(cu->cu_die_off);
+	cu->cu_die_off = NULL;
+	cu->cu_die_cnt = 0;
+}
+
+/*
+ * Record the section bases and the base address of a unit from its
+ * unit DIE, then resolve the indexed attributes of that DIE which
+ * could not be resolved while it was being parsed.
+ */
+static int
+_dwarf_die_set_bases(Dwarf_Debug dbg, Dwarf_CU cu, Dwarf_Die die,
+    Dwarf_Error *error)
+{
+	Dwarf_Attribute at;
+	int ret;
+
+	cu->cu_str_offsets_base = cu->cu_addr_base = cu->cu_dwarf_size * 2;
+	cu->cu_rnglists_base = cu->cu_loclists_base = cu->cu_dwarf_size * 2 + 4;
+	cu->cu_lowpc = 0;
+	cu->cu_bases_loaded = 1;
+
+	if (die == NULL)
+		return (DW_DLE_NONE);
+
+	STAILQ_FOREACH(at, &die->die_attr, at_next) {
+		switch (at->at_attrib) {
+		case DW_AT_str_offsets_base:
+			cu->cu_str_offsets_base = at->u[0].u64;
+			break;
+		case DW_AT_addr_base:
+			cu->cu_addr_base = at->u[0].u64;
+			break;
+		case DW_AT_rnglists_base:
+			cu->cu_rnglists_base = at->u[0].u64;
+			break;
+		case DW_AT_loclists_base:
+			cu->cu_loclists_base = at->u[0].u64;
+			break;
+		default:
+			break;
+		}
+	}
+
+	STAILQ_FOREACH(at, &die->die_attr, at_next) {
+		if ((ret = _dwarf_attr_resolve(dbg, cu, at, error)) !=
+		    DW_DLE_NONE)
+			return (ret);
+		if (at->at_attrib == DW_AT_low_pc)
+			cu->cu_lowpc = (at->at_form == DW_FORM_addr) ?
+			    at->u[0].u64 : at->u[1].u64;
+	}
+
+	return (DW_DLE_NONE);
+}
+
+/*
+ * Make the section bases of a unit known before one of its DIEs, other
+ * than the unit DIE, is parsed.
+ */
+int
+_dwarf_die_load_bases(Dwarf_Debug dbg, Dwarf_CU cu, Dwarf_Error *error)
+{
+	Dwarf_Section *ds;
+	Dwarf_Die die;
+	int ret;
+
+	DWARF_CU_LOCK(cu);
+
+	if (cu->cu_bases_loaded) {
+		DWARF_CU_UNLOCK(cu);
+		return (DW_DLE_NONE);
+	}
+
+	ds = cu->cu_is_info ? dbg->dbg_info_sec : dbg->dbg_types_sec;
+	ret = _dwarf_die_parse(dbg, ds, cu, cu->cu_dwarf_size,
+	    cu->cu_1st_offset, cu->cu_next_offset, &die, 0, error);
+	if (ret == DW_DLE_NO_ENTRY)
+		ret = _dwarf_die_set_bases(dbg, cu, NULL, error);
+	else if (ret == DW_DLE_NONE)
+		dwarf_dealloc(dbg, die, DW_DLA_DIE);
+
+	DWARF_CU_UNLOCK(cu);
+
+	return (ret);
+}
+
+static int
+_dwarf_die_parse_locked(Dwarf_Debug dbg, Dwarf_Section *ds, Dwarf_CU cu,
     int dwarf_size, uint64_t offset, uint64_t next_offset, Dwarf_Die *ret_die,
     int search_sibling, Dwarf_Error *error)
 {
@@ -138,33 +393,75 @@ _dwarf_die_parse(Dwarf_Debug dbg, Dwarf_Section *ds, Dwarf_CU cu,
 		    DW_DLE_NONE)
 			return (ret);
 
-		if ((ret = _dwarf_die_add(cu, die_offset, abnum, ab, &die,
-		    error)) != DW_DLE_NONE)
+		if (!cu->cu_bases_loaded && die_offset != cu->cu_1st_offset &&
+		    (ret = _dwarf_die_load_bases(dbg, cu, error)) !=
+		    DW_DLE_NONE)
 			return (ret);
 
-		STAILQ_FOREACH(ad, &ab->ab_attrdef, ad_next) {
-			if ((ret = _dwarf_attr_init(dbg, ds, &offset,
-			    dwarf_size, cu, die, ad, ad->ad_form, 0,
-			    error)) != DW_DLE_NONE)
-				return (ret);
-		}
-
-		die->die_next_off = offset;
 		if (search_sibling && level > 0) {
-			dwarf_dealloc(dbg, die, DW_DLA_DIE);
+			/* Step over the DIE without building it. */
+			if ((ret = _dwarf_die_skip_attrs(dbg, ds, cu, ab,
+			    &offset, error)) != DW_DLE_NONE)
+				return (ret);
 			if (ab->ab_children == DW_CHILDREN_yes) {
 				/* Advance to next DIE level. */
 				level++;
 			}
+			continue;
+		}
+
+		if ((ret = _dwarf_die_add(cu, die_offset, abnum, ab, &die,
+		    error)) != DW_DLE_NONE)
+			return (ret);
+
+		/*
+		 * The attributes of the unit DIE are decoded right away,
+		 * as they define the section bases of the unit.  Those
+		 * of other DIEs are decoded when first asked for.
+		 */
+		if (die_offset == cu->cu_1st_offset) {
+			STAILQ_FOREACH(ad, &ab->ab_attrdef, ad_next) {
+				if ((ret = _dwarf_attr_init(dbg, ds, &offset,
+				    dwarf_size, cu, die, ad, ad->ad_form, 0,
+				    error)) != DW_DLE_NONE)
+					return (ret);
+			}
 		} else {
-			*ret_die = die;
-			return (DW_DLE_NONE);
+			die->die_attr_off = offset;
+			die->die_lazy = (ab->ab_atnum > 0);
+			if ((ret = _dwarf_die_skip_attrs(dbg, ds, cu, ab,
+			    &offset, error)) != DW_DLE_NONE)
+				return (ret);
 		}
+
+		if (!cu->cu_bases_loaded &&
+		    (ret = _dwarf_die_set_bases(dbg, cu, die, error)) !=
+		    DW_DLE_NONE)
+			return (ret);
+
+		die->die_next_off = offset;
+		*ret_die = die;
+		return (DW_DLE_NONE);
 	}
 
 	return (DW_DLE_NO_ENTRY);
 }
 
+int
+_dwarf_die_parse(Dwarf_Debug dbg, Dwarf_Section *ds, Dwarf_CU cu,
+    int dwarf_size, uint64_t offset, uint64_t next_offset, Dwarf_Die *ret_die,
+    int search_sibling, Dwarf_Error *error)
+{
+	int ret;
+
+	DWARF_CU_LOCK(cu);
+	ret = _dwarf_die_parse_locked(dbg, ds, cu, dwarf_size, offset,
+	    next_offset, ret_die, search_sibling, error);
+	DWARF_CU_UNLOCK(cu);
+
+	return (ret);
+}
+
 void
 _dwarf_die_link(Dwarf_P_Die die, Dwarf_P_Die parent, Dwarf_P_Die child,
     Dwarf_P_Die left_sibling, Dwarf_P_Die right_sibling)
@@ -343,7 +640,7 @@ _dwarf_die_gen_recursive(Dwarf_P_Debug dbg, Dwarf_CU cu, Dwarf_Rel_Section drs,
 			return (ret);
 		STAILQ_FOREACH(at, &die->die_attr, at_next) {
 			ret = _dwarf_attrdef_add(dbg, ab, at->at_attrib,
-			    at->at_form, 0, NULL, error);
+			    at->at_form, 0, 0, NULL, error);
 			if (ret != DW_DLE_NONE)
 				return (ret);
 		}
@@ -131,6 +131,8 @@ _dwarf_elf_load_section(void *obj, Dwarf_Half ndx, Dwarf_Small** ret_data,
 {
 	Dwarf_Elf_Object *e;
 	Dwarf_Elf_Data *ed;
+	Elf_Scn *scn;
+	int ret;
 
 	e = obj;
 	assert(e != NULL);
@@ -149,6 +151,24 @@ _dwarf_elf_load_section(void *obj, Dwarf_Half ndx, Dwarf_Small** ret_data,
 
 	ed = &e->eo_data[ndx];
 
+	if (!ed->ed_loaded) {
+		(void) elf_errno();
+		if ((scn = elf_getscn(e->eo_elf, ed->ed_ndx)) == NULL ||
+		    ((ed->ed_data = elf_getdata(scn, NULL)) == NULL &&
+		    elf_errno() != 0)) {
+			if (error)
+				*error = DW_DLE_ELF;
+			return (DW_DLV_ERROR);
+		}
+		if (ed->ed_data != NULL && ed->ed_relndx != 0 &&
+		    (ret = _dwarf_elf_relocate(e, ed)) != DW_DLE_NONE) {
+			if (error)
+				*error = ret;
+			return (DW_DLV_ERROR);
+		}
+		ed->ed_loaded = 1;
+	}
+
 	if (ed->ed_alloc != NULL)
 		*ret_data = ed->ed_alloc;
 	else {
@@ -46,6 +46,13 @@ static const char *debug_name[] = {
 	".debug_static_vars",
 	".debug_typenames",
 	".debug_weaknames",
+	".debug_addr",
+	".debug_line_str",
+	".debug_loclists",
+	".debug_rnglists",
+	".debug_str_offsets",
+	".debug_names",
+	".gdb_index",
 	NULL
 };
 
@@ -127,71 +134,44 @@ _dwarf_elf_apply_rela_reloc(Dwarf_Debug dbg, void *buf, uint64_t bufsize,
 	}
 }
 
-static int
-_dwarf_elf_relocate(Dwarf_Debug dbg, Elf *elf, Dwarf_Elf_Data *ed, size_t shndx,
-    size_t symtab, Elf_Data *symtab_data, Dwarf_Error *error)
+/*
+ * Apply the relocations of a debug section to a private copy of its
+ * data.  This is done when the section is first loaded, so that debug
+ * sections of a relocatable object are only duplicated when used.
+ */
+int
+_dwarf_elf_relocate(Dwarf_Elf_Object *e, Dwarf_Elf_Data *ed)
 {
-	GElf_Ehdr eh;
 	GElf_Shdr sh;
 	Elf_Scn *scn;
-	Elf_Data *rel;
-	int elferr;
-
-	if (symtab == 0 || symtab_data == NULL)
-		return (DW_DLE_NONE);
+	Elf_Data *rel, *symtab_data;
 
-	if (gelf_getehdr(elf, &eh) == NULL) {
-		DWARF_SET_ELF_ERROR(dbg, error);
-		return (DW_DLE_ELF);
-	}
+	assert(ed->ed_data != NULL && ed->ed_relndx != 0);
 
-	scn = NULL;
 	(void) elf_errno();
-	while ((scn = elf_nextscn(elf, scn)) != NULL) {
-		if (gelf_getshdr(scn, &sh) == NULL) {
-			DWARF_SET_ELF_ERROR(dbg, error);
-			return (DW_DLE_ELF);
-		}
+	if ((scn = elf_getscn(e->eo_elf, ed->ed_relndx)) == NULL ||
+	    gelf_getshdr(scn, &sh) == NULL)
+		return (DW_DLE_ELF);
+	if ((rel = elf_getdata(scn, NULL)) == NULL)
+		return (elf_errno() != 0 ? DW_DLE_ELF : DW_DLE_NONE);
 
-		if ((sh.sh_type != SHT_REL && sh.sh_type != SHT_RELA) ||
-		     sh.sh_size == 0)
-			continue;
+	if ((scn = elf_getscn(e->eo_elf, e->eo_symtab)) == NULL)
+		return (DW_DLE_ELF);
+	if ((symtab_data = elf_getdata(scn, NULL)) == NULL)
+		return (elf_errno() != 0 ? DW_DLE_ELF : DW_DLE_NONE);
 
-		if (sh.sh_info == shndx && sh.sh_link == symtab) {
-			if ((rel = elf_getdata(scn, NULL)) == NULL) {
-				elferr = elf_errno();
-				if (elferr != 0) {
-					_DWARF_SET_ERROR(NULL, error,
-					    DW_DLE_ELF, elferr);
-					return (DW_DLE_ELF);
-				} else
-					return (DW_DLE_NONE);
-			}
+	if ((ed->ed_alloc = malloc(ed->ed_data->d_size)) == NULL)
+		return (DW_DLE_MEMORY);
+	memcpy(ed->ed_alloc, ed->ed_data->d_buf, ed->ed_data->d_size);
 
-			ed->ed_alloc = malloc(ed->ed_data->d_size);
-			if (ed->ed_alloc == NULL) {
-				DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
-				return (DW_DLE_MEMORY);
-			}
-			memcpy(ed->ed_alloc, ed->ed_data->d_buf,
-			    ed->ed_data->d_size);
-			if (sh.sh_type == SHT_REL)
-				_dwarf_elf_apply_rel_reloc(dbg,
-				    ed->ed_alloc, ed->ed_data->d_size,
-				    rel, symtab_data, eh.e_ident[EI_DATA]);
-			else
-				_dwarf_elf_apply_rela_reloc(dbg,
-				    ed->ed_alloc, ed->ed_data->d_size,
-				    rel, symtab_data, eh.e_ident[EI_DATA]);
-
-			return (DW_DLE_NONE);
-		}
-	}
-	elferr = elf_errno();
-	if (elferr != 0) {
-		DWARF_SET_ELF_ERROR(dbg, error);
-		return (DW_DLE_ELF);
-	}
+	if (sh.sh_type == SHT_REL)
+		_dwarf_elf_apply_rel_reloc(e->eo_dbg, ed->ed_alloc,
+		    ed->ed_data->d_size, rel, symtab_data,
+		    e->eo_ehdr.e_ident[EI_DATA]);
+	else
+		_dwarf_elf_apply_rela_reloc(e->eo_dbg, ed->ed_alloc,
+		    ed->ed_data->d_size, rel, symtab_data,
+		    e->eo_ehdr.e_ident[EI_DATA]);
 
 	return (DW_DLE_NONE);
 }
@@ -204,8 +184,7 @@ _dwarf_elf_init(Dwarf_Debug dbg, Elf *elf, Dwarf_Error *error)
 	const char *name;
 	GElf_Shdr sh;
 	Elf_Scn *scn;
-	Elf_Data *symtab_data;
-	size_t symtab_ndx;
+	size_t ndx;
 	int elferr, i, j, n, ret;
 
 	ret = DW_DLE_NONE;
@@ -221,6 +200,7 @@ _dwarf_elf_init(Dwarf_Debug dbg, Elf *elf, Dwarf_Error *error)
 		return (DW_DLE_MEMORY);
 	}
 
+	e->eo_dbg = dbg;
 	e->eo_elf = elf;
 	e->eo_methods.get_section_info = _dwarf_elf_get_section_info;
 	e->eo_methods.get_byte_order = _dwarf_elf_get_byte_order;
@@ -249,8 +229,6 @@ _dwarf_elf_init(Dwarf_Debug dbg, Elf *elf, Dwarf_Error *error)
 	}
 
 	n = 0;
-	symtab_ndx = 0;
-	symtab_data = NULL;
 	scn = NULL;
 	(void) elf_errno();
 	while ((scn = elf_nextscn(elf, scn)) != NULL) {
@@ -268,16 +246,7 @@ _dwarf_elf_init(Dwarf_Debug dbg, Elf *elf, Dwarf_Error *error)
 		}
 
 		if (!strcmp(name, ".symtab")) {
-			symtab_ndx = elf_ndxscn(scn);
-			if ((symtab_data = elf_getdata(scn, NULL)) == NULL) {
-				elferr = elf_errno();
-				if (elferr != 0) {
-					_DWARF_SET_ERROR(NULL, error,
-					    DW_DLE_ELF, elferr);
-					ret = DW_DLE_ELF;
-					goto fail_cleanup;
-				}
-			}
+			e->eo_symtab = elf_ndxscn(scn);
 			continue;
 		}
 
@@ -326,31 +295,50 @@ _dwarf_elf_init(Dwarf_Debug dbg, Elf *elf, Dwarf_Error *error)
 			if (strcmp(name, debug_name[i]))
 				continue;
 
-			(void) elf_errno();
-			if ((e->eo_data[j].ed_data = elf_getdata(scn, NULL)) ==
-			    NULL) {
-				elferr = elf_errno();
-				if (elferr != 0) {
-					_DWARF_SET_ERROR(dbg, error,
-					    DW_DLE_ELF, elferr);
-					ret = DW_DLE_ELF;
-					goto fail_cleanup;
-				}
-			}
-
-			if (_libdwarf.applyreloc) {
-				if (_dwarf_elf_relocate(dbg, elf,
-				    &e->eo_data[j], elf_ndxscn(scn), symtab_ndx,
-				    symtab_data, error) != DW_DLE_NONE)
-					goto fail_cleanup;
-			}
-
+			/* Section data is read when the section is loaded. */
+			e->eo_data[j].ed_ndx = elf_ndxscn(scn);
 			j++;
 		}
 	}
 
 	assert(j == n);
 
+	if (!_libdwarf.applyreloc || e->eo_symtab == 0)
+		return (DW_DLE_NONE);
+
+	/*
+	 * Note which debug sections have relocations against the symbol
+	 * table.  They are applied when a section is loaded.
+	 */
+	scn = NULL;
+	(void) elf_errno();
+	while ((scn = elf_nextscn(elf, scn)) != NULL) {
+		if (gelf_getshdr(scn, &sh) == NULL) {
+			DWARF_SET_ELF_ERROR(dbg, error);
+			ret = DW_DLE_ELF;
+			goto fail_cleanup;
+		}
+
+		if ((sh.sh_type != SHT_REL && sh.sh_type != SHT_RELA) ||
+		    sh.sh_size == 0 || sh.sh_link != e->eo_symtab)
+			continue;
+
+		ndx = elf_ndxscn(scn);
+		for (j = 0; j < n; j++) {
+			if (e->eo_data[j].ed_ndx == sh.sh_info &&
+			    e->eo_data[j].ed_relndx == 0) {
+				e->eo_data[j].ed_relndx = ndx;
+				break;
+			}
+		}
+	}
+	elferr = elf_errno();
+	if (elferr != 0) {
+		DWARF_SET_ELF_ERROR(dbg, error);
+		ret = DW_DLE_ELF;
+		goto fail_cleanup;
+	}
+
 	return (DW_DLE_NONE);
 
 fail_cleanup:
@@ -28,6 +28,9 @@
 
 ELFTC_VCSID("$Id$");
 
+/* Column of the CFA rule in compiled register rule tables. */
+#define	_DWARF_FRAME_CFA_COL	0xffff
+
 static int
 _dwarf_frame_find_cie(Dwarf_FrameSec fs, Dwarf_Unsigned offset,
     Dwarf_Cie *ret_cie)
@@ -412,6 +415,22 @@ _dwarf_frame_add_fde(Dwarf_Debug dbg, Dwarf_FrameSec fs, Dwarf_Section *ds,
 	return (DW_DLE_NONE);
 }
 
+static void
+_dwarf_frame_table_free(Dwarf_FrameTable ft)
+{
+
+	if (ft == NULL)
+		return;
+
+	free(ft->ft_row);
+	free(ft->ft_delta);
+	if (ft->ft_last != NULL) {
+		free(ft->ft_last->rt3_rules);
+		free(ft->ft_last);
+	}
+	free(ft);
+}
+
 static void
 _dwarf_frame_section_cleanup(Dwarf_FrameSec fs)
 {
@@ -425,6 +444,7 @@ _dwarf_frame_section_cleanup(Dwarf_FrameSec fs)
 
 	STAILQ_FOREACH_SAFE(fde, &fs->fs_fdelist, fde_next, tfde) {
 		STAILQ_REMOVE(&fs->fs_fdelist, fde, _Dwarf_Fde, fde_next);
+		_dwarf_frame_table_free(fde->fde_table);
 		free(fde);
 	}
 
@@ -433,6 +453,8 @@ _dwarf_frame_section_cleanup(Dwarf_FrameSec fs)
 	if (fs->fs_fdearray != NULL)
 		free(fs->fs_fdearray);
 
+	_dwarf_pcmap_cleanup(&fs->fs_pcmap);
+
 	free(fs);
 }
 
@@ -545,10 +567,125 @@ fail_cleanup:
 	return (ret);
 }
 
+static int
+_dwarf_frame_rule_equal(Dwarf_Regtable_Entry3 *a, Dwarf_Regtable_Entry3 *b)
+{
+
+	return (a->dw_offset_relevant == b->dw_offset_relevant &&
+	    a->dw_value_type == b->dw_value_type &&
+	    a->dw_regnum == b->dw_regnum &&
+	    a->dw_offset_or_block_len == b->dw_offset_or_block_len &&
+	    a->dw_block_ptr == b->dw_block_ptr);
+}
+
+static int
+_dwarf_frame_table_delta(Dwarf_Debug dbg, Dwarf_FrameTable ft,
+    Dwarf_Half col, Dwarf_Regtable_Entry3 *rule, Dwarf_Error *error)
+{
+	Dwarf_FrameDelta *fd;
+	Dwarf_Unsigned cap;
+
+	if (ft->ft_deltacnt == ft->ft_deltacap) {
+		cap = ft->ft_deltacap > 0 ? ft->ft_deltacap * 2 : 16;
+		if ((fd = realloc(ft->ft_delta, cap * sizeof(*fd))) == NULL) {
+			DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+			return (DW_DLE_MEMORY);
+		}
+		ft->ft_delta = fd;
+		ft->ft_deltacap = cap;
+	}
+
+	fd = &ft->ft_delta[ft->ft_deltacnt++];
+	fd->fd_col = col;
+	fd->fd_rule = *rule;
+
+	return (DW_DLE_NONE);
+}
+
+/*
+ * Record the columns of register table 'rt' that differ from the last
+ * row of a compiled table.
+ */
+static int
+_dwarf_frame_table_diff(Dwarf_Debug dbg, Dwarf_FrameTable ft,
+    Dwarf_Regtable3 *rt, Dwarf_Error *error)
+{
+	Dwarf_Regtable3 *last;
+	int i, ret;
+
+	last = ft->ft_last;
+
+	if (!_dwarf_frame_rule_equal(&last->rt3_cfa_rule, &rt->rt3_cfa_rule)) {
+		if ((ret = _dwarf_frame_table_delta(dbg, ft,
+		    _DWARF_FRAME_CFA_COL, &rt->rt3_cfa_rule, error)) !=
+		    DW_DLE_NONE)
+			return (ret);
+		last->rt3_cfa_rule = rt->rt3_cfa_rule;
+	}
+
+	for (i = 0; i < rt->rt3_reg_table_size; i++) {
+		if (_dwarf_frame_rule_equal(&last->rt3_rules[i],
+		    &rt->rt3_rules[i]))
+			continue;
+		if ((ret = _dwarf_frame_table_delta(dbg, ft, i,
+		    &rt->rt3_rules[i], error)) != DW_DLE_NONE)
+			return (ret);
+		last->rt3_rules[i] = rt->rt3_rules[i];
+	}
+
+	return (DW_DLE_NONE);
+}
+
+/*
+ * End a row of a compiled table: the rules of register table 'rt'
+ * apply below 'end_pc'.
+ */
+static int
+_dwarf_frame_table_row(Dwarf_Debug dbg, Dwarf_FrameTable ft,
+    Dwarf_Regtable3 *rt, Dwarf_Addr end_pc, Dwarf_Addr row_pc,
+    Dwarf_Error *error)
+{
+	Dwarf_FrameRow *fr;
+	Dwarf_Unsigned cap;
+	int ret;
+
+	/* A binary search needs the rows in PC order. */
+	if (ft->ft_rowcnt > 0 &&
+	    end_pc < ft->ft_row[ft->ft_rowcnt - 1].fr_endpc)
+		ft->ft_bad = 1;
+
+	if ((ret = _dwarf_frame_table_diff(dbg, ft, rt, error)) !=
+	    DW_DLE_NONE)
+		return (ret);
+
+	if (ft->ft_rowcnt == ft->ft_rowcap) {
+		cap = ft->ft_rowcap > 0 ? ft->ft_rowcap * 2 : 8;
+		if ((fr = realloc(ft->ft_row, cap * sizeof(*fr))) == NULL) {
+			DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+			return (DW_DLE_MEMORY);
+		}
+		ft->ft_row = fr;
+		ft->ft_rowcap = cap;
+	}
+
+	fr = &ft->ft_row[ft->ft_rowcnt++];
+	fr->fr_endpc = end_pc;
+	fr->fr_rowpc = row_pc;
+	fr->fr_dend = ft->ft_deltacnt;
+
+	return (DW_DLE_NONE);
+}
+
+/*
+ * Run CFA instructions on register table 'rt', stopping at the first
+ * advance past 'pc_req'.  If 'ft' is not NULL, each row the
+ * instructions define is also added to the compiled table 'ft'.
+ */
 static int
 _dwarf_frame_run_inst(Dwarf_Debug dbg, Dwarf_Regtable3 *rt, uint8_t addr_size,
     uint8_t *insts, Dwarf_Unsigned len, Dwarf_Unsigned caf, Dwarf_Signed daf,
-    Dwarf_Addr pc, Dwarf_Addr pc_req, Dwarf_Addr *row_pc, Dwarf_Error *error)
+    Dwarf_Addr pc, Dwarf_Addr pc_req, Dwarf_Addr *row_pc, Dwarf_FrameTable ft,
+    Dwarf_Error *error)
 {
 	Dwarf_Regtable3 *init_rt, *saved_rt;
 	uint8_t *p, *pe;
@@ -571,6 +708,15 @@ _dwarf_frame_run_inst(Dwarf_Debug dbg, Dwarf_Regtable3 *rt, uint8_t addr_size,
 		}							\
 	} while(0)
 
+#define	END_ROW								\
+	do {								\
+		if (ft != NULL && (ret = _dwarf_frame_table_row(dbg,	\
+		    ft, rt, pc, *row_pc, error)) != DW_DLE_NONE)	\
+			goto program_done;				\
+		if (pc_req < pc)					\
+			goto program_done;				\
+	} while(0)
+
 #ifdef FRAME_DEBUG
 	printf("frame_run_inst: (caf=%ju, daf=%jd)\n", caf, daf);
 #endif
@@ -611,8 +757,7 @@ _dwarf_frame_run_inst(Dwarf_Debug dbg, Dwarf_Regtable3 *rt, uint8_t addr_size,
 				printf("DW_CFA_advance_loc(%#jx(%u))\n", pc,
 				    low6);
 #endif
-				if (pc_req < pc)
-					goto program_done;
+				END_ROW;
 				break;
 			case DW_CFA_offset:
 				*row_pc = pc;
@@ -652,32 +797,28 @@ _dwarf_frame_run_inst(Dwarf_Debug dbg, Dwarf_Regtable3 *rt, uint8_t addr_size,
 #ifdef FRAME_DEBUG
 			printf("DW_CFA_set_loc(pc=%#jx)\n", pc);
 #endif
-			if (pc_req < pc)
-				goto program_done;
+			END_ROW;
 			break;
 		case DW_CFA_advance_loc1:
 			pc += dbg->decode(&p, 1) * caf;
 #ifdef FRAME_DEBUG
 			printf("DW_CFA_set_loc1(pc=%#jx)\n", pc);
 #endif
-			if (pc_req < pc)
-				goto program_done;
+			END_ROW;
 			break;
 		case DW_CFA_advance_loc2:
 			pc += dbg->decode(&p, 2) * caf;
 #ifdef FRAME_DEBUG
 			printf("DW_CFA_set_loc2(pc=%#jx)\n", pc);
 #endif
-			if (pc_req < pc)
-				goto program_done;
+			END_ROW;
 			break;
 		case DW_CFA_advance_loc4:
 			pc += dbg->decode(&p, 4) * caf;
 #ifdef FRAME_DEBUG
 			printf("DW_CFA_set_loc4(pc=%#jx)\n", pc);
 #endif
-			if (pc_req < pc)
-				goto program_done;
+			END_ROW;
 			break;
 		case DW_CFA_offset_extended:
 			*row_pc = pc;
@@ -911,6 +1052,7 @@ program_done:
 #undef	RL
 #undef	INITRL
 #undef	CHECK_TABLE_SIZE
+#undef	END_ROW
 }
 
 static int
@@ -1187,6 +1329,111 @@ _dwarf_frame_regtable_copy(Dwarf_Debug dbg, Dwarf_Regtable3 **dest,
 	return (DW_DLE_NONE);
 }
 
+static void
+_dwarf_frame_regtable_init(Dwarf_Debug dbg, Dwarf_Regtable3 *rt)
+{
+	int i;
+
+	/* Clear the content of regtable from previous run. */
+	memset(&rt->rt3_cfa_rule, 0, sizeof(Dwarf_Regtable_Entry3));
+	memset(rt->rt3_rules, 0, rt->rt3_reg_table_size *
+	    sizeof(Dwarf_Regtable_Entry3));
+
+	/* Set rules to initial values. */
+	for (i = 0; i < rt->rt3_reg_table_size; i++)
+		rt->rt3_rules[i].dw_regnum = dbg->dbg_frame_rule_initial_value;
+}
+
+/*
+ * Compile the register rule table of an FDE.  The CIE and FDE
+ * instructions are run once to the end, recording the columns that
+ * change at each row.
+ */
+static int
+_dwarf_frame_table_build(Dwarf_Debug dbg, Dwarf_Fde fde, Dwarf_FrameTable ft,
+    Dwarf_Error *error)
+{
+	Dwarf_Cie cie;
+	Dwarf_Regtable3 *rt;
+	Dwarf_Addr row_pc;
+	int ret;
+
+	rt = dbg->dbg_internal_reg_table;
+	_dwarf_frame_regtable_init(dbg, rt);
+	if ((ret = _dwarf_frame_regtable_copy(dbg, &ft->ft_last, rt, error)) !=
+	    DW_DLE_NONE)
+		return (ret);
+
+	cie = fde->fde_cie;
+	assert(cie != NULL);
+	ret = _dwarf_frame_run_inst(dbg, rt, cie->cie_addrsize,
+	    cie->cie_initinst, cie->cie_instlen, cie->cie_caf, cie->cie_daf, 0,
+	    ~0ULL, &row_pc, NULL, error);
+	if (ret != DW_DLE_NONE)
+		return (ret);
+	if ((ret = _dwarf_frame_table_diff(dbg, ft, rt, error)) !=
+	    DW_DLE_NONE)
+		return (ret);
+
+	ret = _dwarf_frame_run_inst(dbg, rt, cie->cie_addrsize,
+	    fde->fde_inst, fde->fde_instlen, cie->cie_caf, cie->cie_daf,
+	    fde->fde_initloc, ~0ULL, &row_pc, ft, error);
+	if (ret != DW_DLE_NONE)
+		return (ret);
+
+	/* The last row extends to the end of the FDE. */
+	return (_dwarf_frame_table_row(dbg, ft, rt, ~0ULL, row_pc, error));
+}
+
+static int
+_dwarf_frame_table_get(Dwarf_Debug dbg, Dwarf_Fde fde,
+    Dwarf_FrameTable *ret_ft, Dwarf_Error *error)
+{
+	Dwarf_FrameTable ft;
+	Dwarf_Error de;
+	int ret;
+
+	ft = fde->fde_table;
+	if (ft != NULL && ft->ft_gen == dbg->dbg_frame_gen) {
+		*ret_ft = ft;
+		return (DW_DLE_NONE);
+	}
+
+	_dwarf_frame_table_free(ft);
+	fde->fde_table = NULL;
+
+	if ((ft = calloc(1, sizeof(struct _Dwarf_FrameTable))) == NULL) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+		return (DW_DLE_MEMORY);
+	}
+	ft->ft_gen = dbg->dbg_frame_gen;
+
+	/*
+	 * Instructions that can not be run only cause an error for the
+	 * PCs they cover.  Queries on an FDE whose table could not be
+	 * compiled fall back to running its instructions.
+	 */
+	ret = _dwarf_frame_table_build(dbg, fde, ft, &de);
+	if (ret == DW_DLE_MEMORY) {
+		_dwarf_frame_table_free(ft);
+		DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+		return (DW_DLE_MEMORY);
+	}
+	if (ret != DW_DLE_NONE)
+		ft->ft_bad = 1;
+
+	if (ft->ft_last != NULL) {
+		free(ft->ft_last->rt3_rules);
+		free(ft->ft_last);
+		ft->ft_last = NULL;
+	}
+
+	fde->fde_table = ft;
+	*ret_ft = ft;
+
+	return (DW_DLE_NONE);
+}
+
 int
 _dwarf_frame_get_internal_table(Dwarf_Fde fde, Dwarf_Addr pc_req,
     Dwarf_Regtable3 **ret_rt, Dwarf_Addr *ret_row_pc, Dwarf_Error *error)
@@ -1194,8 +1441,12 @@ _dwarf_frame_get_internal_table(Dwarf_Fde fde, Dwarf_Addr pc_req,
 	Dwarf_Debug dbg;
 	Dwarf_Cie cie;
 	Dwarf_Regtable3 *rt;
+	Dwarf_FrameTable ft;
+	Dwarf_FrameRow *fr;
+	Dwarf_FrameDelta *fd;
 	Dwarf_Addr row_pc;
-	int i, ret;
+	Dwarf_Unsigned i, lo, hi, mid;
+	int ret;
 
 	assert(ret_rt != NULL);
 
@@ -1204,21 +1455,46 @@ _dwarf_frame_get_internal_table(Dwarf_Fde fde, Dwarf_Addr pc_req,
 
 	rt = dbg->dbg_internal_reg_table;
 
-	/* Clear the content of regtable from previous run. */
-	memset(&rt->rt3_cfa_rule, 0, sizeof(Dwarf_Regtable_Entry3));
-	memset(rt->rt3_rules, 0, rt->rt3_reg_table_size *
-	    sizeof(Dwarf_Regtable_Entry3));
+	if ((ret = _dwarf_frame_table_get(dbg, fde, &ft, error)) !=
+	    DW_DLE_NONE)
+		return (ret);
 
-	/* Set rules to initial values. */
-	for (i = 0; i < rt->rt3_reg_table_size; i++)
-		rt->rt3_rules[i].dw_regnum = dbg->dbg_frame_rule_initial_value;
+	if (!ft->ft_bad && pc_req >= fde->fde_initloc) {
+		/* Find the first row ending above pc_req. */
+		lo = 0;
+		hi = ft->ft_rowcnt - 1;
+		while (lo < hi) {
+			mid = lo + (hi - lo) / 2;
+			if (ft->ft_row[mid].fr_endpc <= pc_req)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		fr = &ft->ft_row[lo];
+
+		_dwarf_frame_regtable_init(dbg, rt);
+		for (i = 0; i < fr->fr_dend; i++) {
+			fd = &ft->ft_delta[i];
+			if (fd->fd_col == _DWARF_FRAME_CFA_COL)
+				rt->rt3_cfa_rule = fd->fd_rule;
+			else
+				rt->rt3_rules[fd->fd_col] = fd->fd_rule;
+		}
+
+		*ret_rt = rt;
+		*ret_row_pc = fr->fr_rowpc;
+
+		return (DW_DLE_NONE);
+	}
+
+	_dwarf_frame_regtable_init(dbg, rt);
 
 	/* Run initial instructions in CIE. */
 	cie = fde->fde_cie;
 	assert(cie != NULL);
 	ret = _dwarf_frame_run_inst(dbg, rt, cie->cie_addrsize,
 	    cie->cie_initinst, cie->cie_instlen, cie->cie_caf, cie->cie_daf, 0,
-	    ~0ULL, &row_pc, error);
+	    ~0ULL, &row_pc, NULL, error);
 	if (ret != DW_DLE_NONE)
 		return (ret);
 
@@ -1226,7 +1502,8 @@ _dwarf_frame_get_internal_table(Dwarf_Fde fde, Dwarf_Addr pc_req,
 	if (pc_req >= fde->fde_initloc) {
 		ret = _dwarf_frame_run_inst(dbg, rt, cie->cie_addrsize,
 		    fde->fde_inst, fde->fde_instlen, cie->cie_caf,
-		    cie->cie_daf, fde->fde_initloc, pc_req, &row_pc, error);
+		    cie->cie_daf, fde->fde_initloc, pc_req, &row_pc, NULL,
+		    error);
 		if (ret != DW_DLE_NONE)
 			return (ret);
 	}
@@ -135,8 +135,8 @@ _dwarf_info_next_tu(Dwarf_Debug dbg, Dwarf_Error *error)
 	return (DW_DLE_NONE);
 }
 
-int
-_dwarf_info_load(Dwarf_Debug dbg, Dwarf_Bool load_all, Dwarf_Bool is_info,
+static int
+_dwarf_info_read(Dwarf_Debug dbg, Dwarf_Bool load_all, Dwarf_Bool is_info,
     Dwarf_Error *error)
 {
 	Dwarf_CU cu;
@@ -173,6 +173,7 @@ _dwarf_info_load(Dwarf_Debug dbg, Dwarf_Bool load_all, Dwarf_Bool is_info,
 		cu->cu_dbg = dbg;
 		cu->cu_is_info = is_info;
 		cu->cu_offset = offset;
+		LIST_INIT(&cu->cu_die_live);
 
 		length = dbg->read(ds->ds_data, &offset, 4);
 		if (length == 0xffffffff) {
@@ -204,28 +205,57 @@ _dwarf_info_load(Dwarf_Debug dbg, Dwarf_Bool load_all, Dwarf_Bool is_info,
 		cu->cu_length		 = length;
 		cu->cu_length_size	 = (dwarf_size == 4 ? 4 : 12);
 		cu->cu_version		 = dbg->read(ds->ds_data, &offset, 2);
-		cu->cu_abbrev_offset	 = dbg->read(ds->ds_data, &offset,
-		    dwarf_size);
+		if (cu->cu_version >= 5) {
+			/* DWARF5 moved the address size ahead. */
+			cu->cu_unit_type = dbg->read(ds->ds_data, &offset, 1);
+			cu->cu_pointer_size = dbg->read(ds->ds_data, &offset,
+			    1);
+			cu->cu_abbrev_offset = dbg->read(ds->ds_data, &offset,
+			    dwarf_size);
+		} else {
+			cu->cu_unit_type = is_info ? DW_UT_compile :
+			    DW_UT_type;
+			cu->cu_abbrev_offset = dbg->read(ds->ds_data, &offset,
+			    dwarf_size);
+			cu->cu_pointer_size = dbg->read(ds->ds_data, &offset,
+			    1);
+		}
 		cu->cu_abbrev_offset_cur = cu->cu_abbrev_offset;
-		cu->cu_pointer_size	 = dbg->read(ds->ds_data, &offset, 1);
 		cu->cu_next_offset	 = next_offset;
 
-		/* .debug_types extra fields. */
-		if (!is_info) {
+		/* Unit type specific fields. */
+		switch (cu->cu_unit_type) {
+		case DW_UT_type:
+		case DW_UT_split_type:
 			memcpy(cu->cu_type_sig.signature,
 			    (char *) ds->ds_data + offset, 8);
 			offset += 8;
 			cu->cu_type_offset = dbg->read(ds->ds_data, &offset,
 			    dwarf_size);
+			break;
+		case DW_UT_skeleton:
+		case DW_UT_split_compile:
+			cu->cu_dwo_id = dbg->read(ds->ds_data, &offset, 8);
+			break;
+		default:
+			break;
 		}
 
+#if	ELFTC_HAVE_PTHREADS
+		if (_dwarf_lock_init(&cu->cu_lock) != 0) {
+			free(cu);
+			DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+			return (DW_DLE_MEMORY);
+		}
+#endif
+
 		/* Add the compilation unit to the list. */
 		if (is_info)
 			STAILQ_INSERT_TAIL(&dbg->dbg_cu, cu, cu_next);
 		else
 			STAILQ_INSERT_TAIL(&dbg->dbg_tu, cu, cu_next);
 
-		if (cu->cu_version < 2 || cu->cu_version > 4) {
+		if (cu->cu_version < 2 || cu->cu_version > 5) {
 			DWARF_SET_ERROR(dbg, error, DW_DLE_VERSION_STAMP_ERROR);
 			ret = DW_DLE_VERSION_STAMP_ERROR;
 			break;
@@ -250,6 +280,232 @@ _dwarf_info_load(Dwarf_Debug dbg, Dwarf_Bool load_all, Dwarf_Bool is_info,
 	return (ret);
 }
 
+int
+_dwarf_info_load(Dwarf_Debug dbg, Dwarf_Bool load_all, Dwarf_Bool is_info,
+    Dwarf_Error *error)
+{
+	int ret;
+
+	DWARF_LOCK(dbg);
+	ret = _dwarf_info_read(dbg, load_all, is_info, error);
+	DWARF_UNLOCK(dbg);
+
+	return (ret);
+}
+
+/*
+ * Keep the units of a fully loaded section in an array sorted by
+ * offset.
+ */
+static int
+_dwarf_info_index(Dwarf_Debug dbg, Dwarf_Bool is_info, Dwarf_Error *error)
+{
+	Dwarf_CU cu, *cuarray;
+	Dwarf_Unsigned cnt;
+
+	if ((is_info ? dbg->dbg_cu_array : dbg->dbg_tu_array) != NULL)
+		return (DW_DLE_NONE);
+
+	cnt = 0;
+	if (is_info) {
+		STAILQ_FOREACH(cu, &dbg->dbg_cu, cu_next)
+			cnt++;
+	} else {
+		STAILQ_FOREACH(cu, &dbg->dbg_tu, cu_next)
+			cnt++;
+	}
+	if ((cuarray = malloc((cnt > 0 ? cnt : 1) * sizeof(Dwarf_CU))) ==
+	    NULL) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+		return (DW_DLE_MEMORY);
+	}
+
+	/* Units are loaded in section order. */
+	cnt = 0;
+	if (is_info) {
+		STAILQ_FOREACH(cu, &dbg->dbg_cu, cu_next)
+			cuarray[cnt++] = cu;
+		dbg->dbg_cu_array = cuarray;
+		dbg->dbg_cu_cnt = cnt;
+	} else {
+		STAILQ_FOREACH(cu, &dbg->dbg_tu, cu_next)
+			cuarray[cnt++] = cu;
+		dbg->dbg_tu_array = cuarray;
+		dbg->dbg_tu_cnt = cnt;
+	}
+
+	return (DW_DLE_NONE);
+}
+
+static int
+_dwarf_info_find(Dwarf_Debug dbg, Dwarf_Bool is_info, uint64_t offset,
+    Dwarf_CU *ret_cu, Dwarf_Error *error)
+{
+	Dwarf_CU cu, *cuarray;
+	Dwarf_Unsigned lo, hi, mid;
+	Dwarf_Bool loaded;
+	int ret;
+
+	if ((ret = _dwarf_info_read(dbg, 1, is_info, error)) != DW_DLE_NONE)
+		return (ret);
+
+	loaded = is_info ? dbg->dbg_info_loaded : dbg->dbg_types_loaded;
+
+	if (!loaded) {
+		/* Partially loaded section, search the list. */
+		if (is_info) {
+			STAILQ_FOREACH(cu, &dbg->dbg_cu, cu_next)
+				if (offset >= cu->cu_offset &&
+				    offset < cu->cu_next_offset)
+					break;
+		} else {
+			STAILQ_FOREACH(cu, &dbg->dbg_tu, cu_next)
+				if (offset >= cu->cu_offset &&
+				    offset < cu->cu_next_offset)
+					break;
+		}
+		goto done;
+	}
+
+	if ((ret = _dwarf_info_index(dbg, is_info, error)) != DW_DLE_NONE)
+		return (ret);
+	cuarray = is_info ? dbg->dbg_cu_array : dbg->dbg_tu_array;
+
+	/* Find the last unit starting at or before 'offset'. */
+	cu = NULL;
+	lo = 0;
+	hi = is_info ? dbg->dbg_cu_cnt : dbg->dbg_tu_cnt;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (cuarray[mid]->cu_offset <= offset)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo > 0 && offset < cuarray[lo - 1]->cu_next_offset)
+		cu = cuarray[lo - 1];
+
+done:
+	if (cu == NULL) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
+		return (DW_DLE_NO_ENTRY);
+	}
+
+	*ret_cu = cu;
+
+	return (DW_DLE_NONE);
+}
+
+/*
+ * Find the unit containing section offset 'offset'.  Once all the
+ * units of a section are loaded, they are kept in an array sorted by
+ * offset and found by binary search.
+ */
+int
+_dwarf_info_find_cu(Dwarf_Debug dbg, Dwarf_Bool is_info, uint64_t offset,
+    Dwarf_CU *ret_cu, Dwarf_Error *error)
+{
+	int ret;
+
+	assert(dbg != NULL && ret_cu != NULL);
+
+	DWARF_LOCK(dbg);
+	ret = _dwarf_info_find(dbg, is_info, offset, ret_cu, error);
+	DWARF_UNLOCK(dbg);
+
+	return (ret);
+}
+
+/*
+ * Return the headers of all the units of a section.  Only the unit
+ * headers are read; the table is built once and kept until the
+ * section is unloaded.
+ */
+int
+_dwarf_info_headers(Dwarf_Debug dbg, Dwarf_Bool is_info,
+    Dwarf_Unit_Header **ret_hdr, Dwarf_Unsigned *ret_cnt, Dwarf_Error *error)
+{
+	Dwarf_Unit_Header *hdr;
+	Dwarf_CU cu, *cuarray;
+	Dwarf_Unsigned cnt, i;
+	int ret;
+
+	assert(dbg != NULL && ret_hdr != NULL && ret_cnt != NULL);
+
+	DWARF_LOCK(dbg);
+
+	if ((hdr = is_info ? dbg->dbg_cu_hdr : dbg->dbg_tu_hdr) != NULL)
+		goto done;
+
+	if ((ret = _dwarf_info_read(dbg, 1, is_info, error)) != DW_DLE_NONE)
+		goto fail;
+
+	if ((ret = _dwarf_info_index(dbg, is_info, error)) != DW_DLE_NONE)
+		goto fail;
+
+	cuarray = is_info ? dbg->dbg_cu_array : dbg->dbg_tu_array;
+	cnt = is_info ? dbg->dbg_cu_cnt : dbg->dbg_tu_cnt;
+
+	if ((hdr = calloc(cnt > 0 ? cnt : 1, sizeof(Dwarf_Unit_Header))) ==
+	    NULL) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+		ret = DW_DLE_MEMORY;
+		goto fail;
+	}
+
+	for (i = 0; i < cnt; i++) {
+		cu = cuarray[i];
+		hdr[i].uh_offset = cu->cu_offset;
+		hdr[i].uh_length = cu->cu_next_offset - cu->cu_offset;
+		hdr[i].uh_die_offset = cu->cu_1st_offset;
+		hdr[i].uh_version = cu->cu_version;
+		hdr[i].uh_unit_type = cu->cu_unit_type;
+	}
+
+	if (is_info)
+		dbg->dbg_cu_hdr = hdr;
+	else
+		dbg->dbg_tu_hdr = hdr;
+
+done:
+	*ret_hdr = hdr;
+	*ret_cnt = is_info ? dbg->dbg_cu_cnt : dbg->dbg_tu_cnt;
+
+	DWARF_UNLOCK(dbg);
+
+	return (DW_DLE_NONE);
+
+fail:
+	DWARF_UNLOCK(dbg);
+
+	return (ret);
+}
+
+/*
+ * Release the DIEs, attributes and line information read from a unit.
+ * The unit itself stays loaded and can be read again.
+ */
+void
+_dwarf_info_release(Dwarf_CU cu)
+{
+	Dwarf_Die die;
+
+	_dwarf_die_cache_cleanup(cu);
+
+	/*
+	 * The arena holds the DIEs and attributes themselves, but their
+	 * attribute arrays and location descriptions are on the heap.
+	 */
+	while ((die = LIST_FIRST(&cu->cu_die_live)) != NULL)
+		dwarf_dealloc(cu->cu_dbg, die, DW_DLA_DIE);
+
+	if (cu->cu_lineinfo != NULL) {
+		_dwarf_lineno_cleanup(cu->cu_lineinfo);
+		cu->cu_lineinfo = NULL;
+	}
+	_dwarf_arena_cleanup(&cu->cu_arena);
+}
+
 void
 _dwarf_info_cleanup(Dwarf_Debug dbg)
 {
@@ -259,13 +515,18 @@ _dwarf_info_cleanup(Dwarf_Debug dbg)
 
 	STAILQ_FOREACH_SAFE(cu, &dbg->dbg_cu, cu_next, tcu) {
 		STAILQ_REMOVE(&dbg->dbg_cu, cu, _Dwarf_CU, cu_next);
+		_dwarf_info_release(cu);
 		_dwarf_abbrev_cleanup(cu);
-		if (cu->cu_lineinfo != NULL) {
-			_dwarf_lineno_cleanup(cu->cu_lineinfo);
-			cu->cu_lineinfo = NULL;
-		}
+#if	ELFTC_HAVE_PTHREADS
+		(void) pthread_mutex_destroy(&cu->cu_lock);
+#endif
 		free(cu);
 	}
+	free(dbg->dbg_cu_array);
+	dbg->dbg_cu_array = NULL;
+	dbg->dbg_cu_cnt = 0;
+	free(dbg->dbg_cu_hdr);
+	dbg->dbg_cu_hdr = NULL;
 
 	_dwarf_type_unit_cleanup(dbg);
 }
@@ -279,9 +540,18 @@ _dwarf_type_unit_cleanup(Dwarf_Debug dbg)
 
 	STAILQ_FOREACH_SAFE(cu, &dbg->dbg_tu, cu_next, tcu) {
 		STAILQ_REMOVE(&dbg->dbg_tu, cu, _Dwarf_CU, cu_next);
+		_dwarf_info_release(cu);
 		_dwarf_abbrev_cleanup(cu);
+#if	ELFTC_HAVE_PTHREADS
+		(void) pthread_mutex_destroy(&cu->cu_lock);
+#endif
 		free(cu);
 	}
+	free(dbg->dbg_tu_array);
+	dbg->dbg_tu_array = NULL;
+	dbg->dbg_tu_cnt = 0;
+	free(dbg->dbg_tu_hdr);
+	dbg->dbg_tu_hdr = NULL;
 }
 
 int
@@ -84,20 +84,27 @@ _dwarf_consumer_init(Dwarf_Debug dbg, Dwarf_Error *error)
 		dbg->dbg_section[i].ds_addr = sec.addr;
 		dbg->dbg_section[i].ds_size = sec.size;
 		dbg->dbg_section[i].ds_name = sec.name;
-
-		if (m->load_section(obj, i, &dbg->dbg_section[i].ds_data, &ret)
-		    != DW_DLV_OK) {
-			DWARF_SET_ERROR(dbg, error, ret);
-			return (ret);
-		}
 	}
 	dbg->dbg_section[cnt].ds_name = NULL;
 
+	/*
+	 * Section data is loaded on first use.  The sections cached below
+	 * are referred to directly while decoding units and attributes,
+	 * so they are loaded now.
+	 */
 	dbg->dbg_info_sec = _dwarf_find_section(dbg, ".debug_info");
 
 	/* Try to find the optional DWARF4 .debug_types section. */
 	dbg->dbg_types_sec = _dwarf_find_next_types_section(dbg, NULL);
 
+	/* Sections referenced by DWARF5 indexed attribute forms. */
+	dbg->dbg_str_offsets_sec = _dwarf_find_section(dbg,
+	    ".debug_str_offsets");
+	dbg->dbg_addr_sec = _dwarf_find_section(dbg, ".debug_addr");
+	dbg->dbg_line_str_sec = _dwarf_find_section(dbg, ".debug_line_str");
+	dbg->dbg_rnglists_sec = _dwarf_find_section(dbg, ".debug_rnglists");
+	dbg->dbg_loclists_sec = _dwarf_find_section(dbg, ".debug_loclists");
+
 	/* Initialise call frame API related parameters. */
 	_dwarf_frame_params_init(dbg);
 
@@ -211,11 +218,21 @@ _dwarf_init(Dwarf_Debug dbg, Dwarf_Unsigned pro_flags, Dwarf_Handler errhand,
 
 	STAILQ_INIT(&dbg->dbg_cu);
 	STAILQ_INIT(&dbg->dbg_tu);
-	STAILQ_INIT(&dbg->dbg_rllist);
 	STAILQ_INIT(&dbg->dbg_aslist);
 	STAILQ_INIT(&dbg->dbg_mslist);
 
 	if (dbg->dbg_mode == DW_DLC_READ || dbg->dbg_mode == DW_DLC_RDWR) {
+#if	ELFTC_HAVE_PTHREADS
+		if (_dwarf_lock_init(&dbg->dbg_lock) != 0) {
+			DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+			return (DW_DLE_MEMORY);
+		}
+		if (pthread_mutex_init(&dbg->dbg_sec_lock, NULL) != 0) {
+			(void) pthread_mutex_destroy(&dbg->dbg_lock);
+			DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+			return (DW_DLE_MEMORY);
+		}
+#endif
 		ret = _dwarf_consumer_init(dbg, error);
 		if (ret != DW_DLE_NONE) {
 			_dwarf_deinit(dbg);
@@ -271,8 +288,10 @@ _dwarf_consumer_deinit(Dwarf_Debug dbg)
 
 	_dwarf_info_cleanup(dbg);
 	_dwarf_ranges_cleanup(dbg);
+	_dwarf_loclist_cleanup(dbg);
 	_dwarf_frame_cleanup(dbg);
 	_dwarf_arange_cleanup(dbg);
+	_dwarf_pcmap_cleanup(&dbg->dbg_cu_pcmap);
 	_dwarf_macinfo_cleanup(dbg);
 	_dwarf_strtab_cleanup(dbg);
 	_dwarf_nametbl_cleanup(&dbg->dbg_globals);
@@ -281,8 +300,14 @@ _dwarf_consumer_deinit(Dwarf_Debug dbg)
 	_dwarf_nametbl_cleanup(&dbg->dbg_funcs);
 	_dwarf_nametbl_cleanup(&dbg->dbg_vars);
 	_dwarf_nametbl_cleanup(&dbg->dbg_types);
+	_dwarf_names_cleanup(dbg);
 
 	free(dbg->dbg_section);
+
+#if	ELFTC_HAVE_PTHREADS
+	(void) pthread_mutex_destroy(&dbg->dbg_lock);
+	(void) pthread_mutex_destroy(&dbg->dbg_sec_lock);
+#endif
 }
 
 void
@@ -297,6 +322,29 @@ _dwarf_deinit(Dwarf_Debug dbg)
 		_dwarf_producer_deinit(dbg);
 }
 
+#if	ELFTC_HAVE_PTHREADS
+/*
+ * Initialise the lock of a debug instance or a unit.  The locks are
+ * recursive since the lazy loaders call into each other, e.g., parsing
+ * a DIE may bring in the unit DIE to learn the section bases.
+ */
+int
+_dwarf_lock_init(pthread_mutex_t *lock)
+{
+	pthread_mutexattr_t attr;
+	int error;
+
+	if ((error = pthread_mutexattr_init(&attr)) == 0) {
+		if ((error = pthread_mutexattr_settype(&attr,
+		    PTHREAD_MUTEX_RECURSIVE)) == 0)
+			error = pthread_mutex_init(lock, &attr);
+		(void) pthread_mutexattr_destroy(&attr);
+	}
+
+	return (error);
+}
+#endif
+
 int
 _dwarf_alloc(Dwarf_Debug *ret_dbg, int mode, Dwarf_Error *error)
 {
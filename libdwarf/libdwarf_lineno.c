@@ -29,15 +29,24 @@
 ELFTC_VCSID("$Id$");
 
 static int
-_dwarf_lineno_add_file(Dwarf_LineInfo li, uint8_t **p, const char *compdir,
-    Dwarf_Error *error, Dwarf_Debug dbg)
+_dwarf_lineno_add_entry(Dwarf_LineInfo li, char *fname, uint64_t dirndx,
+    uint64_t mtime, uint64_t size, const char *compdir, Dwarf_Error *error,
+    Dwarf_Debug dbg)
 {
 	Dwarf_LineFile lf;
-	const char *dirname;
-	uint8_t *src;
+	const char *dirname, *topdir;
 	int slen;
 
-	src = *p;
+	/*
+	 * Before DWARF5 directory 0 is the compilation directory and is
+	 * not part of the include directory array; from DWARF5 on it is
+	 * the first entry of the array.
+	 */
+	if ((li->li_version >= 5 && dirndx >= li->li_inclen) ||
+	    (li->li_version < 5 && dirndx > li->li_inclen)) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_DIR_INDEX_BAD);
+		return (DW_DLE_DIR_INDEX_BAD);
+	}
 
 	if ((lf = malloc(sizeof(struct _Dwarf_LineFile))) == NULL) {
 		DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
@@ -45,48 +54,269 @@ _dwarf_lineno_add_file(Dwarf_LineInfo li, uint8_t **p, const char *compdir,
 	}
 
 	lf->lf_fullpath = NULL;
-	lf->lf_fname = (char *) src;
-	src += strlen(lf->lf_fname) + 1;
-	lf->lf_dirndx = _dwarf_decode_uleb128(&src);
-	if (lf->lf_dirndx > li->li_inclen) {
-		free(lf);
-		DWARF_SET_ERROR(dbg, error, DW_DLE_DIR_INDEX_BAD);
-		return (DW_DLE_DIR_INDEX_BAD);
-	}
+	lf->lf_fname = fname;
+	lf->lf_dirndx = dirndx;
 
 	/* Make full pathname if need. */
 	if (*lf->lf_fname != '/') {
-		dirname = compdir;
-		if (lf->lf_dirndx > 0)
-			dirname = li->li_incdirs[lf->lf_dirndx - 1];
+		topdir = NULL;
+		if (li->li_version >= 5) {
+			dirname = li->li_incdirs[dirndx];
+			if (dirndx > 0 && *dirname != '/')
+				topdir = li->li_incdirs[0];
+		} else {
+			dirname = compdir;
+			if (dirndx > 0)
+				dirname = li->li_incdirs[dirndx - 1];
+		}
 		if (dirname != NULL) {
 			slen = strlen(dirname) + strlen(lf->lf_fname) + 2;
+			if (topdir != NULL)
+				slen += strlen(topdir) + 1;
 			if ((lf->lf_fullpath = malloc(slen)) == NULL) {
 				free(lf);
 				DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
 				return (DW_DLE_MEMORY);
 			}
-			snprintf(lf->lf_fullpath, slen, "%s/%s", dirname,
-			    lf->lf_fname);
+			if (topdir != NULL)
+				snprintf(lf->lf_fullpath, slen, "%s/%s/%s",
+				    topdir, dirname, lf->lf_fname);
+			else
+				snprintf(lf->lf_fullpath, slen, "%s/%s",
+				    dirname, lf->lf_fname);
 		}
 	}
 
-	lf->lf_mtime = _dwarf_decode_uleb128(&src);
-	lf->lf_size = _dwarf_decode_uleb128(&src);
+	lf->lf_mtime = mtime;
+	lf->lf_size = size;
 	STAILQ_INSERT_TAIL(&li->li_lflist, lf, lf_next);
 	li->li_lflen++;
 
+	return (DW_DLE_NONE);
+}
+
+static int
+_dwarf_lineno_add_file(Dwarf_LineInfo li, uint8_t **p, const char *compdir,
+    Dwarf_Error *error, Dwarf_Debug dbg)
+{
+	char *fname;
+	uint64_t dirndx, mtime, size;
+	uint8_t *src;
+	int ret;
+
+	src = *p;
+
+	fname = (char *) src;
+	src += strlen(fname) + 1;
+	dirndx = _dwarf_decode_uleb128(&src);
+	mtime = _dwarf_decode_uleb128(&src);
+	size = _dwarf_decode_uleb128(&src);
+
+	ret = _dwarf_lineno_add_entry(li, fname, dirndx, mtime, size, compdir,
+	    error, dbg);
+	if (ret != DW_DLE_NONE)
+		return (ret);
+
 	*p = src;
 
 	return (DW_DLE_NONE);
 }
 
+/*
+ * Read one field of a DWARF5 directory or file name entry.  String
+ * forms are returned through 'strp', all the others through 'valp'.
+ */
+static int
+_dwarf_lineno_read_field(Dwarf_CU cu, Dwarf_Section *ds, uint64_t *offsetp,
+    uint64_t endoff, uint64_t form, int dwarf_size, uint64_t *valp,
+    char **strp, Dwarf_Error *error)
+{
+	struct _Dwarf_Attribute atref;
+	Dwarf_Debug dbg;
+	Dwarf_Section *ls;
+	uint64_t off;
+	int ret;
+
+	dbg = cu->cu_dbg;
+	*valp = 0;
+	*strp = NULL;
+
+	switch (form) {
+	case DW_FORM_string:
+		*strp = _dwarf_read_string(ds->ds_data, endoff, offsetp);
+		break;
+	case DW_FORM_line_strp:
+	case DW_FORM_strp:
+		off = dbg->read(ds->ds_data, offsetp, dwarf_size);
+		if (form == DW_FORM_strp) {
+			if (off >= dbg->dbg_strtab_size)
+				goto bad_form;
+			*strp = _dwarf_strtab_get_table(dbg) + off;
+			break;
+		}
+		ls = dbg->dbg_line_str_sec;
+		if (ls == NULL || off >= ls->ds_size)
+			goto bad_form;
+		*strp = (char *) ls->ds_data + off;
+		break;
+	case DW_FORM_strx:
+	case DW_FORM_strx1:
+	case DW_FORM_strx2:
+	case DW_FORM_strx3:
+	case DW_FORM_strx4:
+		memset(&atref, 0, sizeof(atref));
+		atref.at_form = form;
+		if (form == DW_FORM_strx)
+			atref.u[0].u64 = _dwarf_read_uleb128(ds->ds_data,
+			    offsetp);
+		else
+			atref.u[0].u64 = dbg->read(ds->ds_data, offsetp,
+			    form == DW_FORM_strx1 ? 1 : form == DW_FORM_strx2 ?
+			    2 : form == DW_FORM_strx3 ? 3 : 4);
+		if ((ret = _dwarf_die_load_bases(dbg, cu, error)) !=
+		    DW_DLE_NONE)
+			return (ret);
+		if ((ret = _dwarf_attr_resolve(dbg, cu, &atref, error)) !=
+		    DW_DLE_NONE)
+			return (ret);
+		*strp = atref.u[1].s;
+		break;
+	case DW_FORM_udata:
+		*valp = _dwarf_read_uleb128(ds->ds_data, offsetp);
+		break;
+	case DW_FORM_data1:
+		*valp = dbg->read(ds->ds_data, offsetp, 1);
+		break;
+	case DW_FORM_data2:
+		*valp = dbg->read(ds->ds_data, offsetp, 2);
+		break;
+	case DW_FORM_data4:
+		*valp = dbg->read(ds->ds_data, offsetp, 4);
+		break;
+	case DW_FORM_data8:
+		*valp = dbg->read(ds->ds_data, offsetp, 8);
+		break;
+	case DW_FORM_data16:
+		/* MD5 digests are not kept. */
+		*offsetp += 16;
+		break;
+	case DW_FORM_block:
+		*valp = _dwarf_read_uleb128(ds->ds_data, offsetp);
+		*offsetp += *valp;
+		break;
+	default:
+		goto bad_form;
+	}
+
+	if (*offsetp > endoff) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_DEBUG_LINE_LENGTH_BAD);
+		return (DW_DLE_DEBUG_LINE_LENGTH_BAD);
+	}
+
+	return (DW_DLE_NONE);
+
+bad_form:
+	DWARF_SET_ERROR(dbg, error, DW_DLE_ATTR_FORM_BAD);
+	return (DW_DLE_ATTR_FORM_BAD);
+}
+
+/*
+ * Read the self-describing directory and file name tables of a DWARF5
+ * line number program header.
+ */
+static int
+_dwarf_lineno_read_tables(Dwarf_CU cu, Dwarf_LineInfo li, Dwarf_Section *ds,
+    uint64_t *offsetp, uint64_t endoff, int dwarf_size, const char *compdir,
+    Dwarf_Error *error)
+{
+	Dwarf_Debug dbg;
+	uint64_t fmt[2][16], nfmt, count, dirndx, mtime, size, val;
+	uint64_t i, j;
+	char *path, *str;
+	int ret, t;
+
+	dbg = cu->cu_dbg;
+
+	for (t = 0; t < 2; t++) {
+		/* Entry format: pairs of content type and form. */
+		nfmt = dbg->read(ds->ds_data, offsetp, 1);
+		if (nfmt > 16) {
+			DWARF_SET_ERROR(dbg, error,
+			    DW_DLE_DEBUG_LINE_LENGTH_BAD);
+			return (DW_DLE_DEBUG_LINE_LENGTH_BAD);
+		}
+		for (j = 0; j < nfmt; j++) {
+			fmt[0][j] = _dwarf_read_uleb128(ds->ds_data, offsetp);
+			fmt[1][j] = _dwarf_read_uleb128(ds->ds_data, offsetp);
+		}
+
+		count = _dwarf_read_uleb128(ds->ds_data, offsetp);
+		if (count > endoff - *offsetp) {
+			DWARF_SET_ERROR(dbg, error,
+			    DW_DLE_DEBUG_LINE_LENGTH_BAD);
+			return (DW_DLE_DEBUG_LINE_LENGTH_BAD);
+		}
+
+		if (t == 0 && count > 0) {
+			li->li_incdirs = malloc(count * sizeof(char *));
+			if (li->li_incdirs == NULL) {
+				DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+				return (DW_DLE_MEMORY);
+			}
+		}
+
+		for (i = 0; i < count; i++) {
+			path = NULL;
+			dirndx = mtime = size = 0;
+			for (j = 0; j < nfmt; j++) {
+				ret = _dwarf_lineno_read_field(cu, ds, offsetp,
+				    endoff, fmt[1][j], dwarf_size, &val, &str,
+				    error);
+				if (ret != DW_DLE_NONE)
+					return (ret);
+				switch (fmt[0][j]) {
+				case DW_LNCT_path:
+					path = str;
+					break;
+				case DW_LNCT_directory_index:
+					dirndx = val;
+					break;
+				case DW_LNCT_timestamp:
+					mtime = val;
+					break;
+				case DW_LNCT_size:
+					size = val;
+					break;
+				default:
+					break;
+				}
+			}
+			if (path == NULL) {
+				DWARF_SET_ERROR(dbg, error,
+				    DW_DLE_ATTR_FORM_BAD);
+				return (DW_DLE_ATTR_FORM_BAD);
+			}
+			if (t == 0) {
+				li->li_incdirs[i] = path;
+				li->li_inclen++;
+				continue;
+			}
+			ret = _dwarf_lineno_add_entry(li, path, dirndx, mtime,
+			    size, compdir, error, dbg);
+			if (ret != DW_DLE_NONE)
+				return (ret);
+		}
+	}
+
+	return (DW_DLE_NONE);
+}
+
 static int
 _dwarf_lineno_run_program(Dwarf_CU cu, Dwarf_LineInfo li, uint8_t *p,
     uint8_t *pe, const char *compdir, Dwarf_Error *error)
 {
 	Dwarf_Debug dbg;
-	Dwarf_Line ln, tln;
+	Dwarf_Line ln;
 	uint64_t address, file, line, column, opsize;
 	int is_stmt, basic_block, end_sequence;
 	int ret;
@@ -104,7 +334,8 @@ _dwarf_lineno_run_program(Dwarf_CU cu, Dwarf_LineInfo li, uint8_t *p,
 
 #define	APPEND_ROW						\
 	do {							\
-		ln = malloc(sizeof(struct _Dwarf_Line));	\
+		ln = _dwarf_arena_alloc(&li->li_arena,		\
+		    sizeof(struct _Dwarf_Line));		\
 		if (ln == NULL) {				\
 			ret = DW_DLE_MEMORY;			\
 			DWARF_SET_ERROR(dbg, error, ret);	\
@@ -157,6 +388,11 @@ _dwarf_lineno_run_program(Dwarf_CU cu, Dwarf_LineInfo li, uint8_t *p,
 				address = dbg->decode(&p, cu->cu_pointer_size);
 				break;
 			case DW_LNE_define_file:
+				if (li->li_version >= 5) {
+					/* Removed in DWARF5. */
+					p += opsize;
+					break;
+				}
 				p++;
 				ret = _dwarf_lineno_add_file(li, &p, compdir,
 				    error, dbg);
@@ -234,10 +470,9 @@ _dwarf_lineno_run_program(Dwarf_CU cu, Dwarf_LineInfo li, uint8_t *p,
 
 prog_fail:
 
-	STAILQ_FOREACH_SAFE(ln, &li->li_lnlist, ln_next, tln) {
-		STAILQ_REMOVE(&li->li_lnlist, ln, _Dwarf_Line, ln_next);
-		free(ln);
-	}
+	STAILQ_INIT(&li->li_lnlist);
+	li->li_lnlen = 0;
+	_dwarf_arena_cleanup(&li->li_arena);
 
 	return (ret);
 
@@ -279,6 +514,12 @@ _dwarf_lineno_init(Dwarf_Die die, uint64_t offset, Dwarf_Error *error)
 	if (at != NULL) {
 		switch (at->at_form) {
 		case DW_FORM_strp:
+		case DW_FORM_line_strp:
+		case DW_FORM_strx:
+		case DW_FORM_strx1:
+		case DW_FORM_strx2:
+		case DW_FORM_strx3:
+		case DW_FORM_strx4:
 			compdir = at->u[1].s;
 			break;
 		case DW_FORM_string:
@@ -312,10 +553,14 @@ _dwarf_lineno_init(Dwarf_Die die, uint64_t offset, Dwarf_Error *error)
 	li->li_length = length;
 	endoff = offset + length;
 	li->li_version = dbg->read(ds->ds_data, &offset, 2); /* FIXME: verify version */
+	if (li->li_version >= 5) {
+		/* Address and segment selector sizes. */
+		offset += 2;
+	}
 	li->li_hdrlen = dbg->read(ds->ds_data, &offset, dwarf_size);
 	hdroff = offset;
 	li->li_minlen = dbg->read(ds->ds_data, &offset, 1);
-	if (li->li_version == 4)
+	if (li->li_version >= 4)
 		li->li_maxop = dbg->read(ds->ds_data, &offset, 1);
 	li->li_defstmt = dbg->read(ds->ds_data, &offset, 1);
 	li->li_lbase = dbg->read(ds->ds_data, &offset, 1);
@@ -343,6 +588,15 @@ _dwarf_lineno_init(Dwarf_Die die, uint64_t offset, Dwarf_Error *error)
 	for (i = 1; i < li->li_opbase; i++)
 		li->li_oplen[i] = dbg->read(ds->ds_data, &offset, 1);
 
+	if (li->li_version >= 5) {
+		ret = _dwarf_lineno_read_tables(cu, li, ds, &offset, endoff,
+		    dwarf_size, compdir, error);
+		if (ret != DW_DLE_NONE)
+			goto fail_cleanup;
+		p = ds->ds_data + offset;
+		goto header_done;
+	}
+
 	/*
 	 * Check how many strings in the include dir string array.
 	 */
@@ -398,6 +652,7 @@ _dwarf_lineno_init(Dwarf_Die die, uint64_t offset, Dwarf_Error *error)
 
 	p++;
 
+header_done:
 	/* Sanity check. */
 	if (p - ds->ds_data - hdroff != li->li_hdrlen) {
 		ret = DW_DLE_DEBUG_LINE_LENGTH_BAD;
@@ -439,7 +694,6 @@ void
 _dwarf_lineno_cleanup(Dwarf_LineInfo li)
 {
 	Dwarf_LineFile lf, tlf;
-	Dwarf_Line ln, tln;
 
 	if (li == NULL)
 		return;
@@ -450,11 +704,7 @@ _dwarf_lineno_cleanup(Dwarf_LineInfo li)
 			free(lf->lf_fullpath);
 		free(lf);
 	}
-	STAILQ_FOREACH_SAFE(ln, &li->li_lnlist, ln_next, tln) {
-		STAILQ_REMOVE(&li->li_lnlist, ln, _Dwarf_Line,
-		    ln_next);
-		free(ln);
-	}
+	_dwarf_arena_cleanup(&li->li_arena);
 	if (li->li_oplen)
 		free(li->li_oplen);
 	if (li->li_incdirs)
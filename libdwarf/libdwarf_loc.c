@@ -223,6 +223,10 @@ _dwarf_loc_fill_loc(Dwarf_Debug dbg, Dwarf_Locdesc *lbuf, uint8_t pointer_size,
 		case DW_OP_GNU_deref_type:
 		case DW_OP_GNU_convert:
 		case DW_OP_GNU_reinterpret:
+		case DW_OP_addrx:
+		case DW_OP_constx:
+		case DW_OP_convert:
+		case DW_OP_reinterpret:
 			operand1 = _dwarf_decode_uleb128(&p);
 			break;
 
@@ -269,6 +273,7 @@ _dwarf_loc_fill_loc(Dwarf_Debug dbg, Dwarf_Locdesc *lbuf, uint8_t pointer_size,
 		 */
 		case DW_OP_bit_piece:
 		case DW_OP_GNU_regval_type:
+		case DW_OP_regval_type:
 			operand1 = _dwarf_decode_uleb128(&p);
 			operand2 = _dwarf_decode_uleb128(&p);
 			break;
@@ -292,6 +297,7 @@ _dwarf_loc_fill_loc(Dwarf_Debug dbg, Dwarf_Locdesc *lbuf, uint8_t pointer_size,
 		 */
 		case DW_OP_implicit_value:
 		case DW_OP_GNU_entry_value:
+		case DW_OP_entry_value:
 			operand1 = _dwarf_decode_uleb128(&p);
 			operand2 = (Dwarf_Unsigned) (uintptr_t) p;
 			p += operand1;
@@ -329,6 +335,7 @@ _dwarf_loc_fill_loc(Dwarf_Debug dbg, Dwarf_Locdesc *lbuf, uint8_t pointer_size,
 		 * Operand2: SLEB128
 		 */
 		case DW_OP_GNU_implicit_pointer:
+		case DW_OP_implicit_pointer:
 			if (version == 2)
 				operand1 = dbg->decode(&p, pointer_size);
 			else
@@ -342,12 +349,23 @@ _dwarf_loc_fill_loc(Dwarf_Debug dbg, Dwarf_Locdesc *lbuf, uint8_t pointer_size,
 		 * is its size.
 		 */
 		case DW_OP_GNU_const_type:
+		case DW_OP_const_type:
 			operand1 = _dwarf_decode_uleb128(&p);
 			operand2 = (Dwarf_Unsigned) (uintptr_t) p;
 			s = *p++;
 			p += s;
 			break;
 
+		/*
+		 * Operand1: size of the value (1 byte)
+		 * Operand2: DIE offset of the base type (ULEB128)
+		 */
+		case DW_OP_deref_type:
+		case DW_OP_xderef_type:
+			operand1 = *p++;
+			operand2 = _dwarf_decode_uleb128(&p);
+			break;
+
 		/* All other operations cause an error. */
 		default:
 			count = -1;
@@ -28,33 +28,53 @@
 
 ELFTC_VCSID("$Id$");
 
+/* Append an empty location description to a list. */
+static Dwarf_Locdesc *
+_dwarf_loclist_grow(Dwarf_Debug dbg, Dwarf_Loclist ll, Dwarf_Error *error)
+{
+	Dwarf_Locdesc *ld;
+	Dwarf_Signed cap;
+
+	if (ll->ll_ldlen == ll->ll_ldcap) {
+		cap = ll->ll_ldcap > 0 ? ll->ll_ldcap * 2 : 8;
+		if ((ld = realloc(ll->ll_ldarray, cap * sizeof(*ld))) ==
+		    NULL) {
+			DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+			return (NULL);
+		}
+		ll->ll_ldarray = ld;
+		ll->ll_ldcap = cap;
+	}
+
+	ld = &ll->ll_ldarray[ll->ll_ldlen++];
+	memset(ld, 0, sizeof(*ld));
+
+	return (ld);
+}
+
 static int
 _dwarf_loclist_add_locdesc(Dwarf_Debug dbg, Dwarf_CU cu, Dwarf_Section *ds,
-    Dwarf_Unsigned *off, Dwarf_Locdesc **ld, Dwarf_Signed *ldlen,
-    Dwarf_Unsigned *total_len, Dwarf_Error *error)
+    Dwarf_Unsigned *off, Dwarf_Loclist ll, Dwarf_Error *error)
 {
+	Dwarf_Locdesc *ld;
 	uint64_t start, end;
-	int i, len, ret;
+	int len, ret;
 
-	if (total_len != NULL)
-		*total_len = 0;
+	ll->ll_len = 0;
 
-	for (i = 0; *off < ds->ds_size; i++) {
+	while (*off < ds->ds_size) {
 		start = dbg->read(ds->ds_data, off, cu->cu_pointer_size);
 		end = dbg->read(ds->ds_data, off, cu->cu_pointer_size);
-		if (ld != NULL) {
-			ld[i]->ld_lopc = start;
-			ld[i]->ld_hipc = end;
-		}
+		if ((ld = _dwarf_loclist_grow(dbg, ll, error)) == NULL)
+			return (DW_DLE_MEMORY);
+		ld->ld_lopc = start;
+		ld->ld_hipc = end;
 
-		if (total_len != NULL)
-			*total_len += 2 * cu->cu_pointer_size;
+		ll->ll_len += 2 * cu->cu_pointer_size;
 
 		/* Check if it is the end entry. */
-		if (start == 0 && end ==0) {
-			i++;
+		if (start == 0 && end ==0)
 			break;
-		}
 
 		/* Check if it is base-select entry. */
 		if ((cu->cu_pointer_size == 4 && start == ~0U) ||
@@ -69,39 +89,188 @@ _dwarf_loclist_add_locdesc(Dwarf_Debug dbg, Dwarf_CU cu, Dwarf_Section *ds,
 			return (DW_DLE_DEBUG_LOC_SECTION_SHORT);
 		}
 
-		if (total_len != NULL)
-			*total_len += len;
+		ll->ll_len += len;
+
+		ret = _dwarf_loc_fill_locdesc(dbg, ld, ds->ds_data + *off, len,
+		    cu->cu_pointer_size, cu->cu_length_size == 4 ? 4 : 8,
+		    cu->cu_version, error);
+		if (ret != DW_DLE_NONE)
+			return (ret);
+
+		*off += len;
+	}
+
+	return (DW_DLE_NONE);
+}
+
+/* Fetch entry 'idx' of the unit's .debug_addr table. */
+static int
+_dwarf_loclists_addrx(Dwarf_Debug dbg, Dwarf_CU cu, uint64_t idx,
+    uint64_t *addr, Dwarf_Error *error)
+{
+	struct _Dwarf_Attribute atref;
+	int ret;
+
+	memset(&atref, 0, sizeof(atref));
+	atref.at_form = DW_FORM_addrx;
+	atref.u[0].u64 = idx;
+	if ((ret = _dwarf_attr_resolve(dbg, cu, &atref, error)) !=
+	    DW_DLE_NONE)
+		return (ret);
+	*addr = atref.u[1].u64;
 
-		if (ld != NULL) {
-			ret = _dwarf_loc_fill_locdesc(dbg, ld[i],
-			    ds->ds_data + *off, len, cu->cu_pointer_size,
-			    cu->cu_length_size == 4 ? 4 : 8, cu->cu_version,
-			    error);
-			if (ret != DW_DLE_NONE)
+	return (DW_DLE_NONE);
+}
+
+/*
+ * Parse a DWARF5 location list in .debug_loclists, translating the
+ * entries into the DWARF4 representation the way range lists are: base
+ * address entries become base-select entries and bounded entries are
+ * rebased on the current base address.
+ */
+static int
+_dwarf_loclists_add_locdesc(Dwarf_Debug dbg, Dwarf_CU cu, Dwarf_Section *ds,
+    Dwarf_Unsigned *off, Dwarf_Loclist ll, Dwarf_Error *error)
+{
+	Dwarf_Locdesc *ld;
+	uint64_t base, start, end, maxaddr, len, lloff;
+	uint8_t kind;
+	int ret;
+
+	maxaddr = cu->cu_pointer_size == 4 ? ~0U : ~0ULL;
+	base = cu->cu_lowpc;
+	lloff = *off;
+
+	while (*off < ds->ds_size) {
+		kind = dbg->read(ds->ds_data, off, 1);
+		start = end = 0;
+
+		switch (kind) {
+		case DW_LLE_end_of_list:
+			break;
+		case DW_LLE_base_addressx:
+		case DW_LLE_base_address:
+			if (kind == DW_LLE_base_address)
+				end = dbg->read(ds->ds_data, off,
+				    cu->cu_pointer_size);
+			else if ((ret = _dwarf_loclists_addrx(dbg, cu,
+			    _dwarf_read_uleb128(ds->ds_data, off), &end,
+			    error)) != DW_DLE_NONE)
+				return (ret);
+			start = maxaddr;
+			base = end;
+			break;
+		case DW_LLE_offset_pair:
+			start = _dwarf_read_uleb128(ds->ds_data, off);
+			end = _dwarf_read_uleb128(ds->ds_data, off);
+			break;
+		case DW_LLE_default_location:
+			end = maxaddr;
+			break;
+		case DW_LLE_startx_endx:
+		case DW_LLE_startx_length:
+			if ((ret = _dwarf_loclists_addrx(dbg, cu,
+			    _dwarf_read_uleb128(ds->ds_data, off), &start,
+			    error)) != DW_DLE_NONE)
 				return (ret);
+			end = _dwarf_read_uleb128(ds->ds_data, off);
+			if (kind == DW_LLE_startx_length)
+				end += start;
+			else if ((ret = _dwarf_loclists_addrx(dbg, cu, end,
+			    &end, error)) != DW_DLE_NONE)
+				return (ret);
+			start -= base;
+			end -= base;
+			break;
+		case DW_LLE_start_end:
+		case DW_LLE_start_length:
+			start = dbg->read(ds->ds_data, off,
+			    cu->cu_pointer_size);
+			if (kind == DW_LLE_start_end)
+				end = dbg->read(ds->ds_data, off,
+				    cu->cu_pointer_size);
+			else
+				end = start +
+				    _dwarf_read_uleb128(ds->ds_data, off);
+			start -= base;
+			end -= base;
+			break;
+		case DW_LLE_GNU_view_pair:
+			/* Location views are not tracked. */
+			(void) _dwarf_read_uleb128(ds->ds_data, off);
+			(void) _dwarf_read_uleb128(ds->ds_data, off);
+			continue;
+		default:
+			DWARF_SET_ERROR(dbg, error, DW_DLE_LOC_EXPR_BAD);
+			return (DW_DLE_LOC_EXPR_BAD);
 		}
 
+		if ((ld = _dwarf_loclist_grow(dbg, ll, error)) == NULL)
+			return (DW_DLE_MEMORY);
+		ld->ld_lopc = start;
+		ld->ld_hipc = end;
+
+		if (kind == DW_LLE_end_of_list)
+			break;
+
+		if (kind == DW_LLE_base_address ||
+		    kind == DW_LLE_base_addressx)
+			continue;
+
+		len = _dwarf_read_uleb128(ds->ds_data, off);
+		if (*off + len > ds->ds_size) {
+			DWARF_SET_ERROR(dbg, error,
+			    DW_DLE_DEBUG_LOC_SECTION_SHORT);
+			return (DW_DLE_DEBUG_LOC_SECTION_SHORT);
+		}
+
+		ret = _dwarf_loc_fill_locdesc(dbg, ld, ds->ds_data + *off, len,
+		    cu->cu_pointer_size, cu->cu_length_size == 4 ? 4 : 8,
+		    cu->cu_version, error);
+		if (ret != DW_DLE_NONE)
+			return (ret);
+
 		*off += len;
 	}
 
-	if (ldlen != NULL)
-		*ldlen = i;
+	ll->ll_len = *off - lloff;
 
 	return (DW_DLE_NONE);
 }
 
-int
-_dwarf_loclist_find(Dwarf_Debug dbg, Dwarf_CU cu, uint64_t lloff,
-    Dwarf_Locdesc ***ret_llbuf, Dwarf_Signed *listlen,
-    Dwarf_Unsigned *entry_len, Dwarf_Error *error)
+static void
+_dwarf_loclist_free(Dwarf_Loclist ll)
+{
+	Dwarf_Signed i;
+
+	for (i = 0; i < ll->ll_ldlen; i++)
+		free(ll->ll_ldarray[i].ld_s);
+	free(ll->ll_ldarray);
+	free(ll);
+}
+
+static int
+_dwarf_loclist_add(Dwarf_Debug dbg, Dwarf_CU cu, uint64_t lloff,
+    Dwarf_Loclist *ret_ll, Dwarf_Error *error)
 {
-	Dwarf_Locdesc **llbuf;
+	Dwarf_Loclist ll;
 	Dwarf_Section *ds;
-	Dwarf_Signed ldlen;
 	Dwarf_Unsigned off;
-	int i, ret;
+	int (*add_locdesc)(Dwarf_Debug, Dwarf_CU, Dwarf_Section *,
+	    Dwarf_Unsigned *, Dwarf_Loclist, Dwarf_Error *);
+	int ret;
 
-	if ((ds = _dwarf_find_section(dbg, ".debug_loc")) == NULL) {
+	if (cu->cu_version >= 5) {
+		ds = dbg->dbg_loclists_sec;
+		add_locdesc = _dwarf_loclists_add_locdesc;
+		if ((ret = _dwarf_die_load_bases(dbg, cu, error)) !=
+		    DW_DLE_NONE)
+			return (ret);
+	} else {
+		ds = _dwarf_find_section(dbg, ".debug_loc");
+		add_locdesc = _dwarf_loclist_add_locdesc;
+	}
+	if (ds == NULL) {
 		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
 		return (DW_DLE_NO_ENTRY);
 	}
@@ -111,55 +280,70 @@ _dwarf_loclist_find(Dwarf_Debug dbg, Dwarf_CU cu, uint64_t lloff,
 		return (DW_DLE_NO_ENTRY);
 	}
 
-	/* Get the number of locdesc the first round. */
-	off = lloff;
-	ret = _dwarf_loclist_add_locdesc(dbg, cu, ds, &off, NULL, &ldlen,
-	    NULL, error);
-	if (ret != DW_DLE_NONE)
-		return (ret);
-
-	if (ldlen == 0)
-		return (DW_DLE_NO_ENTRY);
-
-	/*
-	 * Dwarf_Locdesc list memory is allocated in this way (one more level
-	 * of indirect) to make the loclist API be compatible with SGI libdwarf.
-	 */
-	if ((llbuf = calloc(ldlen, sizeof(Dwarf_Locdesc *))) == NULL) {
+	if ((ll = calloc(1, sizeof(struct _Dwarf_Loclist))) == NULL) {
 		DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
 		return (DW_DLE_MEMORY);
 	}
-	for (i = 0; i < ldlen; i++) {
-		if ((llbuf[i] = calloc(1, sizeof(Dwarf_Locdesc))) == NULL) {
-			DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
-			ret = DW_DLE_MEMORY;
-			goto fail_cleanup;
-		}
-	}
+	ll->ll_key.lk_offset = lloff;
+	ll->ll_key.lk_cu = cu;
 
 	off = lloff;
+	if ((ret = add_locdesc(dbg, cu, ds, &off, ll, error)) !=
+	    DW_DLE_NONE) {
+		_dwarf_loclist_free(ll);
+		return (ret);
+	}
 
-	/* Fill in locdesc. */
-	ret = _dwarf_loclist_add_locdesc(dbg, cu, ds, &off, llbuf, NULL,
-	    entry_len, error);
-	if (ret != DW_DLE_NONE)
-		goto fail_cleanup;
-
-	*ret_llbuf = llbuf;
-	*listlen = ldlen;
+	HASH_ADD(ll_hh, dbg->dbg_llhash, ll_key, sizeof(ll->ll_key), ll);
+	*ret_ll = ll;
 
 	return (DW_DLE_NONE);
+}
 
-fail_cleanup:
+/*
+ * Return the location list at offset 'lloff' as read from unit 'cu'.
+ * A list is parsed once, the first time it is asked for, and is kept
+ * until the debug context is released.  Location expressions depend on
+ * the address size and version of the unit, so lists are cached per
+ * unit.
+ */
+int
+_dwarf_loclist_find(Dwarf_Debug dbg, Dwarf_CU cu, uint64_t lloff,
+    Dwarf_Loclist *ret_ll, Dwarf_Error *error)
+{
+	Dwarf_Loclist ll;
+	Dwarf_ListKey key;
+	int ret;
 
-	if (llbuf != NULL) {
-		for (i = 0; i < ldlen; i++) {
-			if (llbuf[i]->ld_s)
-				free(llbuf[i]->ld_s);
-			free(llbuf[i]);
-		}
-		free(llbuf);
+	memset(&key, 0, sizeof(key));
+	key.lk_offset = lloff;
+	key.lk_cu = cu;
+
+	DWARF_LOCK(dbg);
+	HASH_FIND(ll_hh, dbg->dbg_llhash, &key, sizeof(key), ll);
+	if (ll == NULL &&
+	    (ret = _dwarf_loclist_add(dbg, cu, lloff, &ll, error)) !=
+	    DW_DLE_NONE) {
+		DWARF_UNLOCK(dbg);
+		return (ret);
 	}
+	DWARF_UNLOCK(dbg);
+
+	if (ll->ll_ldlen == 0)
+		return (DW_DLE_NO_ENTRY);
+
+	*ret_ll = ll;
 
-	return (ret);
+	return (DW_DLE_NONE);
+}
+
+void
+_dwarf_loclist_cleanup(Dwarf_Debug dbg)
+{
+	Dwarf_Loclist ll, tll;
+
+	HASH_ITER(ll_hh, dbg->dbg_llhash, ll, tll) {
+		HASH_DELETE(ll_hh, dbg->dbg_llhash, ll);
+		_dwarf_loclist_free(ll);
+	}
 }
@@ -0,0 +1,1369 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "_libdwarf.h"
+
+ELFTC_VCSID("$Id$");
+
+/*
+ * Name lookups.
+ *
+ * Names are looked up in the hash table of the DWARF5 .debug_names
+ * section, or else in the symbol table of a .gdb_index section.  When
+ * the object has neither, an index of the names of the DIEs is built
+ * in memory.  The units are scanned independently of each other, on
+ * several threads if asked to, and their names are then merged in
+ * unit order.
+ */
+
+#define	_NAMES_UNKNOWN		0	/* Sections not looked at yet. */
+#define	_NAMES_DEBUG_NAMES	1	/* Lookups use .debug_names. */
+#define	_NAMES_GDB_INDEX	2	/* Lookups use .gdb_index. */
+#define	_NAMES_NO_INDEX		3	/* Index not built yet. */
+#define	_NAMES_BUILT		4	/* Lookups use the built index. */
+
+typedef struct {
+	const char	**nv_name;	/* Names. */
+	Dwarf_Off	*nv_off;	/* DIE offsets. */
+	Dwarf_Unsigned	nv_cnt;		/* Length of the arrays. */
+	Dwarf_Unsigned	nv_cap;		/* Capacity of the arrays. */
+} Dwarf_NameVec;
+
+typedef struct {
+	const char	*sc_name;	/* Name qualifying inner names. */
+	int		sc_open;	/* Children are indexed. */
+} Dwarf_NameScope;
+
+typedef struct {
+	Dwarf_Off	nr_off;		/* DIE offset. */
+	Dwarf_Off	nr_ref;		/* DIE completed by a nameless DIE. */
+	const char	*nr_name;	/* Name. */
+	const char	*nr_lname;	/* Linkage name. */
+	int		nr_match;	/* The DIE is named as looked up. */
+} Dwarf_NameRef;
+
+typedef struct {
+	Dwarf_Debug	nj_dbg;		/* Debug context. */
+	Dwarf_CU	*nj_cu;		/* Units to scan. */
+	Dwarf_NameVec	*nj_nv;		/* Names found in each unit. */
+	Dwarf_Unsigned	nj_cnt;		/* Number of units. */
+	Dwarf_Unsigned	nj_next;	/* Next unit to scan. */
+	int		nj_ret;		/* First error seen. */
+#if	ELFTC_HAVE_PTHREADS
+	pthread_mutex_t	nj_lock;	/* Protects 'nj_next' and 'nj_ret'. */
+#endif
+} Dwarf_NameJob;
+
+static int
+_dwarf_names_push(Dwarf_Debug dbg, Dwarf_NameVec *nv, const char *name,
+    Dwarf_Off off, Dwarf_Error *error)
+{
+	const char **np;
+	Dwarf_Off *op;
+	Dwarf_Unsigned cap;
+
+	if (nv->nv_cnt == nv->nv_cap) {
+		cap = nv->nv_cap > 0 ? nv->nv_cap * 2 : 16;
+		if ((np = realloc(nv->nv_name, cap * sizeof(*np))) == NULL) {
+			DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+			return (DW_DLE_MEMORY);
+		}
+		nv->nv_name = np;
+		if ((op = realloc(nv->nv_off, cap * sizeof(*op))) == NULL) {
+			DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+			return (DW_DLE_MEMORY);
+		}
+		nv->nv_off = op;
+		nv->nv_cap = cap;
+	}
+
+	nv->nv_name[nv->nv_cnt] = name;
+	nv->nv_off[nv->nv_cnt++] = off;
+
+	return (DW_DLE_NONE);
+}
+
+static void
+_dwarf_names_vec_free(Dwarf_NameVec *nv)
+{
+
+	free(nv->nv_name);
+	free(nv->nv_off);
+	memset(nv, 0, sizeof(*nv));
+}
+
+static int
+_dwarf_names_lower(int c)
+{
+
+	return (c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+}
+
+/*
+ * Scanning the DIEs of a unit.
+ */
+
+/* Tags of the DIEs that are indexed by name. */
+static int
+_dwarf_names_tag(Dwarf_Unsigned tag)
+{
+
+	switch (tag) {
+	case DW_TAG_base_type:
+	case DW_TAG_class_type:
+	case DW_TAG_constant:
+	case DW_TAG_enumeration_type:
+	case DW_TAG_enumerator:
+	case DW_TAG_interface_type:
+	case DW_TAG_namespace:
+	case DW_TAG_structure_type:
+	case DW_TAG_subprogram:
+	case DW_TAG_typedef:
+	case DW_TAG_union_type:
+	case DW_TAG_unspecified_type:
+	case DW_TAG_variable:
+		return (1);
+	default:
+		return (0);
+	}
+}
+
+/* Tags of the DIEs whose children are indexed too. */
+static int
+_dwarf_names_scope(Dwarf_Unsigned tag)
+{
+
+	switch (tag) {
+	case DW_TAG_class_type:
+	case DW_TAG_enumeration_type:
+	case DW_TAG_interface_type:
+	case DW_TAG_namespace:
+	case DW_TAG_structure_type:
+	case DW_TAG_union_type:
+		return (1);
+	default:
+		return (0);
+	}
+}
+
+static const char *
+_dwarf_names_string(Dwarf_Die die, Dwarf_Half attr)
+{
+	Dwarf_Attribute at;
+
+	if ((at = _dwarf_attr_find(die, attr)) == NULL)
+		return (NULL);
+
+	switch (at->at_form) {
+	case DW_FORM_strp:
+	case DW_FORM_line_strp:
+	case DW_FORM_strx:
+	case DW_FORM_strx1:
+	case DW_FORM_strx2:
+	case DW_FORM_strx3:
+	case DW_FORM_strx4:
+		return (at->u[1].s);
+	case DW_FORM_string:
+		return (at->u[0].s);
+	default:
+		return (NULL);
+	}
+}
+
+static int
+_dwarf_names_declaration(Dwarf_Die die)
+{
+	Dwarf_Attribute at;
+
+	if ((at = _dwarf_attr_find(die, DW_AT_declaration)) == NULL)
+		return (0);
+
+	return (at->at_form == DW_FORM_flag_present || at->u[0].u64 != 0);
+}
+
+/*
+ * Return the offset of the DIE that a nameless DIE completes, through
+ * its DW_AT_specification or DW_AT_abstract_origin attribute, or 0 if
+ * there is none in the same unit.
+ */
+static Dwarf_Off
+_dwarf_names_ref(Dwarf_Die die)
+{
+	Dwarf_Attribute at;
+	Dwarf_CU cu;
+	Dwarf_Off off;
+
+	if ((at = _dwarf_attr_find(die, DW_AT_specification)) == NULL &&
+	    (at = _dwarf_attr_find(die, DW_AT_abstract_origin)) == NULL)
+		return (0);
+
+	cu = die->die_cu;
+	switch (at->at_form) {
+	case DW_FORM_ref_addr:
+		off = at->u[0].u64;
+		break;
+	case DW_FORM_ref1:
+	case DW_FORM_ref2:
+	case DW_FORM_ref4:
+	case DW_FORM_ref8:
+	case DW_FORM_ref_udata:
+		off = at->u[0].u64 + cu->cu_offset;
+		break;
+	default:
+		return (0);
+	}
+
+	if (off < cu->cu_1st_offset || off >= cu->cu_next_offset)
+		return (0);
+
+	return (off);
+}
+
+/*
+ * Check whether 'name', qualified with "::" by the names of the scopes
+ * enclosing it, is 'target'.
+ */
+static int
+_dwarf_names_qualified(const char *target, Dwarf_NameScope *sc, int depth,
+    const char *name)
+{
+	size_t len;
+	int i;
+
+	for (i = 0; i < depth; i++) {
+		if (sc[i].sc_name == NULL)
+			continue;
+		len = strlen(sc[i].sc_name);
+		if (strncmp(target, sc[i].sc_name, len) != 0 ||
+		    target[len] != ':' || target[len + 1] != ':')
+			return (0);
+		target += len + 2;
+	}
+
+	return (strcmp(target, name) == 0);
+}
+
+static int
+_dwarf_names_ref_add(Dwarf_Debug dbg, Dwarf_NameRef **nr, int *cnt, int *cap,
+    Dwarf_NameRef *ent, Dwarf_Error *error)
+{
+	Dwarf_NameRef *nnr;
+	int ncap;
+
+	if (*cnt == *cap) {
+		ncap = *cap > 0 ? *cap * 2 : 16;
+		if ((nnr = realloc(*nr, ncap * sizeof(**nr))) == NULL) {
+			DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+			return (DW_DLE_MEMORY);
+		}
+		*nr = nnr;
+		*cap = ncap;
+	}
+	(*nr)[(*cnt)++] = *ent;
+
+	return (DW_DLE_NONE);
+}
+
+/* Find the entry of the DIE at 'off'; the entries are sorted by offset. */
+static Dwarf_NameRef *
+_dwarf_names_ref_find(Dwarf_NameRef *nr, int cnt, Dwarf_Off off)
+{
+	int hi, lo, mid;
+
+	lo = 0;
+	hi = cnt;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (nr[mid].nr_off == off)
+			return (&nr[mid]);
+		if (nr[mid].nr_off < off)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return (NULL);
+}
+
+/*
+ * Collect the names of the DIEs of a unit that are visible outside of
+ * any function: those at the top level of the unit and in namespaces,
+ * classes and enumerations.  Declarations are left out.  If 'match' is
+ * not NULL, only the DIEs named 'match', by their name, linkage name or
+ * qualified name, are collected.
+ *
+ * A definition without a name of its own, such as that of a member
+ * function outside of its class, takes the name and the qualified name
+ * of the declaration it completes.  These definitions are collected
+ * once the whole unit has been read, as the declaration may follow
+ * them.
+ */
+static int
+_dwarf_names_scan(Dwarf_Debug dbg, Dwarf_CU cu, const char *match,
+    Dwarf_NameVec *nv, Dwarf_Error *error)
+{
+	Dwarf_NameScope *sc, *nsc;
+	Dwarf_NameRef ent, *nr, *tnr;
+	Dwarf_Section *ds;
+	Dwarf_Die die;
+	Dwarf_Unsigned tag;
+	const char *lname, *name;
+	uint64_t offset;
+	int cap, depth, hop, i, nr_cap, nr_cnt, open, ret;
+
+	ds = cu->cu_is_info ? dbg->dbg_info_sec : dbg->dbg_types_sec;
+
+	sc = NULL;
+	nr = NULL;
+	cap = depth = nr_cap = nr_cnt = 0;
+	ret = DW_DLE_NONE;
+
+	offset = cu->cu_1st_offset;
+	while (offset < cu->cu_next_offset && offset < ds->ds_size) {
+		/* A null entry ends the children of the current scope. */
+		if (ds->ds_data[offset] == 0) {
+			offset++;
+			if (depth > 0)
+				depth--;
+			continue;
+		}
+		ret = _dwarf_die_parse(dbg, ds, cu, cu->cu_dwarf_size, offset,
+		    cu->cu_next_offset, &die, 0, error);
+		if (ret == DW_DLE_NO_ENTRY) {
+			ret = DW_DLE_NONE;
+			break;
+		} else if (ret != DW_DLE_NONE)
+			break;
+
+		tag = die->die_ab->ab_tag;
+		open = depth == 0 || sc[depth - 1].sc_open;
+
+		name = lname = NULL;
+		memset(&ent, 0, sizeof(ent));
+		if (depth > 0 && open) {
+			name = _dwarf_names_string(die, DW_AT_name);
+			if (name == NULL && tag == DW_TAG_namespace)
+				name = "(anonymous namespace)";
+			lname = _dwarf_names_string(die, DW_AT_linkage_name);
+			if (lname == NULL)
+				lname = _dwarf_names_string(die,
+				    DW_AT_MIPS_linkage_name);
+			if (lname != NULL && name != NULL &&
+			    strcmp(lname, name) == 0)
+				lname = NULL;
+			ent.nr_off = die->die_offset;
+			ent.nr_name = name;
+			ent.nr_lname = lname;
+			if (name == NULL && _dwarf_names_tag(tag) &&
+			    !_dwarf_names_declaration(die))
+				ent.nr_ref = _dwarf_names_ref(die);
+		}
+
+		/*
+		 * Named DIEs are remembered, declarations included, for the
+		 * definitions that refer to them.
+		 */
+		if (name != NULL) {
+			if (match != NULL)
+				ent.nr_match = strcmp(name, match) == 0 ||
+				    (lname != NULL &&
+				    strcmp(lname, match) == 0) ||
+				    _dwarf_names_qualified(match, sc, depth,
+				    name);
+			ret = _dwarf_names_ref_add(dbg, &nr, &nr_cnt, &nr_cap,
+			    &ent, error);
+		} else if (ent.nr_ref != 0)
+			ret = _dwarf_names_ref_add(dbg, &nr, &nr_cnt, &nr_cap,
+			    &ent, error);
+
+		if (ret == DW_DLE_NONE && name != NULL &&
+		    _dwarf_names_tag(tag) && !_dwarf_names_declaration(die)) {
+			if (match == NULL) {
+				ret = _dwarf_names_push(dbg, nv, name,
+				    die->die_offset, error);
+				if (ret == DW_DLE_NONE && lname != NULL)
+					ret = _dwarf_names_push(dbg, nv, lname,
+					    die->die_offset, error);
+			} else if (ent.nr_match)
+				ret = _dwarf_names_push(dbg, nv, match,
+				    die->die_offset, error);
+		}
+
+		if (ret == DW_DLE_NONE &&
+		    die->die_ab->ab_children == DW_CHILDREN_yes) {
+			if (depth == cap) {
+				cap = cap > 0 ? cap * 2 : 16;
+				if ((nsc = realloc(sc, cap * sizeof(*sc))) ==
+				    NULL) {
+					DWARF_SET_ERROR(dbg, error,
+					    DW_DLE_MEMORY);
+					ret = DW_DLE_MEMORY;
+				} else
+					sc = nsc;
+			}
+			if (ret == DW_DLE_NONE) {
+				sc[depth].sc_open = depth == 0 ||
+				    (open && _dwarf_names_scope(tag));
+				sc[depth].sc_name =
+				    tag == DW_TAG_enumeration_type ? NULL :
+				    name;
+				depth++;
+			}
+		}
+
+		offset = die->die_next_off;
+		dwarf_dealloc(dbg, die, DW_DLA_DIE);
+		if (ret != DW_DLE_NONE)
+			break;
+	}
+
+	/*
+	 * Follow the references of the nameless definitions to a named
+	 * DIE.  A concrete instance of an inlined member function goes
+	 * through its abstract instance to the declaration.
+	 */
+	for (i = 0; i < nr_cnt && ret == DW_DLE_NONE; i++) {
+		if (nr[i].nr_name != NULL)
+			continue;
+		tnr = &nr[i];
+		for (hop = 0; hop < 8 && tnr != NULL && tnr->nr_name == NULL;
+		     hop++)
+			tnr = _dwarf_names_ref_find(nr, nr_cnt, tnr->nr_ref);
+		if (tnr == NULL || tnr->nr_name == NULL)
+			continue;
+		lname = nr[i].nr_lname != NULL ? nr[i].nr_lname :
+		    tnr->nr_lname;
+		if (match == NULL) {
+			ret = _dwarf_names_push(dbg, nv, tnr->nr_name,
+			    nr[i].nr_off, error);
+			if (ret == DW_DLE_NONE && lname != NULL &&
+			    strcmp(lname, tnr->nr_name) != 0)
+				ret = _dwarf_names_push(dbg, nv, lname,
+				    nr[i].nr_off, error);
+		} else if (tnr->nr_match ||
+		    (lname != NULL && strcmp(lname, match) == 0))
+			ret = _dwarf_names_push(dbg, nv, match, nr[i].nr_off,
+			    error);
+	}
+
+	free(nr);
+	free(sc);
+
+	return (ret);
+}
+
+/*
+ * The .debug_names section.
+ */
+
+static int
+_dwarf_names_read_units(Dwarf_Debug dbg, Dwarf_Section *ds,
+    Dwarf_Error *error)
+{
+	Dwarf_NameUnit *nu, *nua;
+	Dwarf_Unsigned cap, ftu_cnt, abbrev_size, aug_size;
+	uint64_t length, offset, next;
+	int offset_size;
+
+	nua = NULL;
+	cap = 0;
+
+	offset = 0;
+	while (offset + 4 <= ds->ds_size) {
+		length = dbg->read(ds->ds_data, &offset, 4);
+		if (length == 0xffffffff) {
+			offset_size = 8;
+			length = dbg->read(ds->ds_data, &offset, 8);
+		} else
+			offset_size = 4;
+
+		if (length > ds->ds_size - offset)
+			break;
+		next = offset + length;
+
+		/* Name indexes of other versions are skipped. */
+		if (length < 36 || dbg->read(ds->ds_data, &offset, 2) != 5) {
+			offset = next;
+			continue;
+		}
+		(void) dbg->read(ds->ds_data, &offset, 2); /* Padding. */
+
+		if (dbg->dbg_nu_cnt == cap) {
+			cap = cap > 0 ? cap * 2 : 8;
+			if ((nu = realloc(nua, cap * sizeof(*nu))) == NULL) {
+				free(nua);
+				DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+				return (DW_DLE_MEMORY);
+			}
+			nua = nu;
+		}
+		nu = &nua[dbg->dbg_nu_cnt];
+
+		nu->nu_offset_size = offset_size;
+		nu->nu_cu_cnt = dbg->read(ds->ds_data, &offset, 4);
+		nu->nu_ltu_cnt = dbg->read(ds->ds_data, &offset, 4);
+		ftu_cnt = dbg->read(ds->ds_data, &offset, 4);
+		nu->nu_bucket_cnt = dbg->read(ds->ds_data, &offset, 4);
+		nu->nu_name_cnt = dbg->read(ds->ds_data, &offset, 4);
+		abbrev_size = dbg->read(ds->ds_data, &offset, 4);
+		aug_size = dbg->read(ds->ds_data, &offset, 4);
+		offset += (aug_size + 3) & ~(Dwarf_Unsigned) 3;
+
+		nu->nu_cu_off = offset;
+		offset += (nu->nu_cu_cnt + nu->nu_ltu_cnt) * offset_size +
+		    ftu_cnt * 8;
+		nu->nu_bucket_off = offset;
+		offset += nu->nu_bucket_cnt * 4;
+		nu->nu_hash_off = offset;
+		if (nu->nu_bucket_cnt > 0)
+			offset += nu->nu_name_cnt * 4;
+		nu->nu_str_off = offset;
+		offset += nu->nu_name_cnt * offset_size;
+		nu->nu_entry_off = offset;
+		offset += nu->nu_name_cnt * offset_size;
+		nu->nu_abbrev_off = offset;
+		offset += abbrev_size;
+		nu->nu_pool_off = offset;
+		nu->nu_end = next;
+
+		/* Keep the name index only if its tables fit. */
+		if (nu->nu_pool_off <= next)
+			dbg->dbg_nu_cnt++;
+
+		offset = next;
+	}
+
+	dbg->dbg_nu_array = nua;
+
+	return (DW_DLE_NONE);
+}
+
+static int
+_dwarf_names_form_read(Dwarf_Debug dbg, Dwarf_Section *ds, uint64_t *offset,
+    uint64_t form, uint64_t *val, Dwarf_Error *error)
+{
+
+	switch (form) {
+	case DW_FORM_flag_present:
+		*val = 1;
+		break;
+	case DW_FORM_data1:
+	case DW_FORM_flag:
+	case DW_FORM_ref1:
+		*val = dbg->read(ds->ds_data, offset, 1);
+		break;
+	case DW_FORM_data2:
+	case DW_FORM_ref2:
+		*val = dbg->read(ds->ds_data, offset, 2);
+		break;
+	case DW_FORM_data4:
+	case DW_FORM_ref4:
+		*val = dbg->read(ds->ds_data, offset, 4);
+		break;
+	case DW_FORM_data8:
+	case DW_FORM_ref8:
+	case DW_FORM_ref_sig8:
+		*val = dbg->read(ds->ds_data, offset, 8);
+		break;
+	case DW_FORM_udata:
+	case DW_FORM_ref_udata:
+		*val = _dwarf_read_uleb128(ds->ds_data, offset);
+		break;
+	case DW_FORM_sdata:
+		*val = _dwarf_read_sleb128(ds->ds_data, offset);
+		break;
+	default:
+		DWARF_SET_ERROR(dbg, error, DW_DLE_ATTR_FORM_BAD);
+		return (DW_DLE_ATTR_FORM_BAD);
+	}
+
+	return (DW_DLE_NONE);
+}
+
+/* Collect the DIE offsets of the entries of name 'i' of a name index. */
+static int
+_dwarf_names_nu_entries(Dwarf_Debug dbg, Dwarf_Section *ds,
+    Dwarf_NameUnit *nu, Dwarf_Unsigned i, const char *name, Dwarf_NameVec *nv,
+    Dwarf_Error *error)
+{
+	uint64_t abbrev, code, cu, die, form, idx, offset, tu, uoff, val;
+	int has_cu, has_die, has_tu, ret;
+
+	offset = nu->nu_entry_off + i * nu->nu_offset_size;
+	offset = nu->nu_pool_off + dbg->read(ds->ds_data, &offset,
+	    nu->nu_offset_size);
+
+	while (offset < nu->nu_end) {
+		if ((code = _dwarf_read_uleb128(ds->ds_data, &offset)) == 0)
+			break;
+
+		/* Find the abbreviation of the entry. */
+		abbrev = nu->nu_abbrev_off;
+		for (;;) {
+			if (abbrev >= nu->nu_pool_off ||
+			    _dwarf_read_uleb128(ds->ds_data, &abbrev) == code)
+				break;
+			(void) _dwarf_read_uleb128(ds->ds_data, &abbrev);
+			do {
+				idx = _dwarf_read_uleb128(ds->ds_data,
+				    &abbrev);
+				form = _dwarf_read_uleb128(ds->ds_data,
+				    &abbrev);
+			} while ((idx != 0 || form != 0) &&
+			    abbrev < nu->nu_pool_off);
+		}
+		if (abbrev >= nu->nu_pool_off)
+			break;
+		(void) _dwarf_read_uleb128(ds->ds_data, &abbrev); /* Tag. */
+
+		/* A name index of a single CU may leave out the CU. */
+		cu = tu = die = 0;
+		has_cu = nu->nu_cu_cnt == 1;
+		has_tu = has_die = 0;
+		while (abbrev < nu->nu_pool_off) {
+			idx = _dwarf_read_uleb128(ds->ds_data, &abbrev);
+			form = _dwarf_read_uleb128(ds->ds_data, &abbrev);
+			if (idx == 0 && form == 0)
+				break;
+			if ((ret = _dwarf_names_form_read(dbg, ds, &offset,
+			    form, &val, error)) != DW_DLE_NONE)
+				return (ret);
+			switch (idx) {
+			case DW_IDX_compile_unit:
+				cu = val;
+				has_cu = 1;
+				break;
+			case DW_IDX_type_unit:
+				tu = val;
+				has_tu = 1;
+				break;
+			case DW_IDX_die_offset:
+				die = val;
+				has_die = 1;
+				break;
+			default:
+				break;
+			}
+		}
+
+		/* Entries of foreign type units are left out. */
+		if (!has_die)
+			continue;
+		if (has_tu) {
+			if (tu >= nu->nu_ltu_cnt)
+				continue;
+			uoff = nu->nu_cu_off + (nu->nu_cu_cnt + tu) *
+			    nu->nu_offset_size;
+		} else if (has_cu && cu < nu->nu_cu_cnt)
+			uoff = nu->nu_cu_off + cu * nu->nu_offset_size;
+		else
+			continue;
+
+		if ((ret = _dwarf_names_push(dbg, nv, name,
+		    dbg->read(ds->ds_data, &uoff, nu->nu_offset_size) + die,
+		    error)) != DW_DLE_NONE)
+			return (ret);
+	}
+
+	return (DW_DLE_NONE);
+}
+
+static int
+_dwarf_names_nu_match(Dwarf_Debug dbg, Dwarf_Section *ds, Dwarf_NameUnit *nu,
+    Dwarf_Unsigned i, const char *name, size_t len)
+{
+	uint64_t offset, stroff;
+
+	offset = nu->nu_str_off + i * nu->nu_offset_size;
+	stroff = dbg->read(ds->ds_data, &offset, nu->nu_offset_size);
+	if (stroff >= dbg->dbg_strtab_size ||
+	    len >= dbg->dbg_strtab_size - stroff)
+		return (0);
+
+	return (memcmp(dbg->dbg_strtab + stroff, name, len) == 0 &&
+	    dbg->dbg_strtab[stroff + len] == '\0');
+}
+
+static int
+_dwarf_names_nu_lookup(Dwarf_Debug dbg, Dwarf_Section *ds, Dwarf_NameUnit *nu,
+    const char *name, uint32_t hash, Dwarf_NameVec *nv, Dwarf_Error *error)
+{
+	Dwarf_Unsigned bucket, i;
+	uint64_t offset;
+	uint32_t h;
+	size_t len;
+	int ret;
+
+	len = strlen(name);
+
+	/* Without a hash table, every name is looked at. */
+	if (nu->nu_bucket_cnt == 0) {
+		for (i = 0; i < nu->nu_name_cnt; i++) {
+			if (!_dwarf_names_nu_match(dbg, ds, nu, i, name, len))
+				continue;
+			if ((ret = _dwarf_names_nu_entries(dbg, ds, nu, i,
+			    name, nv, error)) != DW_DLE_NONE)
+				return (ret);
+		}
+		return (DW_DLE_NONE);
+	}
+
+	/*
+	 * A bucket holds the index, counting from 1, of the first of the
+	 * names that hash to it.  These names are stored together.
+	 */
+	bucket = hash % nu->nu_bucket_cnt;
+	offset = nu->nu_bucket_off + bucket * 4;
+	if ((i = dbg->read(ds->ds_data, &offset, 4)) == 0)
+		return (DW_DLE_NONE);
+
+	for (i--; i < nu->nu_name_cnt; i++) {
+		offset = nu->nu_hash_off + i * 4;
+		h = dbg->read(ds->ds_data, &offset, 4);
+		if (h % nu->nu_bucket_cnt != bucket)
+			break;
+		if (h != hash ||
+		    !_dwarf_names_nu_match(dbg, ds, nu, i, name, len))
+			continue;
+		if ((ret = _dwarf_names_nu_entries(dbg, ds, nu, i, name, nv,
+		    error)) != DW_DLE_NONE)
+			return (ret);
+	}
+
+	return (DW_DLE_NONE);
+}
+
+/* The DJB hash of a name, folded to lower case as DWARF5 requires. */
+static uint32_t
+_dwarf_names_djb_hash(const char *name)
+{
+	uint32_t h;
+
+	for (h = 5381; *name != '\0'; name++)
+		h = h * 33 + _dwarf_names_lower((unsigned char) *name);
+
+	return (h);
+}
+
+/*
+ * The .gdb_index section.  Its values are little-endian, whatever the
+ * byte order of the object.
+ */
+
+#define	_GDB_INDEX_MIN_VERSION	7
+#define	_GDB_INDEX_MAX_VERSION	9
+
+typedef struct {
+	uint64_t	gi_cu_off;	/* Offset of the CU list. */
+	uint64_t	gi_tu_off;	/* Offset of the TU list. */
+	uint64_t	gi_sym_off;	/* Offset of the symbol table. */
+	uint64_t	gi_sym_cnt;	/* Number of symbol table slots. */
+	uint64_t	gi_const_off;	/* Offset of the constant pool. */
+} Dwarf_GdbIndex;
+
+static int
+_dwarf_names_gdb_header(Dwarf_Section *ds, Dwarf_GdbIndex *gi)
+{
+	uint64_t offset, sym_end, version;
+
+	if (ds->ds_size < 24)
+		return (0);
+
+	offset = 0;
+	version = _dwarf_read_lsb(ds->ds_data, &offset, 4);
+	if (version < _GDB_INDEX_MIN_VERSION ||
+	    version > _GDB_INDEX_MAX_VERSION)
+		return (0);
+	gi->gi_cu_off = _dwarf_read_lsb(ds->ds_data, &offset, 4);
+	gi->gi_tu_off = _dwarf_read_lsb(ds->ds_data, &offset, 4);
+	(void) _dwarf_read_lsb(ds->ds_data, &offset, 4); /* Address area. */
+	gi->gi_sym_off = _dwarf_read_lsb(ds->ds_data, &offset, 4);
+	if (version >= 9) {
+		if (ds->ds_size < 28)
+			return (0);
+		/* The shortcut table follows the symbol table. */
+		sym_end = _dwarf_read_lsb(ds->ds_data, &offset, 4);
+	} else
+		sym_end = 0;
+	gi->gi_const_off = _dwarf_read_lsb(ds->ds_data, &offset, 4);
+	if (version < 9)
+		sym_end = gi->gi_const_off;
+
+	if (gi->gi_cu_off > gi->gi_tu_off || gi->gi_sym_off > sym_end ||
+	    sym_end > gi->gi_const_off || gi->gi_const_off > ds->ds_size)
+		return (0);
+
+	/* The number of slots is a power of 2. */
+	gi->gi_sym_cnt = (sym_end - gi->gi_sym_off) / 8;
+	if ((gi->gi_sym_cnt & (gi->gi_sym_cnt - 1)) != 0)
+		return (0);
+
+	return (1);
+}
+
+static uint32_t
+_dwarf_names_gdb_hash(const char *name)
+{
+	uint32_t h;
+
+	for (h = 0; *name != '\0'; name++)
+		h = h * 67 + _dwarf_names_lower((unsigned char) *name) - 113;
+
+	return (h);
+}
+
+static int
+_dwarf_names_gdb_lookup(Dwarf_Debug dbg, Dwarf_Section *ds, const char *name,
+    Dwarf_NameVec *nv, Dwarf_Error *error)
+{
+	Dwarf_GdbIndex gi;
+	Dwarf_CU cu;
+	uint64_t cnt, cuidx, i, j, mask, nameoff, offset, slot, step, vecoff;
+	uint32_t h;
+	size_t len;
+	int ret;
+
+	if (!_dwarf_names_gdb_header(ds, &gi) || gi.gi_sym_cnt == 0)
+		return (DW_DLE_NONE);
+
+	/* Open addressing, with a step derived from the hash. */
+	len = strlen(name);
+	h = _dwarf_names_gdb_hash(name);
+	mask = gi.gi_sym_cnt - 1;
+	slot = h & mask;
+	step = ((h * 17) & mask) | 1;
+	for (i = 0; i < gi.gi_sym_cnt; i++) {
+		offset = gi.gi_sym_off + slot * 8;
+		nameoff = _dwarf_read_lsb(ds->ds_data, &offset, 4);
+		vecoff = _dwarf_read_lsb(ds->ds_data, &offset, 4);
+		if (nameoff == 0 && vecoff == 0)
+			return (DW_DLE_NONE);
+		nameoff += gi.gi_const_off;
+		if (nameoff < ds->ds_size && len < ds->ds_size - nameoff &&
+		    memcmp(ds->ds_data + nameoff, name, len) == 0 &&
+		    ds->ds_data[nameoff + len] == '\0')
+			break;
+		slot = (slot + step) & mask;
+	}
+	if (i == gi.gi_sym_cnt)
+		return (DW_DLE_NONE);
+
+	/*
+	 * The CU vector of the symbol lists the units defining it.  The
+	 * DIEs are found by scanning these units.  Type units, which live
+	 * in .debug_types, are left out.
+	 */
+	offset = gi.gi_const_off + vecoff;
+	if (offset + 4 > ds->ds_size)
+		return (DW_DLE_NONE);
+	cnt = _dwarf_read_lsb(ds->ds_data, &offset, 4);
+	if (cnt > (ds->ds_size - offset) / 4)
+		return (DW_DLE_NONE);
+	for (i = 0; i < cnt; i++) {
+		j = offset + i * 4;
+		cuidx = _dwarf_read_lsb(ds->ds_data, &j, 4) & 0xffffff;
+		if (cuidx >= (gi.gi_tu_off - gi.gi_cu_off) / 16)
+			continue;
+
+		/* A unit may be listed more than once. */
+		for (j = 0; j < i; j++) {
+			slot = offset + j * 4;
+			if ((_dwarf_read_lsb(ds->ds_data, &slot, 4) &
+			    0xffffff) == cuidx)
+				break;
+		}
+		if (j < i)
+			continue;
+
+		slot = gi.gi_cu_off + cuidx * 16;
+		ret = _dwarf_info_find_cu(dbg, 1,
+		    _dwarf_read_lsb(ds->ds_data, &slot, 8), &cu, error);
+		if (ret == DW_DLE_NO_ENTRY)
+			continue;
+		if (ret != DW_DLE_NONE)
+			return (ret);
+		if ((ret = _dwarf_names_scan(dbg, cu, name, nv, error)) !=
+		    DW_DLE_NONE)
+			return (ret);
+	}
+
+	return (DW_DLE_NONE);
+}
+
+/*
+ * Decide where lookups are answered from.  Called with the debug
+ * context locked.
+ */
+static int
+_dwarf_names_init(Dwarf_Debug dbg, Dwarf_Error *error)
+{
+	Dwarf_GdbIndex gi;
+	Dwarf_Section *ds;
+	int ret;
+
+	if (dbg->dbg_names_src != _NAMES_UNKNOWN)
+		return (DW_DLE_NONE);
+
+	if ((ds = _dwarf_find_section(dbg, ".debug_names")) != NULL) {
+		if ((ret = _dwarf_names_read_units(dbg, ds, error)) !=
+		    DW_DLE_NONE)
+			return (ret);
+		if (dbg->dbg_nu_cnt > 0) {
+			dbg->dbg_names_src = _NAMES_DEBUG_NAMES;
+			return (DW_DLE_NONE);
+		}
+	}
+
+	if ((ds = _dwarf_find_section(dbg, ".gdb_index")) != NULL &&
+	    _dwarf_names_gdb_header(ds, &gi)) {
+		dbg->dbg_names_src = _NAMES_GDB_INDEX;
+		return (DW_DLE_NONE);
+	}
+
+	dbg->dbg_names_src = _NAMES_NO_INDEX;
+
+	return (DW_DLE_NONE);
+}
+
+static void *
+_dwarf_names_worker(void *arg)
+{
+	Dwarf_NameJob *nj;
+	Dwarf_Error de;
+	Dwarf_Unsigned i;
+	int ret;
+
+	nj = arg;
+
+	for (;;) {
+#if	ELFTC_HAVE_PTHREADS
+		(void) pthread_mutex_lock(&nj->nj_lock);
+#endif
+		i = nj->nj_next++;
+		ret = nj->nj_ret;
+#if	ELFTC_HAVE_PTHREADS
+		(void) pthread_mutex_unlock(&nj->nj_lock);
+#endif
+		if (i >= nj->nj_cnt || ret != DW_DLE_NONE)
+			break;
+
+		ret = _dwarf_names_scan(nj->nj_dbg, nj->nj_cu[i], NULL,
+		    &nj->nj_nv[i], &de);
+		if (ret != DW_DLE_NONE) {
+#if	ELFTC_HAVE_PTHREADS
+			(void) pthread_mutex_lock(&nj->nj_lock);
+#endif
+			if (nj->nj_ret == DW_DLE_NONE)
+				nj->nj_ret = ret;
+#if	ELFTC_HAVE_PTHREADS
+			(void) pthread_mutex_unlock(&nj->nj_lock);
+#endif
+		}
+	}
+
+	return (NULL);
+}
+
+static void
+_dwarf_names_hash_free(Dwarf_NameIdx *hash)
+{
+	Dwarf_NameIdx ni, nni, tni;
+
+	HASH_ITER(ni_hh, *hash, ni, tni) {
+		HASH_DELETE(ni_hh, *hash, ni);
+		for (; ni != NULL; ni = nni) {
+			nni = ni->ni_next;
+			free(ni->ni_off);
+			free(ni);
+		}
+	}
+}
+
+/*
+ * The built index is hashed on the DJB hash of the names, with the
+ * names sharing a hash value chained together.
+ */
+static Dwarf_NameIdx
+_dwarf_names_hash_find(Dwarf_NameIdx hash, const char *name, uint32_t h)
+{
+	Dwarf_NameIdx ni;
+
+	HASH_FIND(ni_hh, hash, &h, sizeof(h), ni);
+	while (ni != NULL && strcmp(ni->ni_name, name) != 0)
+		ni = ni->ni_next;
+
+	return (ni);
+}
+
+/* Merge the names found in each unit, in unit order. */
+static int
+_dwarf_names_merge(Dwarf_Debug dbg, Dwarf_NameJob *nj, Dwarf_NameIdx *hash,
+    Dwarf_Error *error)
+{
+	Dwarf_NameIdx head, ni;
+	Dwarf_NameVec *nv;
+	Dwarf_Unsigned cap, i, j;
+	Dwarf_Off *off;
+	const char *name;
+	uint32_t h;
+
+	for (i = 0; i < nj->nj_cnt; i++) {
+		nv = &nj->nj_nv[i];
+		for (j = 0; j < nv->nv_cnt; j++) {
+			name = nv->nv_name[j];
+			h = _dwarf_names_djb_hash(name);
+			HASH_FIND(ni_hh, *hash, &h, sizeof(h), head);
+			for (ni = head; ni != NULL; ni = ni->ni_next)
+				if (strcmp(ni->ni_name, name) == 0)
+					break;
+			if (ni == NULL) {
+				if ((ni = calloc(1, sizeof(*ni))) == NULL)
+					goto fail;
+				ni->ni_hash = h;
+				ni->ni_name = name;
+				if (head != NULL) {
+					ni->ni_next = head->ni_next;
+					head->ni_next = ni;
+				} else
+					HASH_ADD(ni_hh, *hash, ni_hash,
+					    sizeof(ni->ni_hash), ni);
+			}
+			if (ni->ni_cnt == ni->ni_cap) {
+				cap = ni->ni_cap > 0 ? ni->ni_cap * 2 : 1;
+				if ((off = realloc(ni->ni_off, cap *
+				    sizeof(*off))) == NULL)
+					goto fail;
+				ni->ni_off = off;
+				ni->ni_cap = cap;
+			}
+			ni->ni_off[ni->ni_cnt++] = nv->nv_off[j];
+		}
+	}
+
+	return (DW_DLE_NONE);
+
+fail:
+	DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+	return (DW_DLE_MEMORY);
+}
+
+/*
+ * Build the index of the names of the DIEs of the compilation units,
+ * scanning the units on 'nthreads' threads.  Nothing is built if the
+ * object has a name index of its own.
+ */
+int
+_dwarf_names_build(Dwarf_Debug dbg, int nthreads, Dwarf_Error *error)
+{
+	Dwarf_NameJob nj;
+	Dwarf_NameIdx hash;
+	Dwarf_CU cu;
+	Dwarf_Unsigned i;
+#if	ELFTC_HAVE_PTHREADS
+	pthread_t *th;
+	int n;
+#endif
+	int ret;
+
+#if	!ELFTC_HAVE_PTHREADS
+	(void) nthreads;
+#endif
+
+	memset(&nj, 0, sizeof(nj));
+	nj.nj_dbg = dbg;
+	hash = NULL;
+
+	DWARF_LOCK(dbg);
+	if ((ret = _dwarf_names_init(dbg, error)) != DW_DLE_NONE ||
+	    dbg->dbg_names_src != _NAMES_NO_INDEX) {
+		DWARF_UNLOCK(dbg);
+		return (ret);
+	}
+	ret = _dwarf_info_load(dbg, 1, 1, error);
+	if (ret == DW_DLE_NONE) {
+		STAILQ_FOREACH(cu, &dbg->dbg_cu, cu_next)
+			nj.nj_cnt++;
+		if ((nj.nj_cu = calloc(nj.nj_cnt + 1, sizeof(Dwarf_CU))) ==
+		    NULL || (nj.nj_nv = calloc(nj.nj_cnt + 1,
+		    sizeof(Dwarf_NameVec))) == NULL) {
+			DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+			ret = DW_DLE_MEMORY;
+		} else {
+			i = 0;
+			STAILQ_FOREACH(cu, &dbg->dbg_cu, cu_next)
+				nj.nj_cu[i++] = cu;
+		}
+	} else if (ret == DW_DLE_NO_ENTRY)
+		ret = DW_DLE_NONE;
+	DWARF_UNLOCK(dbg);
+	if (ret != DW_DLE_NONE)
+		goto done;
+
+	/*
+	 * The units are scanned without the debug context locked, as
+	 * the worker threads need the lock too.
+	 */
+#if	ELFTC_HAVE_PTHREADS
+	if (nthreads > 1 && nj.nj_cnt > 1) {
+		if ((Dwarf_Unsigned) nthreads > nj.nj_cnt)
+			nthreads = nj.nj_cnt;
+		if ((th = calloc(nthreads, sizeof(*th))) == NULL ||
+		    pthread_mutex_init(&nj.nj_lock, NULL) != 0) {
+			free(th);
+			DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+			ret = DW_DLE_MEMORY;
+			goto done;
+		}
+		for (n = 0; n < nthreads; n++)
+			if (pthread_create(&th[n], NULL, _dwarf_names_worker,
+			    &nj) != 0)
+				break;
+		/* The calling thread helps, or does the work alone. */
+		(void) _dwarf_names_worker(&nj);
+		while (n > 0)
+			(void) pthread_join(th[--n], NULL);
+		(void) pthread_mutex_destroy(&nj.nj_lock);
+		free(th);
+	} else
+#endif
+	{
+#if	ELFTC_HAVE_PTHREADS
+		(void) pthread_mutex_init(&nj.nj_lock, NULL);
+#endif
+		(void) _dwarf_names_worker(&nj);
+#if	ELFTC_HAVE_PTHREADS
+		(void) pthread_mutex_destroy(&nj.nj_lock);
+#endif
+	}
+
+	if ((ret = nj.nj_ret) != DW_DLE_NONE) {
+		DWARF_SET_ERROR(dbg, error, ret);
+		goto done;
+	}
+
+	if ((ret = _dwarf_names_merge(dbg, &nj, &hash, error)) !=
+	    DW_DLE_NONE)
+		goto done;
+
+	/* Another thread may have built the index meanwhile. */
+	DWARF_LOCK(dbg);
+	if (dbg->dbg_names_src == _NAMES_NO_INDEX) {
+		dbg->dbg_ni_hash = hash;
+		dbg->dbg_names_src = _NAMES_BUILT;
+		hash = NULL;
+	}
+	DWARF_UNLOCK(dbg);
+
+done:
+	_dwarf_names_hash_free(&hash);
+	for (i = 0; i < nj.nj_cnt && nj.nj_nv != NULL; i++)
+		_dwarf_names_vec_free(&nj.nj_nv[i]);
+	free(nj.nj_nv);
+	free(nj.nj_cu);
+
+	return (ret);
+}
+
+/*
+ * Return the last component of the qualified name 'name', or NULL if
+ * the name is not qualified.  The "::" within template arguments and
+ * parameter lists do not separate components.
+ */
+static const char *
+_dwarf_names_base(const char *name)
+{
+	const char *base, *p;
+	int nest;
+
+	base = NULL;
+	nest = 0;
+	for (p = name; *p != '\0'; p++) {
+		if (*p == '<' || *p == '(')
+			nest++;
+		else if ((*p == '>' || *p == ')') && nest > 0)
+			nest--;
+		else if (nest == 0 && p[0] == ':' && p[1] == ':') {
+			base = p + 2;
+			p++;
+		}
+	}
+
+	return (base != NULL && *base != '\0' ? base : NULL);
+}
+
+/* Look up 'name' in the source of names 'src'. */
+static int
+_dwarf_names_find(Dwarf_Debug dbg, int src, const char *name,
+    Dwarf_NameVec *nv, Dwarf_Error *error)
+{
+	Dwarf_NameIdx ni;
+	Dwarf_Section *ds;
+	Dwarf_Unsigned i;
+	uint32_t hash;
+	int ret;
+
+	ret = DW_DLE_NONE;
+
+	switch (src) {
+	case _NAMES_DEBUG_NAMES:
+		ds = _dwarf_find_section(dbg, ".debug_names");
+		hash = _dwarf_names_djb_hash(name);
+		for (i = 0; i < dbg->dbg_nu_cnt && ret == DW_DLE_NONE; i++)
+			ret = _dwarf_names_nu_lookup(dbg, ds,
+			    &dbg->dbg_nu_array[i], name, hash, nv, error);
+		break;
+	case _NAMES_GDB_INDEX:
+		ds = _dwarf_find_section(dbg, ".gdb_index");
+		ret = _dwarf_names_gdb_lookup(dbg, ds, name, nv, error);
+		break;
+	default:
+		ni = _dwarf_names_hash_find(dbg->dbg_ni_hash, name,
+		    _dwarf_names_djb_hash(name));
+		for (i = 0; ni != NULL && i < ni->ni_cnt &&
+		    ret == DW_DLE_NONE; i++)
+			ret = _dwarf_names_push(dbg, nv, name, ni->ni_off[i],
+			    error);
+		break;
+	}
+
+	return (ret);
+}
+
+/*
+ * Look up a qualified name in an index of unqualified names: the units
+ * defining its last component are scanned for the qualified name.
+ */
+static int
+_dwarf_names_find_qualified(Dwarf_Debug dbg, int src, const char *name,
+    const char *base, Dwarf_NameVec *nv, Dwarf_Error *error)
+{
+	Dwarf_NameVec bnv;
+	Dwarf_CU cu, *cua;
+	Dwarf_Unsigned i, j, n;
+	int ret;
+
+	memset(&bnv, 0, sizeof(bnv));
+	cua = NULL;
+
+	if ((ret = _dwarf_names_find(dbg, src, base, &bnv, error)) !=
+	    DW_DLE_NONE || bnv.nv_cnt == 0)
+		goto done;
+
+	if ((cua = calloc(bnv.nv_cnt, sizeof(*cua))) == NULL) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+		ret = DW_DLE_MEMORY;
+		goto done;
+	}
+
+	for (i = n = 0; i < bnv.nv_cnt; i++) {
+		ret = _dwarf_info_find_cu(dbg, 1, bnv.nv_off[i], &cu, error);
+		if (ret == DW_DLE_NO_ENTRY) {
+			ret = DW_DLE_NONE;
+			continue;
+		}
+		if (ret != DW_DLE_NONE)
+			goto done;
+
+		/* A unit may define the name more than once. */
+		for (j = 0; j < n; j++)
+			if (cua[j] == cu)
+				break;
+		if (j < n)
+			continue;
+		cua[n++] = cu;
+
+		if ((ret = _dwarf_names_scan(dbg, cu, name, nv, error)) !=
+		    DW_DLE_NONE)
+			goto done;
+	}
+
+done:
+	free(cua);
+	_dwarf_names_vec_free(&bnv);
+
+	return (ret);
+}
+
+/*
+ * Return the offsets of the DIEs named 'name', in an array that the
+ * caller releases.
+ */
+int
+_dwarf_names_lookup(Dwarf_Debug dbg, const char *name, Dwarf_Off **ret_off,
+    Dwarf_Unsigned *ret_cnt, Dwarf_Error *error)
+{
+	Dwarf_NameVec nv;
+	const char *base;
+	int ret, src;
+
+	DWARF_LOCK(dbg);
+	ret = _dwarf_names_init(dbg, error);
+	src = dbg->dbg_names_src;
+	DWARF_UNLOCK(dbg);
+	if (ret != DW_DLE_NONE)
+		return (ret);
+
+	if (src == _NAMES_NO_INDEX) {
+		if ((ret = _dwarf_names_build(dbg, 1, error)) != DW_DLE_NONE)
+			return (ret);
+		src = _NAMES_BUILT;
+	}
+
+	memset(&nv, 0, sizeof(nv));
+
+	/* A .gdb_index section holds the qualified names themselves. */
+	if (src != _NAMES_GDB_INDEX &&
+	    (base = _dwarf_names_base(name)) != NULL)
+		ret = _dwarf_names_find_qualified(dbg, src, name, base, &nv,
+		    error);
+	else
+		ret = _dwarf_names_find(dbg, src, name, &nv, error);
+
+	if (ret == DW_DLE_NONE && nv.nv_cnt == 0) {
+		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
+		ret = DW_DLE_NO_ENTRY;
+	}
+	if (ret != DW_DLE_NONE) {
+		_dwarf_names_vec_free(&nv);
+		return (ret);
+	}
+
+	*ret_off = nv.nv_off;
+	*ret_cnt = nv.nv_cnt;
+	free(nv.nv_name);
+
+	return (DW_DLE_NONE);
+}
+
+void
+_dwarf_names_cleanup(Dwarf_Debug dbg)
+{
+
+	free(dbg->dbg_nu_array);
+	dbg->dbg_nu_array = NULL;
+	dbg->dbg_nu_cnt = 0;
+	_dwarf_names_hash_free(&dbg->dbg_ni_hash);
+}
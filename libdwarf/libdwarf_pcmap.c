@@ -0,0 +1,379 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "_libdwarf.h"
+
+ELFTC_VCSID("$Id$");
+
+/*
+ * PC interval tables.
+ *
+ * Intervals are collected with _dwarf_pcmap_add() and then sorted once
+ * by _dwarf_pcmap_sort().  Overlapping intervals are clipped so that
+ * the table is non-overlapping: the interval that starts first owns
+ * the overlap, with ties resolved in insertion order.  Lookups are a
+ * binary search.
+ */
+
+int
+_dwarf_pcmap_add(Dwarf_Debug dbg, Dwarf_PcMap *pm, Dwarf_Unsigned lopc,
+    Dwarf_Unsigned hipc, void *obj, Dwarf_Error *error)
+{
+	Dwarf_PcRange *pr;
+	Dwarf_Unsigned cap;
+
+	if (lopc >= hipc)
+		return (DW_DLE_NONE);
+
+	if (pm->pm_cnt == pm->pm_cap) {
+		cap = pm->pm_cap > 0 ? pm->pm_cap * 2 : 64;
+		if ((pr = realloc(pm->pm_range, cap * sizeof(*pr))) == NULL) {
+			DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+			return (DW_DLE_MEMORY);
+		}
+		pm->pm_range = pr;
+		pm->pm_cap = cap;
+	}
+
+	pr = &pm->pm_range[pm->pm_cnt];
+	pr->pr_lopc = lopc;
+	pr->pr_hipc = hipc;
+	pr->pr_seq = pm->pm_cnt;
+	pr->pr_obj = obj;
+	pm->pm_cnt++;
+	pm->pm_sorted = 0;
+
+	return (DW_DLE_NONE);
+}
+
+static int
+_dwarf_pcmap_cmp(const void *a, const void *b)
+{
+	const Dwarf_PcRange *pa, *pb;
+
+	pa = a;
+	pb = b;
+
+	if (pa->pr_lopc != pb->pr_lopc)
+		return (pa->pr_lopc < pb->pr_lopc ? -1 : 1);
+	if (pa->pr_seq != pb->pr_seq)
+		return (pa->pr_seq < pb->pr_seq ? -1 : 1);
+
+	return (0);
+}
+
+void
+_dwarf_pcmap_sort(Dwarf_PcMap *pm)
+{
+	Dwarf_PcRange *pr, *last;
+	Dwarf_Unsigned i, n;
+
+	if (pm->pm_sorted)
+		return;
+
+	if (pm->pm_cnt > 1)
+		qsort(pm->pm_range, pm->pm_cnt, sizeof(Dwarf_PcRange),
+		    _dwarf_pcmap_cmp);
+
+	/*
+	 * Clip each interval against the one before it.  Since the
+	 * kept intervals are disjoint and sorted, the last one kept
+	 * always has the highest end PC seen so far.
+	 */
+	for (i = 0, n = 0; i < pm->pm_cnt; i++) {
+		pr = &pm->pm_range[i];
+		if (n > 0) {
+			last = &pm->pm_range[n - 1];
+			if (pr->pr_hipc <= last->pr_hipc)
+				continue;
+			if (pr->pr_lopc < last->pr_hipc)
+				pr->pr_lopc = last->pr_hipc;
+		}
+		pm->pm_range[n++] = *pr;
+	}
+	pm->pm_cnt = n;
+	pm->pm_sorted = 1;
+}
+
+Dwarf_PcRange *
+_dwarf_pcmap_find(Dwarf_PcMap *pm, Dwarf_Unsigned pc)
+{
+	Dwarf_PcRange *pr;
+	Dwarf_Unsigned lo, hi, mid;
+
+	assert(pm->pm_sorted);
+
+	/* Find the last interval starting at or below pc. */
+	lo = 0;
+	hi = pm->pm_cnt;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (pm->pm_range[mid].pr_lopc <= pc)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo == 0)
+		return (NULL);
+
+	pr = &pm->pm_range[lo - 1];
+	if (pc >= pr->pr_hipc)
+		return (NULL);
+
+	return (pr);
+}
+
+void
+_dwarf_pcmap_cleanup(Dwarf_PcMap *pm)
+{
+
+	free(pm->pm_range);
+	pm->pm_range = NULL;
+	pm->pm_cnt = pm->pm_cap = 0;
+	pm->pm_sorted = 0;
+}
+
+static Dwarf_Unsigned
+_dwarf_pcmap_attr_addr(Dwarf_Attribute at)
+{
+
+	switch (at->at_form) {
+	case DW_FORM_addrx:
+	case DW_FORM_addrx1:
+	case DW_FORM_addrx2:
+	case DW_FORM_addrx3:
+	case DW_FORM_addrx4:
+		return (at->u[1].u64);
+	default:
+		return (at->u[0].u64);
+	}
+}
+
+/*
+ * Add the PC ranges described by the DW_AT_ranges or DW_AT_low_pc and
+ * DW_AT_high_pc attributes of a DIE.  '*found' is set if the DIE has
+ * any such attributes.  A range list that cannot be read, as when the
+ * object lacks the section holding it, is passed over in favour of
+ * DW_AT_low_pc and DW_AT_high_pc, so that one damaged unit does not
+ * make every lookup fail.  Only running out of memory is an error.
+ */
+static int
+_dwarf_pcmap_die_add(Dwarf_Debug dbg, Dwarf_CU cu, Dwarf_Die die,
+    int *found, Dwarf_Error *error)
+{
+	Dwarf_Attribute at;
+	Dwarf_Error de;
+	Dwarf_Rangelist rl;
+	Dwarf_Ranges *rg;
+	Dwarf_Unsigned base, lopc, hipc, off;
+	int i, ret;
+
+	*found = 0;
+
+	if ((at = _dwarf_attr_find(die, DW_AT_ranges)) != NULL) {
+		off = at->at_form == DW_FORM_rnglistx ? at->u[1].u64 :
+		    at->u[0].u64;
+		ret = _dwarf_ranges_find(dbg, cu, off, &rl);
+		if (ret == DW_DLE_NO_ENTRY)
+			ret = _dwarf_ranges_add(dbg, cu, off, &rl, &de);
+		if (ret == DW_DLE_MEMORY) {
+			DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+			return (ret);
+		}
+		if (ret == DW_DLE_NONE) {
+			*found = 1;
+			base = cu->cu_lowpc;
+			for (i = 0; (Dwarf_Unsigned) i < rl->rl_rglen; i++) {
+				rg = &rl->rl_rgarray[i];
+				if (rg->dwr_type == DW_RANGES_END)
+					break;
+				if (rg->dwr_type ==
+				    DW_RANGES_ADDRESS_SELECTION) {
+					base = rg->dwr_addr2;
+					continue;
+				}
+				ret = _dwarf_pcmap_add(dbg,
+				    &dbg->dbg_cu_pcmap, base + rg->dwr_addr1,
+				    base + rg->dwr_addr2, cu, error);
+				if (ret != DW_DLE_NONE)
+					return (ret);
+			}
+			return (DW_DLE_NONE);
+		}
+	}
+
+	if ((at = _dwarf_attr_find(die, DW_AT_low_pc)) == NULL)
+		return (DW_DLE_NONE);
+	lopc = _dwarf_pcmap_attr_addr(at);
+
+	if ((at = _dwarf_attr_find(die, DW_AT_high_pc)) == NULL)
+		return (DW_DLE_NONE);
+	*found = 1;
+
+	/* Since DWARF4 DW_AT_high_pc may be an offset from DW_AT_low_pc. */
+	switch (at->at_form) {
+	case DW_FORM_addr:
+	case DW_FORM_addrx:
+	case DW_FORM_addrx1:
+	case DW_FORM_addrx2:
+	case DW_FORM_addrx3:
+	case DW_FORM_addrx4:
+		hipc = _dwarf_pcmap_attr_addr(at);
+		break;
+	default:
+		hipc = lopc + at->u[0].u64;
+		break;
+	}
+
+	return (_dwarf_pcmap_add(dbg, &dbg->dbg_cu_pcmap, lopc, hipc, cu,
+	    error));
+}
+
+/*
+ * Collect the PC ranges of a CU that has no .debug_aranges entries.
+ * The ranges of the CU DIE are used if present, otherwise those of
+ * every subprogram DIE in the CU.
+ */
+static int
+_dwarf_pcmap_cu_scan(Dwarf_Debug dbg, Dwarf_CU cu, Dwarf_Error *error)
+{
+	Dwarf_Section *ds;
+	Dwarf_Die die;
+	uint64_t offset;
+	int found, ret;
+
+	ds = dbg->dbg_info_sec;
+	offset = cu->cu_1st_offset;
+	ret = _dwarf_die_parse(dbg, ds, cu, cu->cu_dwarf_size, offset,
+	    cu->cu_next_offset, &die, 0, error);
+	if (ret == DW_DLE_NO_ENTRY)
+		return (DW_DLE_NONE);
+	else if (ret != DW_DLE_NONE)
+		return (ret);
+
+	ret = _dwarf_pcmap_die_add(dbg, cu, die, &found, error);
+	offset = die->die_next_off;
+	dwarf_dealloc(dbg, die, DW_DLA_DIE);
+	if (ret != DW_DLE_NONE || found)
+		return (ret);
+
+	while (offset < cu->cu_next_offset && offset < ds->ds_size) {
+		/* Skip null entries. */
+		if (ds->ds_data[offset] == 0) {
+			offset++;
+			continue;
+		}
+		ret = _dwarf_die_parse(dbg, ds, cu, cu->cu_dwarf_size, offset,
+		    cu->cu_next_offset, &die, 0, error);
+		if (ret == DW_DLE_NO_ENTRY)
+			break;
+		else if (ret != DW_DLE_NONE)
+			return (ret);
+		if (die->die_ab->ab_tag == DW_TAG_subprogram)
+			ret = _dwarf_pcmap_die_add(dbg, cu, die, &found,
+			    error);
+		offset = die->die_next_off;
+		dwarf_dealloc(dbg, die, DW_DLA_DIE);
+		if (ret != DW_DLE_NONE)
+			return (ret);
+	}
+
+	return (DW_DLE_NONE);
+}
+
+/*
+ * Build the CU lookup table.  Address ranges come from .debug_aranges
+ * where available.  CUs that .debug_aranges does not describe are
+ * covered by scanning their DIEs.
+ */
+static int
+_dwarf_pcmap_cu_build(Dwarf_Debug dbg, Dwarf_Error *error)
+{
+	Dwarf_Arange ar;
+	Dwarf_CU cu;
+	Dwarf_Error de;
+	Dwarf_Unsigned i;
+	int ret;
+
+	if (dbg->dbg_cu_pcmap.pm_sorted)
+		return (DW_DLE_NONE);
+
+	ret = _dwarf_info_load(dbg, 1, 1, error);
+	if (ret != DW_DLE_NONE)
+		return (ret);
+
+	/*
+	 * A .debug_aranges section that cannot be read leaves every unit
+	 * to be scanned.
+	 */
+	if (dbg->dbg_arange_cnt == 0) {
+		ret = _dwarf_arange_init(dbg, &de);
+		if (ret == DW_DLE_MEMORY) {
+			DWARF_SET_ERROR(dbg, error, DW_DLE_MEMORY);
+			return (ret);
+		}
+	}
+
+	for (i = 0; i < dbg->dbg_arange_cnt; i++) {
+		ar = dbg->dbg_arange_array[i];
+		cu = ar->ar_as->as_cu;
+		cu->cu_has_arange = 1;
+		ret = _dwarf_pcmap_add(dbg, &dbg->dbg_cu_pcmap,
+		    ar->ar_address, ar->ar_address + ar->ar_range, cu, error);
+		if (ret != DW_DLE_NONE)
+			goto fail_cleanup;
+	}
+
+	STAILQ_FOREACH(cu, &dbg->dbg_cu, cu_next) {
+		if (cu->cu_has_arange)
+			continue;
+		if ((ret = _dwarf_pcmap_cu_scan(dbg, cu, error)) !=
+		    DW_DLE_NONE)
+			goto fail_cleanup;
+	}
+
+	_dwarf_pcmap_sort(&dbg->dbg_cu_pcmap);
+
+	return (DW_DLE_NONE);
+
+fail_cleanup:
+
+	_dwarf_pcmap_cleanup(&dbg->dbg_cu_pcmap);
+
+	return (ret);
+}
+
+int
+_dwarf_pcmap_cu_init(Dwarf_Debug dbg, Dwarf_Error *error)
+{
+	int ret;
+
+	DWARF_LOCK(dbg);
+	ret = _dwarf_pcmap_cu_build(dbg, error);
+	DWARF_UNLOCK(dbg);
+
+	return (ret);
+}
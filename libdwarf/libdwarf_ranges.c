@@ -65,14 +65,146 @@ _dwarf_ranges_parse(Dwarf_Debug dbg, Dwarf_CU cu, Dwarf_Section *ds,
 	return (DW_DLE_NONE);
 }
 
+/* Fetch entry 'idx' of the unit's .debug_addr table. */
+static int
+_dwarf_ranges_addrx(Dwarf_Debug dbg, Dwarf_CU cu, uint64_t idx,
+    Dwarf_Unsigned *addr)
+{
+	struct _Dwarf_Attribute atref;
+	int ret;
+
+	memset(&atref, 0, sizeof(atref));
+	atref.at_form = DW_FORM_addrx;
+	atref.u[0].u64 = idx;
+	if ((ret = _dwarf_attr_resolve(dbg, cu, &atref, NULL)) !=
+	    DW_DLE_NONE)
+		return (ret);
+	*addr = atref.u[1].u64;
+
+	return (DW_DLE_NONE);
+}
+
+/*
+ * Parse a DWARF5 range list in .debug_rnglists.  The entries are
+ * translated into the DWARF4 representation: offset pairs are kept
+ * relative to the current base address, base address entries become
+ * address selection entries and bounded entries are rebased on the
+ * current base address.
+ */
+static int
+_dwarf_rnglists_parse(Dwarf_Debug dbg, Dwarf_CU cu, Dwarf_Section *ds,
+    uint64_t off, Dwarf_Ranges *rg, Dwarf_Unsigned *cnt)
+{
+	Dwarf_Unsigned base, start, end, maxaddr;
+	uint8_t kind;
+	int i, type;
+
+	maxaddr = cu->cu_pointer_size == 4 ? ~0U : ~0ULL;
+	base = cu->cu_lowpc;
+
+	i = 0;
+	while (off < ds->ds_size) {
+
+		kind = dbg->read(ds->ds_data, &off, 1);
+		start = end = 0;
+		type = DW_RANGES_ENTRY;
+
+		switch (kind) {
+		case DW_RLE_end_of_list:
+			type = DW_RANGES_END;
+			break;
+		case DW_RLE_base_addressx:
+		case DW_RLE_base_address:
+			if (kind == DW_RLE_base_address)
+				end = dbg->read(ds->ds_data, &off,
+				    cu->cu_pointer_size);
+			else if (_dwarf_ranges_addrx(dbg, cu,
+			    _dwarf_read_uleb128(ds->ds_data, &off), &end) !=
+			    DW_DLE_NONE)
+				goto done;
+			start = maxaddr;
+			base = end;
+			type = DW_RANGES_ADDRESS_SELECTION;
+			break;
+		case DW_RLE_offset_pair:
+			start = _dwarf_read_uleb128(ds->ds_data, &off);
+			end = _dwarf_read_uleb128(ds->ds_data, &off);
+			break;
+		case DW_RLE_startx_endx:
+		case DW_RLE_startx_length:
+			if (_dwarf_ranges_addrx(dbg, cu,
+			    _dwarf_read_uleb128(ds->ds_data, &off), &start) !=
+			    DW_DLE_NONE)
+				goto done;
+			end = _dwarf_read_uleb128(ds->ds_data, &off);
+			if (kind == DW_RLE_startx_length)
+				end += start;
+			else if (_dwarf_ranges_addrx(dbg, cu, end, &end) !=
+			    DW_DLE_NONE)
+				goto done;
+			start -= base;
+			end -= base;
+			break;
+		case DW_RLE_start_end:
+		case DW_RLE_start_length:
+			start = dbg->read(ds->ds_data, &off,
+			    cu->cu_pointer_size);
+			if (kind == DW_RLE_start_end)
+				end = dbg->read(ds->ds_data, &off,
+				    cu->cu_pointer_size);
+			else
+				end = start +
+				    _dwarf_read_uleb128(ds->ds_data, &off);
+			start -= base;
+			end -= base;
+			break;
+		default:
+			/* Unknown entry kind, the list can not be followed. */
+			goto done;
+		}
+
+		if (rg != NULL) {
+			rg[i].dwr_addr1 = start;
+			rg[i].dwr_addr2 = end;
+			rg[i].dwr_type = type;
+		}
+
+		i++;
+
+		if (type == DW_RANGES_END)
+			break;
+	}
+
+done:
+	if (cnt != NULL)
+		*cnt = i;
+
+	return (DW_DLE_NONE);
+}
+
+static void
+_dwarf_ranges_key(Dwarf_CU cu, uint64_t off, Dwarf_ListKey *key)
+{
+
+	memset(key, 0, sizeof(*key));
+	key->lk_offset = off;
+	if (cu->cu_version >= 5)
+		key->lk_cu = cu;
+}
+
 int
-_dwarf_ranges_find(Dwarf_Debug dbg, uint64_t off, Dwarf_Rangelist *ret_rl)
+_dwarf_ranges_find(Dwarf_Debug dbg, Dwarf_CU cu, uint64_t off,
+    Dwarf_Rangelist *ret_rl)
 {
 	Dwarf_Rangelist rl;
+	Dwarf_ListKey key;
 
-	STAILQ_FOREACH(rl, &dbg->dbg_rllist, rl_next)
-		if (rl->rl_offset == off)
-			break;
+	/*
+	 * DWARF5 range lists live in their own section and depend on
+	 * the base address of the unit referring to them.
+	 */
+	_dwarf_ranges_key(cu, off, &key);
+	HASH_FIND(rl_hh, dbg->dbg_rlhash, &key, sizeof(key), rl);
 
 	if (rl == NULL)
 		return (DW_DLE_NO_ENTRY);
@@ -88,11 +220,8 @@ _dwarf_ranges_cleanup(Dwarf_Debug dbg)
 {
 	Dwarf_Rangelist rl, trl;
 
-	if (STAILQ_EMPTY(&dbg->dbg_rllist))
-		return;
-
-	STAILQ_FOREACH_SAFE(rl, &dbg->dbg_rllist, rl_next, trl) {
-		STAILQ_REMOVE(&dbg->dbg_rllist, rl, _Dwarf_Rangelist, rl_next);
+	HASH_ITER(rl_hh, dbg->dbg_rlhash, rl, trl) {
+		HASH_DELETE(rl_hh, dbg->dbg_rlhash, rl);
 		if (rl->rl_rgarray)
 			free(rl->rl_rgarray);
 		free(rl);
@@ -106,9 +235,21 @@ _dwarf_ranges_add(Dwarf_Debug dbg, Dwarf_CU cu, uint64_t off,
 	Dwarf_Section *ds;
 	Dwarf_Rangelist rl;
 	Dwarf_Unsigned cnt;
+	int (*parse)(Dwarf_Debug, Dwarf_CU, Dwarf_Section *, uint64_t,
+	    Dwarf_Ranges *, Dwarf_Unsigned *);
 	int ret;
 
-	if ((ds = _dwarf_find_section(dbg, ".debug_ranges")) == NULL) {
+	if (cu->cu_version >= 5) {
+		ds = dbg->dbg_rnglists_sec;
+		parse = _dwarf_rnglists_parse;
+		if ((ret = _dwarf_die_load_bases(dbg, cu, error)) !=
+		    DW_DLE_NONE)
+			return (ret);
+	} else {
+		ds = _dwarf_find_section(dbg, ".debug_ranges");
+		parse = _dwarf_ranges_parse;
+	}
+	if (ds == NULL) {
 		DWARF_SET_ERROR(dbg, error, DW_DLE_NO_ENTRY);
 		return (DW_DLE_NO_ENTRY);
 	}
@@ -118,9 +259,9 @@ _dwarf_ranges_add(Dwarf_Debug dbg, Dwarf_CU cu, uint64_t off,
 		return (DW_DLE_MEMORY);
 	}
 
-	rl->rl_offset = off;
+	_dwarf_ranges_key(cu, off, &rl->rl_key);
 
-	ret = _dwarf_ranges_parse(dbg, cu, ds, off, NULL, &cnt);
+	ret = parse(dbg, cu, ds, off, NULL, &cnt);
 	if (ret != DW_DLE_NONE) {
 		free(rl);
 		return (ret);
@@ -135,8 +276,7 @@ _dwarf_ranges_add(Dwarf_Debug dbg, Dwarf_CU cu, uint64_t off,
 			return (DW_DLE_MEMORY);
 		}
 
-		ret = _dwarf_ranges_parse(dbg, cu, ds, off, rl->rl_rgarray,
-		    NULL);
+		ret = parse(dbg, cu, ds, off, rl->rl_rgarray, NULL);
 		if (ret != DW_DLE_NONE) {
 			free(rl->rl_rgarray);
 			free(rl);
@@ -145,7 +285,7 @@ _dwarf_ranges_add(Dwarf_Debug dbg, Dwarf_CU cu, uint64_t off,
 	} else
 		rl->rl_rgarray = NULL;
 
-	STAILQ_INSERT_TAIL(&dbg->dbg_rllist, rl, rl_next);
+	HASH_ADD(rl_hh, dbg->dbg_rlhash, rl_key, sizeof(rl->rl_key), rl);
 	*ret_rl = rl;
 
 	return (DW_DLE_NONE);
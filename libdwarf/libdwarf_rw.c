@@ -52,6 +52,10 @@ _dwarf_read_lsb(uint8_t *data, uint64_t *offsetp, int bytes_to_read)
 	case 1:
 		ret |= src[0];
 		break;
+	case 3:
+		ret = ((uint64_t) src[2]) << 16 | ((uint64_t) src[1]) << 8;
+		ret |= src[0];
+		break;
 	default:
 		return (0);
 	}
@@ -108,6 +112,10 @@ _dwarf_read_msb(uint8_t *data, uint64_t *offsetp, int bytes_to_read)
 	case 2:
 		ret = src[1] | ((uint64_t) src[0]) << 8;
 		break;
+	case 3:
+		ret = src[2] | ((uint64_t) src[1]) << 8;
+		ret |= ((uint64_t) src[0]) << 16;
+		break;
 	case 4:
 		ret = src[3] | ((uint64_t) src[2]) << 8;
 		ret |= ((uint64_t) src[1]) << 16 | ((uint64_t) src[0]) << 24;
@@ -206,6 +206,47 @@ _dwarf_generate_sections(Dwarf_P_Debug dbg, Dwarf_Error *error)
 	return (DW_DLE_NONE);
 }
 
+/*
+ * Fetch the data of a consumer section from the object access interface
+ * the first time the section is used, so that sections no query touches
+ * are never read or relocated.  The section lock is not held while any
+ * other lock is taken, hence callers may hold the instance or a unit
+ * lock.
+ */
+int
+_dwarf_section_load(Dwarf_Debug dbg, Dwarf_Section *ds)
+{
+	const Dwarf_Obj_Access_Methods *m;
+	int error, ret;
+
+	assert(dbg != NULL && ds != NULL);
+	assert(dbg->dbg_iface != NULL);
+
+	m = dbg->dbg_iface->methods;
+	ret = DW_DLE_NONE;
+
+#if	ELFTC_HAVE_PTHREADS
+	(void) pthread_mutex_lock(&dbg->dbg_sec_lock);
+#endif
+	if (!ds->ds_loaded) {
+		error = DW_DLE_NONE;
+		if (m->load_section(dbg->dbg_iface->object,
+		    (Dwarf_Half) (ds - dbg->dbg_section), &ds->ds_data,
+		    &error) == DW_DLV_OK)
+			ds->ds_loaded = 1;
+		else
+			ret = error != DW_DLE_NONE ? error : DW_DLE_NO_ENTRY;
+	}
+#if	ELFTC_HAVE_PTHREADS
+	(void) pthread_mutex_unlock(&dbg->dbg_sec_lock);
+#endif
+
+	return (ret);
+}
+
+/*
+ * Sections that cannot be loaded are reported as absent.
+ */
 Dwarf_Section *
 _dwarf_find_section(Dwarf_Debug dbg, const char *name)
 {
@@ -217,7 +258,8 @@ _dwarf_find_section(Dwarf_Debug dbg, const char *name)
 	for (i = 0; i < dbg->dbg_seccnt; i++) {
 		ds = &dbg->dbg_section[i];
 		if (ds->ds_name != NULL && !strcmp(ds->ds_name, name))
-			return (ds);
+			return (_dwarf_section_load(dbg, ds) == DW_DLE_NONE ?
+			    ds : NULL);
 	}
 
 	return (NULL);
@@ -237,7 +279,8 @@ _dwarf_find_next_types_section(Dwarf_Debug dbg, Dwarf_Section *ds)
 	do {
 		ds++;
 		if (ds->ds_name != NULL &&
-		    !strcmp(ds->ds_name, ".debug_types"))
+		    !strcmp(ds->ds_name, ".debug_types") &&
+		    _dwarf_section_load(dbg, ds) == DW_DLE_NONE)
 			return (ds);
 	} while (ds->ds_name != NULL);
 
@@ -35,25 +35,66 @@
 
 #include "_elftc.h"
 
+#if	ELFTC_HAVE_PTHREADS
+#include <pthread.h>
+#endif
+
 /*
  * Library-private data structures.
  */
 
 #define LIBELF_MSG_SIZE	256
 
+/*
+ * Process-wide settings.  These are set up by elf_version(3) and
+ * elf_fill(3) before any descriptors are created and are only read
+ * thereafter.
+ */
 struct _libelf_globals {
 	int		libelf_arch;
 	unsigned int	libelf_byteorder;
 	int		libelf_class;
-	int		libelf_error;
 	int		libelf_fillchar;
 	unsigned int	libelf_version;
+};
+
+/*
+ * Error state, kept separately for each thread.
+ */
+struct _libelf_tls {
+	int		libelf_error;
 	unsigned char	libelf_msg[LIBELF_MSG_SIZE];
 };
 
+#if	ELFTC_HAVE_PTHREADS
+#if	defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define	LIBELF_TLS	_Thread_local
+#else
+#define	LIBELF_TLS	__thread
+#endif
+#else
+#define	LIBELF_TLS	/**/
+#endif
+
 extern struct _libelf_globals _libelf;
+extern LIBELF_TLS struct _libelf_tls _libelf_tls;
 
 #define	LIBELF_PRIVATE(N)	(_libelf.libelf_##N)
+#define	LIBELF_TLS_PRIVATE(N)	(_libelf_tls.libelf_##N)
+
+/*
+ * Descriptors opened with ELF_C_READ may be shared between threads.
+ * Lazily constructed state hanging off such a descriptor (the ELF
+ * header, the program and section header tables and translated
+ * section data) is built under a per-descriptor lock.
+ */
+#if	ELFTC_HAVE_PTHREADS
+#define	LIBELF_LOCK(E)		(void) pthread_mutex_lock(&(E)->e_lock)
+#define	LIBELF_UNLOCK(E)	(void) pthread_mutex_unlock(&(E)->e_lock)
+#else
+#define	LIBELF_LOCK(E)		do { } while (0)
+#define	LIBELF_UNLOCK(E)	do { } while (0)
+#endif
 
 #define	LIBELF_ELF_ERROR_MASK			0xFF
 #define	LIBELF_OS_ERROR_SHIFT			8
@@ -62,7 +103,7 @@ extern struct _libelf_globals _libelf;
 	((O) << LIBELF_OS_ERROR_SHIFT))
 
 #define	LIBELF_SET_ERROR(E, O) do {					\
-		LIBELF_PRIVATE(error) = LIBELF_ERROR(ELF_E_##E, (O));	\
+		LIBELF_TLS_PRIVATE(error) = LIBELF_ERROR(ELF_E_##E, (O)); \
 	} while (0)
 
 #define	LIBELF_ADJUST_AR_SIZE(S)	(((S) + 1U) & ~1U)
@@ -79,6 +120,9 @@ extern struct _libelf_globals _libelf;
 #define	LIBELF_F_RAWFILE_MMAP	0x100000U /* whether e_rawfile was mmap'ed */
 #define	LIBELF_F_SHDRS_LOADED	0x200000U /* whether all shdrs were read in */
 #define	LIBELF_F_SPECIAL_FILE	0x400000U /* non-regular file */
+#define	LIBELF_F_RAWFILE_PARTIAL 0x800000U /* e_rawfile is read on demand */
+#define	LIBELF_F_SHDRS_INDEXED	0x1000000U /* shdr table checked, not read */
+#define	LIBELF_F_RAWFILE_RESERVED 0x2000000U /* e_rawfile is mapped anon */
 
 struct _Elf {
 	int		e_activations;	/* activation count */
@@ -92,6 +136,11 @@ struct _Elf {
 	unsigned char	*e_rawfile;	/* uninterpreted bytes */
 	off_t		e_rawsize;	/* size of uninterpreted bytes */
 	unsigned int	e_version;	/* file version */
+	Elf_Cmd		e_advice;	/* access pattern, see elf_cntl(3) */
+	unsigned char	*e_rawchunks;	/* chunks of e_rawfile read in */
+#if	ELFTC_HAVE_PTHREADS
+	pthread_mutex_t	e_lock;		/* protects lazily loaded state */
+#endif
 
 	/*
 	 * Header information for archive members.  See the
@@ -105,6 +154,7 @@ struct _Elf {
 	union {
 		struct {		/* ar(1) archives */
 			off_t	e_next;	/* set by elf_rand()/elf_next() */
+			off_t	e_first; /* offset of the first member */
 			int	e_nchildren;
 			unsigned char *e_rawstrtab; /* file name strings */
 			size_t	e_rawstrtabsz;
@@ -112,6 +162,8 @@ struct _Elf {
 			size_t	e_rawsymtabsz;
 			Elf_Arsym *e_symtab;
 			size_t	e_symtabsz;
+			off_t	*e_members; /* see elf_getarmembers() */
+			size_t	e_nmembers;
 		} e_ar;
 		struct {		/* regular ELF files */
 			union {
@@ -123,6 +175,10 @@ struct _Elf {
 				Elf64_Phdr *e_phdr64;
 			} e_phdr;
 			STAILQ_HEAD(, _Elf_Scn)	e_scn;	/* section list */
+			Elf_Scn	**e_scnarray;	/* sections by index */
+			size_t	e_scnarraysz;	/* slots in e_scnarray */
+			struct _Libelf_Scnblock *e_scnblocks; /* storage */
+			uint64_t e_rawshoff;	/* offset of the shdr table */
 			size_t	e_nphdr;	/* number of Phdr entries */
 			size_t	e_nscn;		/* number of sections */
 			size_t	e_strndx;	/* string table section index */
@@ -154,6 +210,7 @@ struct _Elf_Scn {
 	uint64_t	s_offset;	/* managed by elf_update() */
 	uint64_t	s_rawoff;	/* original offset in the file */
 	uint64_t	s_size;		/* managed by elf_update() */
+	struct _Libelf_Strtab *s_strtab; /* cached by elf_strptr() */
 };
 
 
@@ -200,14 +257,19 @@ typedef int _libelf_translator_function(unsigned char *_dst, size_t dsz,
 #ifdef __cplusplus
 extern "C" {
 #endif
+void	_libelf_advise(Elf *_e, Elf_Cmd _c);
 struct _Libelf_Data *_libelf_allocate_data(Elf_Scn *_s);
 Elf	*_libelf_allocate_elf(void);
 Elf_Scn	*_libelf_allocate_scn(Elf *_e, size_t _ndx);
+int	_libelf_reserve_scn(Elf *_e, size_t _count);
 Elf_Arhdr *_libelf_ar_gethdr(Elf *_e);
 Elf	*_libelf_ar_open(Elf *_e, int _reporterror);
-Elf	*_libelf_ar_open_member(int _fd, Elf_Cmd _c, Elf *_ar);
+Elf	*_libelf_ar_open_member(int _fd, Elf_Cmd _c, Elf *_ar, off_t _off);
+off_t	*_libelf_ar_scan_members(Elf *_ar, size_t *_dst);
 Elf_Arsym *_libelf_ar_process_bsd_symtab(Elf *_ar, size_t *_dst);
 Elf_Arsym *_libelf_ar_process_svr4_symtab(Elf *_ar, size_t *_dst);
+size_t	_libelf_bswap(unsigned char *_dst, const unsigned char *_src,
+    size_t _count, const char *_layout);
 long	 _libelf_checksum(Elf *_e, int _elfclass);
 void	*_libelf_ehdr(Elf *_e, int _elfclass, int _allocate);
 int	_libelf_elfmachine(Elf *_e);
@@ -219,6 +281,7 @@ _libelf_translator_function *_libelf_get_translator(Elf_Type _t,
 void	*_libelf_getphdr(Elf *_e, int _elfclass);
 void	*_libelf_getshdr(Elf_Scn *_scn, int _elfclass);
 void	_libelf_init_elf(Elf *_e, Elf_Kind _kind);
+int	_libelf_load_rawfile(Elf *_e, uint64_t _off, uint64_t _sz);
 int	_libelf_load_section_headers(Elf *e, void *ehdr);
 unsigned int _libelf_malign(Elf_Type _t, int _elfclass);
 Elf	*_libelf_memory(unsigned char *_image, size_t _sz, int _reporterror);
@@ -228,6 +291,8 @@ Elf	*_libelf_open_object(int _fd, Elf_Cmd _c, int _reporterror);
 struct _Libelf_Data *_libelf_release_data(struct _Libelf_Data *_d);
 void	_libelf_release_elf(Elf *_e);
 Elf_Scn	*_libelf_release_scn(Elf_Scn *_s);
+void	_libelf_release_scnblocks(Elf *_e);
+void	_libelf_release_strtab(Elf_Scn *_s);
 int	_libelf_setphnum(Elf *_e, void *_eh, int _elfclass, size_t _phnum);
 int	_libelf_setshnum(Elf *_e, void *_eh, int _elfclass, size_t _shnum);
 int	_libelf_setshstrndx(Elf *_e, void *_eh, int _elfclass,
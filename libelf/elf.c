@@ -34,7 +34,10 @@ struct _libelf_globals _libelf = {
 	.libelf_arch		= LIBELF_ARCH,
 	.libelf_byteorder	= LIBELF_BYTEORDER,
 	.libelf_class		= LIBELF_CLASS,
-	.libelf_error		= 0,
 	.libelf_fillchar	= 0,
 	.libelf_version		= EV_NONE
 };
+
+LIBELF_TLS struct _libelf_tls _libelf_tls = {
+	.libelf_error		= 0
+};
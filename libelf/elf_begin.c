@@ -83,9 +83,14 @@ elf_begin(int fd, Elf_Cmd c, Elf *a)
 	if (a == NULL)
 		e = _libelf_open_object(fd, c, 1);
 	else if (a->e_kind == ELF_K_AR)
-		e = _libelf_ar_open_member(a->e_fd, c, a);
-	else
-		(e = a)->e_activations++;
+		e = _libelf_ar_open_member(a->e_fd, c, a,
+		    a->e_u.e_ar.e_next);
+	else {
+		e = a;
+		LIBELF_LOCK(e);
+		e->e_activations++;
+		LIBELF_UNLOCK(e);
+	}
 
 	return (e);
 }
@@ -34,7 +34,9 @@ int
 elf_cntl(Elf *e, Elf_Cmd c)
 {
 	if (e == NULL ||
-	    (c != ELF_C_FDDONE && c != ELF_C_FDREAD)) {
+	    (c != ELF_C_FDDONE && c != ELF_C_FDREAD &&
+	    c != ELF_C_ADVISE_NORMAL && c != ELF_C_ADVISE_RANDOM &&
+	    c != ELF_C_ADVISE_SEQUENTIAL && c != ELF_C_ADVISE_HUGEPAGE)) {
 		LIBELF_SET_ERROR(ARGUMENT, 0);
 		return (-1);
 	}
@@ -44,15 +46,22 @@ elf_cntl(Elf *e, Elf_Cmd c)
 		return (-1);
 	}
 
-	if (c == ELF_C_FDREAD) {
-		if (e->e_cmd == ELF_C_WRITE) {
-			LIBELF_SET_ERROR(MODE, 0);
-			return (-1);
-		}
-		else
-			return (0);
+	if (c != ELF_C_FDDONE && c != ELF_C_FDREAD) {
+		_libelf_advise(e, c);
+		return (0);
 	}
 
-	e->e_fd = -1;
-	return 0;
+	if (c == ELF_C_FDREAD && e->e_cmd == ELF_C_WRITE) {
+		LIBELF_SET_ERROR(MODE, 0);
+		return (-1);
+	}
+
+	/* Read in the parts of the file not yet read. */
+	if (!_libelf_load_rawfile(e, 0, (uint64_t) e->e_rawsize))
+		return (-1);
+
+	if (c == ELF_C_FDDONE)
+		e->e_fd = -1;
+
+	return (0);
 }
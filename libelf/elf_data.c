@@ -34,27 +34,61 @@
 
 ELFTC_VCSID("$Id$");
 
-Elf_Data *
-elf_getdata(Elf_Scn *s, Elf_Data *ed)
+/*
+ * Determine whether the in-memory form of a section of type `elftype'
+ * is byte-for-byte identical to its on-disk form in object `e', so
+ * that a data descriptor may point directly into the file's mapping
+ * instead of receiving a translated copy.
+ *
+ * This is only done for objects opened with ELF_C_READ whose contents
+ * were mmap()'ed in: such mappings are private and writable, so that
+ * an application modifying the returned data only causes the touched
+ * pages to be copied.  Types whose translators validate or reshape
+ * their input are always translated.
+ */
+static int
+_libelf_data_is_native(Elf *e, int elftype, size_t fsz, size_t msz,
+    const unsigned char *src)
+{
+	Elf *top;
+
+	if (e->e_cmd != ELF_C_READ || fsz != msz ||
+	    e->e_byteorder != LIBELF_PRIVATE(byteorder))
+		return (0);
+
+	/* Archive members share their archive's mapping. */
+	for (top = e; top->e_parent != NULL; top = top->e_parent)
+		;
+	if ((top->e_flags & LIBELF_F_RAWFILE_MMAP) == 0)
+		return (0);
+
+	switch (elftype) {
+	case ELF_T_GNUHASH:
+	case ELF_T_NOTE:
+	case ELF_T_VDEF:
+	case ELF_T_VNEED:
+		return (0);
+	default:
+		break;
+	}
+
+	return (((uintptr_t) src % _libelf_malign((Elf_Type) elftype,
+	    e->e_class)) == 0);
+}
+
+/*
+ * Return the data descriptor following `d', translating section
+ * contents on first use.  Called with the descriptor lock held.
+ */
+static Elf_Data *
+_libelf_getdata(Elf *e, Elf_Scn *s, struct _Libelf_Data *d)
 {
-	Elf *e;
 	unsigned int sh_type;
 	int elfclass, elftype;
 	size_t count, fsz, msz;
-	struct _Libelf_Data *d;
 	uint64_t sh_align, sh_offset, sh_size, raw_size;
 	_libelf_translator_function *xlate;
 
-	d = (struct _Libelf_Data *) ed;
-
-	if (s == NULL || (e = s->s_elf) == NULL ||
-	    (d != NULL && s != d->d_scn)) {
-		LIBELF_SET_ERROR(ARGUMENT, 0);
-		return (NULL);
-	}
-
-	assert(e->e_kind == ELF_K_ELF);
-
 	if (d == NULL && (d = STAILQ_FIRST(&s->s_data)) != NULL)
 		return (&d->d_data);
 
@@ -145,6 +179,18 @@ elf_getdata(Elf_Scn *s, Elf_Data *ed)
 		return (&d->d_data);
         }
 
+	if (!_libelf_load_rawfile(e, sh_offset, sh_size)) {
+		(void) _libelf_release_data(d);
+		return (NULL);
+	}
+
+	if (_libelf_data_is_native(e, elftype, fsz, msz,
+	    e->e_rawfile + sh_offset)) {
+		d->d_data.d_buf = e->e_rawfile + sh_offset;
+		STAILQ_INSERT_TAIL(&s->s_data, d, d_next);
+		return (&d->d_data);
+	}
+
 	if ((d->d_data.d_buf = malloc(msz * count)) == NULL) {
 		(void) _libelf_release_data(d);
 		LIBELF_SET_ERROR(RESOURCE, 0);
@@ -168,6 +214,30 @@ elf_getdata(Elf_Scn *s, Elf_Data *ed)
 	return (&d->d_data);
 }
 
+Elf_Data *
+elf_getdata(Elf_Scn *s, Elf_Data *ed)
+{
+	Elf *e;
+	Elf_Data *rd;
+	struct _Libelf_Data *d;
+
+	d = (struct _Libelf_Data *) ed;
+
+	if (s == NULL || (e = s->s_elf) == NULL ||
+	    (d != NULL && s != d->d_scn)) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	assert(e->e_kind == ELF_K_ELF);
+
+	LIBELF_LOCK(e);
+	rd = _libelf_getdata(e, s, d);
+	LIBELF_UNLOCK(e);
+
+	return (rd);
+}
+
 Elf_Data *
 elf_newdata(Elf_Scn *s)
 {
@@ -193,6 +263,7 @@ elf_newdata(Elf_Scn *s)
 		return (NULL);
 
 	STAILQ_INSERT_TAIL(&s->s_data, d, d_next);
+	_libelf_release_strtab(s);
 
 	d->d_data.d_align = 1;
 	d->d_data.d_buf = NULL;
@@ -211,24 +282,13 @@ elf_newdata(Elf_Scn *s)
  * `s'.
  */
 
-Elf_Data *
-elf_rawdata(Elf_Scn *s, Elf_Data *ed)
+static Elf_Data *
+_libelf_rawdata(Elf *e, Elf_Scn *s, struct _Libelf_Data *d)
 {
-	Elf *e;
 	int elf_class;
 	uint32_t sh_type;
-	struct _Libelf_Data *d;
 	uint64_t sh_align, sh_offset, sh_size, raw_size;
 
-	if (s == NULL || (e = s->s_elf) == NULL || e->e_rawfile == NULL) {
-		LIBELF_SET_ERROR(ARGUMENT, 0);
-		return (NULL);
-	}
-
-	assert(e->e_kind == ELF_K_ELF);
-
-	d = (struct _Libelf_Data *) ed;
-
 	if (d == NULL && (d = STAILQ_FIRST(&s->s_rawdata)) != NULL)
 		return (&d->d_data);
 
@@ -263,6 +323,10 @@ elf_rawdata(Elf_Scn *s, Elf_Data *ed)
 		return (NULL);
 	}
 
+	if (sh_type != SHT_NOBITS &&
+	    !_libelf_load_rawfile(e, sh_offset, sh_size))
+		return (NULL);
+
 	if ((d = _libelf_allocate_data(s)) == NULL)
 		return (NULL);
 
@@ -278,3 +342,23 @@ elf_rawdata(Elf_Scn *s, Elf_Data *ed)
 
 	return (&d->d_data);
 }
+
+Elf_Data *
+elf_rawdata(Elf_Scn *s, Elf_Data *ed)
+{
+	Elf *e;
+	Elf_Data *rd;
+
+	if (s == NULL || (e = s->s_elf) == NULL || e->e_rawfile == NULL) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	assert(e->e_kind == ELF_K_ELF);
+
+	LIBELF_LOCK(e);
+	rd = _libelf_rawdata(e, s, (struct _Libelf_Data *) ed);
+	LIBELF_UNLOCK(e);
+
+	return (rd);
+}
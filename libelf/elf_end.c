@@ -41,27 +41,39 @@ elf_end(Elf *e)
 {
 	Elf *sv;
 	Elf_Scn *scn, *tscn;
+	int activations;
 
-	if (e == NULL || e->e_activations == 0)
+	if (e == NULL)
 		return (0);
 
-	if (--e->e_activations > 0)
-		return (e->e_activations);
+	LIBELF_LOCK(e);
 
-	assert(e->e_activations == 0);
+	if (e->e_activations == 0) {
+		LIBELF_UNLOCK(e);
+		return (0);
+	}
+
+	if ((activations = --e->e_activations) > 0) {
+		LIBELF_UNLOCK(e);
+		return (activations);
+	}
+
+	/*
+	 * If we still have open child descriptors, we need to defer
+	 * reclaiming resources till all the child descriptors for the
+	 * archive are closed.
+	 */
+	if (e->e_kind == ELF_K_AR && e->e_u.e_ar.e_nchildren > 0) {
+		LIBELF_UNLOCK(e);
+		return (0);
+	}
+
+	LIBELF_UNLOCK(e);
+
+	while (e != NULL) {
+		assert(e->e_activations == 0);
 
-	while (e && e->e_activations == 0) {
 		switch (e->e_kind) {
-		case ELF_K_AR:
-			/*
-			 * If we still have open child descriptors, we
-			 * need to defer reclaiming resources till all
-			 * the child descriptors for the archive are
-			 * closed.
-			 */
-			if (e->e_u.e_ar.e_nchildren > 0)
-				return (0);
-			break;
 		case ELF_K_ELF:
 			/*
 			 * Reclaim all section descriptors.
@@ -76,18 +88,35 @@ elf_end(Elf *e)
 			break;
 		}
 
+		free(e->e_rawchunks);
+
 		if (e->e_rawfile) {
 			if (e->e_flags & LIBELF_F_RAWFILE_MALLOC)
 				free(e->e_rawfile);
 #if	ELFTC_HAVE_MMAP
-			else if (e->e_flags & LIBELF_F_RAWFILE_MMAP)
+			else if (e->e_flags & (LIBELF_F_RAWFILE_MMAP |
+			    LIBELF_F_RAWFILE_RESERVED))
 				(void) munmap(e->e_rawfile, (size_t) e->e_rawsize);
 #endif
 		}
 
 		sv = e;
-		if ((e = e->e_parent) != NULL)
+
+		/*
+		 * Closing the last child of an archive that has itself
+		 * been elf_end()'ed releases the archive too.
+		 */
+		if ((e = e->e_parent) != NULL) {
+			LIBELF_LOCK(e);
 			e->e_u.e_ar.e_nchildren--;
+			if (e->e_activations > 0 ||
+			    e->e_u.e_ar.e_nchildren > 0) {
+				LIBELF_UNLOCK(e);
+				e = NULL;
+			} else
+				LIBELF_UNLOCK(e);
+		}
+
 		_libelf_release_elf(sv);
 	}
 
@@ -74,6 +74,10 @@ elf_flagdata(Elf_Data *d, Elf_Cmd c, unsigned int flags)
 	else
 		r = ld->d_flags &= ~flags;
 
+	/* The section's contents may have changed. */
+	if (c == ELF_C_SET && (flags & ELF_F_DIRTY) && ld->d_scn != NULL)
+		_libelf_release_strtab(ld->d_scn);
+
 	return (r & LIBELF_F_API_MASK);
 }
 
@@ -41,6 +41,8 @@ elf_rawfile(Elf *e, size_t *sz)
 		LIBELF_SET_ERROR(ARGUMENT, 0);
 	else if ((ptr = e->e_rawfile) == NULL && e->e_cmd == ELF_C_WRITE)
 		LIBELF_SET_ERROR(SEQUENCE, 0);
+	else if (!_libelf_load_rawfile(e, 0, (uint64_t) e->e_rawsize))
+		ptr = NULL;
 
 	if (sz)
 		*sz = e ? (size_t) e->e_rawsize : 0;
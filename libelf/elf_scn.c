@@ -39,23 +39,24 @@
 ELFTC_VCSID("$Id$");
 
 /*
- * Load an ELF section table and create a list of Elf_Scn structures.
+ * Check the section header table of an ELF object and size the index
+ * of section descriptors.  The descriptors themselves are created on
+ * demand, so objects with a large number of sections do not pay for
+ * translating headers that are never looked at.  Called with the
+ * descriptor lock held.
  */
-int
-_libelf_load_section_headers(Elf *e, void *ehdr)
+static int
+_libelf_index_section_headers(Elf *e, void *ehdr)
 {
-	Elf_Scn *scn;
 	uint64_t shoff;
 	Elf32_Ehdr *eh32;
 	Elf64_Ehdr *eh64;
-	int ec, swapbytes;
-	unsigned char *src;
-	size_t fsz, i, shnum;
-	_libelf_translator_function *xlator;
+	int ec;
+	size_t fsz, shnum;
 
 	assert(e != NULL);
 	assert(ehdr != NULL);
-	assert((e->e_flags & LIBELF_F_SHDRS_LOADED) == 0);
+	assert((e->e_flags & LIBELF_F_SHDRS_INDEXED) == 0);
 
 #define	CHECK_EHDR(E,EH)	do {				\
 		uintmax_t rawsize = (uintmax_t) e->e_rawsize;	\
@@ -84,56 +85,165 @@ _libelf_load_section_headers(Elf *e, void *ehdr)
 		CHECK_EHDR(e, eh64);
 	}
 
-	xlator = _libelf_get_translator(ELF_T_SHDR, ELF_TOMEMORY, ec,
-	    _libelf_elfmachine(e));
-
-	swapbytes = e->e_byteorder != LIBELF_PRIVATE(byteorder);
-	src = e->e_rawfile + shoff;
+	if (_libelf_reserve_scn(e, shnum) == 0)
+		return (0);
 
 	/*
 	 * If the file is using extended numbering then section #0
 	 * would have already been read in.
 	 */
+	assert(STAILQ_EMPTY(&e->e_u.e_elf.e_scn) ||
+	    (STAILQ_FIRST(&e->e_u.e_elf.e_scn) ==
+	    STAILQ_LAST(&e->e_u.e_elf.e_scn, _Elf_Scn, s_next) &&
+	    e->e_u.e_elf.e_scnarray[0] != NULL));
+
+	e->e_u.e_elf.e_rawshoff = shoff;
+	e->e_flags |= LIBELF_F_SHDRS_INDEXED;
+
+	return (1);
+}
+
+/*
+ * Create the descriptor for section `ndx' from its entry in the
+ * section header table.  Called with the descriptor lock held.
+ */
+static Elf_Scn *
+_libelf_read_scn(Elf *e, size_t ndx)
+{
+	int ec;
+	Elf_Scn *scn;
+	size_t fsz;
+	uint64_t off;
+	_libelf_translator_function *xlator;
+
+	assert(e->e_flags & LIBELF_F_SHDRS_INDEXED);
+	assert(ndx < e->e_u.e_elf.e_nscn);
+	assert(e->e_u.e_elf.e_scnarray[ndx] == NULL);
+
+	ec = e->e_class;
+	fsz = _libelf_fsize(ELF_T_SHDR, ec, e->e_version, (size_t) 1);
+	off = e->e_u.e_elf.e_rawshoff + ndx * fsz;
+
+	if (!_libelf_load_rawfile(e, off, fsz))
+		return (NULL);
+
+	if ((scn = _libelf_allocate_scn(e, ndx)) == NULL)
+		return (NULL);
+
+	xlator = _libelf_get_translator(ELF_T_SHDR, ELF_TOMEMORY, ec,
+	    _libelf_elfmachine(e));
 
-	i = 0;
-	if (!STAILQ_EMPTY(&e->e_u.e_elf.e_scn)) {
-		assert(STAILQ_FIRST(&e->e_u.e_elf.e_scn) ==
-		    STAILQ_LAST(&e->e_u.e_elf.e_scn, _Elf_Scn, s_next));
+	(*xlator)((unsigned char *) &scn->s_shdr, sizeof(scn->s_shdr),
+	    e->e_rawfile + off, (size_t) 1,
+	    e->e_byteorder != LIBELF_PRIVATE(byteorder));
 
-		i = 1;
-		src += fsz;
+	if (ec == ELFCLASS32) {
+		scn->s_offset = scn->s_rawoff =
+		    scn->s_shdr.s_shdr32.sh_offset;
+		scn->s_size = scn->s_shdr.s_shdr32.sh_size;
+	} else {
+		scn->s_offset = scn->s_rawoff =
+		    scn->s_shdr.s_shdr64.sh_offset;
+		scn->s_size = scn->s_shdr.s_shdr64.sh_size;
 	}
 
-	for (; i < shnum; i++, src += fsz) {
-		if ((scn = _libelf_allocate_scn(e, i)) == NULL)
+	return (scn);
+}
+
+/*
+ * Retrieve the descriptor for section `ndx', reading in its section
+ * header if needed.  Several threads may race to do this for a shared
+ * ELF_C_READ descriptor; only the first one does the work.
+ */
+static Elf_Scn *
+_libelf_getscn(Elf *e, void *ehdr, size_t ndx)
+{
+	Elf_Scn *s;
+
+	LIBELF_LOCK(e);
+
+	s = NULL;
+	if (e->e_cmd != ELF_C_WRITE &&
+	    (e->e_flags & (LIBELF_F_SHDRS_INDEXED|LIBELF_F_SHDRS_LOADED)) ==
+	    0 && _libelf_index_section_headers(e, ehdr) == 0)
+		goto done;
+
+	if (ndx < e->e_u.e_elf.e_scnarraysz &&
+	    (s = e->e_u.e_elf.e_scnarray[ndx]) == NULL &&
+	    (e->e_flags & LIBELF_F_SHDRS_INDEXED) &&
+	    ndx < e->e_u.e_elf.e_nscn)
+		s = _libelf_read_scn(e, ndx);
+	else if (s == NULL)
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+
+ done:
+	LIBELF_UNLOCK(e);
+
+	return (s);
+}
+
+/*
+ * Bring in all the section headers that have not been read in yet,
+ * and link the section descriptors in index order.  Called with the
+ * descriptor lock held.
+ */
+static int
+_libelf_read_section_headers(Elf *e, void *ehdr)
+{
+	size_t fsz, i, shnum;
+
+	assert((e->e_flags & LIBELF_F_SHDRS_LOADED) == 0);
+
+	if ((e->e_flags & LIBELF_F_SHDRS_INDEXED) == 0 &&
+	    _libelf_index_section_headers(e, ehdr) == 0)
+		return (0);
+
+	fsz = _libelf_fsize(ELF_T_SHDR, e->e_class, e->e_version,
+	    (size_t) 1);
+	shnum = e->e_u.e_elf.e_nscn;
+
+	if (!_libelf_load_rawfile(e, e->e_u.e_elf.e_rawshoff, fsz * shnum))
+		return (0);
+
+	for (i = 0; i < shnum; i++)
+		if (e->e_u.e_elf.e_scnarray[i] == NULL &&
+		    _libelf_read_scn(e, i) == NULL)
 			return (0);
 
-		(*xlator)((unsigned char *) &scn->s_shdr, sizeof(scn->s_shdr),
-		    src, (size_t) 1, swapbytes);
-
-		if (ec == ELFCLASS32) {
-			scn->s_offset = scn->s_rawoff =
-			    scn->s_shdr.s_shdr32.sh_offset;
-			scn->s_size = scn->s_shdr.s_shdr32.sh_size;
-		} else {
-			scn->s_offset = scn->s_rawoff =
-			    scn->s_shdr.s_shdr64.sh_offset;
-			scn->s_size = scn->s_shdr.s_shdr64.sh_size;
-		}
-	}
+	STAILQ_INIT(&e->e_u.e_elf.e_scn);
+	for (i = 0; i < shnum; i++)
+		STAILQ_INSERT_TAIL(&e->e_u.e_elf.e_scn,
+		    e->e_u.e_elf.e_scnarray[i], s_next);
 
+	e->e_flags &= ~LIBELF_F_SHDRS_INDEXED;
 	e->e_flags |= LIBELF_F_SHDRS_LOADED;
 
 	return (1);
 }
 
+/*
+ * Bring in the whole section header table if it has not been read in
+ * yet.  This is needed before sections can be added or the layout of
+ * the object recomputed.
+ */
+int
+_libelf_load_section_headers(Elf *e, void *ehdr)
+{
+	int rc;
+
+	LIBELF_LOCK(e);
+	rc = (e->e_flags & LIBELF_F_SHDRS_LOADED) != 0 ||
+	    _libelf_read_section_headers(e, ehdr);
+	LIBELF_UNLOCK(e);
+
+	return (rc);
+}
 
 Elf_Scn *
 elf_getscn(Elf *e, size_t index)
 {
 	int ec;
 	void *ehdr;
-	Elf_Scn *s;
 
 	if (e == NULL || e->e_kind != ELF_K_ELF ||
 	    ((ec = e->e_class) != ELFCLASS32 && ec != ELFCLASS64)) {
@@ -144,17 +254,7 @@ elf_getscn(Elf *e, size_t index)
 	if ((ehdr = _libelf_ehdr(e, ec, 0)) == NULL)
 		return (NULL);
 
-	if (e->e_cmd != ELF_C_WRITE &&
-	    (e->e_flags & LIBELF_F_SHDRS_LOADED) == 0 &&
-	    _libelf_load_section_headers(e, ehdr) == 0)
-		return (NULL);
-
-	STAILQ_FOREACH(s, &e->e_u.e_elf.e_scn, s_next)
-		if (s->s_ndx == index)
-			return (s);
-
-	LIBELF_SET_ERROR(ARGUMENT, 0);
-	return (NULL);
+	return (_libelf_getscn(e, ehdr, index));
 }
 
 size_t
@@ -198,7 +298,6 @@ elf_newscn(Elf *e)
 	 * use elf_update(...,ELF_C_NULL) to compute its new layout.
 	 */
 	if (e->e_cmd != ELF_C_WRITE &&
-	    (e->e_flags & LIBELF_F_SHDRS_LOADED) == 0 &&
 	    _libelf_load_section_headers(e, ehdr) == 0)
 		return (NULL);
 
@@ -231,6 +330,17 @@ elf_nextscn(Elf *e, Elf_Scn *s)
 		return (NULL);
 	}
 
-	return (s == NULL ? elf_getscn(e, (size_t) 1) :
-	    STAILQ_NEXT(s, s_next));
+	if (s == NULL)
+		return (elf_getscn(e, (size_t) 1));
+
+	/*
+	 * Sections are numbered consecutively, so the next one can be
+	 * looked up by index.  Headers past the point where the
+	 * application stops iterating are never read in.
+	 */
+	if (s->s_ndx + 1 >= e->e_u.e_elf.e_nscn)
+		return (NULL);
+
+	return (_libelf_getscn(e, _libelf_ehdr(e, e->e_class, 0),
+	    s->s_ndx + 1));
 }
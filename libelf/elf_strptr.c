@@ -27,104 +27,229 @@
 #include <sys/param.h>
 
 #include <assert.h>
+#include <errno.h>
 #include <gelf.h>
+#include <stdlib.h>
 
 #include "_libelf.h"
 
 ELFTC_VCSID("$Id$");
 
 /*
- * Convert an ELF section#,offset pair to a string pointer.
+ * String table sections are typically looked up many times over, so
+ * elf_strptr() caches a flattened view of each string table section
+ * that it is used with.
+ *
+ * The view is an array of the section's non-empty data buffers, along
+ * with their offsets in the section, sorted by offset.  A lookup is
+ * then a direct computation for the common case of a section with a
+ * single data buffer, or a binary search otherwise.
+ *
+ * The view is discarded when the section's data descriptors could
+ * have changed: when a data descriptor is added by elf_newdata(),
+ * marked dirty with elf_flagdata(), or when the object's layout is
+ * recomputed by elf_update().
  */
 
-char *
-elf_strptr(Elf *e, size_t scndx, size_t offset)
+struct _Libelf_Strchunk {
+	uint64_t	sc_off;		/* offset in the section */
+	uint64_t	sc_size;	/* size of the buffer */
+	char		*sc_buf;	/* the buffer */
+};
+
+struct _Libelf_Strtab {
+	unsigned int	st_layout;	/* ELF_F_LAYOUT when built */
+	int		st_error;	/* error for offsets not covered */
+	uint64_t	st_erroff;	/* start of offsets with st_error */
+	size_t		st_nchunks;	/* number of chunks */
+	struct _Libelf_Strchunk *st_chunks; /* chunks sorted by offset */
+};
+
+static int
+_libelf_strchunk_compare(const void *a, const void *b)
+{
+	const struct _Libelf_Strchunk *ca, *cb;
+
+	ca = a;
+	cb = b;
+
+	if (ca->sc_off < cb->sc_off)
+		return (-1);
+	return (ca->sc_off > cb->sc_off);
+}
+
+/*
+ * Build the view of string table section `s'.  Called with the
+ * descriptor lock held.
+ */
+static struct _Libelf_Strtab *
+_libelf_build_strtab(Elf *e, Elf_Scn *s)
 {
-	Elf_Scn *s;
 	Elf_Data *d;
-	GElf_Shdr shdr;
+	size_t n;
 	uint64_t alignment, count;
+	struct _Libelf_Strtab *st;
+	struct _Libelf_Strchunk *sc;
 
-	if (e == NULL || e->e_kind != ELF_K_ELF) {
-		LIBELF_SET_ERROR(ARGUMENT, 0);
+	n = 0;
+	d = NULL;
+	while ((d = elf_getdata(s, d)) != NULL)
+		n++;
+
+	if ((st = malloc(sizeof(*st) + n * sizeof(*sc))) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, errno);
 		return (NULL);
 	}
 
-	if ((s = elf_getscn(e, scndx)) == NULL ||
-	    gelf_getshdr(s, &shdr) == NULL)
-		return (NULL);
+	st->st_layout = e->e_flags & ELF_F_LAYOUT;
+	st->st_error = ELF_E_NONE;
+	st->st_erroff = 0;
+	st->st_nchunks = 0;
+	st->st_chunks = sc = (struct _Libelf_Strchunk *) (st + 1);
 
-	if (shdr.sh_type != SHT_STRTAB ||
-	    offset >= shdr.sh_size) {
-		LIBELF_SET_ERROR(ARGUMENT, 0);
-		return (NULL);
-	}
+	/*
+	 * Chunks are only recorded up to the first unusable data
+	 * descriptor.  Lookups of offsets not covered by a chunk, and
+	 * for which that descriptor would have been examined, fail
+	 * with ELF_E_DATA.
+	 */
+	count = (uint64_t) 0;	/* cumulative count of bytes seen */
+	while ((d = elf_getdata(s, d)) != NULL) {
 
-	d = NULL;
-	if (e->e_flags & ELF_F_LAYOUT) {
-
-		/*
-		 * The application is taking responsibility for the
-		 * ELF object's layout, so we can directly translate
-		 * an offset to a `char *' address using the `d_off'
-		 * members of Elf_Data descriptors.
-		 */
-		while ((d = elf_getdata(s, d)) != NULL) {
-
-			if (d->d_buf == 0 || d->d_size == 0)
-				continue;
-
-			if (d->d_type != ELF_T_BYTE) {
-				LIBELF_SET_ERROR(DATA, 0);
-				return (NULL);
-			}
+		if (d->d_buf == NULL || d->d_size == 0)
+			continue;
 
-			if (offset >= d->d_off &&
-			    offset < d->d_off + d->d_size)
-				return ((char *) d->d_buf + offset - d->d_off);
+		if (d->d_type != ELF_T_BYTE) {
+			st->st_error = ELF_E_DATA;
+			st->st_erroff = st->st_layout ? 0 : count;
+			break;
 		}
-	} else {
-		/*
-		 * Otherwise, the `d_off' members are not useable and
-		 * we need to compute offsets ourselves, taking into
-		 * account 'holes' in coverage of the section introduced
-		 * by alignment requirements.
-		 */
-		count = (uint64_t) 0;	/* cumulative count of bytes seen */
-		while ((d = elf_getdata(s, d)) != NULL && count <= offset) {
-
-			if (d->d_buf == NULL || d->d_size == 0)
-				continue;
-
-			if (d->d_type != ELF_T_BYTE) {
-				LIBELF_SET_ERROR(DATA, 0);
-				return (NULL);
-			}
 
+		if (st->st_layout) {
+			/*
+			 * The application is taking responsibility for
+			 * the ELF object's layout, so offsets are given
+			 * by the `d_off' members of Elf_Data
+			 * descriptors.
+			 */
+			sc->sc_off = d->d_off;
+		} else {
+			/*
+			 * Otherwise, the `d_off' members are not
+			 * useable and we need to compute offsets
+			 * ourselves, taking into account 'holes' in
+			 * coverage of the section introduced by
+			 * alignment requirements.
+			 */
 			if ((alignment = d->d_align) > 1) {
 				if ((alignment & (alignment - 1)) != 0) {
-					LIBELF_SET_ERROR(DATA, 0);
-					return (NULL);
+					st->st_error = ELF_E_DATA;
+					st->st_erroff = count;
+					break;
 				}
 				count = roundup2(count, alignment);
 			}
+			sc->sc_off = count;
+			count += d->d_size;
+		}
 
-			if (offset < count) {
-				/* offset starts in the 'hole' */
-				LIBELF_SET_ERROR(ARGUMENT, 0);
-				return (NULL);
-			}
+		sc->sc_size = d->d_size;
+		sc->sc_buf = d->d_buf;
+		sc++;
+	}
 
-			if (offset < count + d->d_size) {
-				if (d->d_buf != NULL)
-					return ((char *) d->d_buf +
-					    offset - count);
-				LIBELF_SET_ERROR(DATA, 0);
-				return (NULL);
-			}
+	st->st_nchunks = (size_t) (sc - st->st_chunks);
 
-			count += d->d_size;
+	/* Data descriptors are in offset order unless using ELF_F_LAYOUT. */
+	if (st->st_layout)
+		qsort(st->st_chunks, st->st_nchunks, sizeof(*sc),
+		    _libelf_strchunk_compare);
+
+	return (st);
+}
+
+/*
+ * Discard the cached view of section `s', if any.
+ */
+void
+_libelf_release_strtab(Elf_Scn *s)
+{
+	free(s->s_strtab);
+	s->s_strtab = NULL;
+}
+
+/*
+ * Convert an ELF section#,offset pair to a string pointer.
+ */
+
+char *
+elf_strptr(Elf *e, size_t scndx, size_t offset)
+{
+	Elf_Scn *s;
+	uint64_t sh_size;
+	uint32_t sh_type;
+	size_t hi, lo, mid;
+	struct _Libelf_Strtab *st;
+	struct _Libelf_Strchunk *sc;
+
+	if (e == NULL || e->e_kind != ELF_K_ELF) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	if ((s = elf_getscn(e, scndx)) == NULL)
+		return (NULL);
+
+	if (e->e_class == ELFCLASS32) {
+		sh_type = s->s_shdr.s_shdr32.sh_type;
+		sh_size = (uint64_t) s->s_shdr.s_shdr32.sh_size;
+	} else {
+		sh_type = s->s_shdr.s_shdr64.sh_type;
+		sh_size = s->s_shdr.s_shdr64.sh_size;
+	}
+
+	if (sh_type != SHT_STRTAB || offset >= sh_size) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	LIBELF_LOCK(e);
+	if ((st = s->s_strtab) != NULL &&
+	    st->st_layout != (e->e_flags & ELF_F_LAYOUT)) {
+		_libelf_release_strtab(s);
+		st = NULL;
+	}
+	if (st == NULL)
+		st = s->s_strtab = _libelf_build_strtab(e, s);
+	LIBELF_UNLOCK(e);
+
+	if (st == NULL)
+		return (NULL);
+
+	/* Find the last chunk starting at or before `offset'. */
+	sc = NULL;
+	if (st->st_nchunks == 1)
+		sc = st->st_chunks;
+	else if (st->st_nchunks > 1) {
+		lo = 0;
+		hi = st->st_nchunks;
+		while (hi - lo > 1) {
+			mid = lo + (hi - lo) / 2;
+			if (st->st_chunks[mid].sc_off <= offset)
+				lo = mid;
+			else
+				hi = mid;
 		}
+		sc = &st->st_chunks[lo];
+	}
+
+	if (sc != NULL && offset >= sc->sc_off &&
+	    offset - sc->sc_off < sc->sc_size)
+		return (sc->sc_buf + (offset - sc->sc_off));
+
+	if (st->st_error != ELF_E_NONE && offset >= st->st_erroff) {
+		LIBELF_SET_ERROR(DATA, 0);
+		return (NULL);
 	}
 
 	LIBELF_SET_ERROR(ARGUMENT, 0);
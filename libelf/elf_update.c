@@ -102,6 +102,33 @@ struct _Elf_Extent {
 
 SLIST_HEAD(_Elf_Extent_List, _Elf_Extent);
 
+/*
+ * The destination for the contents of an ELF object being written
+ * out by _libelf_write_elf().
+ *
+ * If `es_image' is not NULL, the object is assembled in memory and
+ * written out in one go.  Otherwise each piece of the object is
+ * written to the underlying file at its final offset as soon as it
+ * has been translated, so that only a scratch buffer large enough
+ * for the largest translated piece is needed.  The file is only
+ * truncated or extended to its final size after all of its contents
+ * have been written, and `es_filesz' holds its size before the
+ * update.
+ *
+ * If `es_raw' is not NULL, the underlying file is being updated in
+ * place and `es_raw' holds its current contents.  Only the bytes
+ * that differ from the current contents are written out.
+ */
+struct _Elf_Sink {
+	int		es_fd;		/* The underlying file. */
+	unsigned char	*es_image;	/* The in-memory image, if any. */
+	unsigned char	*es_raw;	/* The file's current contents. */
+	int		es_rawsync;	/* Whether to update `es_raw'. */
+	unsigned char	*es_buf;	/* Scratch buffer. */
+	size_t		es_bufsz;	/* Size of the scratch buffer. */
+	uint64_t	es_filesz;	/* Size of the file being replaced. */
+};
+
 /*
  * Compute the extents of a section, by looking at the data
  * descriptors associated with it.  The function returns 1
@@ -464,6 +491,9 @@ _libelf_resync_sections(Elf *e, off_t rc, struct _Elf_Extent_List *extents)
 		else
 			sh_type = s->s_shdr.s_shdr64.sh_type;
 
+		/* Data descriptors may have changed since the last call. */
+		_libelf_release_strtab(s);
+
 		if (sh_type == SHT_NOBITS || sh_type == SHT_NULL)
 			continue;
 
@@ -711,12 +741,130 @@ _libelf_resync_elf(Elf *e, struct _Elf_Extent_List *extents)
 	return (rc);
 }
 
+/*
+ * Return a buffer for `sz' bytes of output destined for file offset
+ * `off'.  The buffer's contents are sent to the file by a subsequent
+ * _libelf_sink_write().
+ */
+static unsigned char *
+_libelf_sink_buffer(struct _Elf_Sink *es, uint64_t off, size_t sz)
+{
+	unsigned char *buf;
+
+	if (es->es_image)
+		return (es->es_image + off);
+
+	if (sz > es->es_bufsz) {
+		if ((buf = realloc(es->es_buf, sz)) == NULL) {
+			LIBELF_SET_ERROR(RESOURCE, errno);
+			return (NULL);
+		}
+		es->es_buf = buf;
+		es->es_bufsz = sz;
+	}
+
+	return (es->es_buf);
+}
+
+/*
+ * Write `sz' bytes from `buf' to file offset `off'.
+ */
+static int
+_libelf_sink_write(struct _Elf_Sink *es, uint64_t off, const void *buf,
+    size_t sz)
+{
+	ssize_t n;
+	const unsigned char *p;
+	unsigned char *q;
+
+	if (es->es_image) {
+		if (es->es_image + off != buf)
+			(void) memcpy(es->es_image + off, buf, sz);
+		return (1);
+	}
+
+	p = buf;
+
+	/*
+	 * When updating in place, trim leading and trailing bytes
+	 * that are unchanged, and skip the write if nothing changed.
+	 */
+	if (es->es_raw) {
+		q = es->es_raw + off;
+		while (sz > 0 && *p == *q) {
+			p++;
+			q++;
+			off++;
+			sz--;
+		}
+		while (sz > 0 && p[sz - 1] == q[sz - 1])
+			sz--;
+		if (sz == 0)
+			return (1);
+		if (es->es_rawsync)
+			(void) memmove(q, p, sz);
+	}
+
+	for (; sz > 0; p += n, off += (uint64_t) n, sz -= (size_t) n) {
+		if ((n = pwrite(es->es_fd, p, sz, (off_t) off)) <= 0) {
+			if (n < 0 && errno == EINTR) {
+				n = 0;
+				continue;
+			}
+			LIBELF_SET_ERROR(IO, n < 0 ? errno : 0);
+			return (0);
+		}
+	}
+
+	return (1);
+}
+
+/*
+ * Fill `sz' bytes starting at file offset `off' with the fill
+ * character set by elf_fill(3).
+ */
+static int
+_libelf_sink_fill(struct _Elf_Sink *es, uint64_t off, uint64_t sz)
+{
+	size_t n;
+	unsigned char fill[4096];
+
+	if (es->es_image) {
+		(void) memset(es->es_image + off, LIBELF_PRIVATE(fillchar),
+		    (size_t) sz);
+		return (1);
+	}
+
+	/*
+	 * When streaming, regions past the end of the file being
+	 * replaced read back as zeros once the file has been extended
+	 * to its final size, and can be left as holes.
+	 */
+	if (es->es_raw == NULL && LIBELF_PRIVATE(fillchar) == 0) {
+		if (off >= es->es_filesz)
+			return (1);
+		if (sz > es->es_filesz - off)
+			sz = es->es_filesz - off;
+	}
+
+	n = sz < sizeof(fill) ? (size_t) sz : sizeof(fill);
+	(void) memset(fill, LIBELF_PRIVATE(fillchar), n);
+
+	for (; sz > 0; off += n, sz -= n) {
+		n = sz < sizeof(fill) ? (size_t) sz : sizeof(fill);
+		if (!_libelf_sink_write(es, off, fill, n))
+			return (0);
+	}
+
+	return (1);
+}
+
 /*
  * Write out the contents of an ELF section.
  */
 
 static off_t
-_libelf_write_scn(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
+_libelf_write_scn(Elf *e, struct _Elf_Sink *es, struct _Elf_Extent *ex)
 {
 	off_t rc;
 	int ec, em;
@@ -766,6 +914,15 @@ _libelf_write_scn(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 
 	if (STAILQ_EMPTY(&s->s_data)) {
 
+		/*
+		 * When updating in place, the section's contents are
+		 * already at the right offset in the file.
+		 */
+		if (es->es_raw) {
+			assert(s->s_offset == s->s_rawoff);
+			return ((off_t) (sh_off + sh_size));
+		}
+
 		if ((d = elf_rawdata(s, NULL)) == NULL)
 			return ((off_t) -1);
 
@@ -773,20 +930,20 @@ _libelf_write_scn(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 
 			d = &ld->d_data;
 
-			if ((uint64_t) rc < sh_off + d->d_off)
-				(void) memset(nf + rc,
-				    LIBELF_PRIVATE(fillchar),
-				    (size_t) (sh_off + d->d_off -
-					(uint64_t) rc));
+			if ((uint64_t) rc < sh_off + d->d_off &&
+			    !_libelf_sink_fill(es, (uint64_t) rc,
+				sh_off + d->d_off - (uint64_t) rc))
+				return ((off_t) -1);
 			rc = (off_t) (sh_off + d->d_off);
 
 			assert(d->d_buf != NULL);
 			assert(d->d_type == ELF_T_BYTE);
 			assert(d->d_version == e->e_version);
 
-			(void) memcpy(nf + rc,
+			if (!_libelf_sink_write(es, (uint64_t) rc,
 			    e->e_rawfile + s->s_rawoff + d->d_off,
-			    (size_t) d->d_size);
+			    (size_t) d->d_size))
+				return ((off_t) -1);
 
 			rc += (off_t) d->d_size;
 		}
@@ -809,10 +966,10 @@ _libelf_write_scn(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 		if ((msz = _libelf_msize(d->d_type, ec, e->e_version)) == 0)
 			return ((off_t) -1);
 
-		if ((uint64_t) rc < sh_off + d->d_off)
-			(void) memset(nf + rc,
-			    LIBELF_PRIVATE(fillchar),
-			    (size_t) (sh_off + d->d_off - (uint64_t) rc));
+		if ((uint64_t) rc < sh_off + d->d_off &&
+		    !_libelf_sink_fill(es, (uint64_t) rc,
+			sh_off + d->d_off - (uint64_t) rc))
+			return ((off_t) -1);
 
 		rc = (off_t) (sh_off + d->d_off);
 
@@ -825,11 +982,26 @@ _libelf_write_scn(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 
 		fsz = _libelf_fsize(d->d_type, ec, e->e_version, nobjects);
 
-		dst.d_buf    = nf + rc;
+		/*
+		 * Byte data needs no translation and can be written
+		 * out directly.
+		 */
+		if (d->d_type == ELF_T_BYTE) {
+			if (!_libelf_sink_write(es, (uint64_t) rc, d->d_buf,
+			    fsz))
+				return ((off_t) -1);
+			rc += (off_t) fsz;
+			continue;
+		}
+
+		if ((dst.d_buf = _libelf_sink_buffer(es, (uint64_t) rc,
+		    fsz)) == NULL)
+			return ((off_t) -1);
 		dst.d_size   = fsz;
 
-		if (_libelf_xlate(&dst, d, e->e_byteorder, ec, em, ELF_TOFILE)
-		    == NULL)
+		if (_libelf_xlate(&dst, d, e->e_byteorder, ec, em,
+		    ELF_TOFILE) == NULL ||
+		    !_libelf_sink_write(es, (uint64_t) rc, dst.d_buf, fsz))
 			return ((off_t) -1);
 
 		rc += (off_t) fsz;
@@ -843,7 +1015,7 @@ _libelf_write_scn(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
  */
 
 static off_t
-_libelf_write_ehdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
+_libelf_write_ehdr(Elf *e, struct _Elf_Sink *es, struct _Elf_Extent *ex)
 {
 	int ec, em;
 	void *ehdr;
@@ -872,11 +1044,12 @@ _libelf_write_ehdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 	src.d_type    = ELF_T_EHDR;
 	src.d_version = dst.d_version = e->e_version;
 
-	dst.d_buf     = nf;
+	if ((dst.d_buf = _libelf_sink_buffer(es, 0, fsz)) == NULL)
+		return ((off_t) -1);
 	dst.d_size    = fsz;
 
 	if (_libelf_xlate(&dst, &src, e->e_byteorder, ec, em, ELF_TOFILE) ==
-	    NULL)
+	    NULL || !_libelf_sink_write(es, 0, dst.d_buf, fsz))
 		return ((off_t) -1);
 
 	return ((off_t) fsz);
@@ -887,7 +1060,7 @@ _libelf_write_ehdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
  */
 
 static off_t
-_libelf_write_phdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
+_libelf_write_phdr(Elf *e, struct _Elf_Sink *es, struct _Elf_Extent *ex)
 {
 	int ec, em;
 	void *ehdr;
@@ -935,10 +1108,11 @@ _libelf_write_phdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 	src.d_size = phnum * msz;
 
 	dst.d_size = fsz;
-	dst.d_buf = nf + ex->ex_start;
+	if ((dst.d_buf = _libelf_sink_buffer(es, phoff, fsz)) == NULL)
+		return ((off_t) -1);
 
 	if (_libelf_xlate(&dst, &src, e->e_byteorder, ec, em, ELF_TOFILE) ==
-	    NULL)
+	    NULL || !_libelf_sink_write(es, phoff, dst.d_buf, fsz))
 		return ((off_t) -1);
 
 	return ((off_t) (phoff + fsz));
@@ -949,7 +1123,7 @@ _libelf_write_phdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
  */
 
 static off_t
-_libelf_write_shdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
+_libelf_write_shdr(Elf *e, struct _Elf_Sink *es, struct _Elf_Extent *ex)
 {
 	int ec, em;
 	void *ehdr;
@@ -959,6 +1133,7 @@ _libelf_write_shdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 	Elf64_Ehdr *eh64;
 	size_t fsz, msz, nscn;
 	Elf_Data dst, src;
+	unsigned char *buf;
 
 	assert(ex->ex_type == ELF_EXTENT_SHDR);
 
@@ -995,6 +1170,9 @@ _libelf_write_shdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 
 	fsz = _libelf_fsize(ELF_T_SHDR, ec, e->e_version, (size_t) 1);
 
+	if ((buf = _libelf_sink_buffer(es, shoff, nscn * fsz)) == NULL)
+		return ((off_t) -1);
+
 	STAILQ_FOREACH(scn, &e->e_u.e_elf.e_scn, s_next) {
 		if (ec == ELFCLASS32)
 			src.d_buf = &scn->s_shdr.s_shdr32;
@@ -1002,13 +1180,16 @@ _libelf_write_shdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
 			src.d_buf = &scn->s_shdr.s_shdr64;
 
 		dst.d_size = fsz;
-		dst.d_buf = nf + ex->ex_start + scn->s_ndx * fsz;
+		dst.d_buf = buf + scn->s_ndx * fsz;
 
 		if (_libelf_xlate(&dst, &src, e->e_byteorder, ec, em,
 			ELF_TOFILE) == NULL)
 			return ((off_t) -1);
 	}
 
+	if (!_libelf_sink_write(es, shoff, buf, nscn * fsz))
+		return ((off_t) -1);
+
 	return ((off_t) (ex->ex_start + nscn * fsz));
 }
 
@@ -1025,23 +1206,113 @@ _libelf_write_shdr(Elf *e, unsigned char *nf, struct _Elf_Extent *ex)
  * in ELF_C_RDWR and only retrieved/modified a few sections.  We take
  * care to avoid translating file sections unnecessarily.
  *
+ * Objects opened with ELF_C_WRITE have no prior content to preserve.
+ * When such an object is backed by a regular file, each extent is
+ * written out to the file as soon as it is ready, so that the memory
+ * needed is bounded by the largest extent needing translation and not
+ * by the size of the object.
+ *
+ * Objects opened with ELF_C_RDWR whose size is unchanged, and whose
+ * sections with untouched contents still reside at their original
+ * offsets, are updated in place.  Sections whose contents were not
+ * brought into memory are skipped, and only those bytes of the other
+ * extents that differ from the file's current contents are written.
+ *
  * Gaps in the coverage of the file by the file's sections will be
- * filled with the fill character set by elf_fill(3).
+ * filled with the fill character set by elf_fill(3).  When streaming,
+ * gaps filled with zero bytes are left as holes in the file.
  */
 
+/*
+ * Determine whether the ELF_C_RDWR object `e' can be updated in place
+ * with the layout described by `extents'.
+ */
+static int
+_libelf_can_update_in_place(Elf *e, off_t newsize,
+    struct _Elf_Extent_List *extents)
+{
+	Elf_Scn *s;
+	struct _Elf_Extent *ex;
+
+	if (e->e_cmd != ELF_C_RDWR || e->e_rawfile == NULL ||
+	    (e->e_flags & LIBELF_F_SPECIAL_FILE) ||
+	    newsize != e->e_rawsize)
+		return (0);
+
+	/*
+	 * The contents of sections that were not read in are copied
+	 * from the original file, and must not have moved.
+	 */
+	SLIST_FOREACH(ex, extents, ex_next) {
+		if (ex->ex_type != ELF_EXTENT_SECTION)
+			continue;
+		s = ex->ex_desc;
+		if (STAILQ_EMPTY(&s->s_data) && s->s_offset != s->s_rawoff)
+			return (0);
+	}
+
+	return (1);
+}
+
 static off_t
 _libelf_write_elf(Elf *e, off_t newsize, struct _Elf_Extent_List *extents)
 {
 	off_t nrc, rc;
 	Elf_Scn *scn, *tscn;
 	struct _Elf_Extent *ex;
-	unsigned char *newfile;
+	struct _Elf_Sink es;
+	struct stat sb;
+	int inplace, streaming;
 
 	assert(e->e_kind == ELF_K_ELF);
 	assert(e->e_cmd == ELF_C_RDWR || e->e_cmd == ELF_C_WRITE);
 	assert(e->e_fd >= 0);
 
-	if ((newfile = malloc((size_t) newsize)) == NULL) {
+	/*
+	 * Parts of the original file that are still to be read in
+	 * may be copied into the new file, or overwritten.
+	 */
+	if (e->e_flags & LIBELF_F_RAWFILE_PARTIAL) {
+		if (!_libelf_load_rawfile(e, 0, (uint64_t) e->e_rawsize))
+			return ((off_t) -1);
+		free(e->e_rawchunks);
+		e->e_rawchunks = NULL;
+		e->e_flags &= ~LIBELF_F_RAWFILE_PARTIAL;
+	}
+
+	es.es_fd = e->e_fd;
+	es.es_image = NULL;
+	es.es_raw = NULL;
+	es.es_rawsync = 0;
+	es.es_buf = NULL;
+	es.es_bufsz = 0;
+	es.es_filesz = 0;
+
+	streaming = e->e_cmd == ELF_C_WRITE &&
+	    (e->e_flags & LIBELF_F_SPECIAL_FILE) == 0;
+	inplace = _libelf_can_update_in_place(e, newsize, extents);
+
+	if (inplace) {
+		/*
+		 * A copy of the file in memory is kept up to date as
+		 * the file is written; a mapping of the file is
+		 * replaced once writing is complete.
+		 */
+		es.es_raw = e->e_rawfile;
+		es.es_rawsync = (e->e_flags & (LIBELF_F_RAWFILE_MALLOC |
+		    LIBELF_F_RAWFILE_RESERVED)) != 0;
+	} else if (streaming) {
+		/*
+		 * Existing file content is overwritten in place, and
+		 * any excess is discarded once the new contents have
+		 * been written out.
+		 */
+		if (fstat(e->e_fd, &sb) < 0) {
+			LIBELF_SET_ERROR(IO, errno);
+			return ((off_t) -1);
+		}
+		es.es_filesz = (uint64_t) sb.st_size;
+	} else if ((es.es_image = malloc((size_t) newsize)) == NULL) {
 		LIBELF_SET_ERROR(RESOURCE, errno);
 		return ((off_t) -1);
 	}
@@ -1050,28 +1321,29 @@ _libelf_write_elf(Elf *e, off_t newsize, struct _Elf_Extent_List *extents)
 	SLIST_FOREACH(ex, extents, ex_next) {
 
 		/* Fill inter-extent gaps. */
-		if (ex->ex_start > (size_t) rc)
-			(void) memset(newfile + rc, LIBELF_PRIVATE(fillchar),
-			    (size_t) (ex->ex_start - (uint64_t) rc));
+		if (ex->ex_start > (size_t) rc &&
+		    !_libelf_sink_fill(&es, (uint64_t) rc,
+			ex->ex_start - (uint64_t) rc))
+			goto error;
 
 		switch (ex->ex_type) {
 		case ELF_EXTENT_EHDR:
-			if ((nrc = _libelf_write_ehdr(e, newfile, ex)) < 0)
+			if ((nrc = _libelf_write_ehdr(e, &es, ex)) < 0)
 				goto error;
 			break;
 
 		case ELF_EXTENT_PHDR:
-			if ((nrc = _libelf_write_phdr(e, newfile, ex)) < 0)
+			if ((nrc = _libelf_write_phdr(e, &es, ex)) < 0)
 				goto error;
 			break;
 
 		case ELF_EXTENT_SECTION:
-			if ((nrc = _libelf_write_scn(e, newfile, ex)) < 0)
+			if ((nrc = _libelf_write_scn(e, &es, ex)) < 0)
 				goto error;
 			break;
 
 		case ELF_EXTENT_SHDR:
-			if ((nrc = _libelf_write_shdr(e, newfile, ex)) < 0)
+			if ((nrc = _libelf_write_shdr(e, &es, ex)) < 0)
 				goto error;
 			break;
 
@@ -1088,6 +1360,38 @@ _libelf_write_elf(Elf *e, off_t newsize, struct _Elf_Extent_List *extents)
 
 	assert(rc == newsize);
 
+	if (streaming) {
+		/*
+		 * Set the final size of the file, and leave the file
+		 * offset at its end as write(2) would have.
+		 */
+		if (ftruncate(e->e_fd, newsize) < 0 ||
+		    lseek(e->e_fd, newsize, SEEK_SET) < 0) {
+			LIBELF_SET_ERROR(IO, errno);
+			goto error;
+		}
+		goto done;
+	}
+
+	if (inplace) {
+		if (lseek(e->e_fd, newsize, SEEK_SET) < 0) {
+			LIBELF_SET_ERROR(IO, errno);
+			goto error;
+		}
+#if	ELFTC_HAVE_MMAP
+		if (e->e_flags & LIBELF_F_RAWFILE_MMAP) {
+			if (munmap(e->e_rawfile, (size_t) e->e_rawsize) < 0 ||
+			    (e->e_rawfile = mmap(NULL, (size_t) newsize,
+			    PROT_READ, MAP_PRIVATE, e->e_fd, (off_t) 0)) ==
+			    MAP_FAILED) {
+				LIBELF_SET_ERROR(IO, errno);
+				goto error;
+			}
+		}
+#endif
+		goto done;
+	}
+
 	/*
 	 * For regular files, throw away existing file content and
 	 * unmap any existing mappings.
@@ -1113,7 +1417,7 @@ _libelf_write_elf(Elf *e, off_t newsize, struct _Elf_Extent_List *extents)
 	/*
 	 * Write out the new contents.
 	 */
-	if (write(e->e_fd, newfile, (size_t) newsize) != newsize) {
+	if (write(e->e_fd, es.es_image, (size_t) newsize) != newsize) {
 		LIBELF_SET_ERROR(IO, errno);
 		goto error;
 	}
@@ -1125,14 +1429,22 @@ _libelf_write_elf(Elf *e, off_t newsize, struct _Elf_Extent_List *extents)
 	if (e->e_cmd == ELF_C_RDWR) {
 		assert(e->e_rawfile != NULL);
 		assert((e->e_flags & LIBELF_F_RAWFILE_MALLOC) ||
-		    (e->e_flags & LIBELF_F_RAWFILE_MMAP));
+		    (e->e_flags & LIBELF_F_RAWFILE_MMAP) ||
+		    (e->e_flags & LIBELF_F_RAWFILE_RESERVED));
 		if (e->e_flags & LIBELF_F_RAWFILE_MALLOC) {
 			assert((e->e_flags & LIBELF_F_RAWFILE_MMAP) == 0);
 			free(e->e_rawfile);
-			e->e_rawfile = newfile;
-			newfile = NULL;
+			e->e_rawfile = es.es_image;
+			es.es_image = NULL;
 		}
 #if	ELFTC_HAVE_MMAP
+		else if (e->e_flags & LIBELF_F_RAWFILE_RESERVED) {
+			(void) munmap(e->e_rawfile, (size_t) e->e_rawsize);
+			e->e_rawfile = es.es_image;
+			es.es_image = NULL;
+			e->e_flags &= ~LIBELF_F_RAWFILE_RESERVED;
+			e->e_flags |= LIBELF_F_RAWFILE_MALLOC;
+		}
 		else if (e->e_flags & LIBELF_F_RAWFILE_MMAP) {
 			assert((e->e_flags & LIBELF_F_RAWFILE_MALLOC) == 0);
 			if ((e->e_rawfile = mmap(NULL, (size_t) newsize,
@@ -1151,16 +1463,19 @@ _libelf_write_elf(Elf *e, off_t newsize, struct _Elf_Extent_List *extents)
 		assert(e->e_rawfile == NULL);
 	}
 
+ done:
 	/*
 	 * Reset flags, remove existing section descriptors and
 	 * {E,P}HDR pointers so that a subsequent elf_get{e,p}hdr()
 	 * and elf_getscn() will function correctly.
 	 */
 
-	e->e_flags &= ~ELF_F_DIRTY;
+	e->e_flags &= ~(ELF_F_DIRTY | LIBELF_F_SHDRS_INDEXED |
+	    LIBELF_F_SHDRS_LOADED);
 
 	STAILQ_FOREACH_SAFE(scn, &e->e_u.e_elf.e_scn, s_next, tscn)
 		_libelf_release_scn(scn);
+	_libelf_release_scnblocks(e);
 
 	if (e->e_class == ELFCLASS32) {
 		free(e->e_u.e_elf.e_ehdr.e_ehdr32);
@@ -1178,14 +1493,15 @@ _libelf_write_elf(Elf *e, off_t newsize, struct _Elf_Extent_List *extents)
 		e->e_u.e_elf.e_phdr.e_phdr64 = NULL;
 	}
 
-	/* Free the temporary buffer. */
-	if (newfile)
-		free(newfile);
+	/* Free the temporary buffers. */
+	free(es.es_image);
+	free(es.es_buf);
 
 	return (rc);
 
  error:
-	free(newfile);
+	free(es.es_image);
+	free(es.es_buf);
 
 	return ((off_t) -1);
 }
@@ -91,6 +91,10 @@ typedef enum {
 	ELF_C_READ,
 	ELF_C_SET,
 	ELF_C_WRITE,
+	ELF_C_ADVISE_NORMAL,	/* Access pattern hints for elf_cntl(). */
+	ELF_C_ADVISE_RANDOM,
+	ELF_C_ADVISE_SEQUENTIAL,
+	ELF_C_ADVISE_HUGEPAGE,
 	ELF_C_NUM
 } Elf_Cmd;
 
@@ -195,6 +199,7 @@ unsigned int	elf_flagphdr(Elf *_elf, Elf_Cmd _cmd, unsigned int _flags);
 unsigned int	elf_flagscn(Elf_Scn *_scn, Elf_Cmd _cmd, unsigned int _flags);
 unsigned int	elf_flagshdr(Elf_Scn *_scn, Elf_Cmd _cmd, unsigned int _flags);
 Elf_Arhdr	*elf_getarhdr(Elf *_elf);
+off_t		*elf_getarmembers(Elf *_elf, size_t *_ptr);
 Elf_Arsym	*elf_getarsym(Elf *_elf, size_t *_ptr);
 off_t		elf_getbase(Elf *_elf);
 Elf_Data	*elf_getdata(Elf_Scn *, Elf_Data *);
@@ -215,6 +220,7 @@ Elf_Scn		*elf_newscn(Elf *_elf);
 Elf_Scn		*elf_nextscn(Elf *_elf, Elf_Scn *_scn);
 Elf_Cmd		elf_next(Elf *_elf);
 Elf		*elf_open(int _fd);
+Elf		*elf_openarmember(Elf *_elf, off_t _off);
 Elf		*elf_openmemory(char *_image, size_t _size);
 off_t		elf_rand(Elf *_elf, off_t _off);
 Elf_Data	*elf_rawdata(Elf_Scn *_scn, Elf_Data *_data);
@@ -31,6 +31,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <libelf.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -38,16 +39,57 @@
 
 ELFTC_VCSID("$Id$");
 
+/*
+ * Section descriptors are carved out of blocks of geometrically
+ * increasing size, so that objects with many sections do not need
+ * one malloc() per section.  The blocks are freed together when the
+ * sections of an ELF descriptor are released.
+ */
+
+#define	_LIBELF_SCNBLOCK_MIN	16
+#define	_LIBELF_SCNBLOCK_MAX	4096
+
+struct _Libelf_Scnblock {
+	struct _Libelf_Scnblock *sb_next;
+	size_t		sb_nscn;	/* descriptors in this block */
+	size_t		sb_nused;	/* descriptors handed out */
+	Elf_Scn		sb_scn[];
+};
+
 Elf *
 _libelf_allocate_elf(void)
 {
 	Elf *e;
+#if	ELFTC_HAVE_PTHREADS
+	int error;
+	pthread_mutexattr_t attr;
+#endif
 
 	if ((e = calloc((size_t) 1, sizeof(*e))) == NULL) {
 		LIBELF_SET_ERROR(RESOURCE, errno);
 		return NULL;
 	}
 
+#if	ELFTC_HAVE_PTHREADS
+	/*
+	 * The lock is recursive since the lazy loaders call into each
+	 * other, e.g., loading the program header table brings in the
+	 * ELF header.
+	 */
+	if ((error = pthread_mutexattr_init(&attr)) == 0) {
+		if ((error = pthread_mutexattr_settype(&attr,
+		    PTHREAD_MUTEX_RECURSIVE)) == 0)
+			error = pthread_mutex_init(&e->e_lock, &attr);
+		(void) pthread_mutexattr_destroy(&attr);
+	}
+
+	if (error != 0) {
+		free(e);
+		LIBELF_SET_ERROR(RESOURCE, error);
+		return NULL;
+	}
+#endif
+
 	e->e_activations = 1;
 	e->e_byteorder   = ELFDATANONE;
 	e->e_class       = ELFCLASSNONE;
@@ -84,6 +126,7 @@ _libelf_release_elf(Elf *e)
 	switch (e->e_kind) {
 	case ELF_K_AR:
 		free(e->e_u.e_ar.e_symtab);
+		free(e->e_u.e_ar.e_members);
 		break;
 
 	case ELF_K_ELF:
@@ -100,6 +143,9 @@ _libelf_release_elf(Elf *e)
 
 		assert(STAILQ_EMPTY(&e->e_u.e_elf.e_scn));
 
+		_libelf_release_scnblocks(e);
+		free(e->e_u.e_elf.e_scnarray);
+
 		if (e->e_flags & LIBELF_F_AR_HEADER) {
 			arh = e->e_hdr.e_arhdr;
 			free(arh->ar_name);
@@ -113,6 +159,10 @@ _libelf_release_elf(Elf *e)
 		break;
 	}
 
+#if	ELFTC_HAVE_PTHREADS
+	(void) pthread_mutex_destroy(&e->e_lock);
+#endif
+
 	free(e);
 }
 
@@ -143,16 +193,72 @@ _libelf_release_data(struct _Libelf_Data *d)
 	return (NULL);
 }
 
+/*
+ * Ensure that the index of section descriptors for `e' has room for
+ * at least `count' entries.
+ */
+int
+_libelf_reserve_scn(Elf *e, size_t count)
+{
+	size_t oldsz, newsz;
+	Elf_Scn **newarray;
+
+	if ((oldsz = e->e_u.e_elf.e_scnarraysz) >= count)
+		return (1);
+
+	newsz = oldsz > 0 ? oldsz : 16;
+	while (newsz < count) {
+		if (newsz > SIZE_MAX / 2)
+			newsz = count;
+		else
+			newsz *= 2;
+	}
+
+	if (newsz > SIZE_MAX / sizeof(Elf_Scn *) ||
+	    (newarray = realloc(e->e_u.e_elf.e_scnarray,
+	    newsz * sizeof(Elf_Scn *))) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		return (0);
+	}
+
+	(void) memset(newarray + oldsz, 0,
+	    (newsz - oldsz) * sizeof(Elf_Scn *));
+
+	e->e_u.e_elf.e_scnarray = newarray;
+	e->e_u.e_elf.e_scnarraysz = newsz;
+
+	return (1);
+}
+
 Elf_Scn *
 _libelf_allocate_scn(Elf *e, size_t ndx)
 {
 	Elf_Scn *s;
+	size_t nscn;
+	struct _Libelf_Scnblock *sb;
 
-	if ((s = calloc((size_t) 1, sizeof(Elf_Scn))) == NULL) {
-		LIBELF_SET_ERROR(RESOURCE, errno);
+	if (ndx == SIZE_MAX || _libelf_reserve_scn(e, ndx + 1) == 0)
 		return (NULL);
+
+	if ((sb = e->e_u.e_elf.e_scnblocks) == NULL ||
+	    sb->sb_nused == sb->sb_nscn) {
+		nscn = sb == NULL ? _LIBELF_SCNBLOCK_MIN : 2 * sb->sb_nscn;
+		if (nscn > _LIBELF_SCNBLOCK_MAX)
+			nscn = _LIBELF_SCNBLOCK_MAX;
+
+		if ((sb = calloc((size_t) 1, sizeof(*sb) +
+		    nscn * sizeof(Elf_Scn))) == NULL) {
+			LIBELF_SET_ERROR(RESOURCE, errno);
+			return (NULL);
+		}
+
+		sb->sb_nscn = nscn;
+		sb->sb_next = e->e_u.e_elf.e_scnblocks;
+		e->e_u.e_elf.e_scnblocks = sb;
 	}
 
+	s = &sb->sb_scn[sb->sb_nused++];
+
 	s->s_elf = e;
 	s->s_ndx = ndx;
 
@@ -161,6 +267,9 @@ _libelf_allocate_scn(Elf *e, size_t ndx)
 
 	STAILQ_INSERT_TAIL(&e->e_u.e_elf.e_scn, s, s_next);
 
+	if (e->e_u.e_elf.e_scnarray[ndx] == NULL)
+		e->e_u.e_elf.e_scnarray[ndx] = s;
+
 	return (s);
 }
 
@@ -183,13 +292,36 @@ _libelf_release_scn(Elf_Scn *s)
 		d = _libelf_release_data(d);
 	}
 
+	_libelf_release_strtab(s);
+
 	e = s->s_elf;
 
 	assert(e != NULL);
 
 	STAILQ_REMOVE(&e->e_u.e_elf.e_scn, s, _Elf_Scn, s_next);
 
-	free(s);
+	if (s->s_ndx < e->e_u.e_elf.e_scnarraysz &&
+	    e->e_u.e_elf.e_scnarray[s->s_ndx] == s)
+		e->e_u.e_elf.e_scnarray[s->s_ndx] = NULL;
 
 	return (NULL);
 }
+
+/*
+ * Free the storage for the section descriptors of `e'.  All sections
+ * must have been released.
+ */
+void
+_libelf_release_scnblocks(Elf *e)
+{
+	struct _Libelf_Scnblock *sb, *tsb;
+
+	assert(STAILQ_EMPTY(&e->e_u.e_elf.e_scn));
+
+	for (sb = e->e_u.e_elf.e_scnblocks; sb != NULL; sb = tsb) {
+		tsb = sb->sb_next;
+		free(sb);
+	}
+
+	e->e_u.e_elf.e_scnblocks = NULL;
+}
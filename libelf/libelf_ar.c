@@ -203,19 +203,23 @@ _libelf_ar_gethdr(Elf *e)
 	return (NULL);
 }
 
+/*
+ * Open the archive member whose ar(1) header is at offset `next'.
+ *
+ * The archive descriptor is only read here, so members may be opened
+ * concurrently by multiple threads.
+ */
 Elf *
-_libelf_ar_open_member(int fd, Elf_Cmd c, Elf *elf)
+_libelf_ar_open_member(int fd, Elf_Cmd c, Elf *elf, off_t next)
 {
 	Elf *e;
 	size_t nsz, sz;
-	off_t next, end;
+	off_t end;
 	struct ar_hdr *arh;
 	char *member, *namelen;
 
 	assert(elf->e_kind == ELF_K_AR);
 
-	next = elf->e_u.e_ar.e_next;
-
 	/*
 	 * `next' is only set to zero by elf_next() when the last
 	 * member of an archive is processed.
@@ -284,12 +288,89 @@ _libelf_ar_open_member(int fd, Elf_Cmd c, Elf *elf)
 	e->e_cmd = c;
 	e->e_hdr.e_rawhdr = (unsigned char *) arh;
 
+	LIBELF_LOCK(elf);
 	elf->e_u.e_ar.e_nchildren++;
+	LIBELF_UNLOCK(elf);
 	e->e_parent = elf;
 
 	return (e);
 }
 
+/*
+ * Build the table returned by elf_getarmembers(3) in a single pass
+ * over the archive's member headers.
+ *
+ * The table holds the offsets of the ar(1) headers of the members
+ * that a traversal using elf_begin(3) and elf_next(3) would visit,
+ * and is terminated by an entry with offset zero.
+ */
+off_t *
+_libelf_ar_scan_members(Elf *e, size_t *count)
+{
+	size_t n, nalloc, sz;
+	off_t end, next, *t, *tab;
+	struct ar_hdr *arh;
+
+	assert(e != NULL);
+	assert(count != NULL);
+	assert(e->e_kind == ELF_K_AR);
+	assert(e->e_u.e_ar.e_members == NULL);
+
+	n = nalloc = 0;
+	tab = NULL;
+
+	for (next = e->e_u.e_ar.e_first; next < e->e_rawsize;
+	     next = (end + 1) & ~1) {
+		end = next + (off_t) sizeof(struct ar_hdr);
+		if (end < next || end > e->e_rawsize)
+			goto error;
+
+		arh = (struct ar_hdr *) (e->e_rawfile + next);
+
+		if (arh->ar_fmag[0] != '`' || arh->ar_fmag[1] != '\n' ||
+		    _libelf_ar_get_number(arh->ar_size,
+		    sizeof(arh->ar_size), 10, &sz) == 0)
+			goto error;
+
+		end += (off_t) sz;
+		if (end < next || end > e->e_rawsize)
+			goto error;
+
+		/* Leave room for the terminating entry. */
+		if (n + 1 >= nalloc) {
+			nalloc = nalloc ? 2 * nalloc : LIBELF_NALLOC_SIZE;
+			if ((t = realloc(tab, nalloc * sizeof(*tab))) ==
+			    NULL) {
+				free(tab);
+				LIBELF_SET_ERROR(RESOURCE, 0);
+				return (NULL);
+			}
+			tab = t;
+		}
+
+		tab[n++] = next;
+	}
+
+	if (tab == NULL && (tab = malloc(sizeof(*tab))) == NULL) {
+		LIBELF_SET_ERROR(RESOURCE, 0);
+		return (NULL);
+	}
+
+	tab[n] = (off_t) 0;
+
+	e->e_u.e_ar.e_members = tab;
+	e->e_u.e_ar.e_nmembers = n;
+
+	*count = n;
+
+	return (tab);
+
+error:
+	free(tab);
+	LIBELF_SET_ERROR(ARCHIVE, 0);
+	return (NULL);
+}
+
 /*
  * A BSD-style ar(1) symbol table has the following layout:
  *
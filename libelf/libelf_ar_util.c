@@ -346,6 +346,7 @@ _libelf_ar_open(Elf *e, int reporterror)
 	 * works as expected.
 	 */
 	e->e_u.e_ar.e_next = (off_t) (s - e->e_rawfile);
+	e->e_u.e_ar.e_first = e->e_u.e_ar.e_next;
 
 	return (e);
 
@@ -0,0 +1,300 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include <libelf.h>
+
+#include "_libelf.h"
+
+ELFTC_VCSID("$Id$");
+
+/*
+ * Byte swapping kernels for the translators in `libelf_convert.m4'.
+ *
+ * The kernels swap arrays of fixed size ELF structures whose file and
+ * memory representations have the same layout.  The layout of such a
+ * structure is described by a NUL-terminated string of field widths,
+ * in bytes.  For example, an Elf32_Sym is described by "\4\4\4\1\1\2",
+ * and an array of Elf64_Xword values by "\10".
+ *
+ * When every field is naturally aligned inside the structure, and the
+ * structure's size is a multiple of its widest field, no field in an
+ * array of such structures straddles a 16 byte boundary.  Swapping a
+ * 16 byte chunk of the array then reduces to a byte shuffle within
+ * the chunk, and the shuffle pattern repeats every lcm(size, 16)
+ * bytes.  These shuffles are done using SSE2 or AVX2 instructions.
+ *
+ * The kernels swap a prefix of the array and return the number of
+ * structures swapped.  The caller is expected to handle the remainder
+ * itself; this is the whole array on hosts without vector support, or
+ * if the layout is unsuitable.
+ *
+ * Source and destination may be identical but must not otherwise
+ * overlap.  Neither needs to be aligned.
+ */
+
+#if	defined(__GNUC__) && defined(__SSE2__) &&			\
+	(defined(__i386__) || defined(__x86_64__))
+#define	LIBELF_BSWAP_SSE2	1
+#include <emmintrin.h>
+
+#if	defined(__clang__) || __GNUC__ >= 5
+#define	LIBELF_BSWAP_AVX2	1
+#include <immintrin.h>
+#endif
+#endif
+
+#if	defined(LIBELF_BSWAP_SSE2)
+
+#define	BSWAP_MAXPERIOD		48	/* Largest supported shuffle period. */
+#define	BSWAP_MAXVEC		(BSWAP_MAXPERIOD / 16)
+
+struct bswap_layout {
+	size_t		bl_size;	/* Size of the structure. */
+	size_t		bl_period;	/* Shuffle period, 0 if none. */
+	unsigned int	bl_widths;	/* Bit mask of field widths. */
+};
+
+/*
+ * Examine a layout string, returning 0 if it is unsuitable for the
+ * vector kernels.
+ */
+static int
+bswap_examine(struct bswap_layout *bl, const char *layout)
+{
+	size_t a, b, maxw, w;
+	const unsigned char *p;
+
+	bl->bl_size = 0;
+	bl->bl_widths = 0;
+
+	maxw = 0;
+	for (p = (const unsigned char *) layout; *p; p++) {
+		w = *p;
+		if (w != 1 && w != 2 && w != 4 && w != 8)
+			return (0);
+		if (bl->bl_size % w)	/* Misaligned field. */
+			return (0);
+		if (w > maxw)
+			maxw = w;
+		bl->bl_size += w;
+		bl->bl_widths |= (unsigned int) w;
+	}
+
+	if (bl->bl_size == 0 || bl->bl_size % maxw)
+		return (0);
+
+	/* The shuffle period is lcm(size, 16). */
+	for (a = bl->bl_size, b = 16; b != 0; ) {
+		w = a % b;
+		a = b;
+		b = w;
+	}
+	bl->bl_period = (bl->bl_size / a) * 16;
+
+	return (bl->bl_period <= BSWAP_MAXPERIOD);
+}
+
+/*
+ * Return the width of the field containing byte `i' of an array of
+ * structures, along with the offset of the field's first byte.
+ */
+static size_t
+bswap_field(const struct bswap_layout *bl, const char *layout, size_t i,
+    size_t *start)
+{
+	size_t off;
+	const unsigned char *p;
+
+	off = i - (i % bl->bl_size);
+	for (p = (const unsigned char *) layout; off + *p <= i; p++)
+		off += *p;
+
+	*start = off;
+	return (*p);
+}
+
+/*
+ * SSE2 lacks a byte shuffle.  Instead, each 16 byte chunk is swapped
+ * as 16-, 32- and 64-bit quantities, and the results are blended
+ * together using masks that select the bytes of fields of each width.
+ */
+
+#define	SWAP16(X)	_mm_or_si128(_mm_slli_epi16((X), 8),		\
+	    _mm_srli_epi16((X), 8))
+#define	SWAP32(S16)	_mm_shufflehi_epi16(_mm_shufflelo_epi16((S16),	\
+	    0xB1), 0xB1)
+#define	SWAP64(S16)	_mm_shufflehi_epi16(_mm_shufflelo_epi16((S16),	\
+	    0x1B), 0x1B)
+
+static size_t
+bswap_sse2(unsigned char *dst, const unsigned char *src, size_t count,
+    const struct bswap_layout *bl, const char *layout)
+{
+	__m128i m2[BSWAP_MAXVEC], m4[BSWAP_MAXVEC], m8[BSWAP_MAXVEC];
+	__m128i m1, s16, x;
+	size_t i, k, n, nbytes, nvec, start, w;
+	unsigned char masks[3][BSWAP_MAXPERIOD];
+
+	nbytes = count * bl->bl_size;
+	nbytes -= nbytes % bl->bl_period;
+
+	switch (bl->bl_widths) {
+	case 2:
+		for (n = 0; n < nbytes; n += 16) {
+			x = _mm_loadu_si128((const __m128i *) (src + n));
+			_mm_storeu_si128((__m128i *) (dst + n), SWAP16(x));
+		}
+		return (nbytes / bl->bl_size);
+	case 4:
+		for (n = 0; n < nbytes; n += 16) {
+			x = _mm_loadu_si128((const __m128i *) (src + n));
+			s16 = SWAP16(x);
+			_mm_storeu_si128((__m128i *) (dst + n), SWAP32(s16));
+		}
+		return (nbytes / bl->bl_size);
+	case 8:
+		for (n = 0; n < nbytes; n += 16) {
+			x = _mm_loadu_si128((const __m128i *) (src + n));
+			s16 = SWAP16(x);
+			_mm_storeu_si128((__m128i *) (dst + n), SWAP64(s16));
+		}
+		return (nbytes / bl->bl_size);
+	default:
+		break;
+	}
+
+	for (i = 0; i < bl->bl_period; i++) {
+		w = bswap_field(bl, layout, i, &start);
+		masks[0][i] = w == 2 ? 0xFF : 0;
+		masks[1][i] = w == 4 ? 0xFF : 0;
+		masks[2][i] = w == 8 ? 0xFF : 0;
+	}
+
+	nvec = bl->bl_period / 16;
+	for (k = 0; k < nvec; k++) {
+		m2[k] = _mm_loadu_si128((const __m128i *) (masks[0] + 16 * k));
+		m4[k] = _mm_loadu_si128((const __m128i *) (masks[1] + 16 * k));
+		m8[k] = _mm_loadu_si128((const __m128i *) (masks[2] + 16 * k));
+	}
+
+	for (n = 0; n < nbytes; ) {
+		for (k = 0; k < nvec; k++, n += 16) {
+			x   = _mm_loadu_si128((const __m128i *) (src + n));
+			s16 = SWAP16(x);
+
+			/* Bytes outside all masks are in 1 byte fields. */
+			m1 = _mm_or_si128(_mm_or_si128(m2[k], m4[k]), m8[k]);
+			x = _mm_andnot_si128(m1, x);
+			x = _mm_or_si128(x, _mm_and_si128(m2[k], s16));
+			x = _mm_or_si128(x, _mm_and_si128(m4[k],
+			    SWAP32(s16)));
+			x = _mm_or_si128(x, _mm_and_si128(m8[k],
+			    SWAP64(s16)));
+
+			_mm_storeu_si128((__m128i *) (dst + n), x);
+		}
+	}
+
+	return (nbytes / bl->bl_size);
+}
+
+#undef	SWAP16
+#undef	SWAP32
+#undef	SWAP64
+
+#if	defined(LIBELF_BSWAP_AVX2)
+/*
+ * Swap 32 byte chunks using a shuffle table.  Since VPSHUFB shuffles
+ * within each 16 byte half of a register, table entries are relative
+ * to the start of the half that they fall in.
+ */
+static size_t __attribute__((target("avx2")))
+bswap_avx2(unsigned char *dst, const unsigned char *src, size_t count,
+    const struct bswap_layout *bl, const char *layout)
+{
+	__m256i m[BSWAP_MAXVEC], x;
+	size_t chunk, i, k, n, nbytes, nvec, start, w;
+	unsigned char shuffle[2 * BSWAP_MAXPERIOD];
+
+	/* Process whole multiples of lcm(period, 32) bytes. */
+	chunk = bl->bl_period % 32 ? bl->bl_period * 2 : bl->bl_period;
+	nbytes = count * bl->bl_size;
+	nbytes -= nbytes % chunk;
+
+	for (i = 0; i < chunk; i++) {
+		w = bswap_field(bl, layout, i, &start);
+		shuffle[i] = (unsigned char) ((start + w - 1 - (i - start)) -
+		    (i & ~(size_t) 15));
+	}
+
+	nvec = chunk / 32;
+	for (k = 0; k < nvec; k++)
+		m[k] = _mm256_loadu_si256((const __m256i *) (shuffle +
+		    32 * k));
+
+	for (n = 0; n < nbytes; ) {
+		for (k = 0; k < nvec; k++, n += 32) {
+			x = _mm256_loadu_si256((const __m256i *) (src + n));
+			_mm256_storeu_si256((__m256i *) (dst + n),
+			    _mm256_shuffle_epi8(x, m[k]));
+		}
+	}
+
+	return (nbytes / bl->bl_size);
+}
+#endif	/* LIBELF_BSWAP_AVX2 */
+
+#endif	/* LIBELF_BSWAP_SSE2 */
+
+/*
+ * Byte swap a prefix of an array of `count' structures with the
+ * layout described by `layout', from `src' to `dst'.  Returns the
+ * number of structures swapped.
+ */
+size_t
+_libelf_bswap(unsigned char *dst, const unsigned char *src, size_t count,
+    const char *layout)
+{
+#if	defined(LIBELF_BSWAP_SSE2)
+	struct bswap_layout bl;
+
+	if (count == 0 || !bswap_examine(&bl, layout))
+		return (0);
+
+#if	defined(LIBELF_BSWAP_AVX2)
+	if (__builtin_cpu_supports("avx2"))
+		return (bswap_avx2(dst, src, count, &bl, layout));
+#endif
+	return (bswap_sse2(dst, src, count, &bl, layout));
+#else
+	(void) dst;
+	(void) src;
+	(void) count;
+	(void) layout;
+
+	return (0);
+#endif
+}
@@ -130,6 +130,40 @@ define(`PRIM_XWORD',	1)
 define(`SIZEDEP_ADDR',	1)
 define(`SIZEDEP_OFF',	1)
 
+# `Same layout' composite ELF types have naturally aligned members and
+# no padding, so that their file and memory representations differ at
+# most in byte order.  Arrays of these types, like arrays of primitive
+# types, are byte swapped using the vectorized kernels in
+# `libelf_bswap.c' where the host supports them.
+define(`SAMELAYOUT_DYN',	1)
+define(`SAMELAYOUT_REL',	1)
+define(`SAMELAYOUT_RELA',	1)
+define(`SAMELAYOUT_SYM',	1)
+
+# BSWAP_WIDTH(ELFTYPE) -- The width of a basic type as a C string
+# escape, for use in layout strings passed to _libelf_bswap().
+define(`BSWAP_WIDTH',
+  `ifelse($1,`BYTE',`\1',
+    $1,`HALF',`\2',
+    $1,`SWORD',`\4',
+    $1,`WORD',`\4',
+    $1,`ADDR32',`\4',
+    $1,`OFF32',`\4',
+    `\10')')
+
+# BSWAP_FIELD(FIELDNAME,ELFTYPE) -- The width of one field.
+define(`BSWAP_FIELD',
+  `ifdef(`SIZEDEP_'$2,`BSWAP_WIDTH($2`'SZ())',`BSWAP_WIDTH($2)')')
+
+# BSWAP_MEMBERS(ELFTYPELIST) -- Iterate over a structure definition.
+define(`BSWAP_MEMBERS',
+  `ifelse($#,1,`',
+    `BSWAP_FIELD($1)BSWAP_MEMBERS(shift($@))')')
+
+# BSWAP_LAYOUT(CTYPE,SIZE) -- The layout string for an ELF structure.
+define(`BSWAP_LAYOUT',
+  `pushdef(`SZ',$2)"BSWAP_MEMBERS(Elf$2_$1_DEF)"popdef(`SZ')')
+
 # Generate conversion functions for primitive types.
 #
 # Macro use: MAKEPRIMFUNCS(ELFTYPE,CTYPE,TYPESIZE,SYMSIZE)
@@ -154,7 +188,11 @@ _libelf_cvt_$1$4_tof(unsigned char *dst, size_t dsz, unsigned char *src,
 		return (1);
 	}
 
-	for (c = 0; c < count; c++) {
+	c = _libelf_bswap(dst, src, count, "BSWAP_WIDTH($1$4)");
+	s += c;
+	dst += c * sizeof(*s);
+
+	for (; c < count; c++) {
 		t = *s++;
 		SWAP_$1$4(t);
 		WRITE_$1$4(dst,t);
@@ -178,7 +216,11 @@ _libelf_cvt_$1$4_tom(unsigned char *dst, size_t dsz, unsigned char *src,
 		return (1);
 	}
 
-	for (c = 0; c < count; c++) {
+	c = _libelf_bswap(dst, src, count, "BSWAP_WIDTH($1$4)");
+	d += c;
+	src += c * sizeof(*d);
+
+	for (; c < count; c++) {
 		READ_$1$4(src,t);
 		SWAP_$1$4(t);
 		*d++ = t;
@@ -313,12 +355,85 @@ _libelf_cvt_$1$3_tom(unsigned char *dst, size_t dsz, unsigned char *src,
 }
 ')')
 
+# MAKESAMELAYOUTFUNCS -- Generate converters for `same layout'
+# composite ELF structures.
+#
+# Since the file and memory sizes of these structures are identical,
+# in-place conversions need no special handling.  Structures that are
+# not handled by the byte swapping kernels are swapped one member at
+# a time.
+#
+# Macro use:
+# `$1': Name of the ELF type.
+# `$2': C structure name suffix.
+# `$3': ELF class specifier, one of [`32', `64']
+define(`MAKESAMELAYOUTFUNCS', `ifdef(`NOFUNC_'$1$3,`',`
+static int
+_libelf_cvt_$1$3_tof(unsigned char *dst, size_t dsz, unsigned char *src,
+    size_t count, int byteswap)
+{
+	Elf$3_$2	t, *s;
+	size_t		c;
+
+	(void) dsz;
+
+	if (!byteswap) {
+		if (dst != src)
+			(void) memcpy(dst, src, count * sizeof(Elf$3_$2));
+		return (1);
+	}
+
+	c = _libelf_bswap(dst, src, count, BSWAP_LAYOUT($2,$3));
+	s = ((Elf$3_$2 *) (uintptr_t) src) + c;
+	dst += c * sizeof(Elf$3_$2);
+
+	for (; c < count; c++) {
+		t = *s++;
+		SWAP_STRUCT($2,$3)
+		WRITE_STRUCT($2,$3)
+	}
+
+	return (1);
+}
+
+static int
+_libelf_cvt_$1$3_tom(unsigned char *dst, size_t dsz, unsigned char *src,
+    size_t count, int byteswap)
+{
+	Elf$3_$2	t, *d;
+	unsigned char	*s;
+	size_t		c;
+
+	if (dsz < count * sizeof(Elf$3_$2))
+		return (0);
+
+	if (!byteswap) {
+		if (dst != src)
+			(void) memcpy(dst, src, count * sizeof(Elf$3_$2));
+		return (1);
+	}
+
+	c = _libelf_bswap(dst, src, count, BSWAP_LAYOUT($2,$3));
+	d = ((Elf$3_$2 *) (uintptr_t) dst) + c;
+	s = src + c * sizeof(Elf$3_$2);
+
+	for (; c < count; c++) {
+		READ_STRUCT($2,$3)
+		SWAP_STRUCT($2,$3)
+		*d++ = t;
+	}
+
+	return (1);
+}
+')')
+
 # MAKE_TYPE_CONVERTER(ELFTYPE,CTYPE)
 #
 # Make type convertor functions from the type definition
 # of the ELF type:
 # - Skip convertors marked as `NOFUNC'.
-# - Invoke `MAKEPRIMFUNCS' or `MAKECOMPFUNCS' as appropriate.
+# - Invoke `MAKEPRIMFUNCS', `MAKESAMELAYOUTFUNCS' or `MAKECOMPFUNCS'
+#   as appropriate.
 define(`MAKE_TYPE_CONVERTER',
   `ifdef(`NOFUNC_'$1,`',
     `ifdef(`PRIM_'$1,
@@ -326,8 +441,11 @@ define(`MAKE_TYPE_CONVERTER',
 	`MAKEPRIMFUNCS($1,$2,32,32)dnl
 	 MAKEPRIMFUNCS($1,$2,64,64)',
 	`MAKEPRIMFUNCS($1,$2,64)')',
-      `MAKECOMPFUNCS($1,$2,32)dnl
-       MAKECOMPFUNCS($1,$2,64)')')')
+      `ifdef(`SAMELAYOUT_'$1,
+	`MAKESAMELAYOUTFUNCS($1,$2,32)dnl
+	 MAKESAMELAYOUTFUNCS($1,$2,64)',
+	`MAKECOMPFUNCS($1,$2,32)dnl
+	 MAKECOMPFUNCS($1,$2,64)')')')')
 
 # MAKE_TYPE_CONVERTERS(ELFTYPELIST) -- Generate conversion functions.
 define(`MAKE_TYPE_CONVERTERS',
@@ -61,6 +61,9 @@ _libelf_load_extended(Elf *e, int ec, uint64_t shoff, uint16_t phnum,
 		return (0);
 	}
 
+	if (!_libelf_load_rawfile(e, shoff, fsz))
+		return (0);
+
 	if ((scn = _libelf_allocate_scn(e, (size_t) 0)) == NULL)
 		return (0);
 
@@ -102,8 +105,12 @@ _libelf_load_extended(Elf *e, int ec, uint64_t shoff, uint16_t phnum,
 		eh->e_version = LIBELF_PRIVATE(version);		\
 	} while (0)
 
-void *
-_libelf_ehdr(Elf *e, int ec, int allocate)
+/*
+ * Retrieve (allocating and translating if needed) the ELF header.
+ * Called with the descriptor lock held.
+ */
+static void *
+_libelf_load_ehdr(Elf *e, int ec, int allocate)
 {
 	void *ehdr;
 	size_t fsz, msz;
@@ -112,13 +119,6 @@ _libelf_ehdr(Elf *e, int ec, int allocate)
 	int (*xlator)(unsigned char *_d, size_t _dsz, unsigned char *_s,
 	    size_t _c, int _swap);
 
-	assert(ec == ELFCLASS32 || ec == ELFCLASS64);
-
-	if (e == NULL || e->e_kind != ELF_K_ELF) {
-		LIBELF_SET_ERROR(ARGUMENT, 0);
-		return (NULL);
-	}
-
 	if (e->e_class != ELFCLASSNONE && e->e_class != ec) {
 		LIBELF_SET_ERROR(CLASS, 0);
 		return (NULL);
@@ -210,3 +210,22 @@ _libelf_ehdr(Elf *e, int ec, int allocate)
 
 	return (ehdr);
 }
+
+void *
+_libelf_ehdr(Elf *e, int ec, int allocate)
+{
+	void *ehdr;
+
+	assert(ec == ELFCLASS32 || ec == ELFCLASS64);
+
+	if (e == NULL || e->e_kind != ELF_K_ELF) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	LIBELF_LOCK(e);
+	ehdr = _libelf_load_ehdr(e, ec, allocate);
+	LIBELF_UNLOCK(e);
+
+	return (ehdr);
+}
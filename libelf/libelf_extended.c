@@ -32,16 +32,21 @@
 ELFTC_VCSID("$Id$");
 
 /*
- * Retrieve section #0, allocating a new section if needed.
+ * Retrieve section #0, reading it in or allocating a new section if
+ * needed.
  */
 static Elf_Scn *
 _libelf_getscn0(Elf *e)
 {
 	Elf_Scn *s;
 
-	if ((s = STAILQ_FIRST(&e->e_u.e_elf.e_scn)) != NULL)
+	if (e->e_u.e_elf.e_scnarraysz > 0 &&
+	    (s = e->e_u.e_elf.e_scnarray[SHN_UNDEF]) != NULL)
 		return (s);
 
+	if (e->e_cmd != ELF_C_WRITE && e->e_u.e_elf.e_nscn > 0)
+		return (elf_getscn(e, (size_t) SHN_UNDEF));
+
 	return (_libelf_allocate_scn(e, (size_t) SHN_UNDEF));
 }
 
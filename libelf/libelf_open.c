@@ -30,7 +30,9 @@
 #include <assert.h>
 #include <errno.h>
 #include <libelf.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 #include "_libelf.h"
@@ -42,6 +44,227 @@
 ELFTC_VCSID("$Id$");
 
 #define	_LIBELF_INITSIZE	(64*1024)
+#define	_LIBELF_CHUNKSIZE	(1024*1024)	/* unit of on-demand reads */
+#define	_LIBELF_WILLNEED_MIN	(64*1024)	/* smallest range prefetched */
+
+#if	ELFTC_HAVE_MMAP && !defined(MAP_NORESERVE)
+#define	MAP_NORESERVE		0
+#endif
+
+/*
+ * Read `sz' bytes at offset `off' in the file referenced by `fd'.
+ */
+static int
+_libelf_pread(int fd, unsigned char *buf, size_t sz, off_t off)
+{
+	ssize_t readsz;
+
+	while (sz > 0) {
+		if ((readsz = pread(fd, buf, sz, off)) < 0) {
+			if (errno == EINTR)
+				continue;
+			LIBELF_SET_ERROR(IO, errno);
+			return (0);
+		}
+
+		if (readsz == 0) {	/* The file was truncated. */
+			LIBELF_SET_ERROR(IO, 0);
+			return (0);
+		}
+
+		buf += readsz;
+		sz  -= (size_t) readsz;
+		off += readsz;
+	}
+
+	return (1);
+}
+
+#if	ELFTC_HAVE_MMAP
+/*
+ * Pass an access hint for the pages spanned by a byte range to the
+ * kernel.  The range is extended to page boundaries, so it must lie
+ * within a mapping.
+ */
+static void
+_libelf_madvise(unsigned char *p, size_t sz, int advice)
+{
+	uintptr_t end, pgmask, start;
+
+	pgmask = (uintptr_t) sysconf(_SC_PAGESIZE) - 1;
+	start = (uintptr_t) p & ~pgmask;
+	end = ((uintptr_t) p + sz + pgmask) & ~pgmask;
+
+	(void) madvise((void *) start, (size_t) (end - start), advice);
+}
+#endif
+
+/*
+ * Record an access pattern hint, set using elf_cntl(3), for the file
+ * image of descriptor `e', and pass it on to the kernel.  Hints are
+ * advisory and failures to apply them are ignored.
+ */
+void
+_libelf_advise(Elf *e, Elf_Cmd c)
+{
+#if	ELFTC_HAVE_MMAP
+	int advice;
+	uintptr_t end, pgmask, start;
+#endif
+
+	assert(c == ELF_C_ADVISE_NORMAL || c == ELF_C_ADVISE_RANDOM ||
+	    c == ELF_C_ADVISE_SEQUENTIAL || c == ELF_C_ADVISE_HUGEPAGE);
+
+	if (c != ELF_C_ADVISE_HUGEPAGE)
+		e->e_advice = c;
+
+#if	ELFTC_HAVE_MMAP
+	if (e->e_rawfile == NULL)
+		return;
+
+	switch (c) {
+	case ELF_C_ADVISE_RANDOM:
+		advice = MADV_RANDOM;
+		break;
+	case ELF_C_ADVISE_SEQUENTIAL:
+		advice = MADV_SEQUENTIAL;
+		break;
+	case ELF_C_ADVISE_HUGEPAGE:
+#if	defined(MADV_HUGEPAGE)
+		advice = MADV_HUGEPAGE;
+		break;
+#else
+		return;
+#endif
+	default:
+		advice = MADV_NORMAL;
+		break;
+	}
+
+	if (e->e_flags & (LIBELF_F_RAWFILE_MMAP | LIBELF_F_RAWFILE_RESERVED))
+		_libelf_madvise(e->e_rawfile, (size_t) e->e_rawsize, advice);
+	else if ((e->e_flags & LIBELF_F_RAWFILE_MALLOC) &&
+	    c == ELF_C_ADVISE_HUGEPAGE) {
+		/*
+		 * Large heap allocations are anonymous mappings, where
+		 * huge pages are most effective.  Only whole pages
+		 * inside the allocation are advised.
+		 */
+		pgmask = (uintptr_t) sysconf(_SC_PAGESIZE) - 1;
+		start = ((uintptr_t) e->e_rawfile + pgmask) & ~pgmask;
+		end = ((uintptr_t) e->e_rawfile + (size_t) e->e_rawsize) &
+		    ~pgmask;
+		if (end > start)
+			(void) madvise((void *) start, (size_t) (end - start),
+			    advice);
+	}
+#endif
+}
+
+/*
+ * Make the `sz' bytes at `p' in a file image accessible.  Only images
+ * that are anonymous mappings need this; their pages are inaccessible,
+ * and not backed by memory, until they are about to be read into.
+ */
+static int
+_libelf_commit_rawfile(unsigned char *p, size_t sz, unsigned int flags)
+{
+#if	ELFTC_HAVE_MMAP
+	if ((flags & LIBELF_F_RAWFILE_RESERVED) &&
+	    mprotect(p, sz, PROT_READ | PROT_WRITE) < 0) {
+		LIBELF_SET_ERROR(RESOURCE, errno);
+		return (0);
+	}
+#else
+	(void) p;
+	(void) sz;
+	(void) flags;
+#endif
+
+	return (1);
+}
+
+/*
+ * Make the `sz' bytes at offset `off' in the file image of descriptor
+ * `e' ready for use.
+ *
+ * Parts of images that are being read in on demand are read in here,
+ * a chunk at a time.  If the image is an anonymous mapping, the pages
+ * of a chunk are only made accessible, and thus backed by memory, when
+ * the chunk is read in.  For images that were mapped in, large ranges
+ * are prefetched if the application has described its access pattern.
+ */
+int
+_libelf_load_rawfile(Elf *e, uint64_t off, uint64_t sz)
+{
+	int ok;
+	unsigned char *p;
+	size_t c, first, last, len, n, nchunks;
+	uint64_t end;
+#if	ELFTC_HAVE_MMAP
+	Elf *top;
+#endif
+
+	if (sz == 0 || off >= (uint64_t) e->e_rawsize)
+		return (1);
+	if (sz > (uint64_t) e->e_rawsize - off)
+		sz = (uint64_t) e->e_rawsize - off;
+
+	if ((e->e_flags & LIBELF_F_RAWFILE_PARTIAL) == 0) {
+#if	ELFTC_HAVE_MMAP
+		/* Archive members share their archive's mapping. */
+		for (top = e; top->e_parent != NULL; top = top->e_parent)
+			;
+		if ((top->e_flags & LIBELF_F_RAWFILE_MMAP) &&
+		    sz >= _LIBELF_WILLNEED_MIN &&
+		    (top->e_advice == ELF_C_ADVISE_RANDOM ||
+		    top->e_advice == ELF_C_ADVISE_SEQUENTIAL))
+			_libelf_madvise(e->e_rawfile + off, (size_t) sz,
+			    MADV_WILLNEED);
+#endif
+		return (1);
+	}
+
+	assert(e->e_rawchunks != NULL);
+
+	nchunks = (size_t) ((e->e_rawsize + _LIBELF_CHUNKSIZE - 1) /
+	    _LIBELF_CHUNKSIZE);
+	first = (size_t) (off / _LIBELF_CHUNKSIZE);
+	last = (size_t) ((off + sz - 1) / _LIBELF_CHUNKSIZE);
+
+	/* Read ahead by a chunk if the object is being read in order. */
+	if (e->e_advice == ELF_C_ADVISE_SEQUENTIAL && last + 1 < nchunks)
+		last++;
+
+	ok = 1;
+
+	LIBELF_LOCK(e);
+	for (c = first; ok && c <= last; c = n) {
+		if (e->e_rawchunks[c]) {
+			n = c + 1;
+			continue;
+		}
+
+		/* Read in runs of missing chunks using a single call. */
+		for (n = c + 1; n <= last && e->e_rawchunks[n] == 0; n++)
+			;
+
+		end = (uint64_t) n * _LIBELF_CHUNKSIZE;
+		if (end > (uint64_t) e->e_rawsize)
+			end = (uint64_t) e->e_rawsize;
+
+		p = e->e_rawfile + c * _LIBELF_CHUNKSIZE;
+		len = (size_t) end - c * _LIBELF_CHUNKSIZE;
+
+		if ((ok = _libelf_commit_rawfile(p, len, e->e_flags)) != 0 &&
+		    (ok = _libelf_pread(e->e_fd, p, len,
+		    (off_t) c * _LIBELF_CHUNKSIZE)) != 0)
+			(void) memset(e->e_rawchunks + c, 1, n - c);
+	}
+	LIBELF_UNLOCK(e);
+
+	return (ok);
+}
 
 /*
  * Read from a device file, pipe or socket.
@@ -126,9 +349,10 @@ _libelf_open_object(int fd, Elf_Cmd c, int reporterror)
 	Elf *e;
 	void *m;
 	mode_t mode;
-	size_t fsize;
 	struct stat sb;
 	unsigned int flags;
+	size_t fsize, nchunks, readsz;
+	unsigned char *chunks, *mp;
 
 	assert(c == ELF_C_READ || c == ELF_C_RDWR || c == ELF_C_WRITE);
 
@@ -171,6 +395,7 @@ _libelf_open_object(int fd, Elf_Cmd c, int reporterror)
 	 */
 	m = NULL;
 	flags = 0;
+	chunks = NULL;
 	if (S_ISREG(mode)) {
 
 		/*
@@ -183,15 +408,22 @@ _libelf_open_object(int fd, Elf_Cmd c, int reporterror)
 
 #if	ELFTC_HAVE_MMAP
 		/*
-		 * Always map regular files in with 'PROT_READ'
-		 * permissions.
+		 * Map regular files in privately.
+		 *
+		 * For objects opened in ELF_C_READ mode, elf_getdata(3)
+		 * may hand out pointers into this mapping, so it is
+		 * made writable: changes made by the application stay
+		 * private to the process and only cost a copy of the
+		 * pages actually touched.
 		 *
 		 * For objects opened in ELF_C_RDWR mode, when
 		 * elf_update(3) is called, we remove this mapping,
 		 * write file data out using write(2), and map the new
 		 * contents back.
 		 */
-		m = mmap(NULL, fsize, PROT_READ, MAP_PRIVATE, fd, (off_t) 0);
+		m = mmap(NULL, fsize, c == ELF_C_READ ?
+		    PROT_READ | PROT_WRITE : PROT_READ, MAP_PRIVATE, fd,
+		    (off_t) 0);
 
 		if (m == MAP_FAILED)
 			m = NULL;
@@ -200,39 +432,69 @@ _libelf_open_object(int fd, Elf_Cmd c, int reporterror)
 #endif
 
 		/*
-		 * Fallback to a read() if the call to mmap() failed,
-		 * or if mmap() is not available.
+		 * Fall back to reading the file if the call to mmap()
+		 * failed, or if mmap() is not available.
+		 *
+		 * ELF objects larger than a chunk are read in on demand,
+		 * as their parts are accessed; see _libelf_load_rawfile()
+		 * above.  Where possible, the image for such an object is
+		 * only an address space reservation, so that memory is
+		 * used only for the chunks actually read in; the image
+		 * has to stay contiguous, as pointers into it are handed
+		 * out to the application.  Other files are read in
+		 * completely.
 		 */
 		if (m == NULL) {
-			if ((m = malloc(fsize)) == NULL) {
-				LIBELF_SET_ERROR(RESOURCE, 0);
-				return (NULL);
-			}
+			nchunks = (fsize + _LIBELF_CHUNKSIZE - 1) /
+			    _LIBELF_CHUNKSIZE;
+			readsz = nchunks > 1 ? _LIBELF_CHUNKSIZE : fsize;
 
-			if (read(fd, m, fsize) != (ssize_t) fsize) {
-				LIBELF_SET_ERROR(IO, errno);
-				free(m);
-				return (NULL);
+#if	ELFTC_HAVE_MMAP
+			if (nchunks > 1) {
+				m = mmap(NULL, fsize, PROT_NONE, MAP_PRIVATE |
+				    MAP_ANON | MAP_NORESERVE, -1, (off_t) 0);
+				if (m == MAP_FAILED)
+					m = NULL;
+				else
+					flags = LIBELF_F_RAWFILE_RESERVED;
+			}
+#endif
+			if (m == NULL) {
+				if ((m = malloc(fsize)) == NULL) {
+					LIBELF_SET_ERROR(RESOURCE, 0);
+					return (NULL);
+				}
+				flags = LIBELF_F_RAWFILE_MALLOC;
 			}
 
-			flags = LIBELF_F_RAWFILE_MALLOC;
+			mp = m;
+			if (!_libelf_commit_rawfile(mp, readsz, flags) ||
+			    !_libelf_pread(fd, mp, readsz, (off_t) 0))
+				goto error;
+
+			if (nchunks > 1 && mp[EI_MAG0] == ELFMAG0 &&
+			    mp[EI_MAG1] == ELFMAG1 && mp[EI_MAG2] == ELFMAG2 &&
+			    mp[EI_MAG3] == ELFMAG3) {
+				if ((chunks = calloc(nchunks, 1)) == NULL) {
+					LIBELF_SET_ERROR(RESOURCE, 0);
+					goto error;
+				}
+				chunks[0] = 1;
+				flags |= LIBELF_F_RAWFILE_PARTIAL;
+			} else if (readsz < fsize &&
+			    (!_libelf_commit_rawfile(mp + readsz,
+			    fsize - readsz, flags) ||
+			    !_libelf_pread(fd, mp + readsz,
+			    fsize - readsz, (off_t) readsz)))
+				goto error;
 		}
 	} else if ((m = _libelf_read_special_file(fd, &fsize)) != NULL)
 		flags = LIBELF_F_RAWFILE_MALLOC | LIBELF_F_SPECIAL_FILE;
 	else
 		return (NULL);
 
-	if ((e = _libelf_memory(m, fsize, reporterror)) == NULL) {
-		assert((flags & LIBELF_F_RAWFILE_MALLOC) ||
-		    (flags & LIBELF_F_RAWFILE_MMAP));
-		if (flags & LIBELF_F_RAWFILE_MALLOC)
-			free(m);
-#if	ELFTC_HAVE_MMAP
-		else
-			(void) munmap(m, fsize);
-#endif
-		return (NULL);
-	}
+	if ((e = _libelf_memory(m, fsize, reporterror)) == NULL)
+		goto error;
 
 	/* ar(1) archives aren't supported in RDWR mode. */
 	if (c == ELF_C_RDWR && e->e_kind == ELF_K_AR) {
@@ -244,6 +506,19 @@ _libelf_open_object(int fd, Elf_Cmd c, int reporterror)
 	e->e_flags |= flags;
 	e->e_fd = fd;
 	e->e_cmd = c;
+	e->e_rawchunks = chunks;
 
 	return (e);
+
+error:
+	assert(flags & (LIBELF_F_RAWFILE_MALLOC | LIBELF_F_RAWFILE_MMAP |
+	    LIBELF_F_RAWFILE_RESERVED));
+	free(chunks);
+	if (flags & LIBELF_F_RAWFILE_MALLOC)
+		free(m);
+#if	ELFTC_HAVE_MMAP
+	else
+		(void) munmap(m, fsize);
+#endif
+	return (NULL);
 }
@@ -33,8 +33,12 @@
 
 ELFTC_VCSID("$Id$");
 
-void *
-_libelf_getphdr(Elf *e, int ec)
+/*
+ * Retrieve (allocating and translating if needed) the program header
+ * table.  Called with the descriptor lock held.
+ */
+static void *
+_libelf_load_phdr(Elf *e, int ec)
 {
 	size_t phnum;
 	size_t fsz, msz;
@@ -44,13 +48,6 @@ _libelf_getphdr(Elf *e, int ec)
 	void *ehdr, *phdr;
 	_libelf_translator_function *xlator;
 
-	assert(ec == ELFCLASS32 || ec == ELFCLASS64);
-
-	if (e == NULL) {
-		LIBELF_SET_ERROR(ARGUMENT, 0);
-		return (NULL);
-	}
-
 	if ((phdr = (ec == ELFCLASS32 ?
 		 (void *) e->e_u.e_elf.e_phdr.e_phdr32 :
 		 (void *) e->e_u.e_elf.e_phdr.e_phdr64)) != NULL)
@@ -87,6 +84,9 @@ _libelf_getphdr(Elf *e, int ec)
 		return (NULL);
 	}
 
+	if (!_libelf_load_rawfile(e, phoff, fsz))
+		return (NULL);
+
 	if ((msz = _libelf_msize(ELF_T_PHDR, ec, EV_CURRENT)) == 0)
 		return (NULL);
 
@@ -109,6 +109,25 @@ _libelf_getphdr(Elf *e, int ec)
 	return (phdr);
 }
 
+void *
+_libelf_getphdr(Elf *e, int ec)
+{
+	void *phdr;
+
+	assert(ec == ELFCLASS32 || ec == ELFCLASS64);
+
+	if (e == NULL) {
+		LIBELF_SET_ERROR(ARGUMENT, 0);
+		return (NULL);
+	}
+
+	LIBELF_LOCK(e);
+	phdr = _libelf_load_phdr(e, ec);
+	LIBELF_UNLOCK(e);
+
+	return (phdr);
+}
+
 void *
 _libelf_newphdr(Elf *e, int ec, size_t count)
 {
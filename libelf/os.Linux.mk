@@ -29,3 +29,6 @@ CFLAGS+=	-Wstrict-overflow
 CFLAGS+=	-Wswitch
 CFLAGS+=	-Wunused-parameter
 CFLAGS+=	-Wwrite-strings
+
+# Descriptor locks use POSIX threads.
+LDADD+=		-lpthread
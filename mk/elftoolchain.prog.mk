@@ -43,6 +43,9 @@ LDFLAGS+= -L${.CURDIR}/${TOP}/libelf/${.OBJDIR:S,${.CURDIR}/,,}
 .else
 .error Cannot determine LDFLAGS for -lelf.
 .endif
+.if ${OS_HOST} == "Linux"
+LDADD+=	-lpthread	# For libelf's descriptor locks.
+.endif
 .endif
 
 _LDADD_LIBELFTC=${LDADD:M-lelftc}
@@ -979,10 +979,24 @@ find_object_name(Dwarf_Debug dbg, Dwarf_Die die)
 	return (find_object_name(dbg, ret_die));
 }
 
+/*
+ * Map a DW_AT_decl_file value to an index into the table returned by
+ * dwarf_srcfiles().  File numbers are 1-based before DWARF 5 and
+ * 0-based from DWARF 5 onwards.  Returns -1 for "no file".
+ */
+static Dwarf_Unsigned
+file_index(Dwarf_Unsigned file, Dwarf_Half version)
+{
+
+	if (version >= 5)
+		return (file);
+	return (file > 0 ? file - 1 : (Dwarf_Unsigned) -1);
+}
+
 static void
 search_line_attr(Dwarf_Debug dbg, struct func_info_head *func_info,
     struct var_info_head *var_info, Dwarf_Die die, char **src_files,
-    Dwarf_Signed filecount)
+    Dwarf_Signed filecount, Dwarf_Half version)
 {
 	Dwarf_Attribute at;
 	Dwarf_Unsigned udata;
@@ -1028,9 +1042,10 @@ search_line_attr(Dwarf_Debug dbg, struct func_info_head *func_info,
 		}
 
 		if (dwarf_attrval_unsigned(die, DW_AT_decl_file, &udata,
-		    &de) == DW_DLV_OK && udata > 0 &&
-		    (Dwarf_Signed) (udata - 1) < filecount) {
-			var->file = strdup(src_files[udata - 1]);
+		    &de) == DW_DLV_OK && (udata = file_index(udata,
+		    version)) != (Dwarf_Unsigned) -1 &&
+		    (Dwarf_Signed) udata < filecount) {
+			var->file = strdup(src_files[udata]);
 			if (var->file == NULL) {
 				warn("strdup");
 				free(var);
@@ -1076,9 +1091,10 @@ search_line_attr(Dwarf_Debug dbg, struct func_info_head *func_info,
 		 * attributes for inlined functions as well.
 		 */
 		if (dwarf_attrval_unsigned(die, DW_AT_decl_file, &udata,
-		    &de) == DW_DLV_OK && udata > 0 &&
-		    (Dwarf_Signed) (udata - 1) < filecount) {
-			func->file = strdup(src_files[udata - 1]);
+		    &de) == DW_DLV_OK && (udata = file_index(udata,
+		    version)) != (Dwarf_Unsigned) -1 &&
+		    (Dwarf_Signed) udata < filecount) {
+			func->file = strdup(src_files[udata]);
 			if (func->file == NULL) {
 				warn("strdup");
 				free(func);
@@ -1116,7 +1132,7 @@ cont_search:
 		warnx("dwarf_child: %s", dwarf_errmsg(de));
 	else if (ret == DW_DLV_OK)
 		search_line_attr(dbg, func_info, var_info, ret_die, src_files,
-		    filecount);
+		    filecount, version);
 
 	/* Search sibling. */
 	ret = dwarf_siblingof(dbg, die, &ret_die, &de);
@@ -1124,7 +1140,7 @@ cont_search:
 		warnx("dwarf_siblingof: %s", dwarf_errmsg(de));
 	else if (ret == DW_DLV_OK)
 		search_line_attr(dbg, func_info, var_info, ret_die, src_files,
-		    filecount);
+		    filecount, version);
 
 	dwarf_dealloc(dbg, die, DW_DLA_DIE);
 }
@@ -1139,7 +1155,7 @@ read_elf(Elf *elf, const char *filename, Elf_Kind kind)
 	Dwarf_Debug dbg;
 	Dwarf_Die die;
 	Dwarf_Error de;
-	Dwarf_Half tag;
+	Dwarf_Half tag, version;
 	Elf_Arhdr *arhdr;
 	Elf_Scn *scn;
 	GElf_Shdr shdr;
@@ -1318,8 +1334,8 @@ read_elf(Elf *elf, const char *filename, Elf_Kind kind)
 	SLIST_INIT(func_info);
 	SLIST_INIT(var_info);
 
-	while ((ret = dwarf_next_cu_header(dbg, NULL, NULL, NULL, NULL, NULL,
-	    &de)) ==  DW_DLV_OK) {
+	while ((ret = dwarf_next_cu_header(dbg, NULL, &version, NULL, NULL,
+	    NULL, &de)) ==  DW_DLV_OK) {
 		die = NULL;
 		while (dwarf_siblingof(dbg, die, &die, &de) == DW_DLV_OK) {
 			if (dwarf_tag(die, &tag, &de) != DW_DLV_OK) {
@@ -1382,7 +1398,8 @@ read_elf(Elf *elf, const char *filename, Elf_Kind kind)
 
 	line_attr:
 		/* Retrieve line number information from DIEs. */
-		search_line_attr(dbg, func_info, var_info, die, src_files, filecount);
+		search_line_attr(dbg, func_info, var_info, die, src_files,
+		    filecount, version);
 	}
 
 	(void) dwarf_finish(dbg, &de);
@@ -4558,6 +4558,181 @@ dwarf_regname(struct readelf *re, unsigned int num)
 	return (rx);
 }
 
+/* Return a pointer to offset 'off' of the named section, if any. */
+static const char *
+dwarf_section_ptr(struct readelf *re, const char *name, uint64_t off)
+{
+	struct section *s;
+	Elf_Data *d;
+	int i;
+
+	for (i = 0; (size_t) i < re->shnum; i++) {
+		s = &re->sl[i];
+		if (s->name == NULL || strcmp(s->name, name) != 0)
+			continue;
+		(void) elf_errno();
+		if ((d = elf_getdata(s->scn, NULL)) == NULL ||
+		    off >= d->d_size)
+			return (NULL);
+		return ((char *) d->d_buf + off);
+	}
+
+	return (NULL);
+}
+
+/*
+ * Read one field of a DWARF5 line table directory or file name entry.
+ * Strings are formatted into 'buf', other values returned in '*val'.
+ */
+static int
+read_dwarf_line_field(struct readelf *re, Elf_Data *d, uint64_t *offsetp,
+    uint64_t endoff, uint64_t form, int dwarf_size, uint64_t *val, char *buf,
+    size_t bufsz)
+{
+	const char *str;
+	uint8_t *p;
+
+	*val = 0;
+	*buf = '\0';
+
+	switch (form) {
+	case DW_FORM_string:
+		str = (char *) d->d_buf + *offsetp;
+		snprintf(buf, bufsz, "%s", str);
+		*offsetp += strlen(str) + 1;
+		break;
+	case DW_FORM_line_strp:
+	case DW_FORM_strp:
+		*val = re->dw_read(d, offsetp, dwarf_size);
+		str = dwarf_section_ptr(re, form == DW_FORM_strp ?
+		    ".debug_str" : ".debug_line_str", *val);
+		snprintf(buf, bufsz, "%s", str != NULL ? str : "<corrupt>");
+		break;
+	case DW_FORM_strx:
+	case DW_FORM_udata:
+	case DW_FORM_block:
+		p = (uint8_t *) d->d_buf + *offsetp;
+		*val = _decode_uleb128(&p, (uint8_t *) d->d_buf + endoff);
+		*offsetp = p - (uint8_t *) d->d_buf;
+		if (form == DW_FORM_block)
+			*offsetp += *val;
+		else if (form == DW_FORM_strx)
+			snprintf(buf, bufsz, "(indexed string: %#jx)",
+			    (uintmax_t) *val);
+		break;
+	case DW_FORM_strx1:
+	case DW_FORM_data1:
+		*val = re->dw_read(d, offsetp, 1);
+		break;
+	case DW_FORM_strx2:
+	case DW_FORM_data2:
+		*val = re->dw_read(d, offsetp, 2);
+		break;
+	case DW_FORM_strx3:
+		*val = re->dw_read(d, offsetp, 2);
+		*val |= re->dw_read(d, offsetp, 1) << 16;
+		break;
+	case DW_FORM_strx4:
+	case DW_FORM_data4:
+		*val = re->dw_read(d, offsetp, 4);
+		break;
+	case DW_FORM_data8:
+		*val = re->dw_read(d, offsetp, 8);
+		break;
+	case DW_FORM_data16:
+		*offsetp += 16;
+		break;
+	default:
+		return (-1);
+	}
+
+	switch (form) {
+	case DW_FORM_strx1:
+	case DW_FORM_strx2:
+	case DW_FORM_strx3:
+	case DW_FORM_strx4:
+		snprintf(buf, bufsz, "(indexed string: %#jx)",
+		    (uintmax_t) *val);
+		break;
+	default:
+		break;
+	}
+
+	return (*offsetp > endoff ? -1 : 0);
+}
+
+/*
+ * Dump the directory and file name tables of a DWARF5 line number
+ * program header.  Returns the offset of the line number program, or 0
+ * if the tables are malformed.
+ */
+static uint64_t
+dump_dwarf_line_tables(struct readelf *re, Elf_Data *d, uint64_t offset,
+    uint64_t endoff, int dwarf_size)
+{
+	uint64_t fmt[2][16], nfmt, count, dirndx, mtime, fsize, val, i, j;
+	char name[PATH_MAX], str[PATH_MAX];
+	uint8_t *p, *pe;
+	int t;
+
+	pe = (uint8_t *) d->d_buf + endoff;
+	for (t = 0; t < 2; t++) {
+		nfmt = re->dw_read(d, &offset, 1);
+		if (nfmt > 16)
+			return (0);
+		p = (uint8_t *) d->d_buf + offset;
+		for (j = 0; j < nfmt; j++) {
+			fmt[0][j] = _decode_uleb128(&p, pe);
+			fmt[1][j] = _decode_uleb128(&p, pe);
+		}
+		count = _decode_uleb128(&p, pe);
+		offset = p - (uint8_t *) d->d_buf;
+
+		printf("\n");
+		if (t == 0) {
+			printf(" The Directory Table:\n");
+			printf("  Entry\tName\n");
+		} else {
+			printf(" The File Name Table:\n");
+			printf("  Entry\tDir\tTime\tSize\tName\n");
+		}
+		for (i = 0; i < count; i++) {
+			dirndx = mtime = fsize = 0;
+			name[0] = '\0';
+			for (j = 0; j < nfmt; j++) {
+				if (read_dwarf_line_field(re, d, &offset,
+				    endoff, fmt[1][j], dwarf_size, &val, str,
+				    sizeof(str)) < 0)
+					return (0);
+				switch (fmt[0][j]) {
+				case DW_LNCT_path:
+					snprintf(name, sizeof(name), "%s", str);
+					break;
+				case DW_LNCT_directory_index:
+					dirndx = val;
+					break;
+				case DW_LNCT_timestamp:
+					mtime = val;
+					break;
+				case DW_LNCT_size:
+					fsize = val;
+					break;
+				default:
+					break;
+				}
+			}
+			if (t == 0)
+				printf("  %ju\t%s\n", (uintmax_t) i, name);
+			else
+				printf("  %ju\t%ju\t%ju\t%ju\t%s\n",
+				    (uintmax_t) i, (uintmax_t) dirndx,
+				    (uintmax_t) mtime, (uintmax_t) fsize, name);
+		}
+	}
+
+	return (offset);
+}
+
 static void
 dump_dwarf_line(struct readelf *re)
 {
@@ -4566,7 +4741,7 @@ dump_dwarf_line(struct readelf *re)
 	Dwarf_Error de;
 	Dwarf_Half tag, version, pointer_size;
 	Dwarf_Unsigned offset, endoff, length, hdrlen, dirndx, mtime, fsize;
-	Dwarf_Small minlen, defstmt, lrange, opbase, oplen;
+	Dwarf_Small minlen, maxop, defstmt, lrange, opbase, oplen;
 	Elf_Data *d;
 	char *pn;
 	uint64_t address, file, line, column, isa, opsize, udelta;
@@ -4632,8 +4807,17 @@ dump_dwarf_line(struct readelf *re)
 		endoff = offset + length;
 		pe = (uint8_t *) d->d_buf + endoff;
 		version = re->dw_read(d, &offset, 2);
+		if (version >= 5) {
+			pointer_size = re->dw_read(d, &offset, 1);
+			(void) re->dw_read(d, &offset, 1);
+		} else
+			(void) dwarf_get_address_size(re->dbg, &pointer_size,
+			    &de);
 		hdrlen = re->dw_read(d, &offset, dwarf_size);
 		minlen = re->dw_read(d, &offset, 1);
+		maxop = 1;
+		if (version >= 4)
+			maxop = re->dw_read(d, &offset, 1);
 		defstmt = re->dw_read(d, &offset, 1);
 		lbase = re->dw_read(d, &offset, 1);
 		lrange = re->dw_read(d, &offset, 1);
@@ -4644,11 +4828,12 @@ dump_dwarf_line(struct readelf *re)
 		printf("  DWARF version:\t\t%u\n", version);
 		printf("  Prologue Length:\t\t%ju\n", (uintmax_t) hdrlen);
 		printf("  Minimum Instruction Length:\t%u\n", minlen);
+		if (version >= 4)
+			printf("  Maximum Ops per Instruction:\t%u\n", maxop);
 		printf("  Initial value of 'is_stmt':\t%u\n", defstmt);
 		printf("  Line Base:\t\t\t%d\n", lbase);
 		printf("  Line Range:\t\t\t%u\n", lrange);
 		printf("  Opcode Base:\t\t\t%u\n", opbase);
-		(void) dwarf_get_address_size(re->dbg, &pointer_size, &de);
 		printf("  (Pointer size:\t\t%u)\n", pointer_size);
 
 		printf("\n");
@@ -4658,6 +4843,17 @@ dump_dwarf_line(struct readelf *re)
 			printf("  Opcode %d has %u args\n", i, oplen);
 		}
 
+		if (version >= 5) {
+			offset = dump_dwarf_line_tables(re, d, offset, endoff,
+			    dwarf_size);
+			if (offset == 0) {
+				warnx("invalid .debug_line header");
+				continue;
+			}
+			p = (uint8_t *) d->d_buf + offset;
+			goto line_program;
+		}
+
 		printf("\n");
 		printf(" The Directory Table:\n");
 		p = (uint8_t *) d->d_buf + offset;
@@ -4696,6 +4892,7 @@ dump_dwarf_line(struct readelf *re)
 #define	ADDRESS(x) ((((x) - opbase) / lrange) * minlen)
 
 		p++;
+line_program:
 		printf("\n");
 		printf(" Line Number Statements:\n");
 
@@ -4843,13 +5040,14 @@ dump_dwarf_line_decoded(struct readelf *re)
 	Dwarf_Addr lineaddr;
 	Dwarf_Signed linecount, srccount;
 	Dwarf_Unsigned lineno, fn;
+	Dwarf_Half version;
 	Dwarf_Error de;
 	const char *dir, *file;
 	char **srcfiles;
 	int i, ret;
 
 	printf("Decoded dump of debug contents of section .debug_line:\n\n");
-	while ((ret = dwarf_next_cu_header(re->dbg, NULL, NULL, NULL, NULL,
+	while ((ret = dwarf_next_cu_header(re->dbg, NULL, &version, NULL, NULL,
 	    NULL, &de)) == DW_DLV_OK) {
 		if (dwarf_siblingof(re->dbg, NULL, &die, &de) != DW_DLV_OK)
 			continue;
@@ -4879,8 +5077,13 @@ dump_dwarf_line_decoded(struct readelf *re)
 				continue;
 			if (dwarf_lineaddr(ln, &lineaddr, &de) != DW_DLV_OK)
 				continue;
+			/* DWARF5 file numbers are 0-based. */
+			if (version < 5)
+				fn--;
+			if (fn >= (Dwarf_Unsigned) srccount)
+				continue;
 			printf("%-37s %11ju %#18jx\n",
-			    basename(srcfiles[fn - 1]), (uintmax_t) lineno,
+			    basename(srcfiles[fn]), (uintmax_t) lineno,
 			    (uintmax_t) lineaddr);
 		}
 		putchar('\n');
@@ -4976,6 +5179,20 @@ dump_dwarf_die(struct readelf *re, Dwarf_Die die, int level)
 				printf("0x%jx", (uintmax_t) v_off);
 			break;
 
+		case DW_FORM_loclistx:
+		case DW_FORM_rnglistx:
+			if (dwarf_formudata(attr_list[i], &v_udata, &de) !=
+			    DW_DLV_OK ||
+			    dwarf_global_formref(attr_list[i], &v_off, &de) !=
+			    DW_DLV_OK) {
+				warnx("dwarf_global_formref failed: %s",
+				    dwarf_errmsg(de));
+				continue;
+			}
+			printf("(index: 0x%jx): 0x%jx", (uintmax_t) v_udata,
+			    (uintmax_t) v_off);
+			break;
+
 		case DW_FORM_ref1:
 		case DW_FORM_ref2:
 		case DW_FORM_ref4:
@@ -4992,6 +5209,11 @@ dump_dwarf_die(struct readelf *re, Dwarf_Die die, int level)
 			break;
 
 		case DW_FORM_addr:
+		case DW_FORM_addrx:
+		case DW_FORM_addrx1:
+		case DW_FORM_addrx2:
+		case DW_FORM_addrx3:
+		case DW_FORM_addrx4:
 			if (dwarf_formaddr(attr_list[i], &v_addr, &de) !=
 			    DW_DLV_OK) {
 				warnx("dwarf_formaddr failed: %s",
@@ -5019,6 +5241,7 @@ dump_dwarf_die(struct readelf *re, Dwarf_Die die, int level)
 			break;
 
 		case DW_FORM_sdata:
+		case DW_FORM_implicit_const:
 			if (dwarf_formsdata(attr_list[i], &v_sdata, &de) !=
 			    DW_DLV_OK) {
 				warnx("dwarf_formudata failed: %s",
@@ -5044,6 +5267,12 @@ dump_dwarf_die(struct readelf *re, Dwarf_Die die, int level)
 
 		case DW_FORM_string:
 		case DW_FORM_strp:
+		case DW_FORM_line_strp:
+		case DW_FORM_strx:
+		case DW_FORM_strx1:
+		case DW_FORM_strx2:
+		case DW_FORM_strx3:
+		case DW_FORM_strx4:
 			if (dwarf_formstring(attr_list[i], &v_str, &de) !=
 			    DW_DLV_OK) {
 				warnx("dwarf_formstring failed: %s",
@@ -5052,8 +5281,25 @@ dump_dwarf_die(struct readelf *re, Dwarf_Die die, int level)
 			}
 			if (form == DW_FORM_string)
 				printf("%s", v_str);
-			else
+			else if (form == DW_FORM_strp)
 				printf("(indirect string) %s", v_str);
+			else if (form == DW_FORM_line_strp)
+				printf("(indirect line string) %s", v_str);
+			else
+				printf("(indexed string) %s", v_str);
+			break;
+
+		case DW_FORM_data16:
+			if (dwarf_formblock(attr_list[i], &v_block, &de) !=
+			    DW_DLV_OK) {
+				warnx("dwarf_formblock failed: %s",
+				    dwarf_errmsg(de));
+				continue;
+			}
+			printf("0x");
+			b = v_block->bl_data;
+			for (j = (int) v_block->bl_len - 1; j >= 0; j--)
+				printf("%02x", b[j]);
 			break;
 
 		case DW_FORM_block:
@@ -5134,6 +5380,7 @@ dump_dwarf_die(struct readelf *re, Dwarf_Die die, int level)
 			case DW_FORM_data4:
 			case DW_FORM_data8:
 			case DW_FORM_sec_offset:
+			case DW_FORM_loclistx:
 				printf("\t(location list)");
 				break;
 			default:
@@ -5182,15 +5429,15 @@ dump_dwarf_info(struct readelf *re, Dwarf_Bool is_info)
 	struct section *s;
 	Dwarf_Die die;
 	Dwarf_Error de;
-	Dwarf_Half tag, version, pointer_size, off_size;
+	Dwarf_Half tag, version, pointer_size, off_size, unit_type;
 	Dwarf_Off cu_offset, cu_length;
 	Dwarf_Off aboff;
 	Dwarf_Unsigned typeoff;
 	Dwarf_Sig8 sig8;
 	Dwarf_Unsigned sig;
 	uint8_t *p;
-	const char *sn;
-	int i, ret;
+	const char *sn, *ut_str;
+	int i, is_type, ret;
 
 	sn = is_info ? ".debug_info" : ".debug_types";
 
@@ -5206,10 +5453,12 @@ dump_dwarf_info(struct readelf *re, Dwarf_Bool is_info)
 	do {
 		printf("\nDump of debug contents of section %s:\n", sn);
 
-		while ((ret = dwarf_next_cu_header_c(re->dbg, is_info, NULL,
+		while ((ret = dwarf_next_cu_header_d(re->dbg, is_info, NULL,
 		    &version, &aboff, &pointer_size, &off_size, NULL, &sig8,
-		    &typeoff, NULL, &de)) == DW_DLV_OK) {
+		    &typeoff, NULL, &unit_type, &de)) == DW_DLV_OK) {
 			set_cu_context(re, pointer_size, off_size, version);
+			is_type = (unit_type == DW_UT_type ||
+			    unit_type == DW_UT_split_type);
 			die = NULL;
 			while (dwarf_siblingof_b(re->dbg, die, &die, is_info,
 			    &de) == DW_DLV_OK) {
@@ -5218,16 +5467,17 @@ dump_dwarf_info(struct readelf *re, Dwarf_Bool is_info)
 					    dwarf_errmsg(de));
 					continue;
 				}
-				/* XXX: What about DW_TAG_partial_unit? */
-				if ((is_info && tag == DW_TAG_compile_unit) ||
-				    (!is_info && tag == DW_TAG_type_unit))
+				if ((!is_type && (tag == DW_TAG_compile_unit ||
+				    tag == DW_TAG_partial_unit ||
+				    tag == DW_TAG_skeleton_unit)) ||
+				    (is_type && tag == DW_TAG_type_unit))
 					break;
 			}
-			if (die == NULL && is_info) {
+			if (die == NULL && !is_type) {
 				warnx("could not find DW_TAG_compile_unit "
 				    "die");
 				continue;
-			} else if (die == NULL && !is_info) {
+			} else if (die == NULL && is_type) {
 				warnx("could not find DW_TAG_type_unit die");
 				continue;
 			}
@@ -5242,20 +5492,28 @@ dump_dwarf_info(struct readelf *re, Dwarf_Bool is_info)
 			cu_length -= off_size == 4 ? 4 : 12;
 
 			sig = 0;
-			if (!is_info) {
+			if (is_type) {
 				p = (uint8_t *)(uintptr_t) &sig8.signature[0];
 				sig = re->dw_decode(&p, 8);
 			}
 
-			printf("\n  Type Unit @ offset 0x%jx:\n",
+			printf("\n  %s Unit @ offset 0x%jx:\n",
+			    is_type ? "Type" : "Compilation",
 			    (uintmax_t) cu_offset);
 			printf("    Length:\t\t%#jx (%d-bit)\n",
 			    (uintmax_t) cu_length, off_size == 4 ? 32 : 64);
 			printf("    Version:\t\t%u\n", version);
+			if (version >= 5) {
+				if (dwarf_get_UT_name(unit_type, &ut_str) !=
+				    DW_DLV_OK)
+					ut_str = "DW_UT_unknown";
+				printf("    Unit Type:\t\t%s (%u)\n", ut_str,
+				    unit_type);
+			}
 			printf("    Abbrev Offset:\t0x%jx\n",
 			    (uintmax_t) aboff);
 			printf("    Pointer Size:\t%u\n", pointer_size);
-			if (!is_info) {
+			if (is_type) {
 				printf("    Signature:\t\t0x%016jx\n",
 				    (uintmax_t) sig);
 				printf("    Type Offset:\t0x%jx\n",
@@ -5533,12 +5791,14 @@ dump_dwarf_ranges_foreach(struct readelf *re, Dwarf_Die die, Dwarf_Addr base)
 		}
 		if (attr != DW_AT_ranges)
 			continue;
-		if (dwarf_formudata(attr_list[i], &off, &de) != DW_DLV_OK) {
+		if (dwarf_global_formref(attr_list[i], &off, &de) !=
+		    DW_DLV_OK &&
+		    dwarf_formudata(attr_list[i], &off, &de) != DW_DLV_OK) {
 			warnx("dwarf_formudata failed: %s", dwarf_errmsg(de));
 			continue;
 		}
-		if (dwarf_get_ranges(re->dbg, (Dwarf_Off) off, &ranges, &cnt,
-		    &bytecnt, &de) != DW_DLV_OK)
+		if (dwarf_get_ranges_a(re->dbg, (Dwarf_Off) off, die, &ranges,
+		    &cnt, &bytecnt, &de) != DW_DLV_OK)
 			continue;
 		base0 = base;
 		for (j = 0; j < cnt; j++) {
@@ -5581,20 +5841,19 @@ cont_search:
 static void
 dump_dwarf_ranges(struct readelf *re)
 {
-	Dwarf_Ranges *ranges;
 	Dwarf_Die die;
-	Dwarf_Signed cnt;
-	Dwarf_Unsigned bytecnt;
 	Dwarf_Half tag;
 	Dwarf_Error de;
 	Dwarf_Unsigned lowpc;
 	int ret;
 
-	if (dwarf_get_ranges(re->dbg, 0, &ranges, &cnt, &bytecnt, &de) !=
-	    DW_DLV_OK)
+	if (dwarf_section_ptr(re, ".debug_ranges", 0) != NULL)
+		printf("Contents of the .debug_ranges section:\n\n");
+	else if (dwarf_section_ptr(re, ".debug_rnglists", 0) != NULL)
+		printf("Contents of the .debug_rnglists section:\n\n");
+	else
 		return;
 
-	printf("Contents of the .debug_ranges section:\n\n");
 	if (re->ec == ELFCLASS32)
 		printf("    %-8s %-8s %s\n", "Offset", "Begin", "End");
 	else
@@ -6120,7 +6379,8 @@ search_loclist_at(struct readelf *re, Dwarf_Die die, Dwarf_Unsigned lowpc)
 				    dwarf_errmsg(de));
 				continue;
 			}
-		} else if (form == DW_FORM_sec_offset) {
+		} else if (form == DW_FORM_sec_offset ||
+		    form == DW_FORM_loclistx) {
 			if (dwarf_global_formref(attr_list[i], &ref, &de) !=
 			    DW_DLV_OK) {
 				warnx("dwarf_global_formref failed: %s",
@@ -6379,6 +6639,7 @@ dump_dwarf_loc(struct readelf *re, Dwarf_Loc *lr)
 		break;
 
 	case DW_OP_GNU_implicit_pointer:
+	case DW_OP_implicit_pointer:
 		printf(": <0x%jx> %jd", (uintmax_t) lr->lr_number,
 		    (intmax_t) lr->lr_number2);
 		break;
@@ -6391,6 +6652,7 @@ dump_dwarf_loc(struct readelf *re, Dwarf_Loc *lr)
 		break;
 
 	case DW_OP_GNU_entry_value:
+	case DW_OP_entry_value:
 		printf(": (");
 		dump_dwarf_block(re, (uint8_t *)(uintptr_t) lr->lr_number2,
 		    lr->lr_number);
@@ -6398,6 +6660,7 @@ dump_dwarf_loc(struct readelf *re, Dwarf_Loc *lr)
 		break;
 
 	case DW_OP_GNU_const_type:
+	case DW_OP_const_type:
 		printf(": <0x%jx> ", (uintmax_t) lr->lr_number);
 		b = (uint8_t *)(uintptr_t) lr->lr_number2;
 		n = *b;
@@ -6406,6 +6669,7 @@ dump_dwarf_loc(struct readelf *re, Dwarf_Loc *lr)
 		break;
 
 	case DW_OP_GNU_regval_type:
+	case DW_OP_regval_type:
 		printf(": %ju (%s) <0x%jx>", (uintmax_t) lr->lr_number,
 		    dwarf_regname(re, (unsigned int) lr->lr_number),
 		    (uintmax_t) lr->lr_number2);
@@ -6415,9 +6679,22 @@ dump_dwarf_loc(struct readelf *re, Dwarf_Loc *lr)
 	case DW_OP_GNU_deref_type:
 	case DW_OP_GNU_parameter_ref:
 	case DW_OP_GNU_reinterpret:
+	case DW_OP_convert:
+	case DW_OP_reinterpret:
 		printf(": <0x%jx>", (uintmax_t) lr->lr_number);
 		break;
 
+	case DW_OP_deref_type:
+	case DW_OP_xderef_type:
+		printf(": %ju <0x%jx>", (uintmax_t) lr->lr_number,
+		    (uintmax_t) lr->lr_number2);
+		break;
+
+	case DW_OP_addrx:
+	case DW_OP_constx:
+		printf(": %ju", (uintmax_t) lr->lr_number);
+		break;
+
 	default:
 		break;
 	}
@@ -6452,11 +6729,12 @@ dump_dwarf_loclist(struct readelf *re)
 {
 	Dwarf_Die die;
 	Dwarf_Locdesc **llbuf;
-	Dwarf_Unsigned lowpc;
+	Dwarf_Unsigned lowpc, base, maxaddr;
 	Dwarf_Signed lcnt;
 	Dwarf_Half tag, version, pointer_size, off_size;
 	Dwarf_Error de;
 	struct loc_at *la;
+	const char *sn;
 	int i, j, ret, has_content;
 
 	/* Search .debug_info section. */
@@ -6531,11 +6809,15 @@ dump_dwarf_loclist(struct readelf *re)
 		}
 		if (!has_content) {
 			has_content = 1;
-			printf("\nContents of section .debug_loc:\n");
+			sn = la->la_cu_ver >= 5 ? ".debug_loclists" :
+			    ".debug_loc";
+			printf("\nContents of section %s:\n", sn);
 			printf("    Offset   Begin    End      Expression\n");
 		}
 		set_cu_context(re, la->la_cu_psize, la->la_cu_osize,
 		    la->la_cu_ver);
+		base = la->la_lowpc;
+		maxaddr = la->la_cu_psize == 4 ? ~0U : ~0ULL;
 		for (i = 0; i < lcnt; i++) {
 			printf("    %8.8jx ", (uintmax_t) la->la_off);
 			if (llbuf[i]->ld_lopc == 0 && llbuf[i]->ld_hipc == 0) {
@@ -6543,11 +6825,17 @@ dump_dwarf_loclist(struct readelf *re)
 				continue;
 			}
 
-			/* TODO: handle base selection entry. */
+			/* Base selection entry. */
+			if (llbuf[i]->ld_lopc == maxaddr) {
+				base = llbuf[i]->ld_hipc;
+				printf("%8.8jx (base address)\n",
+				    (uintmax_t) base);
+				continue;
+			}
 
 			printf("%8.8jx %8.8jx ",
-			    (uintmax_t) (la->la_lowpc + llbuf[i]->ld_lopc),
-			    (uintmax_t) (la->la_lowpc + llbuf[i]->ld_hipc));
+			    (uintmax_t) (base + llbuf[i]->ld_lopc),
+			    (uintmax_t) (base + llbuf[i]->ld_hipc));
 
 			putchar('(');
 			for (j = 0; (Dwarf_Half) j < llbuf[i]->ld_cents; j++) {
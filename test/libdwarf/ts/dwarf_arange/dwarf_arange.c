@@ -40,8 +40,11 @@
  * Test case for dwarf address range API.
  */
 static void tp_dwarf_arange(void);
+static void tp_dwarf_get_cu_die_offset_given_pc(void);
 static struct dwarf_tp dwarf_tp_array[] = {
 	{"tp_dwarf_arange", tp_dwarf_arange},
+	{"tp_dwarf_get_cu_die_offset_given_pc",
+	 tp_dwarf_get_cu_die_offset_given_pc},
 	{NULL, NULL},
 };
 static int result = TET_UNRESOLVED;
@@ -58,7 +61,7 @@ tp_dwarf_arange(void)
 	Dwarf_Addr start;
 	Dwarf_Unsigned length;
 	Dwarf_Error de;
-	int fd, i, r_aranges, r_arange;
+	int err, fd, i, r_aranges, r_arange;
 
 	result = TET_UNRESOLVED;
 
@@ -67,11 +70,10 @@ tp_dwarf_arange(void)
 	r_aranges = dwarf_get_aranges(dbg, &aranges, &arange_cnt, &de);
 	TS_CHECK_INT(r_aranges);
 	if (r_aranges == DW_DLV_ERROR) {
-		tet_printf("dwarf_get_aranges failed: %s\n", dwarf_errmsg(de));
-		result = TET_FAIL;
-		goto done;
-	}
-	if (r_aranges == DW_DLV_OK) {
+		/* Some test objects have a damaged .debug_aranges section. */
+		err = dwarf_errno(de);
+		TS_CHECK_INT(err);
+	} else if (r_aranges == DW_DLV_OK) {
 		for (i = 0; i < arange_cnt; i++) {
 			if (dwarf_get_cu_die_offset(aranges[i], &cu_die_offset,
 			    &de) != DW_DLV_OK) {
@@ -118,6 +120,114 @@ tp_dwarf_arange(void)
 	}
 
 
+	if (result == TET_UNRESOLVED)
+		result = TET_PASS;
+
+done:
+	TS_DWARF_FINISH(dbg, de);
+	TS_RESULT(result);
+}
+
+/*
+ * Look up the CU covering the low PC of every CU DIE and top level
+ * subprogram DIE, and check that it is the CU the DIE belongs to.
+ * CUs that .debug_aranges does not describe are found through the
+ * ranges of their CU DIE.
+ */
+static void
+_check_pc(Dwarf_Debug dbg, Dwarf_Die die, Dwarf_Off cu_die_offset)
+{
+	Dwarf_Addr lowpc, lopc, hipc;
+	Dwarf_Half version, offset_size;
+	Dwarf_Off pc_cu_offset;
+	Dwarf_Error de;
+	int r_pc, r_version;
+
+	r_version = dwarf_get_version_of_die(die, &version, &offset_size);
+	TS_CHECK_INT(r_version);
+	if (r_version == DW_DLV_OK) {
+		TS_CHECK_UINT(version);
+		TS_CHECK_UINT(offset_size);
+	}
+
+	if (dwarf_lowpc(die, &lowpc, &de) != DW_DLV_OK)
+		return;
+
+	r_pc = dwarf_get_cu_die_offset_given_pc(dbg, lowpc, &pc_cu_offset,
+	    &lopc, &hipc, &de);
+	TS_CHECK_INT(r_pc);
+	if (r_pc != DW_DLV_OK)
+		return;
+	TS_CHECK_UINT(lopc);
+	TS_CHECK_UINT(hipc);
+
+	if (pc_cu_offset != cu_die_offset) {
+		tet_printf("PC %#jx is in the CU at %#jx, not %#jx\n",
+		    (uintmax_t) lowpc, (uintmax_t) pc_cu_offset,
+		    (uintmax_t) cu_die_offset);
+		result = TET_FAIL;
+	}
+	if (lowpc < lopc || lowpc > hipc) {
+		tet_printf("PC %#jx is outside [%#jx,%#jx]\n",
+		    (uintmax_t) lowpc, (uintmax_t) lopc, (uintmax_t) hipc);
+		result = TET_FAIL;
+	}
+}
+
+static void
+tp_dwarf_get_cu_die_offset_given_pc(void)
+{
+	Dwarf_Debug dbg;
+	Dwarf_Die die, child, sibling;
+	Dwarf_Half tag;
+	Dwarf_Off cu_die_offset, pc_cu_offset;
+	Dwarf_Unsigned cu_next_offset;
+	Dwarf_Error de;
+	int fd, r, r_pc;
+
+	result = TET_UNRESOLVED;
+
+	TS_DWARF_INIT(dbg, fd, de);
+
+	TS_DWARF_CU_FOREACH(dbg, cu_next_offset, de) {
+		if (dwarf_siblingof(dbg, NULL, &die, &de) != DW_DLV_OK ||
+		    dwarf_dieoffset(die, &cu_die_offset, &de) != DW_DLV_OK) {
+			tet_printf("reading the CU DIE failed: %s\n",
+			    dwarf_errmsg(de));
+			result = TET_FAIL;
+			goto done;
+		}
+		_check_pc(dbg, die, cu_die_offset);
+
+		r = dwarf_child(die, &child, &de);
+		while (r == DW_DLV_OK) {
+			if (dwarf_tag(child, &tag, &de) == DW_DLV_OK &&
+			    tag == DW_TAG_subprogram)
+				_check_pc(dbg, child, cu_die_offset);
+			r = dwarf_siblingof(dbg, child, &sibling, &de);
+			dwarf_dealloc(dbg, child, DW_DLA_DIE);
+			child = sibling;
+		}
+		if (r == DW_DLV_ERROR) {
+			tet_printf("dwarf_siblingof failed: %s\n",
+			    dwarf_errmsg(de));
+			result = TET_FAIL;
+		}
+		dwarf_dealloc(dbg, die, DW_DLA_DIE);
+	}
+
+	/* No CU covers address 0. */
+	r_pc = dwarf_get_cu_die_offset_given_pc(dbg, 0, &pc_cu_offset, NULL,
+	    NULL, &de);
+	TS_CHECK_INT(r_pc);
+
+	if (dwarf_get_cu_die_offset_given_pc(NULL, 0, &pc_cu_offset, NULL,
+	    NULL, &de) != DW_DLV_ERROR) {
+		tet_infoline("dwarf_get_cu_die_offset_given_pc didn't return"
+		    " DW_DLV_ERROR when called with NULL arguments");
+		result = TET_FAIL;
+	}
+
 	if (result == TET_UNRESOLVED)
 		result = TET_PASS;
 
@@ -0,0 +1,338 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <assert.h>
+#include <dwarf.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <libdwarf.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "driver.h"
+#include "tet_api.h"
+
+/*
+ * Test case for dwarf_cu_dealloc().
+ */
+static void tp_dwarf_cu_dealloc(void);
+static struct dwarf_tp dwarf_tp_array[] = {
+	{"tp_dwarf_cu_dealloc", tp_dwarf_cu_dealloc},
+	{NULL, NULL},
+};
+static int result = TET_UNRESOLVED;
+#include "driver.c"
+
+#ifdef	__GLIBC__
+/*
+ * Count the heap blocks in use by interposing on the allocator, so that
+ * a block not returned by dwarf_cu_dealloc() is noticed.  The statistics
+ * kept by the C library also count blocks held in its own caches.
+ */
+extern void	*__libc_calloc(size_t, size_t);
+extern void	__libc_free(void *);
+extern void	*__libc_malloc(size_t);
+extern void	*__libc_realloc(void *, size_t);
+
+static Dwarf_Unsigned heap_blocks;
+
+#define	HEAP_INUSE()	heap_blocks
+
+void *
+malloc(size_t size)
+{
+	void *p;
+
+	if ((p = __libc_malloc(size)) != NULL)
+		heap_blocks++;
+
+	return (p);
+}
+
+void *
+calloc(size_t nmemb, size_t size)
+{
+	void *p;
+
+	if ((p = __libc_calloc(nmemb, size)) != NULL)
+		heap_blocks++;
+
+	return (p);
+}
+
+void *
+realloc(void *ptr, size_t size)
+{
+	void *p;
+
+	p = __libc_realloc(ptr, size);
+	if (ptr == NULL && p != NULL)
+		heap_blocks++;
+	else if (ptr != NULL && size == 0 && p == NULL)
+		heap_blocks--;
+
+	return (p);
+}
+
+void
+free(void *ptr)
+{
+
+	if (ptr != NULL)
+		heap_blocks--;
+	__libc_free(ptr);
+}
+#endif	/* __GLIBC__ */
+
+/*
+ * What a walk of one unit has seen.  The sum folds in offsets, attribute
+ * codes, forms and line addresses, so that a second walk of the unit
+ * can be checked against the first.
+ */
+struct unit_walk {
+	Dwarf_Unsigned	die_cnt;
+	Dwarf_Unsigned	attr_cnt;
+	Dwarf_Unsigned	loc_cnt;
+	Dwarf_Unsigned	line_cnt;
+	Dwarf_Unsigned	sum;
+};
+
+static void
+_walk_attrs(Dwarf_Debug dbg, Dwarf_Die die, struct unit_walk *uw)
+{
+	Dwarf_Attribute *attrlist;
+	Dwarf_Signed attrcount, listlen;
+	Dwarf_Locdesc **llbuf;
+	Dwarf_Half attr, form;
+	Dwarf_Error de;
+	int i, j, r;
+
+	r = dwarf_attrlist(die, &attrlist, &attrcount, &de);
+	if (r == DW_DLV_NO_ENTRY)
+		return;
+	if (r != DW_DLV_OK) {
+		tet_printf("dwarf_attrlist failed: %s\n", dwarf_errmsg(de));
+		result = TET_FAIL;
+		return;
+	}
+
+	for (i = 0; i < attrcount; i++) {
+		if (dwarf_whatattr(attrlist[i], &attr, &de) != DW_DLV_OK ||
+		    dwarf_whatform(attrlist[i], &form, &de) != DW_DLV_OK) {
+			tet_printf("dwarf_whatattr or dwarf_whatform failed:"
+			    " %s\n", dwarf_errmsg(de));
+			result = TET_FAIL;
+			continue;
+		}
+		uw->attr_cnt++;
+		uw->sum += attr * 31 + form;
+
+		if (attr != DW_AT_location && attr != DW_AT_frame_base)
+			continue;
+
+		/* Location expressions keep a decoded copy in the unit. */
+		if (dwarf_loclist_n(attrlist[i], &llbuf, &listlen, &de) !=
+		    DW_DLV_OK)
+			continue;
+		for (j = 0; j < listlen; j++) {
+			uw->loc_cnt++;
+			uw->sum += llbuf[j]->ld_cents;
+			dwarf_dealloc(dbg, llbuf[j]->ld_s, DW_DLA_LOC_BLOCK);
+			dwarf_dealloc(dbg, llbuf[j], DW_DLA_LOCDESC);
+		}
+		dwarf_dealloc(dbg, llbuf, DW_DLA_LIST);
+	}
+}
+
+static void
+_walk_die(Dwarf_Debug dbg, Dwarf_Die die, struct unit_walk *uw)
+{
+	Dwarf_Die child, sib;
+	Dwarf_Off off;
+	Dwarf_Error de;
+	int r;
+
+	/* DIEs are not freed here; dwarf_cu_dealloc() releases them. */
+	for (;;) {
+		if (dwarf_dieoffset(die, &off, &de) != DW_DLV_OK) {
+			tet_printf("dwarf_dieoffset failed: %s\n",
+			    dwarf_errmsg(de));
+			result = TET_FAIL;
+			return;
+		}
+		uw->die_cnt++;
+		uw->sum += off;
+		_walk_attrs(dbg, die, uw);
+
+		r = dwarf_child(die, &child, &de);
+		if (r == DW_DLV_OK)
+			_walk_die(dbg, child, uw);
+		else if (r == DW_DLV_ERROR) {
+			tet_printf("dwarf_child failed: %s\n",
+			    dwarf_errmsg(de));
+			result = TET_FAIL;
+			return;
+		}
+
+		r = dwarf_siblingof(dbg, die, &sib, &de);
+		if (r == DW_DLV_NO_ENTRY)
+			return;
+		if (r != DW_DLV_OK) {
+			tet_printf("dwarf_siblingof failed: %s\n",
+			    dwarf_errmsg(de));
+			result = TET_FAIL;
+			return;
+		}
+		die = sib;
+	}
+}
+
+static void
+_walk_unit(Dwarf_Debug dbg, Dwarf_Die cu_die, struct unit_walk *uw)
+{
+	Dwarf_Line *linebuf;
+	Dwarf_Signed linecount;
+	Dwarf_Addr lineaddr;
+	Dwarf_Error de;
+	Dwarf_Signed i;
+	int r;
+
+	memset(uw, 0, sizeof(*uw));
+
+	_walk_die(dbg, cu_die, uw);
+
+	r = dwarf_srclines(cu_die, &linebuf, &linecount, &de);
+	if (r == DW_DLV_NO_ENTRY)
+		return;
+	if (r != DW_DLV_OK) {
+		tet_printf("dwarf_srclines failed: %s\n", dwarf_errmsg(de));
+		result = TET_FAIL;
+		return;
+	}
+	for (i = 0; i < linecount; i++) {
+		if (dwarf_lineaddr(linebuf[i], &lineaddr, &de) != DW_DLV_OK) {
+			tet_printf("dwarf_lineaddr failed: %s\n",
+			    dwarf_errmsg(de));
+			result = TET_FAIL;
+			return;
+		}
+		uw->line_cnt++;
+		uw->sum += lineaddr;
+	}
+}
+
+static void
+tp_dwarf_cu_dealloc(void)
+{
+	Dwarf_Debug dbg;
+	Dwarf_Error de;
+	Dwarf_Die cu_die;
+	Dwarf_Off cu_die_off;
+	Dwarf_Unsigned cu_next_offset;
+	struct unit_walk uw, uw0;
+#ifdef	HEAP_INUSE
+	Dwarf_Unsigned heap_released, heap_walked;
+#endif
+	int fd, i;
+
+	result = TET_UNRESOLVED;
+
+	TS_DWARF_INIT(dbg, fd, de);
+
+	tet_infoline("release each unit after walking it, then walk it again");
+
+	/* dwarf_cu_dealloc() ignores a NULL DIE. */
+	dwarf_cu_dealloc(dbg, NULL);
+
+	TS_DWARF_CU_FOREACH(dbg, cu_next_offset, de) {
+		if (dwarf_siblingof(dbg, NULL, &cu_die, &de) != DW_DLV_OK ||
+		    dwarf_dieoffset(cu_die, &cu_die_off, &de) != DW_DLV_OK) {
+			tet_printf("can not get the unit DIE: %s\n",
+			    dwarf_errmsg(de));
+			result = TET_FAIL;
+			goto done;
+		}
+
+		_walk_unit(dbg, cu_die, &uw0);
+		TS_CHECK_UINT(uw0.die_cnt);
+		TS_CHECK_UINT(uw0.attr_cnt);
+		TS_CHECK_UINT(uw0.loc_cnt);
+		TS_CHECK_UINT(uw0.line_cnt);
+		dwarf_cu_dealloc(dbg, cu_die);
+
+		/*
+		 * Read the unit back from its offset a few times.  Once
+		 * the lookup structures built on first use are in place,
+		 * each round must leave the heap where the previous one
+		 * left it: everything a walk allocates for the unit is
+		 * returned by dwarf_cu_dealloc().
+		 */
+		for (i = 0; i < 3; i++) {
+			if (dwarf_offdie(dbg, cu_die_off, &cu_die, &de) !=
+			    DW_DLV_OK) {
+				tet_printf("dwarf_offdie failed after"
+				    " dwarf_cu_dealloc: %s\n",
+				    dwarf_errmsg(de));
+				result = TET_FAIL;
+				goto done;
+			}
+			_walk_unit(dbg, cu_die, &uw);
+			if (memcmp(&uw, &uw0, sizeof(uw)) != 0) {
+				tet_printf("walk %d of unit at %#jx does not"
+				    " match the first walk\n", i + 1,
+				    (uintmax_t) cu_die_off);
+				result = TET_FAIL;
+			}
+#ifdef	HEAP_INUSE
+			heap_walked = HEAP_INUSE();
+#endif
+			dwarf_cu_dealloc(dbg, cu_die);
+#ifdef	HEAP_INUSE
+			if (i == 1)
+				heap_released = HEAP_INUSE();
+			else if (i == 2 && (HEAP_INUSE() != heap_released ||
+			    heap_walked <= heap_released)) {
+				tet_printf("unit at %#jx: %ju heap blocks in"
+				    " use after the walk, %ju after release,"
+				    " %ju expected\n", (uintmax_t) cu_die_off,
+				    (uintmax_t) heap_walked,
+				    (uintmax_t) HEAP_INUSE(),
+				    (uintmax_t) heap_released);
+				result = TET_FAIL;
+			}
+#endif
+		}
+	}
+
+	if (result == TET_UNRESOLVED)
+		result = TET_PASS;
+
+done:
+	TS_DWARF_FINISH(dbg, de);
+	TS_RESULT(result);
+}
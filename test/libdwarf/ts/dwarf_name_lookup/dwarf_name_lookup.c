@@ -0,0 +1,426 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <assert.h>
+#include <dwarf.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <libdwarf.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "driver.h"
+#include "tet_api.h"
+
+/*
+ * Test case for dwarf_name_lookup() and dwarf_name_index_build().
+ *
+ * The test objects are built from the same C++ sources: one with a
+ * DWARF5 .debug_names section, one with a .gdb_index section and one
+ * without an index, whose names are indexed by the library.
+ */
+static void tp_dwarf_name_lookup(void);
+static void tp_dwarf_name_lookup_argument(void);
+static void tp_dwarf_name_index_build(void);
+static struct dwarf_tp dwarf_tp_array[] = {
+	{"tp_dwarf_name_lookup", tp_dwarf_name_lookup},
+	{"tp_dwarf_name_lookup_argument", tp_dwarf_name_lookup_argument},
+	{"tp_dwarf_name_index_build", tp_dwarf_name_index_build},
+	{NULL, NULL},
+};
+static int result = TET_UNRESOLVED;
+#include "driver.c"
+
+/*
+ * Names defined by the test objects, by their simple, qualified and
+ * linkage names, followed by names that none of them defines.
+ */
+static const char *names[] = {
+	"main",
+	"helper",
+	"_ZL6helperv",
+	"other",
+	"int",
+	"ns",
+	"klass",
+	"ns::klass",
+	"inner",
+	"ns::klass::inner",
+	"member",
+	"ns::klass::member",
+	"_ZN2ns5klass6memberE",
+	"method",
+	"ns::klass::method",
+	"_ZN2ns5klass6methodEv",
+	"x",
+	"k",
+	"nosuch",
+	"ns::nosuch",
+	"klass::member",
+	"ns::klass::",
+	"",
+	NULL
+};
+
+static void
+tp_dwarf_name_lookup(void)
+{
+	Dwarf_Debug dbg;
+	Dwarf_Error de;
+	Dwarf_Die die;
+	Dwarf_Off *off, cu_off, cu_len, die_off, prev_cu_off;
+	Dwarf_Unsigned count, i;
+	Dwarf_Half tag;
+	const char *name;
+	int fd, n, r;
+
+	result = TET_UNRESOLVED;
+
+	TS_DWARF_INIT(dbg, fd, de);
+
+	for (n = 0; names[n] != NULL; n++) {
+		name = names[n];
+		TS_CHECK_STRING(name);
+		r = dwarf_name_lookup(dbg, name, &off, &count, &de);
+		TS_CHECK_INT(r);
+		if (r == DW_DLV_ERROR) {
+			tet_printf("dwarf_name_lookup(%s) failed: %s\n", name,
+			    dwarf_errmsg(de));
+			result = TET_FAIL;
+			goto done;
+		}
+		if (r == DW_DLV_NO_ENTRY) {
+			if (dwarf_errno(de) != DW_DLE_NO_ENTRY) {
+				tet_printf("dwarf_name_lookup(%s) returned"
+				    " DW_DLV_NO_ENTRY with error %d\n", name,
+				    (int) dwarf_errno(de));
+				result = TET_FAIL;
+			}
+			continue;
+		}
+		TS_CHECK_UINT(count);
+
+		/* The entries are listed in the order of their units. */
+		prev_cu_off = 0;
+		for (i = 0; i < count; i++) {
+			die_off = off[i];
+			TS_CHECK_UINT(die_off);
+			if (dwarf_offdie_b(dbg, die_off, 1, &die, &de) !=
+			    DW_DLV_OK) {
+				tet_printf("dwarf_offdie_b(%#jx) failed: %s\n",
+				    (uintmax_t) die_off, dwarf_errmsg(de));
+				result = TET_FAIL;
+				continue;
+			}
+			if (dwarf_tag(die, &tag, &de) != DW_DLV_OK) {
+				tet_printf("dwarf_tag failed: %s\n",
+				    dwarf_errmsg(de));
+				result = TET_FAIL;
+			}
+			TS_CHECK_UINT(tag);
+			if (dwarf_die_CU_offset_range(die, &cu_off, &cu_len,
+			    &de) != DW_DLV_OK) {
+				tet_printf("dwarf_die_CU_offset_range failed:"
+				    " %s\n", dwarf_errmsg(de));
+				result = TET_FAIL;
+			} else if (cu_off < prev_cu_off) {
+				tet_printf("%s: DIE %#jx listed after a DIE of"
+				    " a later unit\n", name,
+				    (uintmax_t) die_off);
+				result = TET_FAIL;
+			} else
+				prev_cu_off = cu_off;
+			dwarf_dealloc(dbg, die, DW_DLA_DIE);
+		}
+		dwarf_dealloc(dbg, off, DW_DLA_LIST);
+	}
+
+	if (result == TET_UNRESOLVED)
+		result = TET_PASS;
+
+done:
+	TS_DWARF_FINISH(dbg, de);
+	TS_RESULT(result);
+}
+
+static void
+tp_dwarf_name_lookup_argument(void)
+{
+	Dwarf_Debug dbg;
+	Dwarf_Error de;
+	Dwarf_Off *off;
+	Dwarf_Unsigned count;
+	int fd;
+
+	result = TET_UNRESOLVED;
+
+	TS_DWARF_INIT(dbg, fd, de);
+
+	if (dwarf_name_lookup(NULL, "main", &off, &count, &de) !=
+	    DW_DLV_ERROR) {
+		tet_infoline("dwarf_name_lookup didn't return DW_DLV_ERROR"
+		    " when called with NULL dbg");
+		result = TET_FAIL;
+		goto done;
+	}
+
+	if (dwarf_name_lookup(dbg, NULL, &off, &count, &de) !=
+	    DW_DLV_ERROR) {
+		tet_infoline("dwarf_name_lookup didn't return DW_DLV_ERROR"
+		    " when called with NULL name");
+		result = TET_FAIL;
+		goto done;
+	}
+
+	if (dwarf_name_lookup(dbg, "main", NULL, &count, &de) !=
+	    DW_DLV_ERROR) {
+		tet_infoline("dwarf_name_lookup didn't return DW_DLV_ERROR"
+		    " when called with NULL offsets");
+		result = TET_FAIL;
+		goto done;
+	}
+
+	if (dwarf_name_lookup(dbg, "main", &off, NULL, &de) !=
+	    DW_DLV_ERROR) {
+		tet_infoline("dwarf_name_lookup didn't return DW_DLV_ERROR"
+		    " when called with NULL count");
+		result = TET_FAIL;
+		goto done;
+	}
+
+	if (dwarf_name_index_build(NULL, 0, &de) != DW_DLV_ERROR) {
+		tet_infoline("dwarf_name_index_build didn't return"
+		    " DW_DLV_ERROR when called with NULL dbg");
+		result = TET_FAIL;
+		goto done;
+	}
+
+	if (dwarf_name_index_build(dbg, -1, &de) != DW_DLV_ERROR) {
+		tet_infoline("dwarf_name_index_build didn't return"
+		    " DW_DLV_ERROR when called with a negative thread"
+		    " count");
+		result = TET_FAIL;
+		goto done;
+	}
+
+	if (result == TET_UNRESOLVED)
+		result = TET_PASS;
+
+done:
+	TS_DWARF_FINISH(dbg, de);
+	TS_RESULT(result);
+}
+
+/*
+ * Whatever the way the index of names comes to be built, ahead of
+ * time on several threads or on the first lookup, and from whichever
+ * thread, lookups return what they return in a debug context that only
+ * one thread uses.
+ */
+
+#define	_NTHREADS	4
+
+/* The outcome of the lookups of all the names. */
+struct name_result {
+	int		r;
+	Dwarf_Off	*off;
+	Dwarf_Unsigned	count;
+};
+
+struct name_job {
+	Dwarf_Debug		dbg;
+	int			nthreads; /* Build the index first. */
+	struct name_result	*expected;
+	int			failed;
+};
+
+static int
+_lookup_names(Dwarf_Debug dbg, struct name_result *nr)
+{
+	Dwarf_Error de;
+	int n;
+
+	for (n = 0; names[n] != NULL; n++) {
+		nr[n].r = dwarf_name_lookup(dbg, names[n], &nr[n].off,
+		    &nr[n].count, &de);
+		if (nr[n].r == DW_DLV_ERROR)
+			return (-1);
+	}
+
+	return (0);
+}
+
+static int
+_compare_names(struct name_result *nr, struct name_result *expected)
+{
+	int n;
+
+	for (n = 0; names[n] != NULL; n++) {
+		if (nr[n].r != expected[n].r)
+			return (-1);
+		if (nr[n].r != DW_DLV_OK)
+			continue;
+		if (nr[n].count != expected[n].count ||
+		    memcmp(nr[n].off, expected[n].off,
+		    nr[n].count * sizeof(Dwarf_Off)) != 0)
+			return (-1);
+	}
+
+	return (0);
+}
+
+static void
+_free_names(Dwarf_Debug dbg, struct name_result *nr)
+{
+	int n;
+
+	for (n = 0; names[n] != NULL; n++) {
+		if (nr[n].r == DW_DLV_OK && nr[n].off != NULL)
+			dwarf_dealloc(dbg, nr[n].off, DW_DLA_LIST);
+		nr[n].r = DW_DLV_NO_ENTRY;
+	}
+}
+
+static void *
+_lookup_names_thread(void *arg)
+{
+	struct name_job *nj;
+	struct name_result nr[sizeof(names) / sizeof(names[0])];
+	Dwarf_Error de;
+
+	nj = arg;
+
+	memset(nr, 0, sizeof(nr));
+	if ((nj->nthreads > 0 &&
+	    dwarf_name_index_build(nj->dbg, nj->nthreads, &de) !=
+	    DW_DLV_OK) || _lookup_names(nj->dbg, nr) < 0 ||
+	    _compare_names(nr, nj->expected) < 0)
+		nj->failed = 1;
+	_free_names(nj->dbg, nr);
+
+	return (NULL);
+}
+
+static void
+tp_dwarf_name_index_build(void)
+{
+	Dwarf_Debug dbg, dbg2;
+	Dwarf_Error de;
+	struct name_result expected[sizeof(names) / sizeof(names[0])];
+	struct name_result nr[sizeof(names) / sizeof(names[0])];
+	struct name_job nj[_NTHREADS];
+	pthread_t t[_NTHREADS];
+	int fd, n, nt, pass;
+
+	result = TET_UNRESOLVED;
+	dbg2 = NULL;
+	memset(expected, 0, sizeof(expected));
+	memset(nr, 0, sizeof(nr));
+
+	TS_DWARF_INIT(dbg, fd, de);
+
+	tet_infoline("look up names in a debug context shared by several"
+	    " threads");
+
+	/* The index of this debug context is built on the first lookup. */
+	if (_lookup_names(dbg, expected) < 0) {
+		tet_infoline("dwarf_name_lookup failed");
+		result = TET_FAIL;
+		goto done;
+	}
+
+	/* Building the index again does nothing. */
+	if (dwarf_name_index_build(dbg, _NTHREADS, &de) != DW_DLV_OK) {
+		tet_printf("dwarf_name_index_build failed: %s\n",
+		    dwarf_errmsg(de));
+		result = TET_FAIL;
+		goto done;
+	}
+	if (_lookup_names(dbg, nr) < 0 || _compare_names(nr, expected) < 0) {
+		tet_infoline("lookups differ once the index is built again");
+		result = TET_FAIL;
+		goto done;
+	}
+	_free_names(dbg, nr);
+
+	/*
+	 * In a first new debug context, all the threads but one build the
+	 * index ahead of time, on threads of their own, while that one
+	 * looks names up.  In a second one, the threads race to build the
+	 * index on their first lookup.
+	 */
+	for (pass = 0; pass < 2; pass++) {
+		if (dwarf_init(fd, DW_DLC_READ, NULL, NULL, &dbg2, &de) !=
+		    DW_DLV_OK) {
+			tet_printf("dwarf_init failed: %s\n",
+			    dwarf_errmsg(de));
+			result = TET_FAIL;
+			goto done;
+		}
+		for (nt = 0; nt < _NTHREADS; nt++) {
+			nj[nt].dbg = dbg2;
+			nj[nt].nthreads = pass ? 0 : nt;
+			nj[nt].expected = expected;
+			nj[nt].failed = 0;
+			if (pthread_create(&t[nt], NULL, _lookup_names_thread,
+			    &nj[nt]) != 0)
+				break;
+		}
+		for (n = 0; n < nt; n++) {
+			(void) pthread_join(t[n], NULL);
+			if (nj[n].failed) {
+				tet_printf("pass %d: thread %d saw lookups"
+				    " that differ from those of a single"
+				    " thread\n", pass, n);
+				result = TET_FAIL;
+			}
+		}
+		if (dwarf_finish(dbg2, &de) != DW_DLV_OK) {
+			tet_printf("dwarf_finish failed: %s\n",
+			    dwarf_errmsg(de));
+			result = TET_FAIL;
+		}
+		dbg2 = NULL;
+		if (nt < _NTHREADS) {
+			tet_infoline("thread creation failed");
+			goto done;
+		}
+		if (result == TET_FAIL)
+			goto done;
+	}
+
+	if (result == TET_UNRESOLVED)
+		result = TET_PASS;
+
+done:
+	_free_names(dbg, nr);
+	_free_names(dbg, expected);
+	TS_DWARF_FINISH(dbg, de);
+	TS_RESULT(result);
+}
@@ -31,6 +31,8 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <libdwarf.h>
+#include <pthread.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "driver.h"
@@ -39,12 +41,19 @@
 static void tp_dwarf_next_cu_header(void);
 static void tp_dwarf_next_cu_header_b(void);
 static void tp_dwarf_next_cu_header_c(void);
+static void tp_dwarf_next_cu_header_d(void);
 static void tp_dwarf_next_cu_header_loop(void);
+static void tp_dwarf_get_unit_headers(void);
+static void tp_dwarf_get_unit_headers_threads(void);
 static struct dwarf_tp dwarf_tp_array[] = {
 	{"tp_dwarf_next_cu_header", tp_dwarf_next_cu_header},
 	{"tp_dwarf_next_cu_header_b", tp_dwarf_next_cu_header_b},
 	{"tp_dwarf_next_cu_header_c", tp_dwarf_next_cu_header_c},
+	{"tp_dwarf_next_cu_header_d", tp_dwarf_next_cu_header_d},
 	{"tp_dwarf_next_cu_header_loop", tp_dwarf_next_cu_header_loop},
+	{"tp_dwarf_get_unit_headers", tp_dwarf_get_unit_headers},
+	{"tp_dwarf_get_unit_headers_threads",
+	 tp_dwarf_get_unit_headers_threads},
 	{NULL, NULL},
 };
 #include "driver.c"
@@ -179,6 +188,79 @@ done:
 	TS_RESULT(result);
 }
 
+static void
+tp_dwarf_next_cu_header_d(void)
+{
+	Dwarf_Debug dbg;
+	Dwarf_Error de;
+	Dwarf_Unsigned cu_header_length;
+	Dwarf_Half cu_version;
+	Dwarf_Off cu_abbrev_offset;
+	Dwarf_Half cu_pointer_size;
+	Dwarf_Half cu_offset_size;
+	Dwarf_Half cu_extension_size;
+	Dwarf_Sig8 cu_type_sig;
+	Dwarf_Unsigned cu_type_offset;
+	Dwarf_Unsigned cu_next_offset;
+	Dwarf_Half cu_unit_type;
+	const char *ut_name;
+	int fd, r_ut_name, result;
+
+	result = TET_UNRESOLVED;
+
+	TS_DWARF_INIT(dbg, fd, de);
+
+	while (dwarf_next_cu_header_d(dbg, 1, &cu_header_length, &cu_version,
+	    &cu_abbrev_offset, &cu_pointer_size, &cu_offset_size,
+	    &cu_extension_size, &cu_type_sig, &cu_type_offset,
+	    &cu_next_offset, &cu_unit_type, &de) == DW_DLV_OK) {
+		TS_CHECK_UINT(cu_header_length);
+		TS_CHECK_UINT(cu_version);
+		TS_CHECK_INT(cu_abbrev_offset);
+		TS_CHECK_UINT(cu_pointer_size);
+		TS_CHECK_UINT(cu_offset_size);
+		TS_CHECK_UINT(cu_extension_size);
+		TS_CHECK_UINT(cu_next_offset);
+		TS_CHECK_UINT(cu_unit_type);
+		r_ut_name = dwarf_get_UT_name(cu_unit_type, &ut_name);
+		TS_CHECK_INT(r_ut_name);
+		if (r_ut_name == DW_DLV_OK)
+			TS_CHECK_STRING(ut_name);
+		if (cu_unit_type == DW_UT_type) {
+			TS_CHECK_BLOCK(cu_type_sig.signature, 8);
+			TS_CHECK_UINT(cu_type_offset);
+		}
+	}
+
+	do {
+		while (dwarf_next_cu_header_d(dbg, 0, &cu_header_length,
+		    &cu_version, &cu_abbrev_offset, &cu_pointer_size,
+		    &cu_offset_size, &cu_extension_size, &cu_type_sig,
+		    &cu_type_offset, &cu_next_offset, &cu_unit_type, &de) ==
+		    DW_DLV_OK) {
+			TS_CHECK_UINT(cu_header_length);
+			TS_CHECK_UINT(cu_version);
+			TS_CHECK_UINT(cu_next_offset);
+			TS_CHECK_UINT(cu_unit_type);
+			TS_CHECK_BLOCK(cu_type_sig.signature, 8);
+			TS_CHECK_UINT(cu_type_offset);
+		}
+	} while (dwarf_next_types_section(dbg, &de) == DW_DLV_OK);
+
+	if (dwarf_get_UT_name(0, &ut_name) != DW_DLV_NO_ENTRY) {
+		tet_infoline("dwarf_get_UT_name didn't return DW_DLV_NO_ENTRY"
+		    " for an invalid unit type");
+		result = TET_FAIL;
+	}
+
+	if (result == TET_UNRESOLVED)
+		result = TET_PASS;
+
+done:
+	TS_DWARF_FINISH(dbg, de);
+	TS_RESULT(result);
+}
+
 #define	_LOOP_COUNT	50
 
 static void
@@ -207,3 +289,352 @@ done:
 	TS_DWARF_FINISH(dbg, de);
 	TS_RESULT(result);
 }
+
+/*
+ * Compare the unit table of one section with the units visited by
+ * dwarf_next_cu_header_d().
+ */
+static int
+_check_unit_headers(Dwarf_Debug dbg, Dwarf_Bool is_info,
+    Dwarf_Unit_Header *uh, Dwarf_Unsigned uh_count)
+{
+	Dwarf_Error de;
+	Dwarf_Die die;
+	Dwarf_Off die_offset, offset;
+	Dwarf_Half cu_version, cu_unit_type;
+	Dwarf_Unsigned cu_next_offset, i;
+	int result;
+
+	result = TET_UNRESOLVED;
+
+	for (i = 0, offset = 0; dwarf_next_cu_header_d(dbg, is_info, NULL,
+	    &cu_version, NULL, NULL, NULL, NULL, NULL, NULL, &cu_next_offset,
+	    &cu_unit_type, &de) == DW_DLV_OK; i++, offset = cu_next_offset) {
+		if (i >= uh_count) {
+			tet_printf("unit %ju is missing from the table\n",
+			    (uintmax_t) i);
+			result = TET_FAIL;
+			continue;
+		}
+		if (dwarf_siblingof_b(dbg, NULL, &die, is_info, &de) !=
+		    DW_DLV_OK || dwarf_dieoffset(die, &die_offset, &de) !=
+		    DW_DLV_OK) {
+			tet_printf("can not get the DIE of unit %ju: %s\n",
+			    (uintmax_t) i, dwarf_errmsg(de));
+			result = TET_FAIL;
+			continue;
+		}
+		if (uh[i].uh_offset != offset ||
+		    uh[i].uh_offset + uh[i].uh_length != cu_next_offset ||
+		    uh[i].uh_die_offset != die_offset ||
+		    uh[i].uh_version != cu_version ||
+		    uh[i].uh_unit_type != cu_unit_type) {
+			tet_printf("unit %ju: table entry (%#jx, %#jx, %#jx,"
+			    " %u, %u) does not match dwarf_next_cu_header_d"
+			    " (%#jx, %#jx, %#jx, %u, %u)\n", (uintmax_t) i,
+			    (uintmax_t) uh[i].uh_offset,
+			    (uintmax_t) uh[i].uh_length,
+			    (uintmax_t) uh[i].uh_die_offset,
+			    uh[i].uh_version, uh[i].uh_unit_type,
+			    (uintmax_t) offset,
+			    (uintmax_t) (cu_next_offset - offset),
+			    (uintmax_t) die_offset, cu_version, cu_unit_type);
+			result = TET_FAIL;
+		}
+	}
+
+	if (i != uh_count) {
+		tet_printf("dwarf_next_cu_header_d visited %ju units, the"
+		    " table has %ju\n", (uintmax_t) i, (uintmax_t) uh_count);
+		result = TET_FAIL;
+	}
+
+	return (result);
+}
+
+static void
+tp_dwarf_get_unit_headers(void)
+{
+	Dwarf_Debug dbg;
+	Dwarf_Error de;
+	Dwarf_Unit_Header *uh;
+	Dwarf_Unsigned uh_count, i;
+	int fd, r, result;
+
+	result = TET_UNRESOLVED;
+
+	TS_DWARF_INIT(dbg, fd, de);
+
+	if (dwarf_get_unit_headers(dbg, 1, &uh, &uh_count, &de) !=
+	    DW_DLV_OK) {
+		tet_printf("dwarf_get_unit_headers failed: %s\n",
+		    dwarf_errmsg(de));
+		result = TET_FAIL;
+		goto done;
+	}
+	TS_CHECK_UINT(uh_count);
+	for (i = 0; i < uh_count; i++) {
+		TS_CHECK_UINT(uh[i].uh_offset);
+		TS_CHECK_UINT(uh[i].uh_length);
+		TS_CHECK_UINT(uh[i].uh_die_offset);
+		TS_CHECK_UINT(uh[i].uh_version);
+		TS_CHECK_UINT(uh[i].uh_unit_type);
+	}
+	if (_check_unit_headers(dbg, 1, uh, uh_count) == TET_FAIL)
+		result = TET_FAIL;
+
+	do {
+		r = dwarf_get_unit_headers(dbg, 0, &uh, &uh_count, &de);
+		TS_CHECK_INT(r);
+		if (r == DW_DLV_ERROR) {
+			tet_printf("dwarf_get_unit_headers failed: %s\n",
+			    dwarf_errmsg(de));
+			result = TET_FAIL;
+			goto done;
+		}
+		if (r == DW_DLV_NO_ENTRY)
+			uh_count = 0;
+		TS_CHECK_UINT(uh_count);
+		if (_check_unit_headers(dbg, 0, uh, uh_count) == TET_FAIL)
+			result = TET_FAIL;
+	} while (dwarf_next_types_section(dbg, &de) == DW_DLV_OK);
+
+	if (dwarf_get_unit_headers(NULL, 1, &uh, &uh_count, &de) !=
+	    DW_DLV_ERROR ||
+	    dwarf_get_unit_headers(dbg, 1, NULL, &uh_count, &de) !=
+	    DW_DLV_ERROR ||
+	    dwarf_get_unit_headers(dbg, 1, &uh, NULL, &de) !=
+	    DW_DLV_ERROR) {
+		tet_infoline("dwarf_get_unit_headers didn't return"
+		    " DW_DLV_ERROR when called with NULL arguments");
+		result = TET_FAIL;
+	}
+
+	if (result == TET_UNRESOLVED)
+		result = TET_PASS;
+
+done:
+	TS_DWARF_FINISH(dbg, de);
+	TS_RESULT(result);
+}
+
+/*
+ * Walk the units of a debug context from several threads at once.  In
+ * the first pass every thread walks every unit, racing the others to
+ * the state that is built on first use.  In the second pass the units
+ * are divided among the threads, which release each unit after walking
+ * it, and read it again in the next round.
+ */
+
+#define	_NTHREADS	4
+#define	_NROUNDS	8
+
+/* What a walk of one unit has seen. */
+struct unit_walk {
+	Dwarf_Unsigned	die_cnt;
+	Dwarf_Unsigned	attr_cnt;
+	Dwarf_Unsigned	line_cnt;
+	Dwarf_Unsigned	sum;
+};
+
+struct unit_job {
+	Dwarf_Debug		dbg;
+	Dwarf_Unit_Header	*uh;
+	Dwarf_Unsigned		uh_count;
+	struct unit_walk	*expected;
+	Dwarf_Unsigned		first;	/* First unit of the thread. */
+	Dwarf_Unsigned		stride;	/* Distance to its next unit. */
+	int			release;
+	int			failed;
+};
+
+static int
+_walk_die(Dwarf_Debug dbg, Dwarf_Die die, struct unit_walk *uw,
+    Dwarf_Error *de)
+{
+	Dwarf_Attribute *attrlist;
+	Dwarf_Signed attrcount, i;
+	Dwarf_Die child, sib;
+	Dwarf_Half attr, form;
+	Dwarf_Off off;
+	int r;
+
+	for (;;) {
+		if (dwarf_dieoffset(die, &off, de) != DW_DLV_OK)
+			return (-1);
+		uw->die_cnt++;
+		uw->sum += off;
+
+		r = dwarf_attrlist(die, &attrlist, &attrcount, de);
+		if (r == DW_DLV_ERROR)
+			return (-1);
+		for (i = 0; r == DW_DLV_OK && i < attrcount; i++) {
+			if (dwarf_whatattr(attrlist[i], &attr, de) !=
+			    DW_DLV_OK ||
+			    dwarf_whatform(attrlist[i], &form, de) !=
+			    DW_DLV_OK)
+				return (-1);
+			uw->attr_cnt++;
+			uw->sum += attr * 31 + form;
+		}
+
+		r = dwarf_child(die, &child, de);
+		if (r == DW_DLV_ERROR ||
+		    (r == DW_DLV_OK && _walk_die(dbg, child, uw, de) < 0))
+			return (-1);
+
+		r = dwarf_siblingof_b(dbg, die, &sib, 1, de);
+		if (r == DW_DLV_NO_ENTRY)
+			return (0);
+		if (r != DW_DLV_OK)
+			return (-1);
+		die = sib;
+	}
+}
+
+static int
+_walk_unit(Dwarf_Debug dbg, Dwarf_Unit_Header *uh, int release,
+    struct unit_walk *uw)
+{
+	Dwarf_Line *linebuf;
+	Dwarf_Signed linecount, i;
+	Dwarf_Addr lineaddr;
+	Dwarf_Error de;
+	Dwarf_Die die;
+	int r;
+
+	memset(uw, 0, sizeof(*uw));
+
+	if (dwarf_offdie_b(dbg, uh->uh_die_offset, 1, &die, &de) !=
+	    DW_DLV_OK)
+		return (-1);
+
+	if (_walk_die(dbg, die, uw, &de) < 0)
+		goto fail;
+
+	r = dwarf_srclines(die, &linebuf, &linecount, &de);
+	if (r == DW_DLV_ERROR)
+		goto fail;
+	for (i = 0; r == DW_DLV_OK && i < linecount; i++) {
+		if (dwarf_lineaddr(linebuf[i], &lineaddr, &de) != DW_DLV_OK)
+			goto fail;
+		uw->line_cnt++;
+		uw->sum += lineaddr;
+	}
+
+	if (release)
+		dwarf_cu_dealloc(dbg, die);
+	return (0);
+
+fail:
+	if (release)
+		dwarf_cu_dealloc(dbg, die);
+	return (-1);
+}
+
+static void *
+_walk_units_thread(void *arg)
+{
+	struct unit_job *uj;
+	struct unit_walk uw;
+	Dwarf_Unsigned i;
+	int n;
+
+	uj = arg;
+
+	for (n = 0; n < _NROUNDS; n++) {
+		for (i = uj->first; i < uj->uh_count; i += uj->stride) {
+			if (_walk_unit(uj->dbg, &uj->uh[i], uj->release,
+			    &uw) < 0 || memcmp(&uw, &uj->expected[i],
+			    sizeof(uw)) != 0) {
+				uj->failed = 1;
+				return (NULL);
+			}
+		}
+	}
+
+	return (NULL);
+}
+
+static void
+tp_dwarf_get_unit_headers_threads(void)
+{
+	Dwarf_Debug dbg;
+	Dwarf_Error de;
+	Dwarf_Unit_Header *uh;
+	Dwarf_Unsigned uh_count, i;
+	struct unit_walk *expected;
+	struct unit_job uj[_NTHREADS];
+	pthread_t t[_NTHREADS];
+	int fd, n, nt, pass, result;
+
+	result = TET_UNRESOLVED;
+	expected = NULL;
+
+	TS_DWARF_INIT(dbg, fd, de);
+
+	tet_infoline("walk the units of a shared debug context from"
+	    " several threads");
+
+	if (dwarf_get_unit_headers(dbg, 1, &uh, &uh_count, &de) !=
+	    DW_DLV_OK) {
+		tet_printf("dwarf_get_unit_headers failed: %s\n",
+		    dwarf_errmsg(de));
+		result = TET_FAIL;
+		goto done;
+	}
+
+	/* Compute the expected results from this thread alone. */
+	if (uh_count > 0 &&
+	    (expected = calloc(uh_count, sizeof(*expected))) == NULL) {
+		tet_printf("calloc failed: %s\n", strerror(errno));
+		result = TET_UNRESOLVED;
+		goto done;
+	}
+	for (i = 0; i < uh_count; i++) {
+		if (_walk_unit(dbg, &uh[i], 1, &expected[i]) < 0) {
+			tet_printf("walk of unit %ju failed\n", (uintmax_t) i);
+			result = TET_FAIL;
+			goto done;
+		}
+	}
+
+	for (pass = 0; pass < 2; pass++) {
+		for (nt = 0; nt < _NTHREADS; nt++) {
+			uj[nt].dbg = dbg;
+			uj[nt].uh = uh;
+			uj[nt].uh_count = uh_count;
+			uj[nt].expected = expected;
+			uj[nt].release = pass;
+			uj[nt].first = pass ? (Dwarf_Unsigned) nt : 0;
+			uj[nt].stride = pass ? _NTHREADS : 1;
+			uj[nt].failed = 0;
+			if (pthread_create(&t[nt], NULL, _walk_units_thread,
+			    &uj[nt]) != 0)
+				break;
+		}
+		for (n = 0; n < nt; n++) {
+			(void) pthread_join(t[n], NULL);
+			if (uj[n].failed) {
+				tet_printf("pass %d: thread %d saw a unit"
+				    " that differs from its walk by a"
+				    " single thread\n", pass, n);
+				result = TET_FAIL;
+			}
+		}
+		if (nt < _NTHREADS) {
+			tet_infoline("thread creation failed");
+			goto done;
+		}
+		if (result == TET_FAIL)
+			goto done;
+	}
+
+	if (result == TET_UNRESOLVED)
+		result = TET_PASS;
+
+done:
+	free(expected);
+	TS_DWARF_FINISH(dbg, de);
+	TS_RESULT(result);
+}
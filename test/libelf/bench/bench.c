@@ -0,0 +1,149 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <err.h>
+#include <libelf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+/*
+ * A driver for libelf micro-benchmarks.
+ *
+ * Usage: libelf-bench [-n iterations] [benchmark...]
+ *
+ * With no arguments, all benchmarks are run.
+ */
+
+static struct bench benchmarks[] = {
+	{
+		.b_name = "ar",
+		.b_description = "reading the members of a large archive, "
+		    "sequentially and from multiple threads",
+		.b_run = bench_ar
+	},
+	{
+		.b_name = "getscn",
+		.b_description = "elf_getscn() and elf_strptr() lookups "
+		    "versus section count",
+		.b_run = bench_getscn
+	},
+	{
+		.b_name = "strptr",
+		.b_description = "elf_strptr() lookups versus the number of "
+		    "data descriptors",
+		.b_run = bench_strptr
+	},
+	{
+		.b_name = "xlate",
+		.b_description = "cross-endian elf_xlatetom() throughput",
+		.b_run = bench_xlate
+	},
+	{ .b_name = NULL }
+};
+
+double
+bench_now(void)
+{
+	struct timespec ts;
+
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) < 0)
+		err(EXIT_FAILURE, "clock_gettime failed");
+
+	return ((double) ts.tv_sec * 1e9 + (double) ts.tv_nsec);
+}
+
+static void
+usage(void)
+{
+	struct bench *b;
+
+	(void) fprintf(stderr, "usage: libelf-bench [-n iterations] "
+	    "[benchmark...]\n\nBenchmarks:\n");
+	for (b = benchmarks; b->b_name; b++)
+		(void) fprintf(stderr, "  %-12s %s\n", b->b_name,
+		    b->b_description);
+	exit(EXIT_FAILURE);
+}
+
+int
+main(int argc, char **argv)
+{
+	int ch, i, rc;
+	char *end;
+	struct bench *b;
+	unsigned long iterations;
+
+	iterations = 1000000UL;
+
+	while ((ch = getopt(argc, argv, "n:")) != -1) {
+		switch (ch) {
+		case 'n':
+			iterations = strtoul(optarg, &end, 0);
+			if (*optarg == '\0' || *end != '\0' || iterations == 0)
+				errx(EXIT_FAILURE, "invalid iteration count "
+				    "\"%s\"", optarg);
+			break;
+		default:
+			usage();
+		}
+	}
+
+	argc -= optind;
+	argv += optind;
+
+	if (elf_version(EV_CURRENT) == EV_NONE)
+		errx(EXIT_FAILURE, "elf_version failed: %s", elf_errmsg(-1));
+
+	rc = EXIT_SUCCESS;
+
+	if (argc == 0) {
+		for (b = benchmarks; b->b_name; b++)
+			if ((*b->b_run)(iterations) != 0)
+				rc = EXIT_FAILURE;
+		return (rc);
+	}
+
+	for (i = 0; i < argc; i++) {
+		for (b = benchmarks; b->b_name; b++)
+			if (strcmp(argv[i], b->b_name) == 0)
+				break;
+		if (b->b_name == NULL) {
+			warnx("unknown benchmark \"%s\"", argv[i]);
+			usage();
+		}
+		if ((*b->b_run)(iterations) != 0)
+			rc = EXIT_FAILURE;
+	}
+
+	return (rc);
+}
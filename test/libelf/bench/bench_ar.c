@@ -0,0 +1,341 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <ar.h>
+#include <err.h>
+#include <gelf.h>
+#include <libelf.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+/*
+ * Measure the time taken to read the symbol tables of all the members
+ * of a large archive, in the manner of nm(1).  The members are either
+ * visited sequentially using elf_begin() and elf_next(), or opened
+ * using elf_getarmembers() and elf_openarmember() and shared out
+ * across a number of threads.
+ */
+
+#define	NMEMBERS	20000	/* Members in the archive. */
+#define	NSYMS		32	/* Symbols per member. */
+#define	MAXTHREADS	8
+
+struct ar_worker {
+	Elf		*aw_ar;
+	off_t		*aw_members;
+	size_t		aw_start;	/* first member to process */
+	size_t		aw_end;		/* one past the last member */
+	size_t		aw_nsyms;	/* symbols seen */
+};
+
+/*
+ * Create a relocatable object containing a symbol table.
+ */
+static char *
+make_member(size_t *psz)
+{
+	Elf *e;
+	Elf_Data *d;
+	Elf_Scn *scn, *strscn;
+	GElf_Ehdr eh;
+	GElf_Shdr sh;
+	Elf64_Sym *syms;
+	char *image, *strings;
+	off_t sz;
+	size_t i;
+	int fd;
+	char tmpl[] = "/tmp/libelf-bench.XXXXXX";
+
+	if ((syms = calloc(NSYMS, sizeof(*syms))) == NULL ||
+	    (strings = malloc(NSYMS * 8 + 1)) == NULL)
+		err(EXIT_FAILURE, "malloc failed");
+
+	strings[0] = '\0';
+	for (i = 0; i < NSYMS; i++) {
+		(void) snprintf(strings + 1 + i * 8, 8, "sym%04zu", i);
+		syms[i].st_name = (Elf64_Word) (1 + i * 8);
+		syms[i].st_info = GELF_ST_INFO(STB_GLOBAL, STT_FUNC);
+		syms[i].st_value = i * 16;
+	}
+
+	if ((fd = mkstemp(tmpl)) < 0)
+		err(EXIT_FAILURE, "mkstemp failed");
+	(void) unlink(tmpl);
+
+	if ((e = elf_begin(fd, ELF_C_WRITE, NULL)) == NULL ||
+	    gelf_newehdr(e, ELFCLASS64) == NULL ||
+	    gelf_getehdr(e, &eh) == NULL)
+		errx(EXIT_FAILURE, "elf_begin failed: %s", elf_errmsg(-1));
+
+	eh.e_ident[EI_DATA] = ELFDATA2LSB;
+	eh.e_type = ET_REL;
+	eh.e_machine = EM_X86_64;
+	if (gelf_update_ehdr(e, &eh) == 0)
+		errx(EXIT_FAILURE, "gelf_update_ehdr failed: %s",
+		    elf_errmsg(-1));
+
+	if ((strscn = elf_newscn(e)) == NULL ||
+	    (d = elf_newdata(strscn)) == NULL ||
+	    gelf_getshdr(strscn, &sh) == NULL)
+		errx(EXIT_FAILURE, "elf_newscn failed: %s", elf_errmsg(-1));
+	d->d_buf = strings;
+	d->d_size = NSYMS * 8 + 1;
+	sh.sh_type = SHT_STRTAB;
+	if (gelf_update_shdr(strscn, &sh) == 0)
+		errx(EXIT_FAILURE, "gelf_update_shdr failed: %s",
+		    elf_errmsg(-1));
+
+	if ((scn = elf_newscn(e)) == NULL ||
+	    (d = elf_newdata(scn)) == NULL ||
+	    gelf_getshdr(scn, &sh) == NULL)
+		errx(EXIT_FAILURE, "elf_newscn failed: %s", elf_errmsg(-1));
+	d->d_buf = syms;
+	d->d_size = NSYMS * sizeof(*syms);
+	d->d_type = ELF_T_SYM;
+	d->d_align = 8;
+	sh.sh_type = SHT_SYMTAB;
+	sh.sh_link = (GElf_Word) elf_ndxscn(strscn);
+	sh.sh_entsize = sizeof(*syms);
+	if (gelf_update_shdr(scn, &sh) == 0)
+		errx(EXIT_FAILURE, "gelf_update_shdr failed: %s",
+		    elf_errmsg(-1));
+
+	if ((sz = elf_update(e, ELF_C_WRITE)) < 0)
+		errx(EXIT_FAILURE, "elf_update failed: %s", elf_errmsg(-1));
+	(void) elf_end(e);
+
+	if ((image = malloc((size_t) sz)) == NULL)
+		err(EXIT_FAILURE, "malloc failed");
+	if (pread(fd, image, (size_t) sz, 0) != sz)
+		err(EXIT_FAILURE, "pread failed");
+
+	(void) close(fd);
+	free(strings);
+	free(syms);
+
+	*psz = (size_t) sz;
+	return (image);
+}
+
+/*
+ * Create an archive holding NMEMBERS copies of `member'.
+ */
+static char *
+make_archive(const char *member, size_t msz, size_t *psz)
+{
+	size_t i, sz;
+	char *image, *p, hdr[sizeof(struct ar_hdr) + 1], name[16];
+
+	sz = SARMAG + NMEMBERS * (sizeof(struct ar_hdr) + ((msz + 1) & ~1U));
+	if ((image = malloc(sz)) == NULL)
+		err(EXIT_FAILURE, "malloc failed");
+
+	(void) memcpy(image, ARMAG, SARMAG);
+
+	for (p = image + SARMAG, i = 0; i < NMEMBERS; i++) {
+		(void) snprintf(name, sizeof(name), "m%05zu.o/", i);
+		(void) snprintf(hdr, sizeof(hdr),
+		    "%-16s%-12d%-6d%-6d%-8o%-10d%s", name, 0, 0, 0, 0644,
+		    (int) msz, ARFMAG);
+		(void) memcpy(p, hdr, sizeof(struct ar_hdr));
+		p += sizeof(struct ar_hdr);
+		(void) memcpy(p, member, msz);
+		p += msz;
+		if (msz & 1)
+			*p++ = '\n';
+	}
+
+	*psz = sz;
+	return (image);
+}
+
+/*
+ * Count the named symbols in a member.
+ */
+static size_t
+scan_member(Elf *e)
+{
+	Elf_Scn *scn;
+	Elf_Data *d;
+	GElf_Shdr sh;
+	GElf_Sym sym;
+	const char *name;
+	size_t i, n;
+
+	n = 0;
+	for (scn = NULL; (scn = elf_nextscn(e, scn)) != NULL; ) {
+		if (gelf_getshdr(scn, &sh) == NULL)
+			errx(EXIT_FAILURE, "gelf_getshdr failed: %s",
+			    elf_errmsg(-1));
+		if (sh.sh_type != SHT_SYMTAB)
+			continue;
+		if ((d = elf_getdata(scn, NULL)) == NULL)
+			errx(EXIT_FAILURE, "elf_getdata failed: %s",
+			    elf_errmsg(-1));
+		for (i = 0; i < sh.sh_size / sh.sh_entsize; i++)
+			if (gelf_getsym(d, (int) i, &sym) != NULL &&
+			    (name = elf_strptr(e, sh.sh_link,
+			    sym.st_name)) != NULL && *name != '\0')
+				n++;
+	}
+
+	return (n);
+}
+
+static void *
+ar_worker(void *arg)
+{
+	Elf *e;
+	size_t i;
+	struct ar_worker *aw;
+
+	aw = arg;
+	aw->aw_nsyms = 0;
+
+	for (i = aw->aw_start; i < aw->aw_end; i++) {
+		if ((e = elf_openarmember(aw->aw_ar, aw->aw_members[i])) ==
+		    NULL)
+			errx(EXIT_FAILURE, "elf_openarmember failed: %s",
+			    elf_errmsg(-1));
+		aw->aw_nsyms += scan_member(e);
+		(void) elf_end(e);
+	}
+
+	return (NULL);
+}
+
+int
+bench_ar(unsigned long iterations)
+{
+	Elf *ar, *e;
+	Elf_Cmd c;
+	off_t *off;
+	char *image, *member;
+	unsigned long n, rounds;
+	double t0, t1, tseq;
+	size_t k, msz, nmembers, nsyms, nt, sz;
+	long ncpu;
+	int rc;
+	pthread_t t[MAXTHREADS];
+	struct ar_worker aw[MAXTHREADS];
+
+	/* `iterations' is the number of members processed per case. */
+	rounds = (iterations + NMEMBERS - 1) / NMEMBERS;
+
+	member = make_member(&msz);
+	image = make_archive(member, msz, &sz);
+
+	if ((ncpu = sysconf(_SC_NPROCESSORS_ONLN)) < 1)
+		ncpu = 1;
+
+	(void) printf("%-12s %12s %12s %8s\n", "method", "threads",
+	    "member(us)", "speedup");
+
+	rc = 0;
+
+	/* Sequential traversal. */
+	nsyms = 0;
+	t0 = bench_now();
+	for (n = 0; n < rounds; n++) {
+		if ((ar = elf_memory(image, sz)) == NULL)
+			errx(EXIT_FAILURE, "elf_memory failed: %s",
+			    elf_errmsg(-1));
+		c = ELF_C_READ;
+		while ((e = elf_begin(-1, c, ar)) != NULL) {
+			nsyms += scan_member(e);
+			c = elf_next(e);
+			(void) elf_end(e);
+		}
+		(void) elf_end(ar);
+	}
+	t1 = bench_now();
+	tseq = t1 - t0;
+
+	if (nsyms != rounds * NMEMBERS * NSYMS) {
+		warnx("sequential: %zu symbols seen", nsyms);
+		rc = 1;
+	}
+
+	(void) printf("%-12s %12d %12.2f %8s\n", "elf_next", 1,
+	    tseq / 1e3 / (double) (rounds * NMEMBERS), "-");
+
+	/* Member table, with increasing numbers of threads. */
+	for (nt = 1; nt <= MAXTHREADS && nt <= (size_t) ncpu; nt *= 2) {
+		nsyms = 0;
+		t0 = bench_now();
+		for (n = 0; n < rounds; n++) {
+			if ((ar = elf_memory(image, sz)) == NULL ||
+			    (off = elf_getarmembers(ar, &nmembers)) == NULL)
+				errx(EXIT_FAILURE, "elf_getarmembers failed: "
+				    "%s", elf_errmsg(-1));
+
+			/* The calling thread processes the first share. */
+			for (k = 0; k < nt; k++) {
+				aw[k].aw_ar = ar;
+				aw[k].aw_members = off;
+				aw[k].aw_start = nmembers * k / nt;
+				aw[k].aw_end = nmembers * (k + 1) / nt;
+				if (k > 0 && pthread_create(&t[k], NULL,
+				    ar_worker, &aw[k]) != 0)
+					errx(EXIT_FAILURE,
+					    "pthread_create failed");
+			}
+
+			(void) ar_worker(&aw[0]);
+
+			for (k = 0; k < nt; k++) {
+				if (k > 0)
+					(void) pthread_join(t[k], NULL);
+				nsyms += aw[k].aw_nsyms;
+			}
+
+			(void) elf_end(ar);
+		}
+		t1 = bench_now();
+
+		if (nsyms != rounds * NMEMBERS * NSYMS) {
+			warnx("%zu threads: %zu symbols seen", nt, nsyms);
+			rc = 1;
+		}
+
+		(void) printf("%-12s %12zu %12.2f %7.2fx\n",
+		    "openarmember", nt,
+		    (t1 - t0) / 1e3 / (double) (rounds * NMEMBERS),
+		    tseq / (t1 - t0));
+	}
+
+	free(image);
+	free(member);
+
+	return (rc);
+}
@@ -0,0 +1,196 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <err.h>
+#include <fcntl.h>
+#include <gelf.h>
+#include <libelf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+/*
+ * Measure the cost of opening an object and retrieving one section,
+ * of looking up sections by index, and of resolving section names,
+ * as the number of sections in an object grows.  The per-lookup
+ * costs should not depend on the section count.
+ */
+
+static const size_t section_counts[] = {
+	10, 100, 1000, 10000, 100000
+};
+
+#define	NAMESZ		16	/* ".s" + digits + NUL */
+
+/*
+ * Create an ELF object with 'nscn' PROGBITS sections (plus the
+ * null section and the section name table) in a temporary file,
+ * returning a file descriptor open for reading.
+ */
+static int
+make_object(size_t nscn)
+{
+	Elf *e;
+	int fd;
+	char *names;
+	Elf_Scn *scn;
+	Elf_Data *d;
+	GElf_Ehdr eh;
+	GElf_Shdr sh;
+	size_t i, off, strndx;
+	char tmpl[] = "/tmp/libelf-bench.XXXXXX";
+
+	if ((fd = mkstemp(tmpl)) < 0)
+		err(EXIT_FAILURE, "mkstemp failed");
+	(void) unlink(tmpl);
+
+	if ((e = elf_begin(fd, ELF_C_WRITE, NULL)) == NULL ||
+	    gelf_newehdr(e, ELFCLASS64) == NULL ||
+	    gelf_getehdr(e, &eh) == NULL)
+		errx(EXIT_FAILURE, "elf_begin failed: %s", elf_errmsg(-1));
+
+	eh.e_ident[EI_DATA] = ELFDATA2LSB;
+	eh.e_type = ET_REL;
+	eh.e_machine = EM_X86_64;
+
+	if ((names = malloc((nscn + 2) * NAMESZ)) == NULL)
+		err(EXIT_FAILURE, "malloc failed");
+
+	names[0] = '\0';
+	off = 1;
+
+	for (i = 1; i <= nscn; i++) {
+		if ((scn = elf_newscn(e)) == NULL ||
+		    gelf_getshdr(scn, &sh) == NULL)
+			errx(EXIT_FAILURE, "elf_newscn failed: %s",
+			    elf_errmsg(-1));
+		sh.sh_name = off;
+		sh.sh_type = SHT_PROGBITS;
+		sh.sh_addralign = 1;
+		off += (size_t) snprintf(names + off, NAMESZ, ".s%zu", i) + 1;
+		if (gelf_update_shdr(scn, &sh) == 0)
+			errx(EXIT_FAILURE, "gelf_update_shdr failed: %s",
+			    elf_errmsg(-1));
+	}
+
+	/* The section name table. */
+	if ((scn = elf_newscn(e)) == NULL ||
+	    (d = elf_newdata(scn)) == NULL ||
+	    gelf_getshdr(scn, &sh) == NULL)
+		errx(EXIT_FAILURE, "elf_newscn failed: %s", elf_errmsg(-1));
+
+	sh.sh_name = off;
+	(void) strcpy(names + off, ".shstrtab");
+	off += sizeof(".shstrtab");
+	sh.sh_type = SHT_STRTAB;
+	sh.sh_addralign = 1;
+
+	d->d_buf = names;
+	d->d_size = off;
+	d->d_type = ELF_T_BYTE;
+	d->d_align = 1;
+
+	strndx = elf_ndxscn(scn);
+	if (gelf_update_shdr(scn, &sh) == 0 ||
+	    gelf_update_ehdr(e, &eh) == 0 ||
+	    elf_setshstrndx(e, strndx) == 0 ||
+	    elf_update(e, ELF_C_WRITE) < 0)
+		errx(EXIT_FAILURE, "elf_update failed: %s", elf_errmsg(-1));
+
+	(void) elf_end(e);
+	free(names);
+
+	return (fd);
+}
+
+int
+bench_getscn(unsigned long iterations)
+{
+	Elf *e;
+	int fd;
+	Elf_Scn *scn;
+	GElf_Shdr sh;
+	const char *name;
+	unsigned long n;
+	double t0, t1, t2, ts;
+	size_t c, ndx, nscn, strndx;
+	volatile size_t sink;
+
+	(void) printf("%-10s %12s %12s %12s\n", "sections", "first(us)",
+	    "getscn(ns)", "strptr(ns)");
+
+	for (c = 0; c < sizeof(section_counts) / sizeof(section_counts[0]);
+	     c++) {
+		fd = make_object(section_counts[c]);
+
+		/* Open the object and retrieve its last section. */
+		ts = bench_now();
+		if ((e = elf_begin(fd, ELF_C_READ, NULL)) == NULL ||
+		    elf_getshdrnum(e, &nscn) != 0 ||
+		    elf_getshdrstrndx(e, &strndx) != 0 ||
+		    elf_getscn(e, nscn - 1) == NULL)
+			errx(EXIT_FAILURE, "elf_begin failed: %s",
+			    elf_errmsg(-1));
+		ts = bench_now() - ts;
+
+		/* Visit sections in a scattered order. */
+		sink = 0;
+		t0 = bench_now();
+		for (n = 0; n < iterations; n++) {
+			ndx = (size_t) ((n * 2654435761UL) % nscn);
+			if ((scn = elf_getscn(e, ndx)) == NULL)
+				errx(EXIT_FAILURE, "elf_getscn failed: %s",
+				    elf_errmsg(-1));
+			sink += elf_ndxscn(scn);
+		}
+		t1 = bench_now();
+		for (n = 0; n < iterations; n++) {
+			ndx = 1 + (size_t) ((n * 2654435761UL) % (nscn - 1));
+			if ((scn = elf_getscn(e, ndx)) == NULL ||
+			    gelf_getshdr(scn, &sh) == NULL ||
+			    (name = elf_strptr(e, strndx, sh.sh_name)) == NULL)
+				errx(EXIT_FAILURE, "elf_strptr failed: %s",
+				    elf_errmsg(-1));
+			sink += (size_t) name[0];
+		}
+		t2 = bench_now();
+
+		(void) printf("%-10zu %12.1f %12.1f %12.1f\n",
+		    section_counts[c], ts / 1e3,
+		    (t1 - t0) / (double) iterations,
+		    (t2 - t1) / (double) iterations);
+
+		(void) elf_end(e);
+		(void) close(fd);
+	}
+
+	return (0);
+}
@@ -0,0 +1,140 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <err.h>
+#include <gelf.h>
+#include <libelf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bench.h"
+
+/*
+ * Measure the cost of elf_strptr() lookups in a string table made up
+ * of a varying number of data descriptors, as is the case for string
+ * tables being assembled by an application.
+ */
+
+static const size_t chunk_counts[] = {
+	1, 4, 16, 64, 256
+};
+
+#define	NSTRINGS	65536	/* Strings in the string table. */
+#define	STRSZ		8	/* Size of each string, with its NUL. */
+
+int
+bench_strptr(unsigned long iterations)
+{
+	Elf *e;
+	Elf_Scn *scn;
+	Elf_Data *d;
+	GElf_Shdr sh;
+	char *r, *strings;
+	unsigned long n;
+	double t0, t1;
+	size_t c, i, nchunks, ndx, off, per;
+	volatile size_t sink;
+	int fd, rc;
+	char tmpl[] = "/tmp/libelf-bench.XXXXXX";
+
+	if ((strings = malloc(NSTRINGS * STRSZ)) == NULL)
+		err(EXIT_FAILURE, "malloc failed");
+
+	for (i = 0; i < NSTRINGS; i++)
+		(void) snprintf(strings + i * STRSZ, STRSZ, "s%06zu", i);
+
+	/* The objects created are never written out. */
+	if ((fd = mkstemp(tmpl)) < 0)
+		err(EXIT_FAILURE, "mkstemp failed");
+	(void) unlink(tmpl);
+
+	(void) printf("%-10s %12s\n", "chunks", "strptr(ns)");
+
+	rc = 0;
+	for (c = 0; c < sizeof(chunk_counts) / sizeof(chunk_counts[0]); c++) {
+		nchunks = chunk_counts[c];
+		per = NSTRINGS / nchunks;
+
+		/* An object holding just the string table. */
+		if ((e = elf_begin(fd, ELF_C_WRITE, NULL)) == NULL ||
+		    gelf_newehdr(e, ELFCLASS64) == NULL ||
+		    (scn = elf_newscn(e)) == NULL ||
+		    gelf_getshdr(scn, &sh) == NULL)
+			errx(EXIT_FAILURE, "elf_begin failed: %s",
+			    elf_errmsg(-1));
+
+		sh.sh_type = SHT_STRTAB;
+		sh.sh_size = NSTRINGS * STRSZ;
+		if (gelf_update_shdr(scn, &sh) == 0)
+			errx(EXIT_FAILURE, "gelf_update_shdr failed: %s",
+			    elf_errmsg(-1));
+
+		for (i = 0; i < nchunks; i++) {
+			if ((d = elf_newdata(scn)) == NULL)
+				errx(EXIT_FAILURE, "elf_newdata failed: %s",
+				    elf_errmsg(-1));
+			d->d_buf = strings + i * per * STRSZ;
+			d->d_size = per * STRSZ;
+		}
+
+		ndx = elf_ndxscn(scn);
+
+		sink = 0;
+		t0 = bench_now();
+		for (n = 0; n < iterations; n++) {
+			off = (size_t) ((n * 2654435761UL) % NSTRINGS) * STRSZ;
+			if ((r = elf_strptr(e, ndx, off)) == NULL)
+				errx(EXIT_FAILURE, "elf_strptr failed: %s",
+				    elf_errmsg(-1));
+			sink += (size_t) r[1];
+		}
+		t1 = bench_now();
+
+		/* Spot check the results. */
+		for (i = 0; i < NSTRINGS; i += NSTRINGS / 16)
+			if ((r = elf_strptr(e, ndx, i * STRSZ)) == NULL ||
+			    strcmp(r, strings + i * STRSZ) != 0) {
+				warnx("%zu chunks: wrong string at offset %zu",
+				    nchunks, i * STRSZ);
+				rc = 1;
+				break;
+			}
+
+		(void) printf("%-10zu %12.1f\n", nchunks,
+		    (t1 - t0) / (double) iterations);
+
+		(void) elf_end(e);
+	}
+
+	(void) close(fd);
+	free(strings);
+
+	return (rc);
+}
@@ -0,0 +1,262 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <err.h>
+#include <libelf.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+
+/*
+ * Measure the throughput of cross-endian translation with
+ * elf{32,64}_xlatetom(), and compare it against translators written
+ * in the style of the member-at-a-time code that libelf_convert.m4
+ * used to generate.  The results of both are also checked to match.
+ */
+
+#define	NELEM		4096	/* Elements translated per call. */
+
+/*
+ * Copies of the READ_* and SWAP_* macros from libelf_convert.m4.
+ */
+#define	REF_READ(P,X)	do {						\
+		(void) memcpy(&(X), (P), sizeof(X));			\
+		(P) = (P) + sizeof(X);					\
+	} while (0)
+#define	REF_SWAP_HALF(X)	do {					\
+		uint16_t _x = (uint16_t) (X);				\
+		uint32_t _t = _x & 0xFFU;				\
+		_t <<= 8U; _x >>= 8U; _t |= _x & 0xFFU;			\
+		(X) = (uint16_t) _t;					\
+	} while (0)
+#define	REF_SWAP_WORD(X)	do {					\
+		uint32_t _x = (uint32_t) (X);				\
+		uint32_t _t = _x & 0xFF;				\
+		_t <<= 8; _x >>= 8; _t |= _x & 0xFF;			\
+		_t <<= 8; _x >>= 8; _t |= _x & 0xFF;			\
+		_t <<= 8; _x >>= 8; _t |= _x & 0xFF;			\
+		(X) = _t;						\
+	} while (0)
+#define	REF_SWAP_WORD64(X)	do {					\
+		uint64_t _x = (uint64_t) (X);				\
+		uint64_t _t = _x & 0xFF;				\
+		_t <<= 8; _x >>= 8; _t |= _x & 0xFF;			\
+		_t <<= 8; _x >>= 8; _t |= _x & 0xFF;			\
+		_t <<= 8; _x >>= 8; _t |= _x & 0xFF;			\
+		_t <<= 8; _x >>= 8; _t |= _x & 0xFF;			\
+		_t <<= 8; _x >>= 8; _t |= _x & 0xFF;			\
+		_t <<= 8; _x >>= 8; _t |= _x & 0xFF;			\
+		_t <<= 8; _x >>= 8; _t |= _x & 0xFF;			\
+		(X) = _t;						\
+	} while (0)
+
+static void
+ref_word(unsigned char *dst, const unsigned char *src, size_t count)
+{
+	uint32_t t, *d;
+
+	for (d = (uint32_t *) (uintptr_t) dst; count--; ) {
+		REF_READ(src, t);
+		REF_SWAP_WORD(t);
+		*d++ = t;
+	}
+}
+
+static void
+ref_xword(unsigned char *dst, const unsigned char *src, size_t count)
+{
+	uint64_t t, *d;
+
+	for (d = (uint64_t *) (uintptr_t) dst; count--; ) {
+		REF_READ(src, t);
+		REF_SWAP_WORD64(t);
+		*d++ = t;
+	}
+}
+
+static void
+ref_sym32(unsigned char *dst, const unsigned char *src, size_t count)
+{
+	Elf32_Sym t, *d;
+
+	for (d = (Elf32_Sym *) (uintptr_t) dst; count--; ) {
+		REF_READ(src, t.st_name);
+		REF_READ(src, t.st_value);
+		REF_READ(src, t.st_size);
+		REF_READ(src, t.st_info);
+		REF_READ(src, t.st_other);
+		REF_READ(src, t.st_shndx);
+		REF_SWAP_WORD(t.st_name);
+		REF_SWAP_WORD(t.st_value);
+		REF_SWAP_WORD(t.st_size);
+		REF_SWAP_HALF(t.st_shndx);
+		*d++ = t;
+	}
+}
+
+static void
+ref_sym64(unsigned char *dst, const unsigned char *src, size_t count)
+{
+	Elf64_Sym t, *d;
+
+	for (d = (Elf64_Sym *) (uintptr_t) dst; count--; ) {
+		REF_READ(src, t.st_name);
+		REF_READ(src, t.st_info);
+		REF_READ(src, t.st_other);
+		REF_READ(src, t.st_shndx);
+		REF_READ(src, t.st_value);
+		REF_READ(src, t.st_size);
+		REF_SWAP_WORD(t.st_name);
+		REF_SWAP_HALF(t.st_shndx);
+		REF_SWAP_WORD64(t.st_value);
+		REF_SWAP_WORD64(t.st_size);
+		*d++ = t;
+	}
+}
+
+static void
+ref_rela64(unsigned char *dst, const unsigned char *src, size_t count)
+{
+	Elf64_Rela t, *d;
+
+	for (d = (Elf64_Rela *) (uintptr_t) dst; count--; ) {
+		REF_READ(src, t.r_offset);
+		REF_READ(src, t.r_info);
+		REF_READ(src, t.r_addend);
+		REF_SWAP_WORD64(t.r_offset);
+		REF_SWAP_WORD64(t.r_info);
+		REF_SWAP_WORD64(t.r_addend);
+		*d++ = t;
+	}
+}
+
+static void
+ref_dyn64(unsigned char *dst, const unsigned char *src, size_t count)
+{
+	Elf64_Dyn t, *d;
+
+	for (d = (Elf64_Dyn *) (uintptr_t) dst; count--; ) {
+		REF_READ(src, t.d_tag);
+		REF_READ(src, t.d_un.d_val);
+		REF_SWAP_WORD64(t.d_tag);
+		REF_SWAP_WORD64(t.d_un.d_val);
+		*d++ = t;
+	}
+}
+
+static const struct xlate_case {
+	const char	*x_name;
+	Elf_Type	x_type;
+	int		x_class;
+	size_t		x_size;
+	void		(*x_ref)(unsigned char *, const unsigned char *,
+			    size_t);
+} xlate_cases[] = {
+	{ "WORD",	ELF_T_WORD,	ELFCLASS32, 4,	ref_word },
+	{ "XWORD",	ELF_T_XWORD,	ELFCLASS64, 8,	ref_xword },
+	{ "SYM32",	ELF_T_SYM,	ELFCLASS32, 16,	ref_sym32 },
+	{ "SYM64",	ELF_T_SYM,	ELFCLASS64, 24,	ref_sym64 },
+	{ "RELA64",	ELF_T_RELA,	ELFCLASS64, 24,	ref_rela64 },
+	{ "DYN64",	ELF_T_DYN,	ELFCLASS64, 16,	ref_dyn64 }
+};
+
+int
+bench_xlate(unsigned long iterations)
+{
+	Elf_Data dst, src;
+	unsigned char *fbuf, *mbuf, *rbuf;
+	const struct xlate_case *x;
+	unsigned long n, rounds;
+	double t0, t1, t2, bytes;
+	unsigned int encoding;
+	size_t c, i, sz;
+	int rc;
+
+	/* Translate from the non-native byte order. */
+	c = 1;
+	encoding = *(unsigned char *) &c ? ELFDATA2MSB : ELFDATA2LSB;
+
+	/* `iterations' is the number of elements translated per case. */
+	rounds = (iterations + NELEM - 1) / NELEM;
+
+	if ((fbuf = malloc(NELEM * 24)) == NULL ||
+	    (mbuf = malloc(NELEM * 24)) == NULL ||
+	    (rbuf = malloc(NELEM * 24)) == NULL)
+		err(EXIT_FAILURE, "malloc failed");
+
+	for (i = 0; i < NELEM * 24; i++)
+		fbuf[i] = (unsigned char) (i * 2654435761UL >> 13);
+
+	(void) printf("%-8s %14s %14s %8s\n", "type", "generic(MB/s)",
+	    "libelf(MB/s)", "speedup");
+
+	rc = 0;
+	for (c = 0; c < sizeof(xlate_cases) / sizeof(xlate_cases[0]); c++) {
+		x = &xlate_cases[c];
+		sz = NELEM * x->x_size;
+
+		src.d_buf = fbuf;
+		src.d_size = sz;
+		src.d_type = x->x_type;
+		src.d_version = EV_CURRENT;
+		dst.d_buf = mbuf;
+		dst.d_size = sz;
+		dst.d_version = EV_CURRENT;
+
+		t0 = bench_now();
+		for (n = 0; n < rounds; n++)
+			(*x->x_ref)(rbuf, fbuf, NELEM);
+		t1 = bench_now();
+		for (n = 0; n < rounds; n++)
+			if ((x->x_class == ELFCLASS32 ?
+			    elf32_xlatetom(&dst, &src, encoding) :
+			    elf64_xlatetom(&dst, &src, encoding)) == NULL)
+				errx(EXIT_FAILURE, "xlatetom failed: %s",
+				    elf_errmsg(-1));
+		t2 = bench_now();
+
+		if (memcmp(mbuf, rbuf, sz) != 0) {
+			warnx("%s: translation results differ", x->x_name);
+			rc = 1;
+		}
+
+		bytes = (double) sz * (double) rounds;
+		(void) printf("%-8s %14.1f %14.1f %7.2fx\n", x->x_name,
+		    bytes * 1e3 / (t1 - t0), bytes * 1e3 / (t2 - t1),
+		    (t1 - t0) / (t2 - t1));
+	}
+
+	free(fbuf);
+	free(mbuf);
+	free(rbuf);
+
+	return (rc);
+}
@@ -256,7 +256,7 @@ divert(0)
 #define	OFF_SEQ_MSB64	QUAD_SEQ_MSB
 #define	OFF_VAL64	QUAD_VAL64
 
-#define	NCOPIES		3
+#define	NCOPIES		11	/* Enough for the vectorized swaps. */
 #define	NOFFSET		8	/* Every alignment in a quad word. */
 
 divert(-1)
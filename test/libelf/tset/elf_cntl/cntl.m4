@@ -89,7 +89,9 @@ tcInvalidInvalid(void)
 	ret = error = 0;
 	result = TET_PASS;
 	for (c = ELF_C_FIRST-1; c <= ELF_C_LAST; c++) {
-		if (c == ELF_C_FDDONE || c == ELF_C_FDREAD)
+		if (c == ELF_C_FDDONE || c == ELF_C_FDREAD ||
+		    c == ELF_C_ADVISE_NORMAL || c == ELF_C_ADVISE_RANDOM ||
+		    c == ELF_C_ADVISE_SEQUENTIAL || c == ELF_C_ADVISE_HUGEPAGE)
 			continue;
 		if ((ret = elf_cntl(e, c)) != -1 ||
 		    (error = elf_errno()) != ELF_E_ARGUMENT) {
@@ -126,6 +128,38 @@ tcReadFDREAD(void)
 	tet_result(result);
 }
 
+/*
+ * Access pattern hints are accepted for descriptors opened for reading.
+ */
+void
+tcReadAdvise(void)
+{
+	Elf *e;
+	int c, result;
+
+	TP_ANNOUNCE("elf_cntl(e,ADVISE_*) for a read-only descriptor "
+	    "succeeds.");
+
+	TP_CHECK_INITIALIZATION();
+
+	TS_OPEN_MEMORY(e, elf_file);
+
+	result = TET_PASS;
+	for (c = ELF_C_ADVISE_NORMAL; c <= ELF_C_ADVISE_HUGEPAGE; c++) {
+		if (elf_cntl(e, c) != 0) {
+			TP_FAIL("c = %d, elf_errmsg=\"%s\".", c,
+			    elf_errmsg(-1));
+			break;
+		}
+	}
+
+	if (result == TET_PASS && elf_getident(e, NULL) == NULL)
+		TP_FAIL("elf_getident() failed: \"%s\".", elf_errmsg(-1));
+
+	(void) elf_end(e);
+	tet_result(result);
+}
+
 static char pathname[PATH_MAX];
 
 /*
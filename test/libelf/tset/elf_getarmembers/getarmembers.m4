@@ -0,0 +1,316 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <ar.h>
+#include <libelf.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "elfts.h"
+#include "tet_api.h"
+
+IC_REQUIRES_VERSION_INIT();
+
+include(`elfts.m4')
+
+/*
+ * The following definitions should match those in `./Makefile'.
+ */
+define(`TP_ARFILE_BSD', `"a-bsd.ar"')
+define(`TP_ARFILE_SVR4', `"a.ar"')
+define(`TP_NONARCHIVE', `"s1"')
+
+/* The members of the test archives, in order. */
+static const char *members[] = {
+	"s1",
+	"s------------------------2",
+	"s 3"
+};
+
+#define	NMEMBERS	(sizeof(members) / sizeof(members[0]))
+
+/*
+ * A NULL `Elf' argument fails.
+ */
+void
+tcArgsNull(void)
+{
+	int error, result;
+	size_t n;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_getarmembers(NULL) and elf_openarmember(NULL) "
+	    "fail.");
+
+	result = TET_PASS;
+	error = ELF_E_NONE;
+	n = ~(size_t) 0;
+
+	if (elf_getarmembers(NULL, &n) != NULL || n != (size_t) 0 ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("elf_getarmembers(): n=%d error=%d \"%s\".",
+		    (int) n, error, elf_errmsg(error));
+	else if (elf_openarmember(NULL, SARMAG) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("elf_openarmember(): error=%d \"%s\".", error,
+		    elf_errmsg(error));
+
+	tet_result(result);
+}
+
+/*
+ * Both functions fail on a descriptor that is not for an archive.
+ */
+void
+tcArgsNonAr(void)
+{
+	Elf *e;
+	int error, fd, result;
+	size_t n;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_getarmembers(non-ar) and elf_openarmember(non-ar) "
+	    "fail.");
+
+	TS_OPEN_FILE(e, TP_NONARCHIVE, ELF_C_READ, fd);
+
+	result = TET_PASS;
+	error = ELF_E_NONE;
+	n = ~(size_t) 0;
+
+	if (elf_getarmembers(e, &n) != NULL || n != (size_t) 0 ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("elf_getarmembers(): n=%d error=%d \"%s\".",
+		    (int) n, error, elf_errmsg(error));
+	else if (elf_openarmember(e, SARMAG) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("elf_openarmember(): error=%d \"%s\".", error,
+		    elf_errmsg(error));
+
+	(void) elf_end(e);
+	(void) close(fd);
+
+	tet_result(result);
+}
+
+/*
+ * The member table lists the members visited by elf_begin() and
+ * elf_next(), in the same order, and the descriptors returned by
+ * elf_openarmember() match those returned by elf_begin().
+ */
+undefine(`FN')
+define(`FN',`
+void
+tcMemberTable$1(void)
+{
+	Elf *ar, *e;
+	Elf_Arhdr *arh;
+	Elf_Cmd c;
+	off_t base[NMEMBERS], *off;
+	int fd, result;
+	size_t i, n;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("$1: the member table matches a sequential traversal.");
+
+	TS_OPEN_FILE(ar, TP_ARFILE_$1, ELF_C_READ, fd);
+
+	result = TET_UNRESOLVED;
+
+	/* Record the member offsets seen by a sequential traversal. */
+	for (i = 0, c = ELF_C_READ; (e = elf_begin(fd, c, ar)) != NULL;
+	     i++) {
+		if (i >= NMEMBERS || (arh = elf_getarhdr(e)) == NULL ||
+		    strcmp(arh->ar_name, members[i]) != 0) {
+			TP_UNRESOLVED("traversal failed at member %d.",
+			    (int) i);
+			(void) elf_end(e);
+			goto done;
+		}
+		base[i] = elf_getbase(e);
+		c = elf_next(e);
+		(void) elf_end(e);
+	}
+
+	if (i != NMEMBERS) {
+		TP_UNRESOLVED("traversal returned %d members.", (int) i);
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	n = ~(size_t) 0;
+	if ((off = elf_getarmembers(ar, &n)) == NULL) {
+		TP_FAIL("elf_getarmembers() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if (n != NMEMBERS || off[n] != (off_t) 0) {
+		TP_FAIL("n=%d off[n]=%lld.", (int) n, (long long) off[n]);
+		goto done;
+	}
+
+	/* Open the members in reverse order. */
+	for (i = n; i-- > 0; ) {
+		if ((e = elf_openarmember(ar, off[i])) == NULL) {
+			TP_FAIL("elf_openarmember(%lld) failed: \"%s\".",
+			    (long long) off[i], elf_errmsg(-1));
+			goto done;
+		}
+
+		if ((arh = elf_getarhdr(e)) == NULL ||
+		    strcmp(arh->ar_name, members[i]) != 0 ||
+		    elf_getbase(e) != base[i])
+			TP_FAIL("member %d: name=\"%s\" base=%lld.", (int) i,
+			    arh ? arh->ar_name : "",
+			    (long long) elf_getbase(e));
+
+		(void) elf_end(e);
+		if (result != TET_PASS)
+			goto done;
+	}
+
+	/* The table is retained by the library. */
+	if (elf_getarmembers(ar, NULL) != off)
+		TP_FAIL("the member table was recomputed.");
+
+ done:
+	(void) elf_end(ar);
+	(void) close(fd);
+
+	tet_result(result);
+}')
+
+FN(SVR4)
+FN(BSD)
+
+/*
+ * elf_openarmember() does not disturb a sequential traversal.
+ */
+void
+tcCursorUnchanged(void)
+{
+	Elf *ar, *e, *m;
+	Elf_Arhdr *arh;
+	off_t *off;
+	int fd, result;
+	size_t n;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_openarmember() leaves the traversal position "
+	    "unchanged.");
+
+	TS_OPEN_FILE(ar, TP_ARFILE_SVR4, ELF_C_READ, fd);
+
+	result = TET_UNRESOLVED;
+	e = m = NULL;
+
+	if ((off = elf_getarmembers(ar, &n)) == NULL || n != NMEMBERS ||
+	    (e = elf_begin(fd, ELF_C_READ, ar)) == NULL) {
+		TP_UNRESOLVED("setup failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	if ((m = elf_openarmember(ar, off[n - 1])) == NULL) {
+		TP_FAIL("elf_openarmember() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	(void) elf_next(e);
+	(void) elf_end(e);
+
+	if ((e = elf_begin(fd, ELF_C_READ, ar)) == NULL ||
+	    (arh = elf_getarhdr(e)) == NULL ||
+	    strcmp(arh->ar_name, members[1]) != 0)
+		TP_FAIL("the traversal did not resume at member 1.");
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (m)
+		(void) elf_end(m);
+	(void) elf_end(ar);
+	(void) close(fd);
+
+	tet_result(result);
+}
+
+/*
+ * elf_openarmember() rejects invalid offsets.
+ */
+void
+tcBadOffset(void)
+{
+	Elf *ar;
+	off_t *off;
+	int error, fd, result;
+	size_t n;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_openarmember() fails with an invalid offset.");
+
+	TS_OPEN_FILE(ar, TP_ARFILE_SVR4, ELF_C_READ, fd);
+
+	result = TET_UNRESOLVED;
+
+	if ((off = elf_getarmembers(ar, &n)) == NULL || n == 0) {
+		TP_UNRESOLVED("elf_getarmembers() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+	error = ELF_E_NONE;
+
+	if (elf_openarmember(ar, (off_t) 1) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("offset 1: error=%d \"%s\".", error,
+		    elf_errmsg(error));
+	else if (elf_openarmember(ar, off[0] + 1) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("odd offset: error=%d \"%s\".", error,
+		    elf_errmsg(error));
+	else if (elf_openarmember(ar, off[0] + 2) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARCHIVE)
+		TP_FAIL("misplaced offset: error=%d \"%s\".", error,
+		    elf_errmsg(error));
+
+ done:
+	(void) elf_end(ar);
+	(void) close(fd);
+
+	tet_result(result);
+}
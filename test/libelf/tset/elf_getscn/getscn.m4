@@ -151,6 +151,72 @@ FN(32,`msb')
 FN(64,`lsb')
 FN(64,`msb')
 
+/*
+ * Sections retrieved out of order are the ones seen by elf_nextscn().
+ */
+
+undefine(`FN')
+define(`FN',`
+void
+tcElfReverse$1$2(void)
+{
+	Elf *e;
+	Elf_Scn *scn;
+	int fd, result;
+	size_t nsections, n;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: sections retrieved in reverse order "
+	    "match those returned by elf_nextscn().");
+
+	e = NULL;
+	fd = -1;
+	result = TET_UNRESOLVED;
+
+	_TS_OPEN_FILE(e, "newscn.$2$1", ELF_C_READ, fd, goto done;);
+
+	if (elf_getshnum(e, &nsections) == 0) {
+		TP_UNRESOLVED("elf_getshnum() failed.");
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	for (n = nsections; n > 1; n -= 2) {
+		if ((scn = elf_getscn(e, n - 1)) == NULL ||
+		    elf_ndxscn(scn) != n - 1) {
+			TP_FAIL("elf_getscn(%d) failed: \"%s\".", n - 1,
+			    elf_errmsg(-1));
+			goto done;
+		}
+	}
+
+	for (n = 1, scn = NULL; (scn = elf_nextscn(e, scn)) != NULL; n++) {
+		if (scn != elf_getscn(e, n)) {
+			TP_FAIL("section %d mismatch.", n);
+			goto done;
+		}
+	}
+
+	if (n != nsections)
+		TP_FAIL("elf_nextscn() returned %d sections, expected %d.",
+		    n, nsections);
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+
+	tet_result(result);
+}')
+
+FN(32,`lsb')
+FN(32,`msb')
+FN(64,`lsb')
+FN(64,`msb')
+
 /*
  * elf_getscn(e,nsections+1) returns NULL.
  */
@@ -354,10 +354,204 @@ FN(64,`lsb',`newscn')
 FN(64,`msb',`newscn')
 
 /*
- * TODO: With the layout bit set, an out of bounds offset is detected.
+ * Check that a change to a data descriptor flagged with elf_flagdata()
+ * is seen by subsequent lookups.
  */
 
+static char changedstring[] = {
+	'w', 'x', 'y', 'z', '\0'
+};
+
+undefine(`FN')
+define(`FN',`
+void
+tcDataChange$1`'TOUPPER($2)(void)
+{
+	int fd, result;
+	Elf *e;
+	Elf_Scn *scn;
+	Elf_Data *d;
+	Elf$1_Ehdr *eh;
+	char *r;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: changes to flagged data are seen.");
+
+	_TS_OPEN_FILE(e, "$3.$2$1", ELF_C_READ, fd, goto done;);
+
+	if ((eh = elf$1_getehdr(e)) == NULL) {
+		TP_UNRESOLVED("elf$1_getehdr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((scn = elf_getscn(e, eh->e_shstrndx)) == NULL) {
+		TP_UNRESOLVED("elf_getscn() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((d = elf_newdata(scn)) == NULL) {
+		TP_UNRESOLVED("elf_newdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	d->d_align  = 512;
+	d->d_buf  = teststring;
+	d->d_size = sizeof(teststring);
+
+	if (elf_update(e, ELF_C_NULL) < 0) {
+		TP_UNRESOLVED("elf_update() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((r = elf_strptr(e, eh->e_shstrndx, 512)) == NULL ||
+	    strcmp(r, "abcd") != 0) {
+		TP_UNRESOLVED("r=\"%s\" error=\"%s\".", r, elf_errmsg(-1));
+		goto done;
+	}
+
+	/* Replace the contents of the data descriptor. */
+	d->d_buf = changedstring;
+
+	if (elf_flagdata(d, ELF_C_SET, ELF_F_DIRTY) != ELF_F_DIRTY) {
+		TP_UNRESOLVED("elf_flagdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	if ((r = elf_strptr(e, eh->e_shstrndx, 513)) == NULL ||
+	    strcmp(r, "xyz") != 0)
+		TP_FAIL("r=\"%s\" error=\"%s\".", r, elf_errmsg(-1));
+
+ done:
+	(void) elf_end(e);
+	tet_result(result);
+}')
+
+FN(32,`lsb',`newscn')
+FN(32,`msb',`newscn')
+FN(64,`lsb',`newscn')
+FN(64,`msb',`newscn')
+
 /*
- * TODO: With the layout bit set, strings are correctly retrieved.
+ * With the layout bit set, strings are correctly retrieved using the
+ * `d_off' members of data descriptors, and offsets not covered by
+ * any data descriptor are rejected.
  */
 
+undefine(`FN')
+define(`FN',`
+void
+tcLayoutValidOffset$1`'TOUPPER($2)(void)
+{
+	int error, fd, result;
+	Elf *e;
+	Elf_Scn *scn;
+	Elf_Data *d;
+	Elf$1_Shdr *sh;
+	Elf$1_Ehdr *eh;
+	char *r;
+	struct refstr *rs;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: strings are retrieved with the layout "
+	    "bit set.");
+
+	_TS_OPEN_FILE(e, "$3.$2$1", ELF_C_READ, fd, goto done;);
+
+	if ((elf_flagelf(e, ELF_C_SET, ELF_F_LAYOUT) & ELF_F_LAYOUT) == 0) {
+		TP_UNRESOLVED("elf_flagelf() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((eh = elf$1_getehdr(e)) == NULL) {
+		TP_UNRESOLVED("elf$1_getehdr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((scn = elf_getscn(e, eh->e_shstrndx)) == NULL) {
+		TP_UNRESOLVED("elf_getscn() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((sh = elf$1_getshdr(scn)) == NULL) {
+		TP_UNRESOLVED("elf$1_getshdr(): failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	/*
+	 * Add data descriptors at offsets 1024 and 512, in that
+	 * order.
+	 */
+	if ((d = elf_newdata(scn)) == NULL) {
+		TP_UNRESOLVED("elf_newdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	d->d_off  = 1024;
+	d->d_buf  = changedstring;
+	d->d_size = sizeof(changedstring);
+
+	if ((d = elf_newdata(scn)) == NULL) {
+		TP_UNRESOLVED("elf_newdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	d->d_off  = 512;
+	d->d_buf  = teststring;
+	d->d_size = sizeof(teststring);
+
+	if (elf_flagdata(d, ELF_C_SET, ELF_F_DIRTY) != ELF_F_DIRTY) {
+		TP_UNRESOLVED("elf_flagdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	sh->sh_size = 1024 + sizeof(changedstring);
+
+	result = TET_PASS;
+
+	for (rs = refstr; rs < &refstr[NSTATIC + 1]; rs++)
+		if ((r = elf_strptr(e, eh->e_shstrndx, rs->offset)) == NULL ||
+		    strcmp(r, rs->string) != 0) {
+			TP_FAIL("r=\"%s\" rs=\"%s\" offset=%d error=\"%s\".",
+			    r, rs->string, rs->offset, elf_errmsg(-1));
+			goto done;
+		}
+
+	if ((r = elf_strptr(e, eh->e_shstrndx, 1024)) == NULL ||
+	    strcmp(r, "wxyz") != 0) {
+		TP_FAIL("r=\"%s\" offset=1024 error=\"%s\".", r,
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	/* An offset in between data descriptors. */
+	if ((r = elf_strptr(e, eh->e_shstrndx, 1000)) != NULL ||
+	    (error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("r=%p offset=1000 error=%d \"%s\".", (void *) r,
+		    error, elf_errmsg(error));
+
+ done:
+	(void) elf_end(e);
+	tet_result(result);
+}')
+
+FN(32,`lsb',`newscn')
+FN(32,`msb',`newscn')
+FN(64,`lsb',`newscn')
+FN(64,`msb',`newscn')
+
@@ -707,6 +707,129 @@ FN(32,`msb')
 FN(64,`lsb')
 FN(64,`msb')
 
+/*
+ * Check that elf_update(ELF_C_WRITE) on an existing, larger file
+ * leaves no stale bytes behind: gaps between the parts of the new
+ * object read back as zeros and the file is truncated to its new
+ * size.
+ */
+
+static unsigned char stale[1024];
+
+undefine(`FN')
+define(`FN',`
+void
+tcUpdateOverwrite$1$2(void)
+{
+	int fd, result;
+	off_t offset;
+	size_t esz, fsz, psz, roundup, ssz;
+	Elf$1_Shdr *sh;
+	Elf$1_Ehdr *eh;
+	Elf$1_Phdr *ph;
+	Elf_Data *d;
+	Elf_Scn *scn;
+	Elf *e;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: elf_update() replaces the contents of "
+	    "an existing file.");
+
+	result = TET_UNRESOLVED;
+	fd = -1;
+	e = NULL;
+
+	(void) memset(stale, 0xFF, sizeof(stale));
+	_TS_WRITE_FILE(TS_NEWFILE, stale, sizeof(stale), goto done;);
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_WRITE, fd, goto done;);
+
+	if ((eh = elf$1_newehdr(e)) == NULL) {
+		TP_UNRESOLVED("elf$1_newehdr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	/* Set the version and endianness */
+	eh->e_version = EV_CURRENT;
+	eh->e_ident[EI_DATA] = ELFDATA2`'TOUPPER($2);
+	eh->e_type = ET_REL;
+
+	if ((esz = elf$1_fsize(ELF_T_EHDR, 1, EV_CURRENT)) == 0 ||
+	    (psz = elf$1_fsize(ELF_T_PHDR, 1, EV_CURRENT)) == 0 ||
+	    (ssz = elf$1_fsize(ELF_T_SHDR, 2, EV_CURRENT)) == 0) {
+		TP_UNRESOLVED("elf$1_fsize() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((ph = elf$1_newphdr(e,1)) == NULL) {
+		TP_UNRESOLVED("elf$1_newphdr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	INIT_PHDR(ph);
+
+	if ((scn = elf_newscn(e)) == NULL) {
+		TP_UNRESOLVED("elf_newscn() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	eh->e_shstrndx = elf_ndxscn(scn);
+
+	if ((sh = elf$1_getshdr(scn)) == NULL) {
+		TP_UNRESOLVED("elf$1_getshdr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((d = elf_newdata(scn)) == NULL) {
+		TP_UNRESOLVED("elf_newdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	d->d_buf  = (char *) strtab;
+	d->d_size = sizeof(strtab);
+	d->d_off  = (off_t) 0;
+
+	INIT_SHDR(sh, esz+psz);
+
+	fsz = esz + psz + sizeof(strtab);
+	roundup = ifelse($1,32,4,8);
+	fsz = (fsz + roundup - 1) & ~(roundup - 1);
+
+	fsz += ssz;
+
+	if ((offset = elf_update(e, ELF_C_WRITE)) != fsz) {
+		TP_FAIL("ret=%jd != %d [elferror=\"%s\"]",
+		    (intmax_t) offset, fsz, elf_errmsg(-1));
+		goto done;
+	}
+
+	(void) elf_end(e);	e = NULL;
+	(void) close(fd);	fd = -1;
+
+	result = elfts_compare_files("u1.$2$1", TS_NEWFILE);
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	(void) unlink(TS_NEWFILE);
+
+	tet_result(result);
+}')
+
+FN(32,`lsb')
+FN(32,`msb')
+FN(64,`lsb')
+FN(64,`msb')
+
 /*
  * An unsupported section type should be rejected.
  */
@@ -1952,6 +2075,152 @@ FN(32,msb)
 FN(64,lsb)
 FN(64,msb)
 
+/*
+ * Test that changing the contents of a section without changing its
+ * size is written out, and is visible both through the updated
+ * descriptor and in the underlying file.
+ */
+
+undefine(`FN')
+define(`FN',`
+void
+tcRdWrModifySection_$1$2(void)
+{
+	int error, fd, result;
+	struct stat sb;
+	Elf *e;
+	Elf_Scn *scn;
+	Elf_Data *d;
+	GElf_Shdr sh;
+	const char *srcfile = "rdwr.$2$1";
+	off_t fsz;
+	char *raw, *tfn;
+	size_t rawsz;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: elf_update() writes out a section "
+	    "modified in place");
+
+	result = TET_UNRESOLVED;
+	e = NULL;
+	fd = -1;
+	tfn = NULL;
+
+	/* Make a copy of the reference object. */
+	if ((tfn = elfts_copy_file(srcfile, &error)) < 0) {
+		TP_UNRESOLVED("elfts_copyfile(%s) failed: \"%s\".",
+		    srcfile, strerror(error));
+		goto done;
+	}
+
+	/* Open the copied object in RDWR mode. */
+	_TS_OPEN_FILE(e, tfn, ELF_C_RDWR, fd, goto done;);
+
+	if (fstat(fd, &sb) < 0) {
+		TP_UNRESOLVED("fstat() failed: \"%s\".",
+		    strerror(errno));
+		goto done;
+	}
+
+	/* Retrieve section 1 and change its contents. */
+	if ((scn = elf_getscn(e, 1)) == NULL) {
+		TP_UNRESOLVED("elf_getscn() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((d = elf_getdata(scn, NULL)) == NULL) {
+		TP_UNRESOLVED("elf_getdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if (gelf_getshdr(scn, &sh) == NULL) {
+		TP_UNRESOLVED("gelf_getshdr() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if (d->d_size != strlen(base_data) || sh.sh_size != d->d_size ||
+	    memcmp(d->d_buf, base_data, d->d_size) != 0) {
+		TP_UNRESOLVED("unexpected section contents.");
+		goto done;
+	}
+
+	(void) memcpy(d->d_buf, "H", 1);
+
+	if (elf_flagdata(d, ELF_C_SET, ELF_F_DIRTY) != ELF_F_DIRTY) {
+		TP_UNRESOLVED("elf_flagdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((fsz = elf_update(e, ELF_C_WRITE)) < 0) {
+		TP_FAIL("elf_update(WRITE) failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if (fsz != sb.st_size) {
+		TP_FAIL("Size error: expected=%d, elf_update()=%d",
+		    sb.st_size, fsz);
+		goto done;
+	}
+
+	/* The image of the file held by the descriptor is updated. */
+	if ((raw = elf_rawfile(e, &rawsz)) == NULL) {
+		TP_FAIL("elf_rawfile() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if (rawsz < sh.sh_offset + sh.sh_size ||
+	    memcmp(raw + sh.sh_offset, "Hello world", sh.sh_size) != 0) {
+		TP_FAIL("descriptor contents were not updated.");
+		goto done;
+	}
+
+	(void) elf_end(e);
+	(void) close(fd);
+	e = NULL;
+	fd = -1;
+
+	/* So should a fresh descriptor for the file. */
+	_TS_OPEN_FILE(e, tfn, ELF_C_READ, fd, goto done;);
+
+	if ((scn = elf_getscn(e, 1)) == NULL ||
+	    (d = elf_getdata(scn, NULL)) == NULL) {
+		TP_FAIL("elf_getdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if (d->d_size != strlen(base_data) ||
+	    memcmp(d->d_buf, "Hello world", d->d_size) != 0) {
+		TP_FAIL("file contents were not updated.");
+		goto done;
+	}
+
+	result = TET_PASS;
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+	if (tfn != NULL)
+		(void) unlink(tfn);
+
+	tet_result(result);
+}
+')
+
+FN(32,lsb)
+FN(32,msb)
+FN(64,lsb)
+FN(64,msb)
+
 /*
  * Test cases rejecting malformed ELF files created with the
  * ELF_F_LAYOUT flag set.
@@ -0,0 +1,310 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#define	_GNU_SOURCE		/* RTLD_NEXT */
+
+#include <sys/types.h>
+#include <sys/mman.h>
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <libelf.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "elfts.h"
+#include "tet_api.h"
+
+IC_REQUIRES_VERSION_INIT();
+
+include(`elfts.m4')
+
+/*
+ * Test the reading in of large files on demand.
+ *
+ * Files that cannot be mapped in are read in by the library, a
+ * chunk (1MB) at a time, as their parts get used.  To exercise this
+ * path, the test purposes below make mmap(2) refuse to map files.
+ */
+
+#define	OD_SIZE1	(3 * 1024 * 1024 + 123)	/* spans several chunks */
+#define	OD_SIZE2	4096
+
+static int od_refuse;		/* Refuse to map files in. */
+static int od_refused;		/* Number of mappings refused. */
+
+void *
+mmap(void *addr, size_t len, int prot, int flags, int fd, off_t off)
+{
+	static void *(*sysmmap)(void *, size_t, int, int, int, off_t);
+
+	if (od_refuse && fd >= 0) {
+		od_refused++;
+		errno = ENODEV;
+		return (MAP_FAILED);
+	}
+
+	if (sysmmap == NULL &&
+	    (sysmmap = (void *(*)(void *, size_t, int, int, int, off_t))
+	    dlsym(RTLD_NEXT, "mmap")) == NULL) {
+		errno = ENOSYS;
+		return (MAP_FAILED);
+	}
+
+	return ((*sysmmap)(addr, len, prot, flags, fd, off));
+}
+
+/*
+ * The contents of byte `i' of a section.  The period of the pattern
+ * is not a divisor of the chunk size.
+ */
+#define	OD_BYTE(I)	((unsigned char) ((I) % 251))
+
+static int
+od_check(Elf_Data *d, size_t sz)
+{
+	size_t i;
+	unsigned char *p;
+
+	if (d == NULL || d->d_size != sz || (p = d->d_buf) == NULL)
+		return (0);
+
+	for (i = 0; i < sz; i++)
+		if (p[i] != OD_BYTE(i))
+			return (0);
+
+	return (1);
+}
+
+/*
+ * Create a file with two sections, the first of which is larger than
+ * a chunk.
+ */
+static int
+od_create(const char *fn)
+{
+	Elf *e;
+	Elf64_Ehdr *eh;
+	Elf_Data *d;
+	Elf_Scn *scn;
+	Elf64_Shdr *sh;
+	int fd, i, ok;
+	size_t j, sz;
+	unsigned char *buf[2];
+
+	ok = 0;
+	e = NULL;
+	buf[0] = buf[1] = NULL;
+
+	(void) unlink(fn);
+	if ((fd = open(fn, O_WRONLY | O_CREAT, 0644)) < 0)
+		return (0);
+
+	if ((e = elf_begin(fd, ELF_C_WRITE, NULL)) == NULL ||
+	    (eh = elf64_newehdr(e)) == NULL)
+		goto done;
+
+	eh->e_ident[EI_DATA] = ELFDATA2LSB;
+	eh->e_type = ET_REL;
+
+	for (i = 0; i < 2; i++) {
+		sz = i == 0 ? OD_SIZE1 : OD_SIZE2;
+		if ((buf[i] = malloc(sz)) == NULL)
+			goto done;
+		for (j = 0; j < sz; j++)
+			buf[i][j] = OD_BYTE(j);
+
+		if ((scn = elf_newscn(e)) == NULL ||
+		    (sh = elf64_getshdr(scn)) == NULL ||
+		    (d = elf_newdata(scn)) == NULL)
+			goto done;
+
+		sh->sh_type = SHT_PROGBITS;
+		d->d_buf = buf[i];
+		d->d_size = sz;
+		d->d_align = 1;
+		d->d_type = ELF_T_BYTE;
+	}
+
+	ok = elf_update(e, ELF_C_WRITE) > 0;
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	(void) close(fd);
+	free(buf[0]);
+	free(buf[1]);
+	return (ok);
+}
+
+/*
+ * Open `fn' with mapping refused.
+ */
+static Elf *
+od_open(const char *fn, Elf_Cmd c, int *fdp)
+{
+	Elf *e;
+
+	if ((*fdp = open(fn, c == ELF_C_READ ? O_RDONLY : O_RDWR)) < 0)
+		return (NULL);
+
+	od_refuse = 1;
+	od_refused = 0;
+	e = elf_begin(*fdp, c, NULL);
+	od_refuse = 0;
+
+	if (e == NULL || od_refused == 0) {
+		if (e)
+			(void) elf_end(e);
+		(void) close(*fdp);
+		return (NULL);
+	}
+
+	return (e);
+}
+
+/*
+ * The sections of a file larger than a chunk are read in correctly,
+ * whichever part of the file is accessed first.
+ */
+void
+tcReadLargeFile(void)
+{
+	Elf *e;
+	Elf_Scn *scn;
+	int fd, result;
+
+	TP_ANNOUNCE("sections of a file that is read in on demand have "
+	    "the right contents.");
+
+	TP_CHECK_INITIALIZATION();
+
+	e = NULL;
+	fd = -1;
+	result = TET_PASS;
+
+	if (!od_create(TS_NEWFILE)) {
+		TP_UNRESOLVED("creating \"" TS_NEWFILE "\" failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((e = od_open(TS_NEWFILE, ELF_C_READ, &fd)) == NULL) {
+		TP_UNRESOLVED("opening \"" TS_NEWFILE "\" without mapping "
+		    "it in failed.");
+		goto done;
+	}
+
+	if ((scn = elf_getscn(e, 2)) == NULL ||
+	    !od_check(elf_getdata(scn, NULL), OD_SIZE2))
+		TP_FAIL("section 2 (past the first chunk): \"%s\".",
+		    elf_errmsg(-1));
+	else if ((scn = elf_getscn(e, 1)) == NULL ||
+	    !od_check(elf_getdata(scn, NULL), OD_SIZE1))
+		TP_FAIL("section 1 (spanning several chunks): \"%s\".",
+		    elf_errmsg(-1));
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd >= 0)
+		(void) close(fd);
+	tet_result(result);
+}
+
+/*
+ * A file being read in on demand can be updated.
+ */
+void
+tcUpdateLargeFile(void)
+{
+	Elf *e;
+	Elf_Data *d;
+	Elf_Scn *scn;
+	int fd, result;
+
+	TP_ANNOUNCE("a file that is read in on demand can be updated.");
+
+	TP_CHECK_INITIALIZATION();
+
+	e = NULL;
+	fd = -1;
+	result = TET_PASS;
+
+	if (!od_create(TS_NEWFILE)) {
+		TP_UNRESOLVED("creating \"" TS_NEWFILE "\" failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	if ((e = od_open(TS_NEWFILE, ELF_C_RDWR, &fd)) == NULL) {
+		TP_UNRESOLVED("opening \"" TS_NEWFILE "\" without mapping "
+		    "it in failed.");
+		goto done;
+	}
+
+	if ((scn = elf_getscn(e, 2)) == NULL ||
+	    (d = elf_getdata(scn, NULL)) == NULL) {
+		TP_UNRESOLVED("elf_getdata() failed: \"%s\".",
+		    elf_errmsg(-1));
+		goto done;
+	}
+
+	((unsigned char *) d->d_buf)[0] = 0xFF;
+	(void) elf_flagdata(d, ELF_C_SET, ELF_F_DIRTY);
+
+	if (elf_update(e, ELF_C_WRITE) < 0) {
+		TP_FAIL("elf_update() failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	(void) elf_end(e);
+	(void) close(fd);
+	fd = -1;
+
+	_TS_OPEN_FILE(e, TS_NEWFILE, ELF_C_READ, fd,
+	    result = TET_UNRESOLVED; goto done;);
+
+	if ((scn = elf_getscn(e, 2)) == NULL ||
+	    (d = elf_getdata(scn, NULL)) == NULL ||
+	    ((unsigned char *) d->d_buf)[0] != 0xFF)
+		TP_FAIL("section 2 was not updated: \"%s\".", elf_errmsg(-1));
+	else if ((scn = elf_getscn(e, 1)) == NULL ||
+	    !od_check(elf_getdata(scn, NULL), OD_SIZE1))
+		TP_FAIL("section 1 was not preserved: \"%s\".",
+		    elf_errmsg(-1));
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd >= 0)
+		(void) close(fd);
+	tet_result(result);
+}
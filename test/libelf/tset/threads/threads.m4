@@ -0,0 +1,434 @@
+/*-
+ * Copyright (c) 2026 The Elftoolchain Project
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * $Id$
+ */
+
+#include <ar.h>
+#include <gelf.h>
+#include <libelf.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "elfts.h"
+#include "tet_api.h"
+
+IC_REQUIRES_VERSION_INIT();
+
+include(`elfts.m4')
+
+/*
+ * Tests for the use of the library from multiple threads.
+ */
+
+#define	NTHREADS	8
+#define	NROUNDS		64
+
+/*
+ * The error number is maintained per-thread.
+ */
+
+static void *
+errnum_thread(void *arg)
+{
+	int *error;
+
+	error = arg;
+
+	/* Errors set by other threads are not visible here ... */
+	if ((error[0] = elf_errno()) != ELF_E_NONE)
+		return (NULL);
+
+	/* ... and errors set here do not leak out. */
+	(void) elf_version(EV_CURRENT + 1);
+	error[1] = elf_errno();
+
+	return (NULL);
+}
+
+void
+tcErrorPerThread(void)
+{
+	pthread_t t;
+	Elf_Scn *scn;
+	int error, result, terror[2];
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("elf_errno() is maintained per-thread.");
+
+	result = TET_UNRESOLVED;
+
+	if ((scn = elf_getscn(NULL, (size_t) 0)) != NULL) {
+		TP_UNRESOLVED("elf_getscn(NULL) succeeded.");
+		goto done;
+	}
+
+	terror[0] = terror[1] = -1;
+	if (pthread_create(&t, NULL, errnum_thread, terror) != 0 ||
+	    pthread_join(t, NULL) != 0) {
+		TP_UNRESOLVED("thread creation failed.");
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	if (terror[0] != ELF_E_NONE)
+		TP_FAIL("thread saw error %d \"%s\".", terror[0],
+		    elf_errmsg(terror[0]));
+	else if (terror[1] != ELF_E_VERSION)
+		TP_FAIL("thread error %d != ELF_E_VERSION.", terror[1]);
+	else if ((error = elf_errno()) != ELF_E_ARGUMENT)
+		TP_FAIL("error=%d \"%s\".", error, elf_errmsg(error));
+
+ done:
+	tet_result(result);
+}
+
+/*
+ * Multiple threads may concurrently read a descriptor opened with
+ * ELF_C_READ.  Each thread holds its own activation of the shared
+ * descriptor, walks the section list and resolves strings, racing
+ * the other threads to the lazily loaded section headers and data.
+ */
+
+struct shared_elf {
+	Elf		*se_elf;
+	int		se_fd;
+	size_t		se_nsections;	/* computed by the main thread */
+	const char	*se_name;	/* expected name of the last section */
+	int		se_failed;	/* set by workers */
+};
+
+static void *
+shared_elf_thread(void *arg)
+{
+	Elf *e;
+	Elf_Scn *scn;
+	GElf_Shdr sh;
+	size_t n, shstrndx;
+	const char *name;
+	struct shared_elf *se;
+
+	se = arg;
+
+	if ((e = elf_begin(se->se_fd, ELF_C_READ, se->se_elf)) !=
+	    se->se_elf) {
+		se->se_failed = 1;
+		return (NULL);
+	}
+
+	if (elf_getshdrstrndx(e, &shstrndx) != 0)
+		goto fail;
+
+	/* Walk the section list. */
+	for (n = 1, scn = NULL; (scn = elf_nextscn(e, scn)) != NULL; n++)
+		if (elf_ndxscn(scn) != n)
+			goto fail;
+
+	if (n != se->se_nsections || elf_errno() != ELF_E_NONE)
+		goto fail;
+
+	/* Look up the last section and its name. */
+	if ((scn = elf_getscn(e, se->se_nsections - 1)) == NULL ||
+	    gelf_getshdr(scn, &sh) == NULL ||
+	    (name = elf_strptr(e, shstrndx, sh.sh_name)) == NULL ||
+	    strcmp(name, se->se_name) != 0)
+		goto fail;
+
+	(void) elf_end(e);
+	return (NULL);
+
+ fail:
+	se->se_failed = 1;
+	(void) elf_end(e);
+	return (NULL);
+}
+
+undefine(`FN')
+define(`FN',`
+void
+tcSharedDescriptor$1$2(void)
+{
+	Elf *e;
+	Elf_Scn *scn;
+	GElf_Shdr sh;
+	int fd, result;
+	const char *name;
+	struct shared_elf se;
+	pthread_t t[NTHREADS];
+	size_t i, n, nt, shstrndx;
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("TOUPPER($2)$1: concurrent readers of a shared "
+	    "descriptor.");
+
+	e = NULL;
+	fd = -1;
+	result = TET_UNRESOLVED;
+
+	/* Compute the expected results with a private descriptor. */
+	_TS_OPEN_FILE(e, "xscn-2.$2$1", ELF_C_READ, fd, goto done;);
+
+	if (elf_getshnum(e, &n) == 0 ||
+	    elf_getshdrstrndx(e, &shstrndx) != 0 ||
+	    (scn = elf_getscn(e, n - 1)) == NULL ||
+	    gelf_getshdr(scn, &sh) == NULL ||
+	    (name = elf_strptr(e, shstrndx, sh.sh_name)) == NULL) {
+		TP_UNRESOLVED("setup failed: \"%s\".", elf_errmsg(-1));
+		goto done;
+	}
+
+	se.se_fd = fd;
+	se.se_nsections = n;
+	se.se_name = strdup(name);
+
+	(void) elf_end(e);
+	e = NULL;
+
+	result = TET_PASS;
+
+	for (n = 0; n < NROUNDS && result == TET_PASS; n++) {
+		if ((e = elf_begin(fd, ELF_C_READ, NULL)) == NULL) {
+			TP_UNRESOLVED("elf_begin() failed: \"%s\".",
+			    elf_errmsg(-1));
+			break;
+		}
+
+		se.se_elf = e;
+		se.se_failed = 0;
+
+		for (nt = 0; nt < NTHREADS; nt++)
+			if (pthread_create(&t[nt], NULL, shared_elf_thread,
+			    &se) != 0) {
+				TP_UNRESOLVED("pthread_create() failed.");
+				break;
+			}
+
+		for (i = 0; i < nt; i++)
+			(void) pthread_join(t[i], NULL);
+
+		if (nt < NTHREADS)
+			break;
+
+		if (se.se_failed)
+			TP_FAIL("round %d: a reader thread failed.", (int) n);
+
+		/* All activations other than ours have been released. */
+		if (elf_end(e) != 0)
+			TP_FAIL("round %d: elf_end() != 0.", (int) n);
+		e = NULL;
+	}
+
+	free((void *) se.se_name);
+
+ done:
+	if (e)
+		(void) elf_end(e);
+	if (fd != -1)
+		(void) close(fd);
+
+	tet_result(result);
+}')
+
+FN(32,`lsb')
+FN(32,`msb')
+FN(64,`lsb')
+FN(64,`msb')
+
+/*
+ * Members of a shared archive descriptor may be opened concurrently.
+ * Each thread retrieves the table of member offsets, racing the other
+ * threads to build it, and then opens and checks its share of the
+ * members.
+ */
+
+#define	NARMEMBERS		256
+#define	AR_MEMBER_SIZE(I)	((size_t) (I) % 13 + 1)
+#define	AR_MEMBER_BYTE(I)	((char) ((I) % 26 + 'a'))
+
+struct ar_thread {
+	Elf		*at_ar;
+	size_t		at_index;	/* index of this thread */
+	off_t		*at_members;	/* the table seen by the thread */
+	int		at_failed;
+};
+
+/*
+ * Create an archive with NARMEMBERS members named "m0", "m1", ....
+ */
+static char *
+ar_make_image(size_t *psz)
+{
+	size_t i, msz, sz;
+	char *image, *p, hdr[sizeof(struct ar_hdr) + 1], name[16];
+
+	for (sz = SARMAG, i = 0; i < NARMEMBERS; i++)
+		sz += sizeof(struct ar_hdr) + ((AR_MEMBER_SIZE(i) + 1) & ~1U);
+
+	if ((image = malloc(sz)) == NULL)
+		return (NULL);
+
+	(void) memcpy(image, ARMAG, SARMAG);
+
+	for (p = image + SARMAG, i = 0; i < NARMEMBERS; i++) {
+		msz = AR_MEMBER_SIZE(i);
+		(void) snprintf(name, sizeof(name), "m%d", (int) i);
+		(void) snprintf(hdr, sizeof(hdr),
+		    "%-16s%-12d%-6d%-6d%-8o%-10d%s", name, 0, 0, 0, 0644,
+		    (int) msz, ARFMAG);
+		(void) memcpy(p, hdr, sizeof(struct ar_hdr));
+		p += sizeof(struct ar_hdr);
+		(void) memset(p, AR_MEMBER_BYTE(i), msz);
+		p += msz;
+		if (msz & 1)
+			*p++ = '\n';
+	}
+
+	*psz = sz;
+	return (image);
+}
+
+static void *
+ar_member_thread(void *arg)
+{
+	Elf *e;
+	Elf_Arhdr *arh;
+	off_t *off;
+	size_t i, k, n, sz;
+	char *image, name[16];
+	struct ar_thread *at;
+
+	at = arg;
+
+	if ((off = elf_getarmembers(at->at_ar, &n)) == NULL ||
+	    n != NARMEMBERS) {
+		at->at_failed = 1;
+		return (NULL);
+	}
+
+	at->at_members = off;
+
+	for (i = at->at_index; i < n; i += NTHREADS) {
+		if ((e = elf_openarmember(at->at_ar, off[i])) == NULL) {
+			at->at_failed = 1;
+			return (NULL);
+		}
+
+		(void) snprintf(name, sizeof(name), "m%d", (int) i);
+
+		if ((arh = elf_getarhdr(e)) == NULL ||
+		    strcmp(arh->ar_name, name) != 0 ||
+		    (image = elf_rawfile(e, &sz)) == NULL ||
+		    sz != AR_MEMBER_SIZE(i))
+			at->at_failed = 1;
+		else
+			for (k = 0; k < sz; k++)
+				if (image[k] != AR_MEMBER_BYTE(i))
+					at->at_failed = 1;
+
+		(void) elf_end(e);
+
+		if (at->at_failed)
+			break;
+	}
+
+	return (NULL);
+}
+
+void
+tcArchiveMembers(void)
+{
+	Elf *ar;
+	off_t *off;
+	char *image;
+	int result;
+	size_t i, n, nt, sz;
+	pthread_t t[NTHREADS];
+	struct ar_thread at[NTHREADS];
+
+	TP_CHECK_INITIALIZATION();
+
+	TP_ANNOUNCE("concurrent opens of the members of a shared archive.");
+
+	ar = NULL;
+	result = TET_UNRESOLVED;
+
+	if ((image = ar_make_image(&sz)) == NULL) {
+		TP_UNRESOLVED("malloc() failed.");
+		goto done;
+	}
+
+	result = TET_PASS;
+
+	for (n = 0; n < NROUNDS && result == TET_PASS; n++) {
+		if ((ar = elf_memory(image, sz)) == NULL) {
+			TP_UNRESOLVED("elf_memory() failed: \"%s\".",
+			    elf_errmsg(-1));
+			break;
+		}
+
+		for (nt = 0; nt < NTHREADS; nt++) {
+			at[nt].at_ar = ar;
+			at[nt].at_index = nt;
+			at[nt].at_members = NULL;
+			at[nt].at_failed = 0;
+			if (pthread_create(&t[nt], NULL, ar_member_thread,
+			    &at[nt]) != 0) {
+				TP_UNRESOLVED("pthread_create() failed.");
+				break;
+			}
+		}
+
+		for (i = 0; i < nt; i++)
+			(void) pthread_join(t[i], NULL);
+
+		if (nt < NTHREADS)
+			break;
+
+		/* All threads saw the same table. */
+		off = elf_getarmembers(ar, NULL);
+		for (i = 0; i < NTHREADS; i++)
+			if (at[i].at_failed || at[i].at_members != off)
+				TP_FAIL("round %d: thread %d failed.", (int) n,
+				    (int) i);
+
+		/* All member descriptors have been released. */
+		if (elf_end(ar) != 0)
+			TP_FAIL("round %d: elf_end() != 0.", (int) n);
+		ar = NULL;
+	}
+
+ done:
+	if (ar)
+		(void) elf_end(ar);
+	free(image);
+
+	tet_result(result);
+}